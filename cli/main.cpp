@@ -39,6 +39,7 @@
 #include <iostream>
 #include <ranges>
 #include <string_view>
+#include <type_traits>
 
 using namespace CppUtilities;
 using namespace CppUtilities::EscapeCodes;
@@ -100,7 +101,7 @@ static void printPackageSearchResults(const LibRepoMgr::WebClient::Response::bod
     t.add_row({ "Arch", "Repo", "Name", "Version", "Description", "Build date" });
     for (const auto &[db, package, packageID] : packages) {
         const auto &dbInfo = std::get<LibPkg::DatabaseInfo>(db);
-        t.add_row({ !package->arch.empty() ? package->arch : dbInfo.arch, dbInfo.name, package->name, package->version, package->description,
+        t.add_row({ !package->arch.empty() ? package->arch.str() : dbInfo.arch, dbInfo.name, package->name, package->version, package->description,
             !package->buildDate.isNull() ? package->buildDate.toString() : "?" });
     }
     t.row(0).format().font_align(tabulate::FontAlign::center).font_style({ tabulate::FontStyle::bold });
@@ -110,7 +111,11 @@ static void printPackageSearchResults(const LibRepoMgr::WebClient::Response::bod
 
 template <typename List> inline std::string formatList(const List &list)
 {
-    return joinStrings(list, ", ");
+    if constexpr (std::is_same_v<typename List::value_type, LibPkg::InternedString>) {
+        return joinStrings(std::vector<std::string>(list.begin(), list.end()), ", ");
+    } else {
+        return joinStrings(list, ", ");
+    }
 }
 
 static std::string formatDependencies(const std::vector<LibPkg::Dependency> &deps)
@@ -134,7 +139,7 @@ static void printPackageDetails(const LibRepoMgr::WebClient::Response::body_type
         tabulate::Table t;
         t.format().hide_border();
         if (pkg->packageInfo) {
-            t.add_row({ "Arch", pkg->arch });
+            t.add_row({ "Arch", pkg->arch.str() });
         } else if (!pkg->archs.empty()) {
             t.add_row({ "Archs", formatList(pkg->archs) });
         } else if (pkg->sourceInfo) {
@@ -423,8 +428,8 @@ int main(int argc, const char *argv[])
     searchTermArg.setImplicit(true);
     searchTermArg.setRequired(true);
     auto searchModeArg
-        = ConfigValueArgument("mode", 'm', "specifies the mode", { "name/name-contains/regex/provides/depends/libprovides/libdepends" });
-    searchModeArg.setPreDefinedCompletionValues("name name-contains regex provides depends libprovides libdepends");
+        = ConfigValueArgument("mode", 'm', "specifies the mode", { "name/name-contains/regex/provides/depends/libprovides/libdepends/files" });
+    searchModeArg.setPreDefinedCompletionValues("name name-contains regex provides depends libprovides libdepends files");
     searchArg.setSubArguments({ &searchTermArg, &searchModeArg });
     searchArg.setCallback([&path, &printer, &searchTermArg, &searchModeArg](const ArgumentOccurrence &) {
         path = "/api/v0/packages?mode=" + LibRepoMgr::WebAPI::Url::encodeValue(searchModeArg.firstValueOr("name-contains"));
@@ -103,13 +103,13 @@ std::string Config::addLicenseInfo(LicenseResult &result, PackageSearchResult &s
         // read the package's license field (see https://wiki.archlinux.org/index.php/PKGBUILD#license)
         for (const auto &license : package->licenses) {
             // check for custom licenses and licenses which contain project specific references and are therefore considered custom as well
-            if (startsWith(license, "custom") || license == "BSD" || license == "ISC" || license == "MIT" || license == "ZLIB"
+            if (license.starts_with("custom") || license == "BSD" || license == "ISC" || license == "MIT" || license == "ZLIB"
                 || license == "Python") {
                 hasCustomLicense = true;
                 continue;
             }
             // map Arch Linux generic way to say e.g. "GPL2 and above" to a concrete license e.g. "GPL2"
-            auto concreteLicense = license;
+            auto concreteLicense = license.str();
             if (license == "GPL") {
                 concreteLicense = "GPL2 or any later version";
             } else if (license == "GPL2") {
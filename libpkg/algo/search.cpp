@@ -1,10 +1,15 @@
 #include "../data/config.h"
+#include "../data/storageprivate.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/ansiescapecodes.h>
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 using namespace CppUtilities;
@@ -124,6 +129,46 @@ std::vector<PackageSearchResult> Config::findPackages(
     return pkgs;
 }
 
+/*!
+ * \brief Returns the packages providing \a dependency within the configured databases as pairs of the index of the
+ *        database and the package ID.
+ * \remarks
+ * - Looks up the dependency in the index of provides across all databases so it takes only one lookup regardless of the
+ *   number of databases.
+ * - The pairs are ordered by the index of the database (which is its priority) and then like Database::providingPackages()
+ *   would visit them.
+ * - Entries of databases which are not configured (anymore) are skipped. Such entries are removed when discarding
+ *   databases, see Config::discardDatabases().
+ */
+static std::vector<std::pair<std::size_t, StorageID>> findProvidingPackageIDs(Config &config, const Dependency &dependency)
+{
+    auto ids = std::vector<std::pair<std::size_t, StorageID>>();
+    if (dependency.name.empty() || !config.storage()) {
+        return ids;
+    }
+    auto indexByDatabaseID = std::unordered_map<std::uint32_t, std::size_t>();
+    for (auto i = std::size_t(); i != config.databases.size(); ++i) {
+        if (const auto id = config.databases[i].storageID()) {
+            indexByDatabaseID.try_emplace(id, i);
+        }
+    }
+    auto &storage = *config.storage();
+    auto txn = storage.env()->getROTransaction();
+    auto matcher = DependencyVersionMatcher(dependency);
+    storage.allProvides().forEach(*txn, dependency.name, [&](std::uint32_t databaseID, const DependencyIndexEntry &entry) {
+        const auto db = indexByDatabaseID.find(databaseID);
+        if (db == indexByDatabaseID.end()) {
+            return false;
+        }
+        if (matcher.matches(entry.version)) {
+            ids.emplace_back(db->second, entry.packageID);
+        }
+        return false;
+    });
+    std::stable_sort(ids.begin(), ids.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    return ids;
+}
+
 /*!
  * \brief Returns the first package satisfying \a dependency.
  * \remarks Packages where the name itself matches are preferred.
@@ -131,16 +176,17 @@ std::vector<PackageSearchResult> Config::findPackages(
 PackageSearchResult Config::findPackage(const Dependency &dependency)
 {
     auto result = PackageSearchResult();
-    auto exactMatch = false;
-    for (auto &db : databases) {
-        db.providingPackages(dependency, false, [&](StorageID id, const std::shared_ptr<Package> &package) {
-            exactMatch = dependency.name == package->name;
-            result.db = &db;
-            result.pkg = package;
-            result.id = id;
-            // prefer package where the name matches exactly; so if we found one no need to look further
-            return exactMatch;
-        });
+    for (const auto &[dbIndex, packageID] : findProvidingPackageIDs(*this, dependency)) {
+        auto &db = databases[dbIndex];
+        auto package = db.findPackage(packageID);
+        if (!package) {
+            continue;
+        }
+        const auto exactMatch = dependency.name == package->name;
+        result.db = &db;
+        result.pkg = std::move(package);
+        result.id = packageID;
+        // prefer package where the name matches exactly; so if we found one no need to look further
         if (exactMatch) {
             break;
         }
@@ -154,6 +200,27 @@ PackageSearchResult Config::findPackage(const Dependency &dependency)
 std::vector<PackageSearchResult> Config::findPackages(const Dependency &dependency, bool reverse, std::size_t limit)
 {
     auto results = std::vector<PackageSearchResult>();
+    if (!reverse) {
+        auto previousDbIndex = std::numeric_limits<std::size_t>::max();
+        auto visited = std::unordered_set<StorageID>();
+        for (const auto &[dbIndex, packageID] : findProvidingPackageIDs(*this, dependency)) {
+            if (results.size() >= limit) {
+                break;
+            }
+            if (dbIndex != previousDbIndex) {
+                visited.clear();
+                previousDbIndex = dbIndex;
+            }
+            if (!visited.emplace(packageID).second) {
+                continue;
+            }
+            auto &db = databases[dbIndex];
+            if (auto package = db.findPackage(packageID)) {
+                results.emplace_back(db, std::move(package), packageID);
+            }
+        }
+        return results;
+    }
     for (auto &db : databases) {
         auto visited = std::unordered_set<StorageID>();
         db.providingPackages(dependency, reverse, [&](StorageID packageID, const std::shared_ptr<Package> &package) {
@@ -247,6 +314,84 @@ void Config::packagesByName(const DatabaseVisitor &databaseVisitor, const Packag
     }
 }
 
+void Config::packagesByName(const DatabaseVisitor &databaseVisitor, const PackageVisitorByNameView &visitor)
+{
+    for (auto &db : databases) {
+        if (databaseVisitor && databaseVisitor(db)) {
+            continue;
+        }
+        db.allPackagesByName([&](std::string_view packageName, const std::function<StorageID(PackageView &)> &getPackage) {
+            return visitor(db, packageName, getPackage);
+        });
+    }
+}
+
+/*!
+ * \brief Visits packages whose names contain all of the specified \a substrings via the trigram index of each database.
+ * \sa Database::packagesByNameContaining()
+ */
+void Config::packagesByNameContaining(
+    std::span<const std::string_view> substrings, const DatabaseVisitor &databaseVisitor, const PackageVisitorByNameView &visitor)
+{
+    for (auto &db : databases) {
+        if (databaseVisitor && databaseVisitor(db)) {
+            continue;
+        }
+        db.packagesByNameContaining(substrings, [&](std::string_view packageName, const std::function<StorageID(PackageView &)> &getPackage) {
+            return visitor(db, packageName, getPackage);
+        });
+    }
+}
+
+/*!
+ * \brief Visits packages containing the file with the specified \a path via the index of files of each database.
+ * \sa Database::packagesContainingFile()
+ */
+void Config::packagesContainingFile(std::string_view path, FileSearchMode mode, const DatabaseVisitor &databaseVisitor, const FileVisitor &visitor)
+{
+    for (auto &db : databases) {
+        if (databaseVisitor && databaseVisitor(db)) {
+            continue;
+        }
+        auto stop = false;
+        db.packagesContainingFile(path, mode, [&](StorageID packageID, std::string_view foundPath) { return stop = visitor(db, packageID, foundPath); });
+        if (stop) {
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief Visits packages containing the file with the specified \a path via the index of files of each database without copying their data.
+ * \sa Database::packagesContainingFile()
+ */
+void Config::packagesContainingFile(std::string_view path, FileSearchMode mode, const DatabaseVisitor &databaseVisitor, const FileVisitorView &visitor)
+{
+    for (auto &db : databases) {
+        if (databaseVisitor && databaseVisitor(db)) {
+            continue;
+        }
+        auto stop = false;
+        db.packagesContainingFile(
+            path, mode, [&](StorageID packageID, std::string_view foundPath, const std::function<bool(PackageView &)> &getPackage) {
+                return stop = visitor(db, packageID, foundPath, getPackage);
+            });
+        if (stop) {
+            return;
+        }
+    }
+}
+
+void Config::packagesView(const DatabaseVisitor &databaseVisitor, const PackageVisitorView &visitor)
+{
+    for (auto &db : databases) {
+        if (databaseVisitor && databaseVisitor(db)) {
+            continue;
+        }
+        db.allPackagesView([&](StorageID packageID, const PackageView &package) { return visitor(db, packageID, package); });
+    }
+}
+
 void Config::providingPackages(const Dependency &dependency, bool reverse, const DatabaseVisitor &databaseVisitor, const PackageVisitorConst &visitor)
 {
     for (auto &db : databases) {
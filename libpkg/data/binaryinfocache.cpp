@@ -0,0 +1,290 @@
+#include "./binaryinfocache.h"
+#include "./storageprivate.h"
+
+#include "../parser/binary.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace LibPkg {
+
+/// \cond
+namespace {
+
+/*!
+ * \brief The key the current generation is stored under; it does not start with Binary::infoVersion.
+ */
+constexpr auto generationKey = std::string_view("\0generation", 11);
+
+/*!
+ * \brief The size of the generation preceding the info within the value of an entry.
+ */
+constexpr auto generationSize = sizeof(std::uint64_t);
+
+inline void appendGeneration(std::string &data, std::uint64_t generation)
+{
+    for (auto shift = 56; shift >= 0; shift -= 8) {
+        data += static_cast<char>((generation >> shift) & 0xFF);
+    }
+}
+
+inline std::uint64_t readGeneration(std::string_view data)
+{
+    auto generation = std::uint64_t();
+    for (const auto c : data.substr(0, generationSize)) {
+        generation = (generation << 8) | static_cast<unsigned char>(c);
+    }
+    return generation;
+}
+
+inline std::string makeValue(std::uint64_t generation, std::string_view info)
+{
+    auto value = std::string();
+    value.reserve(generationSize + info.size());
+    appendGeneration(value, generation);
+    value += info;
+    return value;
+}
+
+std::uint64_t readStoredGeneration(StorageDistribution &storage)
+{
+    auto txn = storage.env()->getROTransaction();
+    auto value = LMDBSafe::MDBOutVal();
+    return txn->get(storage.binaryInfoDbi(), LMDBSafe::MDBInVal(generationKey), value) == MDB_NOTFOUND
+        ? 0
+        : readGeneration(value.get<std::string_view>());
+}
+
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Constructs a cache using the "binaryinfo" table of the specified \a storage.
+ * \remarks
+ * - Entries are stamped with the current generation; call startGeneration() to start a new one.
+ * - The stored entries (keys and values) are allowed to occupy \a limit bytes; see removeStaleEntries().
+ */
+BinaryInfoCache::BinaryInfoCache(StorageDistribution &storage, std::size_t limit)
+    : m_storage(storage)
+    , m_limit(limit)
+    , m_generation(readStoredGeneration(storage))
+{
+}
+
+/*!
+ * \brief Increments the generation stored within the storage; entries stored or found from now on are stamped with it.
+ * \returns Returns the new generation.
+ */
+std::uint64_t BinaryInfoCache::startGeneration()
+{
+    auto txn = m_storage.env()->getRWTransaction();
+    auto value = LMDBSafe::MDBOutVal();
+    m_generation = txn->get(m_storage.binaryInfoDbi(), LMDBSafe::MDBInVal(generationKey), value) == MDB_NOTFOUND
+        ? 1
+        : readGeneration(value.get<std::string_view>()) + 1;
+    auto newValue = std::string();
+    appendGeneration(newValue, m_generation);
+    txn->put(m_storage.binaryInfoDbi(), LMDBSafe::MDBInVal(generationKey), LMDBSafe::MDBInVal(newValue));
+    txn->commit();
+    return m_generation;
+}
+
+/*!
+ * \brief Assigns the info stored for \a key to \a info.
+ * \returns Returns whether an entry for \a key exists.
+ * \remarks
+ * - Entries which have only been added but not written yet are not found.
+ * - Found entries stamped with a previous generation are stamped with the current one with the next batch.
+ */
+bool BinaryInfoCache::find(std::string_view key, std::string &info)
+{
+    auto txn = m_storage.env()->getROTransaction();
+    auto value = LMDBSafe::MDBOutVal();
+    if (txn->get(m_storage.binaryInfoDbi(), LMDBSafe::MDBInVal(key), value) == MDB_NOTFOUND) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const auto valueView = value.get<std::string_view>();
+    if (valueView.size() < generationSize) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    info = valueView.substr(generationSize);
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    if (readGeneration(valueView) == m_generation) {
+        return true;
+    }
+    txn.reset();
+    auto lock = std::unique_lock(m_mutex);
+    m_usedKeys.emplace_back(key);
+    if (m_newEntries.size() + m_usedKeys.size() < batchSize) {
+        return true;
+    }
+    auto entries = std::move(m_newEntries);
+    auto usedKeys = std::move(m_usedKeys);
+    m_newEntries.clear();
+    m_usedKeys.clear();
+    lock.unlock();
+    store(std::move(entries), std::move(usedKeys));
+    return true;
+}
+
+/*!
+ * \brief Adds an entry; it is written to the storage with the next batch or when flush() is called.
+ */
+void BinaryInfoCache::add(std::string &&key, std::string &&info)
+{
+    auto lock = std::unique_lock(m_mutex);
+    m_newEntries.emplace_back(std::move(key), std::move(info));
+    if (m_newEntries.size() + m_usedKeys.size() < batchSize) {
+        return;
+    }
+    auto entries = std::move(m_newEntries);
+    auto usedKeys = std::move(m_usedKeys);
+    m_newEntries.clear();
+    m_usedKeys.clear();
+    lock.unlock();
+    store(std::move(entries), std::move(usedKeys));
+}
+
+/*!
+ * \brief Writes all entries added so far and the generation of all entries found so far to the storage.
+ */
+void BinaryInfoCache::flush()
+{
+    auto lock = std::unique_lock(m_mutex);
+    auto entries = std::move(m_newEntries);
+    auto usedKeys = std::move(m_usedKeys);
+    m_newEntries.clear();
+    m_usedKeys.clear();
+    lock.unlock();
+    store(std::move(entries), std::move(usedKeys));
+}
+
+/*!
+ * \brief Removes entries which have been stored by another version of the parser and the least recently used entries
+ *        exceeding limit().
+ * \returns Returns the number of removed entries.
+ * \remarks
+ * - Keys start with Binary::infoVersion so stale entries are sorted before or after the current ones.
+ * - Entries are removed in the order of the generation they have been stored or found last in so entries used by the
+ *   latest reloads are kept. Entries of binaries which have not been parsed for many reloads are kept as well as long as
+ *   the limit is not exceeded.
+ */
+std::size_t BinaryInfoCache::removeStaleEntries()
+{
+    auto &dbi = m_storage.binaryInfoDbi();
+    auto txn = m_storage.env()->getRWTransaction();
+    auto staleKeys = std::vector<std::string>();
+    auto currentEntries = std::vector<std::tuple<std::uint64_t, std::size_t, std::string>>(); // generation, size and key
+    auto size = std::size_t();
+    {
+        auto cursor = txn->getROCursor(dbi);
+        auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+        for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+            const auto keyView = key.get<std::string_view>();
+            if (keyView == generationKey) {
+                continue;
+            }
+            const auto valueView = value.get<std::string_view>();
+            if (!keyView.starts_with(Binary::infoVersion) || valueView.size() < generationSize) {
+                staleKeys.emplace_back(keyView);
+                continue;
+            }
+            const auto entrySize = keyView.size() + valueView.size();
+            size += entrySize;
+            currentEntries.emplace_back(readGeneration(valueView), entrySize, keyView);
+        }
+    }
+    if (size > m_limit) {
+        std::sort(currentEntries.begin(), currentEntries.end());
+        for (auto &[generation, entrySize, key] : currentEntries) {
+            if (size <= m_limit) {
+                break;
+            }
+            size -= entrySize;
+            staleKeys.emplace_back(std::move(key));
+        }
+    }
+    for (const auto &key : staleKeys) {
+        txn->del(dbi, LMDBSafe::MDBInVal(key));
+    }
+    txn->commit();
+    return staleKeys.size();
+}
+
+/*!
+ * \brief Removes all entries, including the ones which have only been added but not written yet.
+ * \remarks The generation is kept.
+ */
+void BinaryInfoCache::clear()
+{
+    auto lock = std::unique_lock(m_mutex);
+    m_newEntries.clear();
+    m_usedKeys.clear();
+    lock.unlock();
+    auto txn = m_storage.env()->getRWTransaction();
+    txn->clear(m_storage.binaryInfoDbi());
+    if (m_generation) {
+        auto value = std::string();
+        appendGeneration(value, m_generation);
+        txn->put(m_storage.binaryInfoDbi(), LMDBSafe::MDBInVal(generationKey), LMDBSafe::MDBInVal(value));
+    }
+    txn->commit();
+}
+
+/*!
+ * \brief Returns the number of bytes the stored entries (keys and values) occupy.
+ * \remarks Entries which have only been added but not written yet are not taken into account.
+ */
+std::size_t BinaryInfoCache::size()
+{
+    auto txn = m_storage.env()->getROTransaction();
+    auto cursor = txn->getROCursor(m_storage.binaryInfoDbi());
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    auto size = std::size_t();
+    for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+        if (const auto keyView = key.get<std::string_view>(); keyView != generationKey) {
+            size += keyView.size() + value.get<std::string_view>().size();
+        }
+    }
+    return size;
+}
+
+BinaryInfoCacheStatistics BinaryInfoCache::statistics() const
+{
+    return BinaryInfoCacheStatistics{
+        .hits = m_hits.load(std::memory_order_relaxed),
+        .misses = m_misses.load(std::memory_order_relaxed),
+        .stored = m_stored.load(std::memory_order_relaxed),
+    };
+}
+
+/*!
+ * \brief Writes the specified \a entries and stamps the entries of \a usedKeys with the current generation.
+ */
+void BinaryInfoCache::store(Entries &&entries, std::vector<std::string> &&usedKeys)
+{
+    if (entries.empty() && usedKeys.empty()) {
+        return;
+    }
+    auto &dbi = m_storage.binaryInfoDbi();
+    auto txn = m_storage.env()->getRWTransaction();
+    for (const auto &[key, info] : entries) {
+        txn->put(dbi, LMDBSafe::MDBInVal(key), LMDBSafe::MDBInVal(makeValue(m_generation, info)));
+    }
+    for (const auto &key : usedKeys) {
+        auto value = LMDBSafe::MDBOutVal();
+        if (txn->get(dbi, LMDBSafe::MDBInVal(key), value) == MDB_NOTFOUND) {
+            continue; // removed in the meantime
+        }
+        const auto valueView = value.get<std::string_view>();
+        if (valueView.size() >= generationSize && readGeneration(valueView) != m_generation) {
+            txn->put(dbi, LMDBSafe::MDBInVal(key), LMDBSafe::MDBInVal(makeValue(m_generation, valueView.substr(generationSize))));
+        }
+    }
+    txn->commit();
+    m_stored.fetch_add(entries.size(), std::memory_order_relaxed);
+}
+
+} // namespace LibPkg
@@ -0,0 +1,89 @@
+#ifndef LIBPKG_DATA_BINARY_INFO_CACHE_H
+#define LIBPKG_DATA_BINARY_INFO_CACHE_H
+
+#include "./storagefwd.h"
+
+#include "../global.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace LibPkg {
+
+struct BinaryInfoCacheStatistics {
+    std::size_t hits = 0; // number of binaries whose info has been found
+    std::size_t misses = 0; // number of binaries which had to be parsed
+    std::size_t stored = 0; // number of entries written to the storage
+};
+
+/*!
+ * \brief The BinaryInfoCache class persists the information Binary::load() parses from binaries within the storage.
+ * \remarks
+ * - Keys and values are opaque to this class; they are computed by Binary::load().
+ * - Lookups are served from the storage directly. New entries are buffered and written in batches so adding them does
+ *   not require a write transaction per binary. Call flush() when done to write the remaining entries.
+ * - Each entry is stamped with the generation it has been stored or found last in. Call startGeneration() when starting
+ *   to use the cache for a new reload so entries found during the reload are stamped again (in batches as well). The
+ *   generation only determines the order in which entries are evicted; entries are not evicted just because a number of
+ *   reloads did not use them (packages which have not changed are usually not parsed again at all).
+ * - Entries stored by a previous version of the parser are removed via removeStaleEntries(). If the stored entries
+ *   occupy more than the limit specified when constructing the instance it also removes the least recently used entries
+ *   until they fit. That happens when the storage is initialized and after each reload. Rebuilding the storage clears
+ *   all entries.
+ * - The class is thread-safe except for startGeneration() which must be called before using the instance concurrently.
+ */
+class LIBPKG_EXPORT BinaryInfoCache {
+public:
+    explicit BinaryInfoCache(StorageDistribution &storage, std::size_t limit = defaultLimit);
+    std::uint64_t startGeneration();
+    std::uint64_t generation() const;
+    std::size_t limit() const;
+    bool find(std::string_view key, std::string &info);
+    void add(std::string &&key, std::string &&info);
+    void flush();
+    std::size_t removeStaleEntries();
+    void clear();
+    std::size_t size();
+    BinaryInfoCacheStatistics statistics() const;
+
+    static constexpr auto defaultLimit = std::size_t(64 * 1024 * 1024);
+
+private:
+    using Entries = std::vector<std::pair<std::string, std::string>>;
+    void store(Entries &&entries, std::vector<std::string> &&usedKeys);
+
+    static constexpr auto batchSize = std::size_t(512);
+    StorageDistribution &m_storage;
+    std::size_t m_limit; // in bytes
+    std::uint64_t m_generation;
+    std::mutex m_mutex;
+    Entries m_newEntries;
+    std::vector<std::string> m_usedKeys; // keys of entries found which are stamped with a previous generation
+    std::atomic<std::size_t> m_hits = 0, m_misses = 0, m_stored = 0;
+};
+
+/*!
+ * \brief Returns the generation entries are currently stamped with.
+ */
+inline std::uint64_t BinaryInfoCache::generation() const
+{
+    return m_generation;
+}
+
+/*!
+ * \brief Returns the number of bytes the stored entries (keys and values) are allowed to occupy.
+ */
+inline std::size_t BinaryInfoCache::limit() const
+{
+    return m_limit;
+}
+
+} // namespace LibPkg
+
+#endif // LIBPKG_DATA_BINARY_INFO_CACHE_H
@@ -0,0 +1,119 @@
+#ifndef LIBPKG_DATA_BLOOM_FILTER_H
+#define LIBPKG_DATA_BLOOM_FILTER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace LibPkg {
+
+/*!
+ * \brief The BloomFilter class is a set of strings which might yield false positives but never false negatives.
+ * \remarks
+ * - The filter uses 10 bits per expected key and 7 hash functions (derived from one 64-bit hash via double hashing)
+ *   which gives a false-positive rate of about 1 % when the expected number of keys is not exceeded.
+ * - Keys can not be removed; rebuild the filter instead.
+ * - The class is not thread-safe.
+ */
+class BloomFilter {
+public:
+    explicit BloomFilter(std::size_t expectedKeyCount = 0);
+
+    static std::uint64_t hash(std::string_view key);
+    void add(std::string_view key);
+    void add(std::uint64_t keyHash);
+    bool mightContain(std::string_view key) const;
+    bool mightContain(std::uint64_t keyHash) const;
+    std::size_t bitCount() const;
+
+private:
+    template <typename Function> void forEachBit(std::uint64_t keyHash, Function function) const;
+
+    static constexpr auto bitsPerKey = std::size_t(10);
+    static constexpr auto hashCount = std::size_t(7);
+    std::vector<std::uint64_t> m_words;
+};
+
+/*!
+ * \brief Constructs a filter with enough bits to hold \a expectedKeyCount keys.
+ */
+inline BloomFilter::BloomFilter(std::size_t expectedKeyCount)
+    : m_words(std::max<std::size_t>((expectedKeyCount * bitsPerKey + 63) / 64, 1))
+{
+}
+
+/*!
+ * \brief Returns the hash of \a key used by add() and mightContain().
+ * \remarks Computing the hash once is useful to add the same key to several filters or to size a filter before adding keys.
+ */
+inline std::uint64_t BloomFilter::hash(std::string_view key)
+{
+    return std::hash<std::string_view>()(key);
+}
+
+/*!
+ * \brief Adds \a key to the filter.
+ */
+inline void BloomFilter::add(std::string_view key)
+{
+    add(hash(key));
+}
+
+/*!
+ * \brief Adds the key with the specified \a keyHash to the filter.
+ */
+inline void BloomFilter::add(std::uint64_t keyHash)
+{
+    forEachBit(keyHash, [this](std::size_t bit) {
+        m_words[bit / 64] |= std::uint64_t(1) << (bit % 64);
+        return true;
+    });
+}
+
+/*!
+ * \brief Returns whether \a key might have been added; returns false only if \a key has definitely not been added.
+ */
+inline bool BloomFilter::mightContain(std::string_view key) const
+{
+    return mightContain(hash(key));
+}
+
+/*!
+ * \brief Returns whether the key with the specified \a keyHash might have been added.
+ */
+inline bool BloomFilter::mightContain(std::uint64_t keyHash) const
+{
+    auto contained = true;
+    forEachBit(keyHash, [this, &contained](std::size_t bit) { return contained = m_words[bit / 64] & (std::uint64_t(1) << (bit % 64)); });
+    return contained;
+}
+
+/*!
+ * \brief Returns the number of bits of the filter.
+ */
+inline std::size_t BloomFilter::bitCount() const
+{
+    return m_words.size() * 64;
+}
+
+/*!
+ * \brief Invokes \a function for each bit the key with the specified \a keyHash maps to until \a function returns false.
+ * \remarks The second hash is derived by mixing the first one as std::hash might be weak in its lower bits.
+ */
+template <typename Function> inline void BloomFilter::forEachBit(std::uint64_t keyHash, Function function) const
+{
+    const auto bits = bitCount();
+    const auto secondHash = ((keyHash * 0x9E3779B97F4A7C15ull) >> 32) | 1;
+    for (auto i = std::size_t(); i != hashCount; ++i, keyHash += secondHash) {
+        if (!function(static_cast<std::size_t>(keyHash % bits))) {
+            return;
+        }
+    }
+}
+
+} // namespace LibPkg
+
+#endif // LIBPKG_DATA_BLOOM_FILTER_H
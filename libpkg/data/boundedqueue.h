@@ -0,0 +1,112 @@
+#ifndef LIBPKG_DATA_BOUNDED_QUEUE_H
+#define LIBPKG_DATA_BOUNDED_QUEUE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LibPkg {
+
+/*!
+ * \brief The FifoOrder struct is used as order of a BoundedQueue to pop items in the order they have been pushed.
+ */
+struct FifoOrder {};
+
+/*!
+ * \brief The BoundedQueue class is a thread-safe queue for passing items between the stages of a pipeline.
+ * \remarks
+ * - push() blocks while the queue is full so fast producers can not exhaust the memory.
+ * - pop() blocks while the queue is empty and returns std::nullopt once the queue has been closed and drained.
+ * - abort() closes the queue and discards pending items; push() returns false afterwards so producers can stop early.
+ * - Items are popped in the order they have been pushed by default. If \a Order is a comparison function (like for
+ *   std::priority_queue) the greatest of the items currently in the queue is popped instead.
+ */
+template <typename Item, typename Order = FifoOrder> class BoundedQueue {
+public:
+    using item_type = Item;
+    using order_type = Order;
+
+    explicit BoundedQueue(std::size_t capacity, order_type order = order_type())
+        : m_order(std::move(order))
+        , m_capacity(capacity ? capacity : 1)
+    {
+    }
+
+    bool push(item_type &&item)
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed) {
+            return false;
+        }
+        m_items.emplace_back(std::move(item));
+        if constexpr (!isFifo) {
+            std::push_heap(m_items.begin(), m_items.end(), m_order);
+        }
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    std::optional<item_type> pop()
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+        if (m_items.empty()) {
+            return std::nullopt;
+        }
+        auto item = std::optional<item_type>();
+        if constexpr (isFifo) {
+            item.emplace(std::move(m_items.front()));
+            m_items.pop_front();
+        } else {
+            std::pop_heap(m_items.begin(), m_items.end(), m_order);
+            item.emplace(std::move(m_items.back()));
+            m_items.pop_back();
+        }
+        lock.unlock();
+        m_notFull.notify_one();
+        return item;
+    }
+
+    void close()
+    {
+        {
+            const auto lock = std::lock_guard(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+
+    void abort()
+    {
+        {
+            const auto lock = std::lock_guard(m_mutex);
+            m_closed = true;
+            m_items.clear();
+        }
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+
+private:
+    static constexpr auto isFifo = std::is_same_v<order_type, FifoOrder>;
+
+    std::conditional_t<isFifo, std::deque<item_type>, std::vector<item_type>> m_items;
+    [[no_unique_address]] order_type m_order;
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty, m_notFull;
+    std::size_t m_capacity;
+    bool m_closed = false;
+};
+
+} // namespace LibPkg
+
+#endif // LIBPKG_DATA_BOUNDED_QUEUE_H
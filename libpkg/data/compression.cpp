@@ -0,0 +1,232 @@
+#include "./compression.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+namespace LibPkg {
+
+/// \cond
+namespace {
+constexpr auto compressedHeaderSize = std::size_t(5);
+
+/*!
+ * \brief Returns a view of \a data usable as zlib input; zlib's API is not const-correct.
+ */
+inline Bytef *zlibInput(std::string_view data)
+{
+    return reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+}
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Returns the size \a record had before compressing it.
+ * \remarks Returns the size of \a record itself if it is not compressed.
+ */
+std::size_t CompressionDictionaries::uncompressedSize(std::string_view record)
+{
+    if (!isCompressed(record)) {
+        return record.size();
+    }
+    auto size = std::uint32_t();
+    for (auto i = std::size_t(4); i; --i) {
+        size = (size << 8) | static_cast<unsigned char>(record[i]);
+    }
+    return size;
+}
+
+/*!
+ * \brief Returns the ID of \a dictionary which is the Adler-32 checksum zlib puts into the header of compressed streams.
+ */
+std::uint32_t CompressionDictionaries::idOf(std::string_view dictionary)
+{
+    return static_cast<std::uint32_t>(adler32(adler32(0, nullptr, 0), zlibInput(dictionary), static_cast<uInt>(dictionary.size())));
+}
+
+/*!
+ * \brief Adds \a dictionary so records compressed with it can be decompressed.
+ * \returns Returns the ID of the dictionary.
+ */
+std::uint32_t CompressionDictionaries::add(std::string_view dictionary)
+{
+    const auto id = idOf(dictionary);
+    const auto lock = std::unique_lock(m_mutex);
+    if (!m_dictionaries.contains(id)) {
+        m_dictionaries.emplace(id, std::make_shared<const std::string>(dictionary));
+    }
+    return id;
+}
+
+/*!
+ * \brief Sets the dictionary used by compress(); passing 0 disables compression.
+ * \throws Throws std::invalid_argument if the dictionary has not been added.
+ */
+void CompressionDictionaries::setActive(std::uint32_t dictionaryID)
+{
+    const auto lock = std::unique_lock(m_mutex);
+    if (!dictionaryID) {
+        m_active.reset();
+        m_activeID = 0;
+        return;
+    }
+    const auto i = m_dictionaries.find(dictionaryID);
+    if (i == m_dictionaries.end()) {
+        throw std::invalid_argument("unable to activate unknown compression dictionary");
+    }
+    m_active = i->second;
+    m_activeID = dictionaryID;
+}
+
+/*!
+ * \brief Returns the ID of the dictionary used by compress() or 0 if compression is disabled.
+ */
+std::uint32_t CompressionDictionaries::active() const
+{
+    const auto lock = std::shared_lock(m_mutex);
+    return m_activeID;
+}
+
+std::shared_ptr<const std::string> CompressionDictionaries::find(std::uint32_t dictionaryID) const
+{
+    const auto lock = std::shared_lock(m_mutex);
+    const auto i = m_dictionaries.find(dictionaryID);
+    return i != m_dictionaries.end() ? i->second : nullptr;
+}
+
+/*!
+ * \brief Compresses \a data using the active dictionary.
+ * \remarks Returns \a data as-is if compression is disabled or would not save any space.
+ */
+std::string CompressionDictionaries::compress(std::string &&data) const
+{
+    auto dictionary = std::shared_ptr<const std::string>();
+    {
+        const auto lock = std::shared_lock(m_mutex);
+        dictionary = m_active;
+    }
+    if (!dictionary || data.size() <= compressedHeaderSize || data.size() > std::numeric_limits<std::uint32_t>::max()) {
+        return std::move(data);
+    }
+    auto stream = z_stream();
+    if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+        throw std::runtime_error("unable to initialize zlib for compressing record");
+    }
+    auto record = std::string(compressedHeaderSize + deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    for (auto i = std::size_t(1), size = data.size(); i != compressedHeaderSize; ++i, size >>= 8) {
+        record[i] = static_cast<char>(size & 0xFF);
+    }
+    if (deflateSetDictionary(&stream, zlibInput(*dictionary), static_cast<uInt>(dictionary->size())) != Z_OK) {
+        deflateEnd(&stream);
+        throw std::runtime_error("unable to set dictionary for compressing record");
+    }
+    stream.next_in = zlibInput(data);
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(record.data() + compressedHeaderSize);
+    stream.avail_out = static_cast<uInt>(record.size() - compressedHeaderSize);
+    const auto res = deflate(&stream, Z_FINISH);
+    const auto compressedSize = compressedHeaderSize + stream.total_out;
+    deflateEnd(&stream);
+    if (res != Z_STREAM_END) {
+        throw std::runtime_error("unable to compress record");
+    }
+    if (compressedSize >= data.size()) {
+        return std::move(data);
+    }
+    record.resize(compressedSize);
+    return record;
+}
+
+/*!
+ * \brief Decompresses \a record if it has been compressed; otherwise returns a copy of it.
+ * \throws Throws std::runtime_error if \a record is corrupted or has been compressed with an unknown dictionary.
+ */
+std::string CompressionDictionaries::decompress(std::string_view record) const
+{
+    if (!isCompressed(record)) {
+        return std::string(record);
+    }
+    auto data = std::string(uncompressedSize(record), '\0');
+    auto stream = z_stream();
+    if (inflateInit(&stream) != Z_OK) {
+        throw std::runtime_error("unable to initialize zlib for decompressing record");
+    }
+    stream.next_in = zlibInput(record.substr(compressedHeaderSize));
+    stream.avail_in = static_cast<uInt>(record.size() - compressedHeaderSize);
+    stream.next_out = reinterpret_cast<Bytef *>(data.data());
+    stream.avail_out = static_cast<uInt>(data.size());
+    auto res = inflate(&stream, Z_FINISH);
+    if (res == Z_NEED_DICT) {
+        const auto dictionary = find(static_cast<std::uint32_t>(stream.adler));
+        if (!dictionary) {
+            inflateEnd(&stream);
+            throw std::runtime_error("record has been compressed with an unknown dictionary");
+        }
+        if (inflateSetDictionary(&stream, zlibInput(*dictionary), static_cast<uInt>(dictionary->size())) != Z_OK) {
+            inflateEnd(&stream);
+            throw std::runtime_error("unable to set dictionary for decompressing record");
+        }
+        res = inflate(&stream, Z_FINISH);
+    }
+    const auto decompressedSize = stream.total_out;
+    inflateEnd(&stream);
+    if (res != Z_STREAM_END || decompressedSize != data.size()) {
+        throw std::runtime_error("unable to decompress record");
+    }
+    return data;
+}
+
+/*!
+ * \brief Trains a dictionary for compressing records of cold data from the specified \a samples.
+ * \remarks
+ * The dictionary consists of the strings (paths of files and their parent directories) occurring in most
+ * samples, weighted by their length. The most valuable strings are put at the end of the dictionary as zlib encodes
+ * shorter distances more efficiently.
+ */
+std::string trainCompressionDictionary(std::span<const PackageColdData> samples, std::size_t maxSize)
+{
+    auto occurrences = std::unordered_map<std::string_view, std::size_t>();
+    auto strings = std::unordered_set<std::string_view>();
+    for (const auto &sample : samples) {
+        strings.clear();
+        if (const auto &packageInfo = sample.packageInfo) {
+            for (const auto &file : packageInfo->files) {
+                const auto path = std::string_view(file);
+                for (auto slash = path.find('/'); slash != std::string_view::npos && slash + 1 < path.size(); slash = path.find('/', slash + 1)) {
+                    strings.emplace(path.substr(0, slash + 1));
+                }
+                strings.emplace(path);
+            }
+        }
+        for (const auto string : strings) {
+            ++occurrences[string];
+        }
+    }
+
+    auto candidates = std::vector<std::pair<std::size_t, std::string_view>>();
+    candidates.reserve(occurrences.size());
+    for (const auto &[string, count] : occurrences) {
+        if (count > 1 && string.size() > 3) {
+            candidates.emplace_back((count - 1) * string.size(), string);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto &lhs, const auto &rhs) { return lhs.first > rhs.first; });
+    auto size = std::size_t();
+    auto end = candidates.begin();
+    for (; end != candidates.end() && size + end->second.size() <= maxSize; ++end) {
+        size += end->second.size();
+    }
+    auto dictionary = std::string();
+    dictionary.reserve(size);
+    for (auto i = std::make_reverse_iterator(end); i != candidates.rend(); ++i) {
+        dictionary.append(i->second);
+    }
+    return dictionary;
+}
+
+} // namespace LibPkg
@@ -0,0 +1,60 @@
+#ifndef LIBPKG_DATA_COMPRESSION_H
+#define LIBPKG_DATA_COMPRESSION_H
+
+#include "./package.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace LibPkg {
+
+/*!
+ * \brief The CompressionDictionaries class compresses records of the storage using preset dictionaries.
+ * \remarks
+ * - Records are deflated with zlib using the active dictionary. The zlib header contains the ID (Adler-32 checksum) of the
+ *   dictionary so records compressed with any known dictionary can be decompressed, also after the active dictionary changed.
+ * - Compressed records start with a zero byte followed by the uncompressed size (32-bit, little endian). Serialized versioned
+ *   structs never start with a zero byte so uncompressed records are still readable.
+ * - Each StorageDistribution has its own instance holding the dictionaries persisted within it. The DatabaseStorage
+ *   compresses/decompresses its cold data via that instance.
+ */
+class CompressionDictionaries {
+public:
+    static bool isCompressed(std::string_view record);
+    static std::size_t uncompressedSize(std::string_view record);
+    static std::uint32_t idOf(std::string_view dictionary);
+
+    std::uint32_t add(std::string_view dictionary);
+    void setActive(std::uint32_t dictionaryID);
+    std::uint32_t active() const;
+    std::string compress(std::string &&data) const;
+    std::string decompress(std::string_view record) const;
+
+private:
+    std::shared_ptr<const std::string> find(std::uint32_t dictionaryID) const;
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::uint32_t, std::shared_ptr<const std::string>> m_dictionaries;
+    std::shared_ptr<const std::string> m_active;
+    std::uint32_t m_activeID = 0;
+};
+
+/*!
+ * \brief Returns whether \a record has been compressed via CompressionDictionaries::compress().
+ */
+inline bool CompressionDictionaries::isCompressed(std::string_view record)
+{
+    return record.size() > 5 && record.front() == '\0';
+}
+
+std::string trainCompressionDictionary(std::span<const PackageColdData> samples, std::size_t maxSize = 32 * 1024);
+
+} // namespace LibPkg
+
+#endif // LIBPKG_DATA_COMPRESSION_H
@@ -1,9 +1,14 @@
+#include "./binaryinfocache.h"
 #include "./config.h"
 #include "./storageprivate.h"
 
 #include <reflective_rapidjson/json/reflector.h>
 
 #include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+
+#include <iostream>
+#include <unordered_set>
 
 using namespace std;
 using namespace CppUtilities;
@@ -45,6 +50,7 @@ DatabaseStatistics::DatabaseStatistics(const Database &db)
 }
 
 Config::Config()
+    : m_binaryInfoCacheLimit(BinaryInfoCache::defaultLimit)
 {
 }
 
@@ -52,15 +58,42 @@ Config::~Config()
 {
 }
 
+/*!
+ * \brief Removes databases which are not configured (anymore) from the index of provides across all databases.
+ * \remarks Databases configured again later get their provides added again when their storage is initialized.
+ */
+static void removeUnconfiguredDatabasesFromProvidesIndex(Config &config)
+{
+    auto &storage = config.storage();
+    if (!storage) {
+        return;
+    }
+    auto configuredIDs = std::unordered_set<std::uint32_t>();
+    for (const auto &db : config.databases) {
+        configuredIDs.emplace(db.storageID());
+    }
+    configuredIDs.emplace(config.aur.storageID());
+    auto txn = storage->env()->getRWTransaction();
+    const auto removed = storage->allProvides().removeDatabases(*txn, [&configuredIDs](std::uint32_t id) { return !configuredIDs.contains(id); });
+    txn->commit();
+    if (removed) {
+        std::cerr << "Removed " << removed << " databases which are not configured anymore from the index of provides.\n";
+    }
+}
+
 void Config::initStorage(const char *path, std::uint32_t maxDbs)
 {
     assert(m_storage == nullptr); // only allow initializing storage once
+    // note: Each database uses 10 LMDB databases (tables and their indexes) and up to 10 further ones when the tables of former
+    //       versions are dropped. There is one table for compression dictionaries, one for info parsed from binaries and two
+    //       tables for the index of provides across all databases; reserve some more for future use.
     m_storage
-        = std::make_unique<StorageDistribution>(path, maxDbs ? maxDbs : std::max((static_cast<std::uint32_t>(databases.capacity()) + 1u) * 10u, 60u));
+        = std::make_unique<StorageDistribution>(path, maxDbs ? maxDbs : std::max((static_cast<std::uint32_t>(databases.capacity()) + 1u) * 24u, 60u));
     for (auto &db : databases) {
         db.initStorage(*m_storage);
     }
     aur.initStorage(*m_storage);
+    BinaryInfoCache(*m_storage, m_binaryInfoCacheLimit).removeStaleEntries();
 }
 
 void LibPkg::Config::rebuildDb()
@@ -70,6 +103,8 @@ void LibPkg::Config::rebuildDb()
         db.rebuildDb();
     }
     aur.rebuildDb();
+    removeUnconfiguredDatabasesFromProvidesIndex(*this);
+    BinaryInfoCache(*m_storage).clear();
 }
 
 void Config::dumpDb(const std::optional<std::regex> &filterRegex)
@@ -81,16 +116,86 @@ void Config::dumpDb(const std::optional<std::regex> &filterRegex)
     aur.dumpDb(filterRegex);
 }
 
+/*!
+ * \brief Enables or disables compressing the cold data of packages (e.g. file lists) and rewrites existing records accordingly.
+ * \remarks
+ * - When enabling compression a new dictionary is trained from a sample of the cold data of all databases.
+ * - Statistics before and after rewriting the records are printed to std::cerr.
+ * \returns Returns the statistics after rewriting the records.
+ */
+PackageStorageStatistics Config::setPackageCompression(bool enabled)
+{
+    assert(m_storage != nullptr);
+    static constexpr auto maxSamplesPerDatabase = std::size_t(2000);
+    auto dbs = std::vector<Database *>();
+    dbs.reserve(databases.size() + 1);
+    for (auto &db : databases) {
+        dbs.emplace_back(&db);
+    }
+    dbs.emplace_back(&aur);
+
+    auto before = PackageStorageStatistics();
+    for (auto *const db : dbs) {
+        before += db->packageStorageStatistics();
+    }
+    std::cerr << "Cold data before rewriting: " << before << '\n';
+
+    auto dictionary = std::string();
+    if (enabled) {
+        auto samples = std::vector<PackageColdData>();
+        for (auto *const db : dbs) {
+            db->sampleColdData(samples, maxSamplesPerDatabase);
+        }
+        dictionary = trainCompressionDictionary(samples);
+        if (dictionary.empty()) {
+            std::cerr << "Unable to train dictionary from " << samples.size() << " records, not compressing cold data.\n";
+        } else {
+            std::cerr << "Trained dictionary of " << dataSizeToString(dictionary.size()) << " from " << samples.size() << " records.\n";
+        }
+    }
+    m_storage->setCompressionDictionary(dictionary);
+
+    auto after = PackageStorageStatistics();
+    for (auto *const db : dbs) {
+        std::cerr << "Rewriting cold data of \"" << db->name << "\".\n";
+        db->rewriteColdData();
+        after += db->packageStorageStatistics();
+    }
+    std::cerr << "Cold data after rewriting: " << after << '\n';
+    return after;
+}
+
 std::size_t Config::cachedPackages() const
 {
     return m_storage ? m_storage->packageCache().size() : 0;
 }
 
+/*!
+ * \brief Returns statistics about the package cache, e.g. its approximate memory usage and the number of cache hits.
+ */
+StorageCacheStatistics Config::packageCacheStatistics() const
+{
+    return m_storage ? m_storage->packageCache().statistics() : StorageCacheStatistics();
+}
+
+/*!
+ * \brief Sets the approximate number of bytes the package cache is allowed to occupy.
+ */
 void Config::setPackageCacheLimit(std::size_t limit)
 {
     m_storage->packageCache().setLimit(limit);
 }
 
+/*!
+ * \brief Sets the number of bytes the info cached from binaries is allowed to occupy within the storage.
+ * \remarks Takes effect when the storage is initialized and when the cache is used the next time. May be called before
+ *          initializing the storage.
+ */
+void Config::setBinaryInfoCacheLimit(std::size_t limit)
+{
+    m_binaryInfoCacheLimit = limit;
+}
+
 static std::string addDatabaseDependencies(
     Config &config, Database &database, std::vector<Database *> &result, std::unordered_map<Database *, bool> &visited, bool addSelf)
 {
@@ -211,7 +316,12 @@ void Config::markAllDatabasesToBeDiscarded()
 
 void Config::discardDatabases()
 {
-    databases.erase(remove_if(databases.begin(), databases.end(), [](const auto &db) { return db.toBeDiscarded; }), databases.end());
+    const auto end = remove_if(databases.begin(), databases.end(), [](const auto &db) { return db.toBeDiscarded; });
+    if (end == databases.end()) {
+        return;
+    }
+    databases.erase(end, databases.end());
+    removeUnconfiguredDatabasesFromProvidesIndex(*this);
 }
 
 } // namespace LibPkg
@@ -113,6 +113,10 @@ struct LIBPKG_EXPORT Config : public Lockable, public ReflectiveRapidJSON::Binar
     using PackageVisitorConst = std::function<bool(Database &, StorageID, const std::shared_ptr<Package> &)>;
     using PackageVisitorByName = std::function<bool(Database &, std::string_view, const std::function<PackageSpec(void)> &)>;
     using PackageVisitorByNameBase = std::function<bool(Database &, std::string_view, const std::function<StorageID(PackageBase &)> &)>;
+    using PackageVisitorView = std::function<bool(Database &, StorageID, const PackageView &)>; // view is only valid during the call!!!
+    using PackageVisitorByNameView = std::function<bool(Database &, std::string_view, const std::function<StorageID(PackageView &)> &)>;
+    using FileVisitor = std::function<bool(Database &, StorageID, std::string_view)>; // path is only valid during the call!!!
+    using FileVisitorView = std::function<bool(Database &, StorageID, std::string_view, const std::function<bool(PackageView &)> &)>;
 
     explicit Config();
     ~Config();
@@ -125,8 +129,12 @@ struct LIBPKG_EXPORT Config : public Lockable, public ReflectiveRapidJSON::Binar
     void initStorage(const char *path = "libpkg.db", std::uint32_t maxDbs = 0);
     void rebuildDb();
     void dumpDb(const std::optional<std::regex> &filterRegex);
+    PackageStorageStatistics setPackageCompression(bool enabled);
     std::size_t cachedPackages() const;
+    StorageCacheStatistics packageCacheStatistics() const;
     void setPackageCacheLimit(std::size_t limit);
+    std::size_t binaryInfoCacheLimit() const;
+    void setBinaryInfoCacheLimit(std::size_t limit);
     std::unique_ptr<StorageDistribution> &storage();
     std::uint64_t restoreFromCache();
     std::uint64_t dumpCacheFile();
@@ -171,6 +179,12 @@ struct LIBPKG_EXPORT Config : public Lockable, public ReflectiveRapidJSON::Binar
         const PackageVisitorBase &visitor);
     void packagesByName(const DatabaseVisitor &databaseVisitor, const PackageVisitorByName &visitor);
     void packagesByName(const DatabaseVisitor &databaseVisitor, const PackageVisitorByNameBase &visitor);
+    void packagesByName(const DatabaseVisitor &databaseVisitor, const PackageVisitorByNameView &visitor);
+    void packagesByNameContaining(
+        std::span<const std::string_view> substrings, const DatabaseVisitor &databaseVisitor, const PackageVisitorByNameView &visitor);
+    void packagesView(const DatabaseVisitor &databaseVisitor, const PackageVisitorView &visitor);
+    void packagesContainingFile(std::string_view path, FileSearchMode mode, const DatabaseVisitor &databaseVisitor, const FileVisitor &visitor);
+    void packagesContainingFile(std::string_view path, FileSearchMode mode, const DatabaseVisitor &databaseVisitor, const FileVisitorView &visitor);
     void providingPackages(const Dependency &dependency, bool reverse, const DatabaseVisitor &databaseVisitor, const PackageVisitorConst &visitor);
     void providingPackagesBase(const Dependency &dependency, bool reverse, const DatabaseVisitor &databaseVisitor, const PackageVisitorBase &visitor);
     void providingPackages(const std::string &libraryName, bool reverse, const DatabaseVisitor &databaseVisitor, const PackageVisitorConst &visitor);
@@ -193,6 +207,7 @@ private:
     std::string addLicenseInfo(LicenseResult &result, PackageSearchResult &searchResult, const std::shared_ptr<Package> &package);
 
     std::unique_ptr<StorageDistribution> m_storage;
+    std::size_t m_binaryInfoCacheLimit; // in bytes
 };
 
 inline std::unique_ptr<StorageDistribution> &Config::storage()
@@ -200,6 +215,14 @@ inline std::unique_ptr<StorageDistribution> &Config::storage()
     return m_storage;
 }
 
+/*!
+ * \brief Returns the number of bytes the info cached from binaries is allowed to occupy within the storage.
+ */
+inline std::size_t Config::binaryInfoCacheLimit() const
+{
+    return m_binaryInfoCacheLimit;
+}
+
 inline Status Config::computeStatus() const
 {
     return Status(*this);
@@ -5,19 +5,43 @@
 #include "reflection/database.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 using namespace std;
 using namespace CppUtilities;
 
 namespace LibPkg {
 
+/*!
+ * \brief The AffectedPackages struct holds the net changes of the packages providing/requiring a dependency or library.
+ * \remarks Removing a package after it has been added within the same updater (and vice versa) cancels out so the sets
+ *          are disjoint. See PackageUpdaterPrivate::addDependency() and PackageUpdaterPrivate::addLibrary().
+ */
 struct AffectedPackages {
     std::unordered_set<StorageID> newPackages;
     std::unordered_set<StorageID> removedPackages;
+
+    void add(StorageID packageID, bool removed);
 };
 
+void AffectedPackages::add(StorageID packageID, bool removed)
+{
+    auto &cancelled = removed ? newPackages : removedPackages;
+    if (!cancelled.erase(packageID)) {
+        (removed ? removedPackages : newPackages).emplace(packageID);
+    }
+}
+
 struct AffectedPackagesWithDependencyDetail : public AffectedPackages {
     std::string version;
     DependencyMode mode = DependencyMode::Any;
@@ -27,21 +51,30 @@ struct PackageUpdaterPrivate {
     using AffectedDeps = std::unordered_multimap<std::string, AffectedPackagesWithDependencyDetail>;
     using AffectedLibs = std::unordered_map<std::string, AffectedPackages>;
 
-    explicit PackageUpdaterPrivate(DatabaseStorage &storage, bool clear);
+    explicit PackageUpdaterPrivate(DatabaseStorage &storage, PackageUpdaterMode mode);
     void update(const PackageCache::StoreResult &res, const std::shared_ptr<Package> &package);
-    void update(const StorageID packageID, bool removed, const std::shared_ptr<Package> &package);
-    void submit(const std::string &dependencyName, AffectedDeps::mapped_type &affected, DependencyStorage::RWTransaction &txn);
-    void submit(const std::string &libraryName, AffectedLibs::mapped_type &affected, LibraryDependencyStorage::RWTransaction &txn);
-
-    bool clear = false;
+    void update(const StorageID packageID, bool removed, const Package &package);
+    void submit(std::string_view dependencyName, AffectedDeps::mapped_type &affected, DependencyIndex &index);
+    void submit(std::string_view libraryName, AffectedLibs::mapped_type &affected, DependencyIndex &index);
+    void bulkLoad(AffectedDeps &affected, DependencyIndex &index);
+    void bulkLoad(AffectedLibs &affected, DependencyIndex &index);
+    void submitToAllProvides();
+    void updateNameTrigrams(StorageID packageID, bool removed, const std::string &packageName);
+
+    DatabaseStorage &storage;
+    PackageUpdaterMode mode = PackageUpdaterMode::Update;
     std::unique_lock<std::mutex> lock;
     PackageStorage::RWTransaction packagesTxn;
+    bool isBulkLoad = false; // whether the indexes are populated from scratch on commit
+    DependencyIndex::BulkEntries bulkEntries;
     std::unordered_set<StorageID> handledIds;
     AffectedDeps affectedProvidedDeps;
     AffectedDeps affectedRequiredDeps;
     AffectedLibs affectedProvidedLibs;
     AffectedLibs affectedRequiredLibs;
+    AffectedLibs affectedNameTrigrams;
     std::size_t packageCountBeforeCommit = 0;
+    PackageUpdaterDiff diff;
 
 private:
     static AffectedDeps::iterator findDependency(const Dependency &dependency, AffectedDeps &affected);
@@ -76,19 +109,35 @@ void LibPkg::Database::rebuildDb()
 {
     std::cerr << "Rebuilding package database \"" << name << "\"\n";
     auto txn = m_storage->packages.getRWTransaction();
+    auto &txnHandle = **txn.getTransactionHandle();
     auto processed = std::size_t();
     auto ok = std::size_t();
+    auto migrated = std::size_t();
     auto lastOk = false;
-    txn.rebuild([count = txn.size(), &processed, &ok, &lastOk](StorageID id, Package *package) mutable {
+    txn.rebuild([this, count = txn.size(), &txn, &txnHandle, &processed, &ok, &migrated, &lastOk](StorageID id, Package *package) mutable {
         std::cerr << "Processing package " << ++processed << " / " << count << "          ";
         if (!package) {
             std::cerr << "\nDeleting package " << id << ": unable to deserialize\n";
+            m_storage->deletePackageColdData(txn, id);
             return lastOk = false;
         }
         if (package->name.empty()) {
             std::cerr << "\nDeleting package " << id << ": name is empty\n";
+            m_storage->deletePackageColdData(txn, id);
             return lastOk = false;
         }
+        // move cold data still stored within the package record (from before the split) into its own table and move the
+        // parts former versions stored as cold data as well (package info besides files, source info) back into the record
+        auto coldData = PackageColdData();
+        const auto hadColdData = m_storage->getColdData(txnHandle, id, coldData);
+        coldData.moveTo(*package);
+        coldData.takeFrom(*package);
+        if (!coldData.empty()) {
+            m_storage->putColdData(txnHandle, id, coldData);
+            migrated += !hadColdData;
+        } else if (hadColdData) {
+            m_storage->deletePackageColdData(txn, id);
+        }
         std::cerr << '\r';
         ++ok;
         return lastOk = true;
@@ -101,6 +150,29 @@ void LibPkg::Database::rebuildDb()
     } else {
         std::cerr << "All " << ok << " packages from \"" << name << "\" are valid.\n";
     }
+    if (migrated) {
+        std::cerr << "Moved cold data of " << migrated << " packages from \"" << name << "\" into separate table.\n";
+    }
+    auto orphanedColdData = m_storage->coldDataIDs(txnHandle);
+    std::erase_if(orphanedColdData, [&txn](StorageID id) {
+        auto package = PackageBase();
+        return txn.get<PackageBase>(id, package);
+    });
+    for (const auto id : orphanedColdData) {
+        m_storage->deletePackageColdData(txn, id);
+    }
+    if (!orphanedColdData.empty()) {
+        std::cerr << "Discarding cold data of " << orphanedColdData.size() << " non-existing packages from \"" << name << "\".\n";
+    }
+    std::cerr << "Rebuilding indexes of dependencies of \"" << name << "\".\n";
+    m_storage->rebuildDependencies(txn);
+    if (const auto legacyTables = m_storage->dropLegacyDependencyTables(txn)) {
+        std::cerr << "Dropped " << legacyTables << " tables of \"" << name << "\" used by former versions to store dependencies.\n";
+    }
+    std::cerr << "Rebuilding index of package names of \"" << name << "\".\n";
+    m_storage->rebuildNameTrigrams(txn);
+    std::cerr << "Rebuilding index of files of \"" << name << "\".\n";
+    m_storage->rebuildFileIndex(txn);
     std::cerr << "Committing changes to package database \"" << name << "\".\n";
     txn.commit();
 }
@@ -108,9 +180,10 @@ void LibPkg::Database::rebuildDb()
 void Database::dumpDb(const std::optional<std::regex> &filterRegex)
 {
     std::cout << "db: " << name << '@' << arch << '\n';
+    std::cout << "cold data: " << packageStorageStatistics() << '\n';
     auto txn = m_storage->packages.getROTransaction();
     auto end = txn.end();
-    std::cout << "packages (" << txn.size() << "):\n";
+    std::cout << "packages (" << txn.size() << ", " << m_storage->coldDataIDs(**txn.getTransactionHandle()).size() << " with cold data):\n";
     for (auto i = txn.begin(); i != end; ++i) {
         if (const auto &value = i.value(); !filterRegex.has_value() || std::regex_match(value.name, filterRegex.value())) {
             const auto key = i.getKey().get<LMDBSafe::IDType>();
@@ -128,6 +201,72 @@ void Database::dumpDb(const std::optional<std::regex> &filterRegex)
     std::cout << '\n';
 }
 
+/*!
+ * \brief Returns statistics about how the cold data of packages is stored, e.g. to assess the effectiveness of compression.
+ * \remarks Reads all records so this is rather expensive.
+ */
+PackageStorageStatistics Database::packageStorageStatistics()
+{
+    auto statistics = PackageStorageStatistics();
+    auto txn = m_storage->packages.getROTransaction();
+    auto &txnHandle = txn.getTransactionHandle();
+    auto cursor = (*txnHandle)->getROCursor(m_storage->packagesColdDbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+        const auto record = value.get<std::string_view>();
+        ++statistics.records;
+        statistics.compressedRecords += CompressionDictionaries::isCompressed(record);
+        statistics.storedBytes += record.size();
+        statistics.uncompressedBytes += CompressionDictionaries::uncompressedSize(record);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    m_storage->forEachColdData(**txnHandle, [](StorageID, PackageColdData &&) { return false; });
+    statistics.readSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return statistics;
+}
+
+/*!
+ * \brief Adds up to \a maxSamples records of cold data evenly distributed over all packages to \a samples.
+ * \remarks This is used to train a dictionary for compressing the cold data.
+ */
+void Database::sampleColdData(std::vector<PackageColdData> &samples, std::size_t maxSamples)
+{
+    auto txn = m_storage->packages.getROTransaction();
+    auto &txnHandle = **txn.getTransactionHandle();
+    const auto stride = maxSamples ? std::max<std::size_t>(m_storage->coldDataIDs(txnHandle).size() / maxSamples, 1) : 0;
+    if (!stride) {
+        return;
+    }
+    auto index = std::size_t();
+    m_storage->forEachColdData(txnHandle, [&samples, &maxSamples, &index, stride](StorageID, PackageColdData &&coldData) {
+        if (index++ % stride == 0) {
+            samples.emplace_back(std::move(coldData));
+            --maxSamples;
+        }
+        return !maxSamples;
+    });
+}
+
+/*!
+ * \brief Writes all records of cold data again so they are stored according to the current compression settings.
+ * \returns Returns the number of rewritten records.
+ * \sa StorageDistribution::setCompressionDictionary()
+ */
+std::size_t Database::rewriteColdData()
+{
+    const auto lock = std::unique_lock(m_storage->updateMutex);
+    auto txn = m_storage->packages.getRWTransaction();
+    auto &txnHandle = **txn.getTransactionHandle();
+    const auto packageIDs = m_storage->coldDataIDs(txnHandle);
+    for (const auto packageID : packageIDs) {
+        if (auto coldData = PackageColdData(); m_storage->getColdData(txnHandle, packageID, coldData)) {
+            m_storage->putColdData(txnHandle, packageID, coldData);
+        }
+    }
+    txn.commit();
+    return packageIDs.size();
+}
+
 void LibPkg::Database::deducePathsFromLocalDirs()
 {
     if (localDbDir.empty()) {
@@ -180,175 +319,230 @@ std::vector<std::shared_ptr<Package>> Database::findPackages(const std::function
     return pkgs;
 }
 
-static void removeDependency(DependencyStorage::RWTransaction &txn, StorageID packageID, const std::string &dependencyName)
+/*!
+ * \brief Loads the package with the specified \a packageID (including cold data) from \a txn bypassing the cache.
+ */
+static std::shared_ptr<Package> loadPackageBypassingCache(DatabaseStorage &storage, PackageStorage::ROTransaction &txn, StorageID packageID)
 {
-    for (auto [i, end] = txn.equal_range<0>(dependencyName); i != end; ++i) {
-        auto &dependency = i.value();
-        dependency.relevantPackages.erase(packageID);
-        if (dependency.relevantPackages.empty()) {
-            i.del();
-        } else {
-            txn.put(dependency, i.getID());
-        }
+    auto package = std::make_shared<Package>();
+    if (!txn.get(packageID, *package)) {
+        return nullptr;
     }
+    storage.loadPackageColdData(txn, packageID, *package);
+    return package;
 }
 
-static void removeLibDependency(LibraryDependencyStorage::RWTransaction &txn, StorageID packageID, const std::string &dependencyName)
+static void removeNameTrigrams(DatabaseStorage &storage, LMDBSafe::MDBRWTransactionImpl &txn, StorageID packageID, const std::string &packageName)
 {
-    for (auto [i, end] = txn.equal_range<0>(dependencyName); i != end; ++i) {
-        auto &dependency = i.value();
-        dependency.relevantPackages.erase(packageID);
-        if (dependency.relevantPackages.empty()) {
-            i.del();
-        } else {
-            txn.put(dependency, i.getID());
-        }
+    for (const auto &trigram : nameTrigrams(packageName)) {
+        storage.packageNameTrigrams.remove(txn, trigram, packageID);
     }
 }
 
-static void removePackageDependencies(DatabaseStorage &storage, const std::shared_ptr<LMDBSafe::MDBRWTransaction> &txnHandle, StorageID packageID,
-    const std::shared_ptr<Package> &package)
+static void addNameTrigrams(DatabaseStorage &storage, LMDBSafe::MDBRWTransactionImpl &txn, StorageID packageID, const std::string &packageName)
 {
-    {
-        auto txn = storage.providedDeps.getRWTransaction(txnHandle);
-        removeDependency(txn, packageID, package->name);
-        for (const auto &dep : package->provides) {
-            removeDependency(txn, packageID, dep.name);
-        }
-    }
-    {
-        auto txn = storage.requiredDeps.getRWTransaction(txnHandle);
-        for (const auto &dep : package->dependencies) {
-            removeDependency(txn, packageID, dep.name);
-        }
-        for (const auto &dep : package->optionalDependencies) {
-            removeDependency(txn, packageID, dep.name);
-        }
-    }
-    {
-        auto txn = storage.providedLibs.getRWTransaction(txnHandle);
-        for (const auto &lib : package->libprovides) {
-            removeLibDependency(txn, packageID, lib);
-        }
-    }
-    {
-        auto txn = storage.requiredLibs.getRWTransaction(txnHandle);
-        for (const auto &lib : package->libdepends) {
-            removeLibDependency(txn, packageID, lib);
-        }
+    for (const auto &trigram : nameTrigrams(packageName)) {
+        storage.packageNameTrigrams.add(txn, trigram, packageID);
     }
 }
 
-static void addDependency(DependencyStorage::RWTransaction &txn, StorageID packageID, const std::string &dependencyName,
-    const std::string &dependencyVersion, DependencyMode dependencyMode = DependencyMode::Any)
+/*!
+ * \brief Visits all packages.
+ * \remarks The cold data (files, install info) is only loaded if \a withColdData is set.
+ */
+void Database::allPackages(const PackageVisitorMove &visitor, bool withColdData)
 {
-    if (dependencyName.empty()) {
-        return;
-    }
-    for (auto [i, end] = txn.equal_range<0>(dependencyName); i != end; ++i) {
-        auto &existingDependency = i.value();
-        if (static_cast<const Dependency &>(existingDependency).version != dependencyVersion) {
-            continue;
+    auto txn = m_storage->packages.getROTransaction();
+    for (auto i = txn.begin<std::shared_ptr>(); i != txn.end(); ++i) {
+        if (withColdData) {
+            m_storage->loadPackageColdData(txn, i.getID(), *i.getPointer());
         }
-        const auto [i2, newID] = existingDependency.relevantPackages.emplace(packageID);
-        if (newID) {
-            txn.put(existingDependency, i.getID());
+        if (visitor(i.getID(), std::move(i.getPointer()))) {
+            return;
         }
-        return;
     }
-    auto newDependency = DatabaseDependency(dependencyName, dependencyVersion, dependencyMode);
-    newDependency.relevantPackages.emplace(packageID);
-    txn.put(newDependency);
 }
 
-static void addLibDependency(LibraryDependencyStorage::RWTransaction &txn, StorageID packageID, const std::string &dependencyName)
+void Database::allPackagesBase(const PackageVisitorBase &visitor)
 {
-    if (dependencyName.empty()) {
-        return;
-    }
-    for (auto [i, end] = txn.equal_range<0>(dependencyName); i != end; ++i) {
-        auto &existingDependency = i.value();
-        const auto [i2, newID] = existingDependency.relevantPackages.emplace(packageID);
-        if (newID) {
-            txn.put(existingDependency, i.getID());
+    auto txn = m_storage->packages.getROTransaction();
+    for (auto i = txn.begin<std::shared_ptr, PackageBase>(); i != txn.end(); ++i) {
+        if (visitor(i.getID(), std::move(i.getPointer()))) {
+            return;
         }
-        return;
     }
-    auto newDependency = DatabaseLibraryDependency(dependencyName);
-    newDependency.relevantPackages.emplace(packageID);
-    txn.put(newDependency);
 }
 
-static void addPackageDependencies(DatabaseStorage &storage, const std::shared_ptr<LMDBSafe::MDBRWTransaction> &txnHandle, StorageID packageID,
-    const std::shared_ptr<Package> &package)
+void LibPkg::Database::allPackagesByName(const PackageVisitorByName &visitor)
 {
-    {
-        auto txn = storage.providedDeps.getRWTransaction(txnHandle);
-        addDependency(txn, packageID, package->name, package->version);
-        for (const auto &dep : package->provides) {
-            addDependency(txn, packageID, dep.name, dep.version, dep.mode);
-        }
-    }
-    {
-        auto txn = storage.requiredDeps.getRWTransaction(txnHandle);
-        for (const auto &dep : package->dependencies) {
-            addDependency(txn, packageID, dep.name, dep.version, dep.mode);
-        }
-        for (const auto &dep : package->optionalDependencies) {
-            addDependency(txn, packageID, dep.name, dep.version, dep.mode);
-        }
-    }
-    {
-        auto txn = storage.providedLibs.getRWTransaction(txnHandle);
-        for (const auto &lib : package->libprovides) {
-            addLibDependency(txn, packageID, lib);
-        }
-    }
-    {
-        auto txn = storage.requiredLibs.getRWTransaction(txnHandle);
-        for (const auto &lib : package->libdepends) {
-            addLibDependency(txn, packageID, lib);
+    auto txn = m_storage->packages.getROTransaction();
+    for (auto i = txn.begin_idx<0, std::shared_ptr>(); i != txn.end(); ++i) {
+        const auto packageName = i.getKey().get<string_view>();
+        if (visitor(packageName, [this, &txn, &i] { return m_storage->packageCache.retrieve(*m_storage, &txn, i.value()); })) {
+            return;
         }
     }
 }
 
-void Database::allPackages(const PackageVisitorMove &visitor)
+void LibPkg::Database::allPackagesByName(const PackageVisitorByNameBase &visitor)
 {
     auto txn = m_storage->packages.getROTransaction();
-    for (auto i = txn.begin<std::shared_ptr>(); i != txn.end(); ++i) {
-        if (visitor(i.getID(), std::move(i.getPointer()))) {
+    for (auto i = txn.begin_idx<0, std::shared_ptr>(); i != txn.end(); ++i) {
+        const auto packageName = i.getKey().get<string_view>();
+        if (visitor(packageName, [&txn, &i](PackageBase &pkg) { return txn.get(i.value(), pkg); })) {
             return;
         }
     }
 }
 
-void Database::allPackagesBase(const PackageVisitorBase &visitor)
+/*!
+ * \brief Visits all packages without copying their data.
+ * \remarks The view passed to \a visitor is only valid during the call.
+ */
+void Database::allPackagesView(const PackageVisitorView &visitor)
 {
     auto txn = m_storage->packages.getROTransaction();
-    for (auto i = txn.begin<std::shared_ptr, PackageBase>(); i != txn.end(); ++i) {
-        if (visitor(i.getID(), std::move(i.getPointer()))) {
+    auto reader = PackageViewReader(*m_storage, txn);
+    reader.forEach(visitor);
+}
+
+/*!
+ * \brief Visits all packages by name without copying their data.
+ * \remarks The view populated via the function passed to \a visitor is only valid during the call.
+ */
+void LibPkg::Database::allPackagesByName(const PackageVisitorByNameView &visitor)
+{
+    auto txn = m_storage->packages.getROTransaction();
+    auto reader = PackageViewReader(*m_storage, txn);
+    for (auto i = txn.begin_idx<0, std::shared_ptr>(); i != txn.end(); ++i) {
+        const auto packageName = i.getKey().get<string_view>();
+        if (visitor(packageName, [&reader, &i](PackageView &view) { return reader.read(i.value(), view) ? i.value() : StorageID(); })) {
             return;
         }
     }
 }
 
-void LibPkg::Database::allPackagesByName(const PackageVisitorByName &visitor)
+/*!
+ * \brief Visits packages whose names contain all of the specified \a substrings by name without copying their data.
+ * \remarks
+ * - Candidates are looked up via the trigram index of package names. Only substrings of at least three bytes narrow
+ *   down the candidates. If there is no such substring all packages are checked.
+ * - Packages are visited in the order of their names like allPackagesByName() does.
+ * - The view populated via the function passed to \a visitor is only valid during the call.
+ */
+void Database::packagesByNameContaining(std::span<const std::string_view> substrings, const PackageVisitorByNameView &visitor)
 {
+    const auto containsAll = [substrings](std::string_view packageName) {
+        return std::all_of(substrings.begin(), substrings.end(),
+            [packageName](std::string_view substring) { return packageName.find(substring) != std::string_view::npos; });
+    };
     auto txn = m_storage->packages.getROTransaction();
-    for (auto i = txn.begin_idx<0, std::shared_ptr>(); i != txn.end(); ++i) {
-        const auto packageName = i.getKey().get<string_view>();
-        if (visitor(packageName, [this, &txn, &i] { return m_storage->packageCache.retrieve(*m_storage, &txn, i.value()); })) {
+    auto candidates = std::optional<std::unordered_set<StorageID>>();
+    auto &txnHandle = **txn.getTransactionHandle();
+    auto packageIDs = std::unordered_set<StorageID>();
+    for (const auto substring : substrings) {
+        for (const auto &trigram : nameTrigrams(substring)) {
+            packageIDs.clear();
+            m_storage->packageNameTrigrams.forEach(txnHandle, trigram, [&packageIDs](const DependencyIndexEntry &entry) {
+                packageIDs.emplace(entry.packageID);
+                return false;
+            });
+            if (packageIDs.empty()) {
+                return;
+            }
+            if (!candidates.has_value()) {
+                candidates = packageIDs;
+            } else {
+                std::erase_if(*candidates, [&packageIDs](StorageID packageID) { return !packageIDs.contains(packageID); });
+            }
+            if (candidates->empty()) {
+                return;
+            }
+        }
+    }
+
+    // check all packages if the index could not be used
+    auto reader = PackageViewReader(*m_storage, txn);
+    if (!candidates.has_value()) {
+        for (auto i = txn.begin_idx<0, std::shared_ptr>(); i != txn.end(); ++i) {
+            const auto packageName = i.getKey().get<string_view>();
+            if (containsAll(packageName)
+                && visitor(packageName, [&reader, &i](PackageView &view) { return reader.read(i.value(), view) ? i.value() : StorageID(); })) {
+                return;
+            }
+        }
+        return;
+    }
+
+    // check candidates (a name might contain all trigrams but not the substring itself) and visit them ordered by name
+    auto matches = std::vector<std::pair<std::string, StorageID>>();
+    auto candidateView = PackageView();
+    for (const auto packageID : *candidates) {
+        if (reader.read(packageID, candidateView) && containsAll(candidateView.name)) {
+            matches.emplace_back(candidateView.name, packageID);
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    for (const auto &match : matches) {
+        const auto packageID = match.second;
+        if (visitor(match.first, [&reader, packageID](PackageView &view) { return reader.read(packageID, view) ? packageID : StorageID(); })) {
             return;
         }
     }
 }
 
-void LibPkg::Database::allPackagesByName(const PackageVisitorByNameBase &visitor)
+/*!
+ * \brief Visits packages containing the file with the specified \a path via the index of files.
+ * \remarks
+ * - Only packages loaded from files databases are considered. Directories and paths longer than 511 bytes are not indexed.
+ * - The path passed to \a visitor is the matching path (or file name in case of FileSearchMode::Name). It is only valid
+ *   during the call. A package might be visited multiple times with different paths when searching via FileSearchMode::PathPrefix.
+ */
+void Database::packagesContainingFile(std::string_view path, FileSearchMode mode, const FileVisitor &visitor)
 {
+    packagesContainingFile(path, mode, [&visitor](StorageID packageID, std::string_view foundPath, const std::function<bool(PackageView &)> &) {
+        return visitor(packageID, foundPath);
+    });
+}
+
+/*!
+ * \brief Visits packages containing the file with the specified \a path via the index of files without copying their data.
+ * \remarks
+ * - Works like the overload taking a FileVisitor but \a visitor can additionally read a view of the package via the function
+ *   passed to it. The view is only valid during the call.
+ * - Reading the view does not load the package (and its files) into the cache.
+ */
+void Database::packagesContainingFile(std::string_view path, FileSearchMode mode, const FileVisitorView &visitor)
+{
+    while (path.starts_with('/')) {
+        path.remove_prefix(1);
+    }
+    if (path.empty() && mode != FileSearchMode::PathPrefix) {
+        return;
+    }
     auto txn = m_storage->packages.getROTransaction();
-    for (auto i = txn.begin_idx<0, std::shared_ptr>(); i != txn.end(); ++i) {
-        const auto packageName = i.getKey().get<string_view>();
-        if (visitor(packageName, [&txn, &i](PackageBase &pkg) { return txn.get(i.value(), pkg); })) {
+    auto &txnHandle = txn.getTransactionHandle();
+    auto cursor = (*txnHandle)->getROCursor(mode == FileSearchMode::Name ? m_storage->fileNamesDbi : m_storage->filePathsDbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    auto reader = PackageViewReader(*m_storage, txn);
+    const auto visit = [&visitor, &reader](StorageID packageID, std::string_view foundPath) {
+        return visitor(packageID, foundPath, [&reader, packageID](PackageView &view) { return reader.read(packageID, view); });
+    };
+    if (mode == FileSearchMode::PathPrefix) {
+        for (auto rc = path.empty() ? cursor.first(key, value) : cursor.lower_bound(LMDBSafe::MDBInVal(path), key, value); rc != MDB_NOTFOUND;
+             rc = cursor.next(key, value)) {
+            const auto foundPath = key.get<std::string_view>();
+            if (!foundPath.starts_with(path)) {
+                return;
+            }
+            if (visit(value.get<StorageID>(), foundPath)) {
+                return;
+            }
+        }
+        return;
+    }
+    for (auto rc = cursor.find(LMDBSafe::MDBInVal(path), key, value); rc != MDB_NOTFOUND; rc = cursor.get(key, value, MDB_NEXT_DUP)) {
+        if (visit(value.get<StorageID>(), path)) {
             return;
         }
     }
@@ -359,26 +553,30 @@ std::size_t Database::packageCount() const
     return m_storage->packages.getROTransaction().size();
 }
 
+/*!
+ * \brief Returns the ID of the database within the index of provides across all databases or zero if the storage has not
+ *        been initialized.
+ */
+std::uint32_t Database::storageID() const
+{
+    return m_storage ? m_storage->databaseID : 0;
+}
+
 void Database::providingPackages(const Dependency &dependency, bool reverse, const PackageVisitorConst &visitor)
 {
     if (dependency.name.empty()) {
         return;
     }
-    auto providesTxn = (reverse ? m_storage->requiredDeps : m_storage->providedDeps).getROTransaction();
     auto packagesTxn = m_storage->packages.getROTransaction();
-    for (auto [i, end] = providesTxn.equal_range<0>(dependency.name); i != end; ++i) {
-        const auto &providedDependency = i.value();
-        const auto &asDependency = static_cast<const Dependency &>(providedDependency);
-        if (!Dependency::matches(dependency.mode, dependency.version, asDependency.version)) {
-            continue;
-        }
-        for (const auto packageID : providedDependency.relevantPackages) {
-            auto res = m_storage->packageCache.retrieve(*m_storage, &packagesTxn, packageID);
-            if (res.pkg && visitor(packageID, res.pkg)) {
-                return;
+    auto matcher = DependencyVersionMatcher(dependency);
+    (reverse ? m_storage->requiredDeps : m_storage->providedDeps)
+        .forEach(**packagesTxn.getTransactionHandle(), dependency.name, [&](const DependencyIndexEntry &entry) {
+            if (!matcher.matches(entry.version)) {
+                return false;
             }
-        }
-    }
+            auto res = m_storage->packageCache.retrieve(*m_storage, &packagesTxn, entry.packageID);
+            return res.pkg && visitor(entry.packageID, res.pkg);
+        });
 }
 
 void Database::providingPackagesBase(const Dependency &dependency, bool reverse, const PackageVisitorBase &visitor)
@@ -386,26 +584,21 @@ void Database::providingPackagesBase(const Dependency &dependency, bool reverse,
     if (dependency.name.empty()) {
         return;
     }
-    auto providesTxn = (reverse ? m_storage->requiredDeps : m_storage->providedDeps).getROTransaction();
     auto packagesTxn = m_storage->packages.getROTransaction();
     auto package = std::shared_ptr<PackageBase>();
-    for (auto [i, end] = providesTxn.equal_range<0>(dependency.name); i != end; ++i) {
-        const auto &providedDependency = i.value();
-        const auto &asDependency = static_cast<const Dependency &>(providedDependency);
-        if (!Dependency::matches(dependency.mode, dependency.version, asDependency.version)) {
-            continue;
-        }
-        for (const auto packageID : providedDependency.relevantPackages) {
+    auto matcher = DependencyVersionMatcher(dependency);
+    (reverse ? m_storage->requiredDeps : m_storage->providedDeps)
+        .forEach(**packagesTxn.getTransactionHandle(), dependency.name, [&](const DependencyIndexEntry &entry) {
+            if (!matcher.matches(entry.version)) {
+                return false;
+            }
             if (!package) {
                 package = std::make_shared<PackageBase>();
             } else {
                 package->clear();
             }
-            if (packagesTxn.get<PackageBase>(packageID, *package) && visitor(packageID, std::move(package))) {
-                return;
-            }
-        }
-    }
+            return packagesTxn.get<PackageBase>(entry.packageID, *package) && visitor(entry.packageID, std::move(package));
+        });
 }
 
 void Database::providingPackages(const std::string &libraryName, bool reverse, const PackageVisitorConst &visitor)
@@ -413,16 +606,12 @@ void Database::providingPackages(const std::string &libraryName, bool reverse, c
     if (libraryName.empty()) {
         return;
     }
-    auto providesTxn = (reverse ? m_storage->requiredLibs : m_storage->providedLibs).getROTransaction();
     auto packagesTxn = m_storage->packages.getROTransaction();
-    for (auto [i, end] = providesTxn.equal_range<0>(libraryName); i != end; ++i) {
-        for (const auto packageID : i->relevantPackages) {
-            auto res = m_storage->packageCache.retrieve(*m_storage, &packagesTxn, packageID);
-            if (res.pkg && visitor(packageID, res.pkg)) {
-                return;
-            }
-        }
-    }
+    (reverse ? m_storage->requiredLibs : m_storage->providedLibs)
+        .forEach(**packagesTxn.getTransactionHandle(), libraryName, [&](const DependencyIndexEntry &entry) {
+            auto res = m_storage->packageCache.retrieve(*m_storage, &packagesTxn, entry.packageID);
+            return res.pkg && visitor(entry.packageID, res.pkg);
+        });
 }
 
 void Database::providingPackagesBase(const std::string &libraryName, bool reverse, const PackageVisitorBase &visitor)
@@ -430,45 +619,42 @@ void Database::providingPackagesBase(const std::string &libraryName, bool revers
     if (libraryName.empty()) {
         return;
     }
-    auto providesTxn = (reverse ? m_storage->requiredLibs : m_storage->providedLibs).getROTransaction();
     auto packagesTxn = m_storage->packages.getROTransaction();
     auto package = std::shared_ptr<PackageBase>();
-    for (auto [i, end] = providesTxn.equal_range<0>(libraryName); i != end; ++i) {
-        for (const auto packageID : i->relevantPackages) {
+    (reverse ? m_storage->requiredLibs : m_storage->providedLibs)
+        .forEach(**packagesTxn.getTransactionHandle(), libraryName, [&](const DependencyIndexEntry &entry) {
             if (!package) {
                 package = std::make_shared<PackageBase>();
             } else {
                 package->clear();
             }
-            if (packagesTxn.get<PackageBase>(packageID, *package) && visitor(packageID, std::move(package))) {
-                return;
-            }
-        }
-    }
+            return packagesTxn.get<PackageBase>(entry.packageID, *package) && visitor(entry.packageID, std::move(package));
+        });
 }
 
 bool Database::provides(const Dependency &dependency, bool reverse) const
 {
-    if (dependency.name.empty()) {
+    if (dependency.name.empty() || (!reverse && !m_storage->mightProvide(dependency.name))) {
         return false;
     }
-    auto providesTxn = (reverse ? m_storage->requiredDeps : m_storage->providedDeps).getROTransaction();
-    for (auto [i, end] = providesTxn.equal_range<0>(dependency.name); i != end; ++i) {
-        const Dependency &providedDependency = i.value();
-        if (Dependency::matches(dependency.mode, dependency.version, providedDependency.version)) {
-            return true;
-        }
-    }
-    return false;
+    auto txn = m_storage->packages.getROTransaction();
+    auto matcher = DependencyVersionMatcher(dependency);
+    auto found = false;
+    (reverse ? m_storage->requiredDeps : m_storage->providedDeps)
+        .forEach(**txn.getTransactionHandle(), dependency.name, [&](const DependencyIndexEntry &entry) {
+            // entries are sorted by version so the matcher only needs to compute the key of each version once
+            return found = matcher.matches(entry.version);
+        });
+    return found;
 }
 
 bool Database::provides(const std::string &libraryName, bool reverse) const
 {
-    if (libraryName.empty()) {
+    if (libraryName.empty() || (!reverse && !m_storage->mightProvide(libraryName))) {
         return false;
     }
-    auto providesTxn = (reverse ? m_storage->requiredLibs : m_storage->providedLibs).getROTransaction();
-    return providesTxn.find<0>(libraryName) != providesTxn.end();
+    auto txn = m_storage->packages.getROTransaction();
+    return (reverse ? m_storage->requiredLibs : m_storage->providedLibs).contains(**txn.getTransactionHandle(), libraryName);
 }
 
 std::shared_ptr<Package> Database::findPackage(StorageID packageID)
@@ -486,6 +672,19 @@ PackageSpec Database::findPackageWithID(const std::string &packageName)
     return m_storage->packageCache.retrieve(*m_storage, packageName);
 }
 
+/*!
+ * \brief Returns the package with the specified \a packageID including its cold data (files, install info).
+ * \remarks
+ * - Packages returned by findPackage() and other functions using the cache only contain hot data. Use this function
+ *   if the cold data is actually needed.
+ * - The package is loaded bypassing the cache. Modifying it has no effect on cached packages.
+ */
+std::shared_ptr<Package> Database::findPackageWithColdData(StorageID packageID)
+{
+    auto txn = m_storage->packages.getROTransaction();
+    return loadPackageBypassingCache(*m_storage, txn, packageID);
+}
+
 StorageID Database::findBasePackageWithID(const std::string &packageName, PackageBase &basePackage)
 {
     auto txn = m_storage->packages.getROTransaction();
@@ -501,12 +700,24 @@ void Database::removePackage(const std::string &packageName)
     auto txn = m_storage->packages.getRWTransaction();
     const auto [packageID, package] = m_storage->packageCache.retrieve(*m_storage, &txn, packageName);
     if (package) {
-        removePackageDependencies(*m_storage, txn.getTransactionHandle(), packageID, package);
+        auto &txnHandle = **txn.getTransactionHandle();
+        m_storage->removePackageDependencies(txnHandle, packageID, *package);
+        removeNameTrigrams(*m_storage, txnHandle, packageID, package->name);
+        auto coldData = PackageColdData();
+        if (!m_storage->getColdData(txnHandle, packageID, coldData)) {
+            // packages not migrated via rebuildDb() yet contain their cold data within the main record
+            coldData.takeFrom(*package);
+        }
+        m_storage->updateFileIndex(txn, packageID, &coldData, nullptr);
         txn.commit();
         m_storage->packageCache.invalidate(*m_storage, packageName);
     }
 }
 
+/*!
+ * \brief Updates the specified \a package. The \a package may or may not exist.
+ * \remarks The cold data (files, install info) is moved out of \a package as only hot data is cached.
+ */
 StorageID Database::updatePackage(const std::shared_ptr<Package> &package)
 {
     if (package->name.empty()) {
@@ -515,10 +726,14 @@ StorageID Database::updatePackage(const std::shared_ptr<Package> &package)
     const auto lock = std::unique_lock(m_storage->updateMutex);
     auto txn = m_storage->packages.getRWTransaction();
     const auto res = m_storage->packageCache.store(*m_storage, txn, package);
+    auto &txnHandle = **txn.getTransactionHandle();
     if (res.oldEntry) {
-        removePackageDependencies(*m_storage, txn.getTransactionHandle(), res.id, res.oldEntry);
+        m_storage->removePackageDependencies(txnHandle, res.id, *res.oldEntry);
+    } else {
+        addNameTrigrams(*m_storage, txnHandle, res.id, package->name);
     }
-    addPackageDependencies(*m_storage, txn.getTransactionHandle(), res.id, package);
+    m_storage->addPackageDependencies(txnHandle, res.id, *package);
+    m_storage->updateFileIndex(txn, res.id, &res.oldColdData, &res.coldData);
     txn.commit();
     return res.id;
 }
@@ -532,13 +747,12 @@ StorageID Database::updatePackage(const std::shared_ptr<Package> &package)
  * \param libsToIgnore Specifies libraries to be ignored if missing.
  * \remarks "Resolvable" means here (so far) just that all dependencies are present. It does not mean a package is "installable" because
  *          conflicts between dependencies might still prevent that.
+ * \remarks The required dependencies and libraries are checked concurrently using all available cores.
  */
 std::unordered_map<PackageSpec, UnresolvedDependencies> Database::detectUnresolvedPackages(Config &config,
     const std::vector<std::shared_ptr<Package>> &newPackages, const DependencySet &removedProvides,
     const std::unordered_set<std::string_view> &depsToIgnore, const std::unordered_set<std::string_view> &libsToIgnore)
 {
-    auto unresolvedPackages = std::unordered_map<PackageSpec, UnresolvedDependencies>();
-
     // determine new provides
     auto newProvides = DependencySet();
     auto newLibProvides = std::set<std::string>();
@@ -570,159 +784,367 @@ std::unordered_map<PackageSpec, UnresolvedDependencies> Database::detectUnresolv
     }
 
     // check whether all required dependencies are still provided
-    for (auto txn = m_storage->requiredDeps.getROTransaction(); const auto &requiredDep : txn) {
-        // skip dependencies to ignore
-        if (depsToIgnore.find(requiredDep.name) != depsToIgnore.end()) {
-            continue;
-        }
-
-        // skip if new packages provide dependency
-        if (newProvides.provides(requiredDep)) {
-            continue;
-        }
+    // note: The entries of the index are grouped by name, version and mode so each dependency is only checked once.
+    using UnresolvedPackages = std::unordered_map<PackageSpec, UnresolvedDependencies>;
+    const auto checkRequiredDeps = [&](LMDBSafe::MDBROTransactionImpl &txnHandle, std::string_view begin, std::string_view end) {
+        auto unresolved = UnresolvedPackages();
+        auto requiredDep = Dependency();
+        auto affectedPackageIDs = std::vector<StorageID>();
+        const auto checkRequiredDep = [&] {
+            if (affectedPackageIDs.empty()) {
+                return;
+            }
 
-        // skip if db provides dependency
-        if (!removedProvides.provides(requiredDep) && provides(requiredDep)) {
-            continue;
-        }
+            // skip dependencies to ignore
+            // skip if new packages provide dependency
+            // skip if db provides dependency
+            if (depsToIgnore.find(requiredDep.name) != depsToIgnore.end() || newProvides.provides(requiredDep)
+                || (!removedProvides.provides(requiredDep) && provides(requiredDep))) {
+                affectedPackageIDs.clear();
+                return;
+            }
 
-        // skip if dependency is provided by a database this database depends on or the protected version of this db
-        auto providedByAnotherDb = false;
-        for (const auto *db : deps) {
-            if ((providedByAnotherDb = db->provides(requiredDep))) {
-                break;
+            // skip if dependency is provided by a database this database depends on or the protected version of this db
+            for (const auto *db : deps) {
+                if (db->provides(requiredDep)) {
+                    affectedPackageIDs.clear();
+                    return;
+                }
             }
-        }
-        if (providedByAnotherDb) {
-            continue;
-        }
 
-        // add packages to list of unresolved packages
-        for (const auto &affectedPackageID : requiredDep.relevantPackages) {
-            const auto affectedPackage = findPackage(affectedPackageID);
-            unresolvedPackages[GenericPackageSpec(affectedPackageID, affectedPackage)].deps.emplace_back(requiredDep);
-        }
-    }
+            // add packages to list of unresolved packages
+            for (const auto affectedPackageID : affectedPackageIDs) {
+                const auto affectedPackage = findPackage(affectedPackageID);
+                unresolved[GenericPackageSpec(affectedPackageID, affectedPackage)].deps.emplace_back(requiredDep);
+            }
+            affectedPackageIDs.clear();
+        };
+        m_storage->requiredDeps.forEachInRange(txnHandle, begin, end, [&](const DependencyIndexEntry &entry) {
+            if (affectedPackageIDs.empty() || entry.name != requiredDep.name || entry.version != requiredDep.version
+                || entry.mode != requiredDep.mode) {
+                checkRequiredDep();
+                requiredDep.name = entry.name;
+                requiredDep.version = entry.version;
+                requiredDep.mode = entry.mode;
+            }
+            affectedPackageIDs.emplace_back(entry.packageID);
+            return false;
+        });
+        checkRequiredDep();
+        return unresolved;
+    };
 
     // check whether all required libraries are still provided
-    for (auto txn = m_storage->requiredLibs.getROTransaction(); const auto &requiredLib : txn) {
-
-        // skip libs to ignore
-        if (libsToIgnore.find(requiredLib.name) != libsToIgnore.end()) {
-            continue;
-        }
+    const auto checkRequiredLibs = [&](LMDBSafe::MDBROTransactionImpl &txnHandle, std::string_view begin, std::string_view end) {
+        auto unresolved = UnresolvedPackages();
+        auto requiredLib = std::string();
+        auto affectedPackageIDs = std::vector<StorageID>();
+        const auto checkRequiredLib = [&] {
+            if (affectedPackageIDs.empty()) {
+                return;
+            }
 
-        // skip if new packages provide dependency
-        if (newLibProvides.find(requiredLib.name) != newLibProvides.end()) {
-            continue;
-        }
+            // skip libs to ignore
+            // skip if new packages provide dependency
+            // skip if db provides dependency
+            if (libsToIgnore.find(requiredLib) != libsToIgnore.end() || newLibProvides.find(requiredLib) != newLibProvides.end()
+                || provides(requiredLib)) {
+                affectedPackageIDs.clear();
+                return;
+            }
 
-        // skip if db provides dependency
-        if (provides(requiredLib.name)) {
-            continue;
-        }
+            // skip if dependency is provided by a database this database depends on or the protected version of this db
+            for (const auto *db : deps) {
+                if (db->provides(requiredLib)) {
+                    affectedPackageIDs.clear();
+                    return;
+                }
+            }
 
-        // skip if dependency is provided by a database this database depends on or the protected version of this db
-        auto providedByAnotherDb = false;
-        for (const auto *db : deps) {
-            if ((providedByAnotherDb = db->provides(requiredLib.name))) {
-                break;
+            // skip DLLs known to be provided by Windows (but can not be detected as provides of mingw-w64-crt)
+            if (requiredLib.find("api-ms-win") != std::string::npos && requiredLib.ends_with(".dll")) {
+                affectedPackageIDs.clear();
+                return;
             }
-        }
-        if (providedByAnotherDb) {
-            continue;
-        }
 
-        // skip DLLs known to be provided by Windows (but can not be detected as provides of mingw-w64-crt)
-        if (requiredLib.name.find("api-ms-win") != std::string::npos && requiredLib.name.ends_with(".dll")) {
-            continue;
+            // add packages to list of unresolved packages
+            for (const auto affectedPackageID : affectedPackageIDs) {
+                const auto affectedPackage = findPackage(affectedPackageID);
+                unresolved[GenericPackageSpec(affectedPackageID, affectedPackage)].libs.emplace_back(requiredLib);
+            }
+            affectedPackageIDs.clear();
+        };
+        m_storage->requiredLibs.forEachInRange(txnHandle, begin, end, [&](const DependencyIndexEntry &entry) {
+            if (affectedPackageIDs.empty() || entry.name != requiredLib) {
+                checkRequiredLib();
+                requiredLib = entry.name;
+            }
+            affectedPackageIDs.emplace_back(entry.packageID);
+            return false;
+        });
+        checkRequiredLib();
+        return unresolved;
+    };
+
+    // split the required dependencies and libraries into ranges of names which are checked concurrently
+    // note: Each range is checked within its own read transaction. The results are merged in the order of the ranges so
+    //       the order of the unresolved dependencies/libraries of a package does not depend on the number of threads.
+    struct Range {
+        bool libs = false;
+        std::string_view begin, end;
+    };
+    const auto threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    auto depBoundaries = std::vector<std::string>(), libBoundaries = std::vector<std::string>();
+    {
+        auto txn = m_storage->packages.getROTransaction();
+        auto &txnHandle = **txn.getTransactionHandle();
+        depBoundaries = m_storage->requiredDeps.partition(txnHandle, threadCount * 2);
+        libBoundaries = m_storage->requiredLibs.partition(txnHandle, threadCount * 2);
+    }
+    auto ranges = std::vector<Range>();
+    for (const auto *const boundaries : { &depBoundaries, &libBoundaries }) {
+        auto begin = std::string_view();
+        for (const auto &boundary : *boundaries) {
+            ranges.emplace_back(Range{ .libs = boundaries == &libBoundaries, .begin = begin, .end = boundary });
+            begin = boundary;
+        }
+        ranges.emplace_back(Range{ .libs = boundaries == &libBoundaries, .begin = begin });
+    }
+    auto results = std::vector<UnresolvedPackages>(ranges.size());
+    auto nextIndex = std::atomic_size_t();
+    auto errorMutex = std::mutex();
+    auto error = std::exception_ptr();
+    const auto checkRanges = [&] {
+        try {
+            for (auto index = nextIndex++; index < ranges.size(); index = nextIndex++) {
+                const auto &range = ranges[index];
+                auto txn = m_storage->packages.getROTransaction();
+                auto &txnHandle = **txn.getTransactionHandle();
+                results[index] = range.libs ? checkRequiredLibs(txnHandle, range.begin, range.end) : checkRequiredDeps(txnHandle, range.begin, range.end);
+            }
+        } catch (...) {
+            nextIndex = ranges.size();
+            const auto lock = std::unique_lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
         }
+    };
+    auto workers = std::vector<std::thread>(std::min(threadCount, ranges.size()) - 1);
+    for (auto &worker : workers) {
+        worker = std::thread(checkRanges);
+    }
+    checkRanges();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
 
-        // add packages to list of unresolved packages
-        for (const auto &affectedPackageID : requiredLib.relevantPackages) {
-            const auto affectedPackage = findPackage(affectedPackageID);
-            unresolvedPackages[GenericPackageSpec(affectedPackageID, affectedPackage)].libs.emplace_back(requiredLib.name);
+    // merge results
+    auto unresolvedPackages = std::move(results.front());
+    for (auto i = std::next(results.begin()); i != results.end(); ++i) {
+        for (auto &[packageSpec, unresolved] : *i) {
+            auto &mergedUnresolved = unresolvedPackages[packageSpec];
+            std::move(unresolved.deps.begin(), unresolved.deps.end(), std::back_inserter(mergedUnresolved.deps));
+            std::move(unresolved.libs.begin(), unresolved.libs.end(), std::back_inserter(mergedUnresolved.libs));
         }
     }
-
     return unresolvedPackages;
 }
 
+/// \cond
+namespace {
+struct UpdateCheckTarget {
+    std::string_view name; // points into the index of the target database; valid as long as its transaction is alive
+    PackageVersionKey versionKey; // computed once as the package is possibly compared with a package of each update source
+    StorageID id = 0;
+};
+
+struct UpdateCheckMatch {
+    StorageID id = 0;
+    std::shared_ptr<Package> package;
+    PackageVersionComparison comparison = PackageVersionComparison::Equal;
+};
+
+struct UpdateCheckSourceResult {
+    std::vector<UpdateCheckMatch> byName; // matches by the name of the target package, indexed like the targets
+    std::vector<UpdateCheckMatch> byRegularName; // matches by the regular name of the target package, indexed like the targets
+};
+
+/*!
+ * \brief Returns whether \a comparison means the package from the update source is supposed to be listed.
+ */
+inline bool isUpdateCheckResult(PackageVersionComparison comparison)
+{
+    return comparison == PackageVersionComparison::SoftwareUpgrade || comparison == PackageVersionComparison::PackageUpgradeOnly
+        || comparison == PackageVersionComparison::NewerThanSyncVersion;
+}
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Compares the packages of this database with the ones from \a updateSources.
+ * \remarks
+ * - Package names are the key of an index so the names of this database and each update source are compared via a
+ *   merge-join of the sorted indexes. Only the versions of packages present in both are read (via PackageView) and only
+ *   packages ending up in the results are loaded completely. The package cache is not used.
+ * - The update sources are processed concurrently.
+ * - The results are ordered by the names of the packages of this database.
+ */
 LibPkg::PackageUpdates LibPkg::Database::checkForUpdates(const std::vector<LibPkg::Database *> &updateSources, UpdateCheckOptions options)
 {
+    // read names and versions of all packages of this database in the order of the name index
     auto results = PackageUpdates();
-    allPackages([&](StorageID myPackageID, std::shared_ptr<Package> &&package) {
-        auto regularName = std::string();
-        auto used = false;
-        if (options & UpdateCheckOptions::ConsiderRegularPackage) {
-            const auto decomposedName = package->decomposeName();
+    auto txn = m_storage->packages.getROTransaction();
+    auto reader = PackageViewReader(*m_storage, txn);
+    auto view = PackageView();
+    auto targets = std::vector<UpdateCheckTarget>();
+    targets.reserve(txn.size());
+    for (auto i = txn.begin_idx<0, std::shared_ptr>(); i != txn.end(); ++i) {
+        const auto packageID = i.value();
+        if (reader.read(packageID, view)) {
+            targets.emplace_back(
+                UpdateCheckTarget{ .name = i.getKey().get<std::string_view>(), .versionKey = PackageVersionKey::fromString(view.version), .id = packageID });
+        }
+    }
+
+    // determine regular names (sorted so they can be merge-joined as well)
+    auto regularNames = std::vector<std::pair<std::string_view, std::size_t>>();
+    if (options & UpdateCheckOptions::ConsiderRegularPackage) {
+        for (auto index = std::size_t(); index != targets.size(); ++index) {
+            const auto decomposedName = PackageNameData::decompose(targets[index].name);
             if ((!decomposedName.targetPrefix.empty() || !decomposedName.vcsSuffix.empty()) && !decomposedName.isVcsPackage()) {
-                regularName = decomposedName.actualName;
+                regularNames.emplace_back(decomposedName.actualName, index);
             }
         }
-        auto foundPackage = false;
-        for (auto *const updateSource : updateSources) {
-            const auto [updatePackageID, updatePackage] = updateSource->findPackageWithID(package->name);
-            if (!updatePackage) {
-                continue;
+        std::sort(regularNames.begin(), regularNames.end());
+    }
+
+    // merge-join the names of each update source with the names/regular names of the packages of this database
+    const auto checkSource = [&](Database &updateSource) {
+        auto result = UpdateCheckSourceResult{ .byName = std::vector<UpdateCheckMatch>(targets.size()),
+            .byRegularName = std::vector<UpdateCheckMatch>(regularNames.empty() ? 0 : targets.size()) };
+        auto &sourceStorage = *updateSource.m_storage;
+        auto sourceTxn = sourceStorage.packages.getROTransaction();
+        auto sourceReader = PackageViewReader(sourceStorage, sourceTxn);
+        auto sourceView = PackageView();
+        auto target = targets.cbegin();
+        auto regularName = regularNames.cbegin();
+        auto sourceVersionKey = std::optional<PackageVersionKey>(); // computed once per source package matching any targets
+        const auto compare = [&](StorageID sourcePackageID, const UpdateCheckTarget &matchingTarget, UpdateCheckMatch &match) {
+            if (!sourceVersionKey) {
+                if (!sourceReader.read(sourcePackageID, sourceView)) {
+                    return;
+                }
+                sourceVersionKey = PackageVersionKey::fromString(sourceView.version);
             }
-            foundPackage = true;
-            const auto versionDiff = package->compareVersion(*updatePackage);
-            std::vector<PackageUpdate> *list = nullptr;
-            switch (versionDiff) {
-            case PackageVersionComparison::SoftwareUpgrade:
-                list = &results.versionUpdates;
-                break;
-            case PackageVersionComparison::PackageUpgradeOnly:
-                list = &results.packageUpdates;
-                break;
-            case PackageVersionComparison::NewerThanSyncVersion:
-                list = &results.downgrades;
+            const auto comparison = matchingTarget.versionKey.compare(*sourceVersionKey);
+            match.id = sourcePackageID;
+            match.comparison = comparison;
+            if (isUpdateCheckResult(comparison)) {
+                match.package = loadPackageBypassingCache(sourceStorage, sourceTxn, sourcePackageID);
+            }
+        };
+        for (auto i = sourceTxn.begin_idx<0, std::shared_ptr>(); i != sourceTxn.end(); ++i) {
+            if (target == targets.cend() && regularName == regularNames.cend()) {
                 break;
-            default:;
             }
-            if (list) {
-                list->emplace_back(
-                    PackageSearchResult(*this, package, myPackageID), PackageSearchResult(*updateSource, updatePackage, updatePackageID));
-                used = true;
+            const auto sourceName = i.getKey().get<std::string_view>();
+            sourceVersionKey.reset();
+            for (; target != targets.cend() && target->name < sourceName; ++target)
+                ;
+            if (target != targets.cend() && target->name == sourceName) {
+                compare(i.value(), *target, result.byName[static_cast<std::size_t>(target - targets.cbegin())]);
+            }
+            for (; regularName != regularNames.cend() && regularName->first < sourceName; ++regularName)
+                ;
+            for (; regularName != regularNames.cend() && regularName->first == sourceName; ++regularName) {
+                compare(i.value(), targets[regularName->second], result.byRegularName[regularName->second]);
             }
         }
-        if (!foundPackage) {
-            results.orphans.emplace_back(PackageSearchResult(*this, package, myPackageID));
-            used = true;
+        return result;
+    };
+    auto sourceResults = std::vector<UpdateCheckSourceResult>(updateSources.size());
+    auto nextIndex = std::atomic_size_t();
+    auto errorMutex = std::mutex();
+    auto error = std::exception_ptr();
+    const auto checkSources = [&] {
+        try {
+            for (auto index = nextIndex++; index < updateSources.size(); index = nextIndex++) {
+                sourceResults[index] = checkSource(*updateSources[index]);
+            }
+        } catch (...) {
+            nextIndex = updateSources.size();
+            const auto lock = std::unique_lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
         }
-        if (!regularName.empty()) {
-            for (auto *const updateSource : updateSources) {
-                const auto [updatePackageID, updatePackage] = updateSource->findPackageWithID(regularName);
-                if (!updatePackage) {
-                    continue;
-                }
-                const auto versionDiff = package->compareVersion(*updatePackage);
-                std::vector<PackageUpdate> *list = nullptr;
-                switch (versionDiff) {
-                case PackageVersionComparison::SoftwareUpgrade:
-                    list = &results.versionUpdates;
-                    break;
-                case PackageVersionComparison::PackageUpgradeOnly:
-                    list = &results.packageUpdates;
-                    break;
-                case PackageVersionComparison::NewerThanSyncVersion:
-                    list = &results.downgrades;
-                    break;
-                default:;
-                }
-                if (list) {
-                    list->emplace_back(
-                        PackageSearchResult(*this, package, myPackageID), PackageSearchResult(*updateSource, updatePackage, updatePackageID));
-                    used = true;
-                }
+    };
+    const auto threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    auto workers = std::vector<std::thread>(std::min(threadCount, std::max<std::size_t>(updateSources.size(), 1)) - 1);
+    for (auto &worker : workers) {
+        worker = std::thread(checkSources);
+    }
+    checkSources();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    // populate results
+    const auto addResult = [&](std::shared_ptr<Package> &package, const UpdateCheckTarget &target, Database &updateSource, UpdateCheckMatch &match) {
+        std::vector<PackageUpdate> *list = nullptr;
+        switch (match.comparison) {
+        case PackageVersionComparison::SoftwareUpgrade:
+            list = &results.versionUpdates;
+            break;
+        case PackageVersionComparison::PackageUpgradeOnly:
+            list = &results.packageUpdates;
+            break;
+        case PackageVersionComparison::NewerThanSyncVersion:
+            list = &results.downgrades;
+            break;
+        default:;
+        }
+        if (!list || !match.package) {
+            return;
+        }
+        if (!package) {
+            package = loadPackageBypassingCache(*m_storage, txn, target.id);
+        }
+        list->emplace_back(PackageSearchResult(*this, package, target.id), PackageSearchResult(updateSource, std::move(match.package), match.id));
+    };
+    for (auto index = std::size_t(); index != targets.size(); ++index) {
+        const auto &target = targets[index];
+        auto package = std::shared_ptr<Package>();
+        auto foundPackage = false;
+        for (auto source = std::size_t(); source != updateSources.size(); ++source) {
+            auto &match = sourceResults[source].byName[index];
+            if (match.id) {
+                foundPackage = true;
+                addResult(package, target, *updateSources[source], match);
             }
         }
-        if (used) {
-            package.reset();
+        if (!foundPackage) {
+            if (!package) {
+                package = loadPackageBypassingCache(*m_storage, txn, target.id);
+            }
+            results.orphans.emplace_back(PackageSearchResult(*this, package, target.id));
         }
-        return false;
-    });
+        if (regularNames.empty()) {
+            continue;
+        }
+        for (auto source = std::size_t(); source != updateSources.size(); ++source) {
+            if (auto &match = sourceResults[source].byRegularName[index]; match.id) {
+                addResult(package, target, *updateSources[source], match);
+            }
+        }
+    }
     return results;
 }
 
@@ -817,11 +1239,38 @@ std::string Database::debugName() const
     return name + "-debug";
 }
 
-PackageUpdaterPrivate::PackageUpdaterPrivate(DatabaseStorage &storage, bool clear)
-    : clear(clear)
+PackageStorageStatistics &PackageStorageStatistics::operator+=(const PackageStorageStatistics &other)
+{
+    records += other.records;
+    compressedRecords += other.compressedRecords;
+    storedBytes += other.storedBytes;
+    uncompressedBytes += other.uncompressedBytes;
+    readSeconds += other.readSeconds;
+    return *this;
+}
+
+std::ostream &operator<<(std::ostream &o, const PackageStorageStatistics &statistics)
+{
+    o << statistics.records << " records (" << statistics.compressedRecords << " compressed), " << dataSizeToString(statistics.storedBytes)
+      << " stored, " << dataSizeToString(statistics.uncompressedBytes) << " uncompressed";
+    if (statistics.readSeconds > 0.0) {
+        o << ", read at " << dataSizeToString(static_cast<std::uint64_t>(static_cast<double>(statistics.uncompressedBytes) / statistics.readSeconds))
+          << "/s";
+    }
+    return o;
+}
+
+PackageUpdaterPrivate::PackageUpdaterPrivate(DatabaseStorage &storage, PackageUpdaterMode mode)
+    : storage(storage)
+    , mode(mode)
     , lock(storage.updateMutex)
     , packagesTxn(storage.packages.getRWTransaction())
+    , isBulkLoad(mode == PackageUpdaterMode::Clear || !packagesTxn.size())
 {
+    // clear the index of files right away as it is updated immediately (and not on commit like the other indexes)
+    if (mode == PackageUpdaterMode::Clear) {
+        storage.clearFileIndex(packagesTxn);
+    }
 }
 
 void PackageUpdaterPrivate::update(const PackageCache::StoreResult &res, const std::shared_ptr<Package> &package)
@@ -829,78 +1278,128 @@ void PackageUpdaterPrivate::update(const PackageCache::StoreResult &res, const s
     if (!res.id) {
         return;
     }
-    handledIds.emplace(res.id);
-    update(res.id, false, package);
-    if (!clear && res.oldEntry) {
-        update(res.id, true, res.oldEntry);
+    const auto handledBefore = !handledIds.emplace(res.id).second;
+    ++(res.oldEntry ? diff.updated : diff.added);
+    // remove the old entry before adding the new one so dependencies present in both cancel out
+    // note: When clearing, the old entry needs only be removed if it has been added by this updater as the indexes are
+    //       populated from scratch anyway.
+    const auto *const oldEntry = mode != PackageUpdaterMode::Clear || handledBefore ? res.oldEntry.get() : nullptr;
+    if (oldEntry) {
+        update(res.id, true, *oldEntry);
+    }
+    update(res.id, false, *package);
+    storage.updateFileIndex(packagesTxn, res.id, oldEntry ? &res.oldColdData : nullptr, &res.coldData);
+    // the name of an existing package does not change so its trigrams only need to be added when clearing the index anyway
+    if (mode == PackageUpdaterMode::Clear || !res.oldEntry) {
+        updateNameTrigrams(res.id, false, package->name);
     }
 }
 
-void PackageUpdaterPrivate::update(const StorageID packageID, bool removed, const std::shared_ptr<Package> &package)
+void PackageUpdaterPrivate::update(const StorageID packageID, bool removed, const Package &package)
 {
-    addDependency(packageID, Dependency(package->name, package->version), removed, affectedProvidedDeps);
-    for (const auto &dependency : package->provides) {
+    addDependency(packageID, Dependency(package.name, package.version), removed, affectedProvidedDeps);
+    for (const auto &dependency : package.provides) {
         addDependency(packageID, dependency, removed, affectedProvidedDeps);
     }
-    for (const auto &lib : package->libprovides) {
+    for (const auto &lib : package.libprovides) {
         addLibrary(packageID, lib, removed, affectedProvidedLibs);
     }
-    for (const auto &dependency : package->dependencies) {
+    for (const auto &dependency : package.dependencies) {
         addDependency(packageID, dependency, removed, affectedRequiredDeps);
     }
-    for (const auto &dependency : package->optionalDependencies) {
+    for (const auto &dependency : package.optionalDependencies) {
         addDependency(packageID, dependency, removed, affectedRequiredDeps);
     }
-    for (const auto &lib : package->libdepends) {
+    for (const auto &lib : package.libdepends) {
         addLibrary(packageID, lib, removed, affectedRequiredLibs);
     }
 }
 
-template <typename Dependency, typename MappedType, typename Txn>
-static void submitExistingDependency(StorageID id, Dependency &existingDependency, MappedType &affected, Txn &txn)
+/*!
+ * \brief Applies the net changes of \a affected to \a index.
+ * \remarks
+ * An update of a package still providing/requiring the dependency cancels out so its entry is left as-is. This is the
+ * common case when updating packages so most entries are not touched at all.
+ */
+template <typename MappedType>
+static void submitAffectedPackages(LMDBSafe::MDBRWTransactionImpl &txn, DependencyIndex &index, std::string_view name, const MappedType &affected,
+    std::string_view version = std::string_view(), DependencyMode mode = DependencyMode::Any)
 {
-    auto &pkgs = existingDependency.relevantPackages;
-    auto change = false;
-    for (auto &toRemove : affected.removedPackages) {
-        change = pkgs.erase(toRemove) || change;
+    for (const auto packageID : affected.removedPackages) {
+        index.remove(txn, name, packageID, version, mode);
     }
-    auto size = pkgs.size();
-    pkgs.merge(affected.newPackages);
-    change = change || pkgs.size() != size;
-    if (change) {
-        txn.put(existingDependency, id);
+    for (const auto packageID : affected.newPackages) {
+        index.add(txn, name, packageID, version, mode);
     }
 }
 
-void PackageUpdaterPrivate::submit(const std::string &dependencyName, AffectedDeps::mapped_type &affected, DependencyStorage::RWTransaction &txn)
+void PackageUpdaterPrivate::submit(std::string_view dependencyName, AffectedDeps::mapped_type &affected, DependencyIndex &index)
 {
-    for (auto [i, end] = txn.equal_range<0>(dependencyName); i != end; ++i) {
-        auto &existingDependency = i.value();
-        if (static_cast<const Dependency &>(existingDependency).version != affected.version) {
-            continue;
+    submitAffectedPackages(**packagesTxn.getTransactionHandle(), index, dependencyName, affected, affected.version, affected.mode);
+}
+
+void PackageUpdaterPrivate::submit(std::string_view libraryName, AffectedLibs::mapped_type &affected, DependencyIndex &index)
+{
+    submitAffectedPackages(**packagesTxn.getTransactionHandle(), index, libraryName, affected);
+}
+
+/*!
+ * \brief Populates \a index from scratch with the packages providing/requiring the \a affected dependencies.
+ * \remarks The new packages are the net set as removals within this updater cancel out additions. So a dependency dropped
+ *          by a package which has been updated twice within this updater is not added.
+ */
+void PackageUpdaterPrivate::bulkLoad(AffectedDeps &affected, DependencyIndex &index)
+{
+    for (const auto &[dependencyName, affectedPackages] : affected) {
+        for (const auto packageID : affectedPackages.newPackages) {
+            DependencyIndex::addToBulk(bulkEntries, dependencyName, packageID, affectedPackages.version, affectedPackages.mode);
         }
-        submitExistingDependency(i.getID(), existingDependency, affected, txn);
-        return;
     }
-    auto newDependency = DatabaseDependency(dependencyName, affected.version, affected.mode);
-    newDependency.relevantPackages.swap(affected.newPackages);
-    txn.put(newDependency);
+    index.bulkLoad(**packagesTxn.getTransactionHandle(), bulkEntries);
 }
 
-void PackageUpdaterPrivate::submit(const std::string &libraryName, AffectedLibs::mapped_type &affected, LibraryDependencyStorage::RWTransaction &txn)
+void PackageUpdaterPrivate::bulkLoad(AffectedLibs &affected, DependencyIndex &index)
 {
-    for (auto [i, end] = txn.equal_range<0>(libraryName); i != end; ++i) {
-        submitExistingDependency(i.getID(), i.value(), affected, txn);
-        return;
+    for (const auto &[libraryName, affectedPackages] : affected) {
+        for (const auto packageID : affectedPackages.newPackages) {
+            DependencyIndex::addToBulk(bulkEntries, libraryName, packageID);
+        }
     }
-    auto newDependency = DatabaseLibraryDependency(libraryName);
-    newDependency.relevantPackages.swap(affected.newPackages);
-    txn.put(newDependency);
+    index.bulkLoad(**packagesTxn.getTransactionHandle(), bulkEntries);
 }
+
+/*!
+ * \brief Applies the changes of provided dependencies to the index of all databases.
+ * \remarks
+ * When bulk-loading the entries of this database have been removed from the index of all databases by clearing the
+ * dependencies so all new packages need to be added (like DependencyIndex::bulkLoad() does for this database).
+ */
+void PackageUpdaterPrivate::submitToAllProvides()
+{
+    auto &txn = **packagesTxn.getTransactionHandle();
+    for (const auto &[dependencyName, affected] : affectedProvidedDeps) {
+        for (const auto packageID : affected.removedPackages) {
+            if (!isBulkLoad) {
+                storage.allProvides.remove(txn, storage.databaseID, dependencyName, packageID, affected.version, affected.mode);
+            }
+        }
+        for (const auto packageID : affected.newPackages) {
+            storage.allProvides.add(txn, storage.databaseID, dependencyName, packageID, affected.version, affected.mode);
+        }
+    }
+}
+
+void PackageUpdaterPrivate::updateNameTrigrams(StorageID packageID, bool removed, const std::string &packageName)
+{
+    for (const auto &trigram : nameTrigrams(packageName)) {
+        addLibrary(packageID, trigram, removed, affectedNameTrigrams);
+    }
+}
+
 PackageUpdaterPrivate::AffectedDeps::iterator PackageUpdaterPrivate::findDependency(const Dependency &dependency, AffectedDeps &affected)
 {
     for (auto range = affected.equal_range(dependency.name); range.first != range.second; ++range.first) {
-        if (dependency.version == range.first->second.version) {
+        if (dependency.version == range.first->second.version && dependency.mode == range.first->second.mode) {
             return range.first;
         }
     }
@@ -918,11 +1417,7 @@ void PackageUpdaterPrivate::addDependency(StorageID packageID, const Dependency
         iterator->second.version = dependency.version;
         iterator->second.mode = dependency.mode;
     }
-    if (!removed) {
-        iterator->second.newPackages.emplace(packageID);
-    } else {
-        iterator->second.removedPackages.emplace(packageID);
-    }
+    iterator->second.add(packageID, removed);
 }
 
 void PackageUpdaterPrivate::addLibrary(StorageID packageID, const std::string &libraryName, bool removed, AffectedLibs &affected)
@@ -930,16 +1425,17 @@ void PackageUpdaterPrivate::addLibrary(StorageID packageID, const std::string &l
     if (libraryName.empty()) {
         return;
     }
-    if (auto &affectedPackages = affected[libraryName]; !removed) {
-        affectedPackages.newPackages.emplace(packageID);
-    } else {
-        affectedPackages.removedPackages.emplace(packageID);
-    }
+    affected[libraryName].add(packageID, removed);
 }
 
 PackageUpdater::PackageUpdater(Database &database, bool clear)
+    : PackageUpdater(database, clear ? PackageUpdaterMode::Clear : PackageUpdaterMode::Update)
+{
+}
+
+PackageUpdater::PackageUpdater(Database &database, PackageUpdaterMode mode)
     : m_database(database)
-    , m_d(std::make_unique<PackageUpdaterPrivate>(*m_database.m_storage, clear))
+    , m_d(std::make_unique<PackageUpdaterPrivate>(*m_database.m_storage, mode))
 {
 }
 
@@ -960,7 +1456,7 @@ PackageSpec LibPkg::PackageUpdater::findPackageWithID(const std::string &package
  */
 void PackageUpdater::beginUpdate(StorageID packageID, const std::shared_ptr<Package> &package)
 {
-    m_d->update(packageID, true, package);
+    m_d->update(packageID, true, *package);
 }
 
 /*!
@@ -968,22 +1464,29 @@ void PackageUpdater::beginUpdate(StorageID packageID, const std::shared_ptr<Pack
  * \remarks
  * - Do not use this function when PackageUpdate has been constructed with clear=true.
  * - Call this method after callsing beginUpdate() and modifying \a package.
+ * - The stored cold data (files, install info) is kept unless \a package contains cold data which replaces it then.
  */
 void PackageUpdater::endUpdate(StorageID packageID, const std::shared_ptr<Package> &package)
 {
     const auto &storage = m_database.m_storage;
-    storage->packageCache.store(*m_database.m_storage, m_d->packagesTxn, packageID, package);
-    m_d->update(packageID, false, package);
+    const auto res = storage->packageCache.store(*m_database.m_storage, m_d->packagesTxn, packageID, package);
+    m_d->update(packageID, false, *package);
+    storage->updateFileIndex(m_d->packagesTxn, packageID, &res.oldColdData, &res.coldData);
 }
 
 /*!
  * \brief Updates the specified \a package. The \a package may or may not exist.
- * \remarks If the package exists then provides/deps from the existing package are taken over if appropriate.
+ * \remarks
+ * - If the package exists then provides/deps from the existing package are taken over if appropriate.
+ * - The cold data (files, install info) is moved out of \a package as only hot data is cached.
  */
 StorageID PackageUpdater::update(const std::shared_ptr<Package> &package)
 {
     const auto &storage = m_database.m_storage;
-    const auto res = storage->packageCache.store(*m_database.m_storage, m_d->packagesTxn, package);
+    // note: When clearing, the cold data of the existing package is only needed to update the index of files if it has been
+    //       added by this updater, see PackageUpdaterPrivate::update().
+    const auto res = storage->packageCache.store(*m_database.m_storage, m_d->packagesTxn, package,
+        [this](StorageID packageID) { return m_d->mode != PackageUpdaterMode::Clear || m_d->handledIds.contains(packageID); });
     m_d->update(res, package);
     return res.id;
 }
@@ -1005,15 +1508,55 @@ std::size_t PackageUpdater::packageCount() const
     return m_d->packageCountBeforeCommit;
 }
 
-bool PackageUpdater::insertFromDatabaseFile(const std::string &databaseFilePath)
+/*!
+ * \brief Returns the number of packages added, updated, skipped and removed so far.
+ * \remarks Removed packages are only counted when committing.
+ */
+const PackageUpdaterDiff &PackageUpdater::diff() const
 {
-    LibPkg::Package::fromDatabaseFile(databaseFilePath, [this](const std::shared_ptr<LibPkg::Package> &package) {
-        if (const auto [id, existingPackage] = findPackageWithID(package->name); existingPackage) {
-            package->addDepsAndProvidesFromOtherPackage(*existingPackage);
+    return m_d->diff;
+}
+
+/*!
+ * \brief Inserts the specified \a package which has been read from a database file.
+ * \remarks
+ * - Provides/deps from an existing package are taken over if appropriate (see update()).
+ * - In PackageUpdaterMode::Diff an existing package with the same build is only marked as handled. It is still updated if
+ *   \a package has files but the existing package has none (e.g. when loading the files database after the regular one).
+ */
+void PackageUpdater::insert(const std::shared_ptr<Package> &package)
+{
+    const auto hasFiles = [](const std::optional<PackageInfo> &packageInfo) { return packageInfo && !packageInfo->files.empty(); };
+    if (const auto [id, existingPackage] = findPackageWithID(package->name);
+        existingPackage && m_d->mode == PackageUpdaterMode::Diff && existingPackage->isSameBuild(*package)) {
+        // note: The existing package is retrieved from the cache and therefore lacks its files so they are checked within its
+        //       cold data (unless it has not been migrated via rebuildDb() yet and still contains its files).
+        auto coldData = PackageColdData();
+        if (!hasFiles(package->packageInfo) || hasFiles(existingPackage->packageInfo)
+            || (m_d->storage.getColdData(**m_d->packagesTxn.getTransactionHandle(), id, coldData) && hasFiles(coldData.packageInfo))) {
+            m_d->handledIds.emplace(id);
+            ++m_d->diff.unchanged;
+            return;
         }
-        update(package);
-        return false;
-    });
+    }
+    update(package);
+}
+
+/*!
+ * \brief Inserts all packages from the specified \a databaseFilePath.
+ * \remarks
+ * - The descriptions are parsed by \a parserCount threads. See Package::fromDatabaseFile() for the default.
+ * - Callers loading multiple databases concurrently should specify \a parserCount to avoid oversubscribing the CPU.
+ */
+bool PackageUpdater::insertFromDatabaseFile(const std::string &databaseFilePath, std::size_t parserCount)
+{
+    LibPkg::Package::fromDatabaseFile(
+        databaseFilePath,
+        [this](const std::shared_ptr<LibPkg::Package> &package) {
+            insert(package);
+            return false;
+        },
+        parserCount);
     return false;
 }
 
@@ -1022,52 +1565,57 @@ void PackageUpdater::commit()
     auto &storage = *m_database.m_storage;
     auto &pkgTxn = m_d->packagesTxn;
     auto txnHandle = pkgTxn.getTransactionHandle();
-    if (m_d->clear) {
+    if (m_d->mode != PackageUpdaterMode::Update) {
         const auto &toPreserve = m_d->handledIds;
         const auto end = pkgTxn.end();
         for (auto i = pkgTxn.begin(); i != end; ++i) {
             if (!toPreserve.contains(i.getID())) {
+                if (m_d->mode == PackageUpdaterMode::Diff) {
+                    auto &removedPackage = i.value();
+                    m_d->update(i.getID(), true, removedPackage);
+                    m_d->updateNameTrigrams(i.getID(), true, removedPackage.name);
+                    auto coldData = PackageColdData();
+                    if (!storage.getColdData(**txnHandle, i.getID(), coldData)) {
+                        // packages not migrated via rebuildDb() yet have no separate cold data but their files within the main record
+                        coldData.takeFrom(removedPackage);
+                    }
+                    storage.updateFileIndex(pkgTxn, i.getID(), &coldData, nullptr);
+                }
+                ++m_d->diff.removed;
                 storage.packageCache.invalidateCacheOnly(storage, i.value().name);
+                storage.deletePackageColdData(pkgTxn, i.getID());
                 i.del();
             }
         }
     }
-    {
-        auto txn = storage.providedDeps.getRWTransaction(txnHandle);
-        if (m_d->clear) {
-            txn.clear();
-        }
+    if (m_d->isBulkLoad) {
+        // populate the indexes from scratch (in sorted order) as there were no packages before anyway
+        storage.clearDependencies(**txnHandle);
+        storage.packageNameTrigrams.clear(**txnHandle);
+        m_d->bulkLoad(m_d->affectedProvidedDeps, storage.providedDeps);
+        m_d->bulkLoad(m_d->affectedRequiredDeps, storage.requiredDeps);
+        m_d->bulkLoad(m_d->affectedProvidedLibs, storage.providedLibs);
+        m_d->bulkLoad(m_d->affectedRequiredLibs, storage.requiredLibs);
+        m_d->bulkLoad(m_d->affectedNameTrigrams, storage.packageNameTrigrams);
+    } else {
         for (auto &[dependencyName, affected] : m_d->affectedProvidedDeps) {
-            m_d->submit(dependencyName, affected, txn);
-        }
-    }
-    {
-        auto txn = storage.requiredDeps.getRWTransaction(txnHandle);
-        if (m_d->clear) {
-            txn.clear();
+            m_d->submit(dependencyName, affected, storage.providedDeps);
         }
         for (auto &[dependencyName, affected] : m_d->affectedRequiredDeps) {
-            m_d->submit(dependencyName, affected, txn);
-        }
-    }
-    {
-        auto txn = storage.providedLibs.getRWTransaction(txnHandle);
-        if (m_d->clear) {
-            txn.clear();
+            m_d->submit(dependencyName, affected, storage.requiredDeps);
         }
         for (auto &[libraryName, affected] : m_d->affectedProvidedLibs) {
-            m_d->submit(libraryName, affected, txn);
-        }
-    }
-    {
-        auto txn = storage.requiredLibs.getRWTransaction(txnHandle);
-        if (m_d->clear) {
-            txn.clear();
+            m_d->submit(libraryName, affected, storage.providedLibs);
         }
         for (auto &[libraryName, affected] : m_d->affectedRequiredLibs) {
-            m_d->submit(libraryName, affected, txn);
+            m_d->submit(libraryName, affected, storage.requiredLibs);
+        }
+        for (auto &[trigram, affected] : m_d->affectedNameTrigrams) {
+            m_d->submit(trigram, affected, storage.packageNameTrigrams);
         }
     }
+    m_d->submitToAllProvides();
+    storage.invalidateProvidesFilter();
     m_d->packageCountBeforeCommit = pkgTxn.size();
     pkgTxn.commit();
     m_d->lock.unlock();
@@ -1154,6 +1702,23 @@ void push<LibPkg::PackageBaseSearchResult>(
     auto obj = value.GetObject();
     if (auto &pkg = reflectable.pkg) {
         push(*pkg, obj, allocator);
+    } else if (auto &view = reflectable.view) {
+        const auto pushString = [&obj, &allocator](const char *name, std::string_view str) {
+            obj.AddMember(RAPIDJSON_NAMESPACE::StringRef(name),
+                RAPIDJSON_NAMESPACE::Value(str.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(str.size()), allocator), allocator);
+        };
+        push(view->origin, "origin", obj, allocator);
+        push(view->timestamp, "timestamp", obj, allocator);
+        push(view->buildDate, "buildDate", obj, allocator);
+        pushString("name", view->name);
+        pushString("version", view->version);
+        pushString("arch", view->arch);
+        auto archs = RAPIDJSON_NAMESPACE::Value(RAPIDJSON_NAMESPACE::kArrayType);
+        for (const auto arch : view->archs()) {
+            archs.PushBack(RAPIDJSON_NAMESPACE::Value(arch.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(arch.size()), allocator), allocator);
+        }
+        obj.AddMember(RAPIDJSON_NAMESPACE::StringRef("archs"), archs, allocator);
+        pushString("description", view->description);
     }
     if (const auto &db = reflectable.db) {
         push(db->name, "db", obj, allocator);
@@ -12,8 +12,10 @@
 
 #include <atomic>
 #include <filesystem>
+#include <iosfwd>
 #include <optional>
 #include <regex>
+#include <span>
 #include <unordered_set>
 
 namespace LibPkg {
@@ -46,6 +48,7 @@ struct LIBPKG_EXPORT PackageSearchResult {
 struct LIBPKG_EXPORT PackageBaseSearchResult {
     PackageBaseSearchResult() = default;
     PackageBaseSearchResult(const Database &database, const PackageBase &package, StorageID id);
+    PackageBaseSearchResult(const Database &database, const PackageView &package, StorageID id);
 
     /// \brief The related database.
     /// \remarks
@@ -54,6 +57,7 @@ struct LIBPKG_EXPORT PackageBaseSearchResult {
     /// - The serialization functions can cope with both alternatives.
     const Database *db = nullptr;
     const PackageBase *pkg = nullptr;
+    const PackageView *view = nullptr; // alternative to pkg, only valid within the visitor the view has been passed to
     StorageID id = 0;
 };
 
@@ -113,19 +117,66 @@ struct LIBPKG_EXPORT UnresolvedDependencies : public ReflectiveRapidJSON::JsonSe
     std::vector<std::string> libs;
 };
 
+/*!
+ * \brief The FileSearchMode enum specifies how Database::packagesContainingFile() matches files.
+ */
+enum class FileSearchMode {
+    Path, /*!< the path of the file (without leading slash) matches exactly */
+    PathPrefix, /*!< the path of the file (without leading slash) starts with the search term */
+    Name, /*!< the name of the file (path without directory) matches exactly */
+};
+
+/*!
+ * \brief The PackageStorageStatistics struct holds statistics about how the cold data of packages is stored.
+ */
+struct LIBPKG_EXPORT PackageStorageStatistics {
+    PackageStorageStatistics &operator+=(const PackageStorageStatistics &other);
+
+    std::size_t records = 0; // number of records of cold data
+    std::size_t compressedRecords = 0; // number of records stored compressed
+    std::size_t storedBytes = 0; // number of bytes the records occupy within the storage
+    std::size_t uncompressedBytes = 0; // number of bytes the records would occupy without compression
+    double readSeconds = 0.0; // time it took to read (decompress and deserialize) all records
+};
+
+LIBPKG_EXPORT std::ostream &operator<<(std::ostream &o, const PackageStorageStatistics &statistics);
+
 struct PackageUpdaterPrivate;
 
+/*!
+ * \brief The PackageUpdaterMode enum specifies how a PackageUpdater treats existing packages.
+ */
+enum class PackageUpdaterMode {
+    Update, /*!< packages are added/updated; existing packages not passed to the updater are kept */
+    Clear, /*!< existing packages not passed to the updater are removed; the dependency indexes are re-created from scratch */
+    Diff, /*!< like Clear but packages with unchanged name, version and build date are skipped (unless they gain files) so only actual
+               changes reach the indexes */
+};
+
+/*!
+ * \brief The PackageUpdaterDiff struct holds the number of packages a PackageUpdater has added, updated, skipped and removed.
+ */
+struct LIBPKG_EXPORT PackageUpdaterDiff {
+    std::size_t added = 0;
+    std::size_t updated = 0;
+    std::size_t unchanged = 0;
+    std::size_t removed = 0;
+};
+
 struct LIBPKG_EXPORT PackageUpdater {
     explicit PackageUpdater(Database &database, bool clear = false);
+    explicit PackageUpdater(Database &database, PackageUpdaterMode mode);
     ~PackageUpdater();
 
     PackageSpec findPackageWithID(const std::string &packageName);
     void beginUpdate(StorageID packageID, const std::shared_ptr<Package> &package);
     void endUpdate(StorageID packageID, const std::shared_ptr<Package> &package);
     StorageID update(const std::shared_ptr<Package> &package);
+    void insert(const std::shared_ptr<Package> &package);
     const std::unordered_set<StorageID> &handledIDs() const;
     std::size_t packageCount() const;
-    bool insertFromDatabaseFile(const std::string &databaseFilePath);
+    const PackageUpdaterDiff &diff() const;
+    bool insertFromDatabaseFile(const std::string &databaseFilePath, std::size_t parserCount = 0);
     void commit();
 
 private:
@@ -155,6 +206,11 @@ struct LIBPKG_EXPORT Database : public ReflectiveRapidJSON::JsonSerializable<Dat
     using PackageVisitorConst = std::function<bool(StorageID, const std::shared_ptr<Package> &)>;
     using PackageVisitorByName = std::function<bool(std::string_view, const std::function<PackageSpec(void)> &)>;
     using PackageVisitorByNameBase = std::function<bool(std::string_view, const std::function<StorageID(PackageBase &)> &)>;
+    using PackageVisitorView = std::function<bool(StorageID, const PackageView &)>; // view is only valid during the call!!!
+    using PackageVisitorByNameView = std::function<bool(std::string_view, const std::function<StorageID(PackageView &)> &)>;
+    using FileVisitor = std::function<bool(StorageID, std::string_view)>; // path is only valid during the call!!!
+    // path and view are only valid during the call!!!
+    using FileVisitorView = std::function<bool(StorageID, std::string_view, const std::function<bool(PackageView &)> &)>;
 
     friend struct PackageUpdater;
 
@@ -167,18 +223,29 @@ struct LIBPKG_EXPORT Database : public ReflectiveRapidJSON::JsonSerializable<Dat
     void initStorage(StorageDistribution &storage);
     void rebuildDb();
     void dumpDb(const std::optional<std::regex> &filterRegex);
+    PackageStorageStatistics packageStorageStatistics();
+    void sampleColdData(std::vector<PackageColdData> &samples, std::size_t maxSamples);
+    std::size_t rewriteColdData();
     void deducePathsFromLocalDirs();
     void resetConfiguration(bool keepLocalPaths = false);
     void clearPackages();
+    std::pair<std::string, CppUtilities::DateTime> configuredPackagesPath(bool withFiles = false, bool force = false) const;
     void loadPackagesFromConfiguredPaths(bool withFiles = false, bool force = false);
-    void loadPackages(const std::string &databaseFilePath, CppUtilities::DateTime lastModified);
+    void loadPackages(const std::string &databaseFilePath, CppUtilities::DateTime lastModified, bool force = false);
+    void loadPackages(const std::vector<std::shared_ptr<Package>> &packages, CppUtilities::DateTime lastModified, bool force = false);
     static bool isFileRelevant(const char *filePath, const char *fileName, mode_t);
     std::vector<std::shared_ptr<Package>> findPackages(const std::function<bool(const Database &, const Package &)> &pred);
-    void allPackages(const PackageVisitorMove &visitor);
+    void allPackages(const PackageVisitorMove &visitor, bool withColdData = false);
     void allPackagesBase(const PackageVisitorBase &visitor);
     void allPackagesByName(const PackageVisitorByName &visitor);
     void allPackagesByName(const PackageVisitorByNameBase &visitor);
+    void allPackagesView(const PackageVisitorView &visitor);
+    void allPackagesByName(const PackageVisitorByNameView &visitor);
+    void packagesByNameContaining(std::span<const std::string_view> substrings, const PackageVisitorByNameView &visitor);
+    void packagesContainingFile(std::string_view path, FileSearchMode mode, const FileVisitor &visitor);
+    void packagesContainingFile(std::string_view path, FileSearchMode mode, const FileVisitorView &visitor);
     std::size_t packageCount() const;
+    std::uint32_t storageID() const;
     void providingPackages(const Dependency &dependency, bool reverse, const PackageVisitorConst &visitor);
     void providingPackagesBase(const Dependency &dependency, bool reverse, const PackageVisitorBase &visitor);
     void providingPackages(const std::string &libraryName, bool reverse, const PackageVisitorConst &visitor);
@@ -188,6 +255,7 @@ struct LIBPKG_EXPORT Database : public ReflectiveRapidJSON::JsonSerializable<Dat
     std::shared_ptr<Package> findPackage(StorageID packageID);
     std::shared_ptr<Package> findPackage(const std::string &packageName);
     PackageSpec findPackageWithID(const std::string &packageName);
+    std::shared_ptr<Package> findPackageWithColdData(StorageID packageID);
     StorageID findBasePackageWithID(const std::string &packageName, PackageBase &basePackage);
     void removePackage(const std::string &packageName);
     StorageID updatePackage(const std::shared_ptr<Package> &package);
@@ -289,6 +357,13 @@ inline PackageBaseSearchResult::PackageBaseSearchResult(const Database &database
 {
 }
 
+inline PackageBaseSearchResult::PackageBaseSearchResult(const Database &database, const PackageView &package, StorageID id)
+    : db(&database)
+    , view(&package)
+    , id(id)
+{
+}
+
 } // namespace LibPkg
 
 namespace std {
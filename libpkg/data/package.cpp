@@ -13,52 +13,33 @@ using namespace CppUtilities;
 
 namespace LibPkg {
 
-bool Dependency::matches(const DependencyMode mode, const string &version1, const string &version2)
+/*!
+ * \brief Returns whether a version compared with the required version as \a comparison satisfies \a mode.
+ */
+static bool satisfiesMode(DependencyMode mode, PackageVersionPartComparison comparison)
 {
     switch (mode) {
     case DependencyMode::Any:
         return true;
     case DependencyMode::Equal:
-        switch (PackageVersion::compareParts(version2, version1, true)) {
-        case PackageVersionPartComparison::Equal:
-            return true;
-        default:;
-        }
-        break;
+        return comparison == PackageVersionPartComparison::Equal;
     case DependencyMode::GreatherEqual:
-        switch (PackageVersion::compareParts(version2, version1, true)) {
-        case PackageVersionPartComparison::Equal:
-        case PackageVersionPartComparison::Newer:
-            return true;
-        default:;
-        }
-        break;
+        return comparison == PackageVersionPartComparison::Equal || comparison == PackageVersionPartComparison::Newer;
     case DependencyMode::GreatherThan:
-        switch (PackageVersion::compareParts(version2, version1, true)) {
-        case PackageVersionPartComparison::Newer:
-            return true;
-        default:;
-        }
-        break;
+        return comparison == PackageVersionPartComparison::Newer;
     case DependencyMode::LessEqual:
-        switch (PackageVersion::compareParts(version2, version1, true)) {
-        case PackageVersionPartComparison::Equal:
-        case PackageVersionPartComparison::Older:
-            return true;
-        default:;
-        }
-        break;
+        return comparison == PackageVersionPartComparison::Equal || comparison == PackageVersionPartComparison::Older;
     case DependencyMode::LessThan:
-        switch (PackageVersion::compareParts(version2, version1, true)) {
-        case PackageVersionPartComparison::Older:
-            return true;
-        default:;
-        }
-        break;
+        return comparison == PackageVersionPartComparison::Older;
     }
     return false;
 }
 
+bool Dependency::matches(const DependencyMode mode, const string &version1, const string &version2)
+{
+    return mode == DependencyMode::Any || satisfiesMode(mode, PackageVersion::compareParts(version2, version1, true));
+}
+
 ostream &operator<<(ostream &o, const DependencyMode &mode)
 {
     switch (mode) {
@@ -310,6 +291,147 @@ PackageVersionComparison PackageVersion::compare(const PackageVersion &other) co
     return PackageVersionComparison::Equal;
 }
 
+/*!
+ * \brief Returns the key for the specified version.
+ */
+PackageVersionKey PackageVersionKey::fromVersion(const PackageVersion &version)
+{
+    auto key = PackageVersionKey();
+    if (!version.epoch.empty()) {
+        key.epoch = partKey(version.epoch);
+    }
+    key.upstream = partKey(version.upstream);
+    if (!version.package.empty()) {
+        key.package = partKey(version.package);
+    }
+    return key;
+}
+
+/*!
+ * \brief Assigns a key for the specified version \a part (epoch, pkgver or pkgrel) which can be compared bytewise to \a key.
+ * \remarks
+ * The key reproduces the behavior of PackageVersion::compareParts() (without implicit pkgrel):
+ * - It starts with a byte denoting whether the first segment is followed by a colon (so a part with epoch is newer).
+ * - Each segment is encoded as marker byte (0x01), the number of bytes of its size, its size (big endian) and its
+ *   characters with leading zeros trimmed. So longer segments are newer and segments of equal size compare by character.
+ * - The key ends with a zero byte which is smaller than the marker byte. So a part with further segments is newer.
+ * - Like PackageVersion::compareParts() processing stops at the first null-byte.
+ * - The capacity of \a key is retained so it can be reused as buffer.
+ */
+void PackageVersionKey::partKey(std::string_view part, std::string &key)
+{
+    part = part.substr(0, part.find('\0'));
+    key.clear();
+    key.reserve(part.size() + 8);
+    const auto *pos = part.data(), *const end = part.data() + part.size();
+    for (auto first = true;; first = false) {
+        auto *segmentEnd = firstNonAlphanumericCharacter(pos, end);
+        if (first) {
+            key += segmentEnd != end && *segmentEnd == ':' ? '\x02' : '\x01';
+        }
+        for (; pos != segmentEnd && *pos == '0'; ++pos)
+            ;
+        const auto size = static_cast<std::size_t>(segmentEnd - pos);
+        auto sizeBytes = std::size_t();
+        for (auto remainingSize = size; remainingSize; remainingSize >>= 8) {
+            ++sizeBytes;
+        }
+        key += '\x01';
+        key += static_cast<char>(sizeBytes);
+        while (sizeBytes--) {
+            key += static_cast<char>((size >> (sizeBytes * 8)) & 0xFF);
+        }
+        key.append(pos, segmentEnd);
+        if (segmentEnd == end) {
+            break;
+        }
+        pos = segmentEnd + 1;
+    }
+    key += '\0';
+}
+
+/*!
+ * \brief Compares the current instance with another key.
+ * \returns Returns the same as PackageVersion::compare() would return for the versions the keys have been created from.
+ */
+PackageVersionComparison PackageVersionKey::compare(const PackageVersionKey &other) const
+{
+    static const auto emptyPartKey = partKey(std::string_view());
+    const auto compareParts = [](const std::string &part1, const std::string &part2) {
+        const auto res = (part1.empty() ? emptyPartKey : part1).compare(part2.empty() ? emptyPartKey : part2);
+        return res > 0 ? PackageVersionPartComparison::Newer : (res < 0 ? PackageVersionPartComparison::Older : PackageVersionPartComparison::Equal);
+    };
+    // check whether epoch differs
+    if (!epoch.empty() || !other.epoch.empty()) {
+        switch (compareParts(other.epoch, epoch)) {
+        case PackageVersionPartComparison::Newer:
+            return PackageVersionComparison::SoftwareUpgrade;
+        case PackageVersionPartComparison::Older:
+            return PackageVersionComparison::NewerThanSyncVersion;
+        case PackageVersionPartComparison::Equal:;
+        }
+    }
+    // check whether upstream version differs
+    switch (compareParts(other.upstream, upstream)) {
+    case PackageVersionPartComparison::Newer:
+        return PackageVersionComparison::SoftwareUpgrade;
+    case PackageVersionPartComparison::Older:
+        return PackageVersionComparison::NewerThanSyncVersion;
+    case PackageVersionPartComparison::Equal:;
+    }
+    // check whether package version differs (only if both versions specify it)
+    if (!package.empty() && !other.package.empty()) {
+        switch (compareParts(other.package, package)) {
+        case PackageVersionPartComparison::Newer:
+            return PackageVersionComparison::PackageUpgradeOnly;
+        case PackageVersionPartComparison::Older:
+            return PackageVersionComparison::NewerThanSyncVersion;
+        case PackageVersionPartComparison::Equal:;
+        }
+    }
+    return PackageVersionComparison::Equal;
+}
+
+/*!
+ * \brief Constructs a matcher for the specified \a mode and \a requiredVersion.
+ */
+DependencyVersionMatcher::DependencyVersionMatcher(DependencyMode mode, const std::string &requiredVersion)
+    : m_mode(mode)
+    , m_requiredVersion(requiredVersion)
+{
+    if (m_mode != DependencyMode::Any) {
+        PackageVersionKey::partKey(m_requiredVersion, m_requiredKey);
+    }
+}
+
+/*!
+ * \brief Returns whether \a version satisfies the version constraint; the same as Dependency::matches() would return.
+ * \remarks
+ * If the key of \a version only differs from the key of the required version by having further segments the versions are
+ * compared again via PackageVersion::compareParts() as it considers both equal if the further segments are just a pkgrel
+ * the required version does not specify.
+ */
+bool DependencyVersionMatcher::matches(std::string_view version)
+{
+    if (m_mode == DependencyMode::Any) {
+        return true;
+    }
+    if (m_hasLastResult && version == m_lastVersion) {
+        return m_lastResult;
+    }
+    PackageVersionKey::partKey(version, m_key);
+    const auto res = m_key.compare(m_requiredKey);
+    auto comparison
+        = res > 0 ? PackageVersionPartComparison::Newer : (res < 0 ? PackageVersionPartComparison::Older : PackageVersionPartComparison::Equal);
+    if (comparison == PackageVersionPartComparison::Newer
+        && std::string_view(m_key).starts_with(std::string_view(m_requiredKey.data(), m_requiredKey.size() - 1))) {
+        comparison = PackageVersion::compareParts(std::string(version), m_requiredVersion, true);
+    }
+    m_lastVersion.assign(version);
+    m_hasLastResult = true;
+    return m_lastResult = satisfiesMode(m_mode, comparison);
+}
+
 std::string PackageVersion::toString() const
 {
     return epoch.empty() ? upstream % '-' + package : epoch % ':' % upstream % '-' + package;
@@ -325,7 +447,7 @@ string LibPkg::Package::computeFileName(const char *extension) const
     if (packageInfo && !packageInfo->fileName.empty()) {
         return packageInfo->fileName;
     }
-    return argsToString(name, '-', version, '-', arch, '.', extension);
+    return argsToString(name, '-', version, '-', arch.str(), '.', extension);
 }
 
 std::string_view LibPkg::PackageBase::computeRegularPackageName() const
@@ -531,6 +653,72 @@ std::vector<std::string> Package::validate() const
     return problems;
 }
 
+static std::size_t heapSize(const std::string &value)
+{
+    // assume small strings are stored inline (SSO) as libstdc++ and libc++ do
+    return value.capacity() > 15 ? value.capacity() + 1 : 0;
+}
+
+static std::size_t heapSize(const InternedString &)
+{
+    // interned strings are shared across all packages so they are not attributed to a particular one
+    return 0;
+}
+
+static std::size_t heapSize(const Dependency &dependency)
+{
+    return heapSize(dependency.name) + heapSize(dependency.version) + heapSize(dependency.description);
+}
+
+static std::size_t heapSize(const SourceFile &sourceFile)
+{
+    return heapSize(sourceFile.path) + heapSize(sourceFile.contents);
+}
+
+template <typename ElementType> static std::size_t heapSize(const std::vector<ElementType> &values)
+{
+    auto size = values.capacity() * sizeof(ElementType);
+    for (const auto &value : values) {
+        size += heapSize(value);
+    }
+    return size;
+}
+
+static std::size_t heapSize(const InternedStringSet &values)
+{
+    // assume a red-black tree node has 4 words of overhead
+    auto size = values.size() * (sizeof(InternedString) + 4 * sizeof(void *));
+    for (const auto &value : values) {
+        size += heapSize(value);
+    }
+    return size;
+}
+
+/*!
+ * \brief Returns the approximate number of bytes the package occupies on the heap.
+ * \remarks This is used to limit the memory usage of the package cache so it only needs to be a rough estimate
+ *          considering the major contributors like the file list.
+ */
+std::size_t Package::approximateMemoryUsage() const
+{
+    auto size = sizeof(Package) + heapSize(name) + heapSize(version) + heapSize(arch) + heapSize(archs) + heapSize(description)
+        + heapSize(upstreamUrl) + heapSize(licenses) + heapSize(groups) + heapSize(dependencies) + heapSize(optionalDependencies)
+        + heapSize(conflicts) + heapSize(provides) + heapSize(replaces) + heapSize(libprovides) + heapSize(libdepends);
+    if (sourceInfo) {
+        size += heapSize(sourceInfo->name) + heapSize(sourceInfo->archs) + heapSize(sourceInfo->makeDependencies)
+            + heapSize(sourceInfo->checkDependencies) + heapSize(sourceInfo->maintainer) + heapSize(sourceInfo->url)
+            + heapSize(sourceInfo->sources) + heapSize(sourceInfo->directory);
+    }
+    if (packageInfo) {
+        size += heapSize(packageInfo->fileName) + heapSize(packageInfo->files) + heapSize(packageInfo->packager) + heapSize(packageInfo->md5)
+            + heapSize(packageInfo->sha256) + heapSize(packageInfo->pgpSignature);
+    }
+    if (installInfo) {
+        size += heapSize(installInfo->backupFiles);
+    }
+    return size;
+}
+
 DependencySetBase::iterator DependencySet::find(const Dependency &dependency)
 {
     for (auto range = equal_range(dependency.name); range.first != range.second; ++range.first) {
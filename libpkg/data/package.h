@@ -2,6 +2,7 @@
 #define LIBPKG_DATA_PACKAGE_H
 
 #include "./storagefwd.h"
+#include "./stringpool.h"
 
 #include "../global.h"
 
@@ -15,13 +16,16 @@
 #include <c++utilities/chrono/datetime.h>
 #include <c++utilities/io/archive.h>
 
+#include <cstdint>
 #include <cstring>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <set>
+#include <span>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace LibPkg {
@@ -99,7 +103,7 @@ struct LIBPKG_EXPORT Dependency : public ReflectiveRapidJSON::JsonSerializable<D
     static Dependency fromString(std::string_view dependency);
     std::string toString() const;
 
-    std::string name;
+    InternedString name;
     std::string version;
     std::string description;
     DependencyMode mode = DependencyMode::Any;
@@ -209,7 +213,7 @@ struct SourceFile : public ReflectiveRapidJSON::JsonSerializable<SourceFile>, pu
 struct LIBPKG_EXPORT SourceInfo : public ReflectiveRapidJSON::JsonSerializable<SourceInfo>,
                                   public ReflectiveRapidJSON::BinarySerializable<SourceInfo> {
     std::string name;
-    std::vector<std::string> archs; // archs specified in base package
+    std::vector<InternedString> archs; // archs specified in base package
     std::vector<Dependency> makeDependencies;
     std::vector<Dependency> checkDependencies;
     std::string maintainer;
@@ -302,6 +306,68 @@ inline bool PackageVersion::isNewer(PackageVersionComparison comparison)
     return comparison == PackageVersionComparison::SoftwareUpgrade || comparison == PackageVersionComparison::PackageUpgradeOnly;
 }
 
+/*!
+ * \brief The PackageVersionKey struct holds normalized keys of the parts of a version which can be compared bytewise.
+ * \remarks
+ * - Comparing two keys via compare() yields the same result as PackageVersion::compare() but only needs up to three
+ *   std::string comparisons (so basically memcmp calls) instead of splitting the parts into segments again.
+ * - Computing a key is about as expensive as comparing two versions once. So it is only worth it if the same version is
+ *   compared multiple times.
+ */
+struct LIBPKG_EXPORT PackageVersionKey {
+    static PackageVersionKey fromVersion(const PackageVersion &version);
+    static PackageVersionKey fromString(std::string_view versionString);
+    static std::string partKey(std::string_view part);
+    static void partKey(std::string_view part, std::string &key);
+    PackageVersionComparison compare(const PackageVersionKey &other) const;
+
+    std::string epoch; // empty if the version has no epoch
+    std::string upstream;
+    std::string package; // empty if the version has no pkgrel
+};
+
+inline PackageVersionKey PackageVersionKey::fromString(std::string_view versionString)
+{
+    return fromVersion(PackageVersion::fromString(versionString.data(), versionString.size()));
+}
+
+inline std::string PackageVersionKey::partKey(std::string_view part)
+{
+    auto key = std::string();
+    partKey(part, key);
+    return key;
+}
+
+/*!
+ * \brief The DependencyVersionMatcher struct checks whether versions satisfy the version constraint of a dependency.
+ * \remarks
+ * - Yields the same as Dependency::matches() but computes the key of the required version only once. So checking many
+ *   versions against the same dependency (e.g. all entries of an index for the name of the dependency) only needs to
+ *   compute the key of each version (into a buffer that is reused) and to compare it bytewise.
+ * - The result for the last version is kept. So checking the same version again is only a string comparison which is
+ *   useful as the entries of dependency indexes are sorted by version.
+ * - The required version is referenced and must outlive the matcher.
+ */
+struct LIBPKG_EXPORT DependencyVersionMatcher {
+    explicit DependencyVersionMatcher(DependencyMode mode, const std::string &requiredVersion);
+    explicit DependencyVersionMatcher(const Dependency &dependency);
+    bool matches(std::string_view version);
+
+private:
+    DependencyMode m_mode;
+    const std::string &m_requiredVersion;
+    std::string m_requiredKey;
+    std::string m_key;
+    std::string m_lastVersion;
+    bool m_hasLastResult = false;
+    bool m_lastResult = false;
+};
+
+inline DependencyVersionMatcher::DependencyVersionMatcher(const Dependency &dependency)
+    : DependencyVersionMatcher(dependency.mode, dependency.version)
+{
+}
+
 /*!
  * \brief The PackageOrigin enum specifies where the information contained by a Package object come from.
  *
@@ -386,6 +452,7 @@ struct LIBPKG_EXPORT PackageBase : public ReflectiveRapidJSON::JsonSerializable<
     PackageBase &operator=(PackageBase &&other) = default;
 
     bool isSame(const PackageBase &other) const;
+    bool isSameBuild(const PackageBase &other) const;
     bool isDebug() const;
     PackageVersionComparison compareVersion(const PackageBase &other) const;
     std::string_view computeRegularPackageName() const;
@@ -397,11 +464,34 @@ struct LIBPKG_EXPORT PackageBase : public ReflectiveRapidJSON::JsonSerializable<
     CppUtilities::DateTime timestamp, buildDate;
     std::string name;
     std::string version;
-    std::string arch;
-    std::vector<std::string> archs; // set if a split package overrides the base archs; if empty, archs from sourceInfo apply
+    InternedString arch;
+    std::vector<InternedString> archs; // set if a split package overrides the base archs; if empty, archs from sourceInfo apply
     std::string description;
 };
 
+/*!
+ * \brief The PackageView struct provides read-only access to the fields of PackageBase without copying them.
+ * \remarks
+ * - The string views point into the memory-mapped database. They are only valid as long as the read-only
+ *   transaction the view has been obtained from is alive. So views must not be used outside of the visitor
+ *   they have been passed to. Use toPackageBase() to obtain a copy.
+ * - The archs are kept serialized (or refer to a deserialized vector); use archs() to access them.
+ */
+struct LIBPKG_EXPORT PackageView {
+    std::vector<std::string_view> archs() const;
+    PackageBase toPackageBase() const;
+
+    PackageOrigin origin = PackageOrigin::Default;
+    CppUtilities::DateTime timestamp, buildDate;
+    std::string_view name;
+    std::string_view version;
+    std::string_view arch;
+    std::string_view description;
+    std::string_view serializedArchs;
+    std::size_t archCount = 0;
+    const std::vector<InternedString> *deserializedArchs = nullptr;
+};
+
 struct LIBPKG_EXPORT Package : public PackageBase,
                                public ReflectiveRapidJSON::JsonSerializable<Package>,
                                public ReflectiveRapidJSON::BinarySerializable<Package, 1> {
@@ -416,14 +506,15 @@ struct LIBPKG_EXPORT Package : public PackageBase,
     PackageNameData decomposeName() const;
     void addInfoFromPkgInfoFile(const std::string &info);
     void addDepsAndProvidesFromContainedDirectory(std::string_view directoryPath);
-    void addDepsAndProvidesFromContainedFile(
-        std::string_view directoryPath, const CppUtilities::ArchiveFile &file, std::set<std::string> &dllsReferencedByImportLibs);
+    void addDepsAndProvidesFromContainedFile(std::string_view directoryPath, const CppUtilities::ArchiveFile &file,
+        std::set<std::string> &dllsReferencedByImportLibs, BinaryInfoCache *binaryInfoCache = nullptr);
     void addDepsAndProvidesFromContents(const CppUtilities::FileMap &contents);
     std::vector<std::string> processDllsReferencedByImportLibs(std::set<std::string> &&dllsReferencedByImportLibs);
     bool canDepsAndProvidesFromOtherPackage(const Package &otherPackage) const;
     bool addDepsAndProvidesFromOtherPackage(const Package &otherPackage, bool force = false);
     bool isArchAny() const;
     std::vector<std::string> validate() const;
+    std::size_t approximateMemoryUsage() const;
     using ReflectiveRapidJSON::JsonSerializable<Package>::fromJson;
     using ReflectiveRapidJSON::JsonSerializable<Package>::toJson;
     using ReflectiveRapidJSON::JsonSerializable<Package>::toJsonDocument;
@@ -432,11 +523,14 @@ struct LIBPKG_EXPORT Package : public PackageBase,
     using ReflectiveRapidJSON::BinarySerializable<Package, 1>::fromBinary;
 
     static bool isPkgInfoFileOrBinary(const char *filePath, const char *fileName, mode_t mode);
+    static std::uint64_t requiredSizeOfPkgInfoFileOrBinary(const char *fileName, std::string_view contentPrefix, std::uint64_t fileSize);
     static bool isLicense(const char *filePath, const char *fileName, mode_t mode);
 
     static std::vector<GenericPackageSpec<Package>> fromInfo(const std::string &info, bool isPackageInfo = false);
     static std::shared_ptr<Package> fromDescription(const std::vector<std::string> &descriptionParts);
-    static void fromDatabaseFile(const std::string &archivePath, const std::function<bool(const std::shared_ptr<Package> &)> &visitor);
+    static std::shared_ptr<Package> fromDescription(std::span<const std::string_view> descriptionParts);
+    static void fromDatabaseFile(
+        const std::string &archivePath, const std::function<bool(const std::shared_ptr<Package> &)> &visitor, std::size_t parserCount = 0);
     static std::shared_ptr<Package> fromPkgFile(const std::string &path);
     static std::tuple<std::string_view, std::string_view, std::string_view> fileNameComponents(std::string_view fileName);
     static std::shared_ptr<Package> fromPkgFileName(std::string_view fileName);
@@ -445,25 +539,108 @@ struct LIBPKG_EXPORT Package : public PackageBase,
 
     using PackageBase::version;
     std::string upstreamUrl;
-    std::vector<std::string> licenses;
-    std::vector<std::string> groups;
+    std::vector<InternedString> licenses;
+    std::vector<InternedString> groups;
     std::vector<Dependency> dependencies;
     std::vector<Dependency> optionalDependencies;
     std::vector<Dependency> conflicts;
     std::vector<Dependency> provides;
     std::vector<Dependency> replaces;
-    std::set<std::string> libprovides;
-    std::set<std::string> libdepends;
+    InternedStringSet libprovides;
+    InternedStringSet libdepends;
     std::optional<SourceInfo> sourceInfo;
     std::optional<PackageInfo> packageInfo;
     std::optional<InstallInfo> installInfo;
 };
 
+/*!
+ * \brief The PackageColdData struct holds the bulky parts of a Package which are rarely needed.
+ * \remarks
+ * - The storage keeps this data in a separate table so scanning and caching packages does not need to page in file lists.
+ * - It consists of the files of the package info and the install info. The remaining package info and the source info
+ *   are needed by many code paths (e.g. the file name of the package) and are therefore kept within the package itself.
+ * - Packages retrieved from the storage do not contain it. It needs to be loaded explicitly, e.g. via
+ *   Database::findPackageWithColdData().
+ * - Records stored by former versions may contain the entire package info and the source info as well.
+ */
+struct LIBPKG_EXPORT PackageColdData : public ReflectiveRapidJSON::BinarySerializable<PackageColdData, 1> {
+    bool empty() const;
+    void takeFrom(Package &package);
+    void moveTo(Package &package);
+    void addMissingFrom(const PackageColdData &other);
+
+    std::optional<SourceInfo> sourceInfo;
+    std::optional<PackageInfo> packageInfo;
+    std::optional<InstallInfo> installInfo;
+};
+
+inline bool PackageColdData::empty() const
+{
+    return !sourceInfo.has_value() && !packageInfo.has_value() && !installInfo.has_value();
+}
+
+/*!
+ * \brief Moves the cold data of the specified \a package into this object, leaving the package without it.
+ */
+inline void PackageColdData::takeFrom(Package &package)
+{
+    sourceInfo.reset();
+    packageInfo.reset();
+    if (package.packageInfo && !package.packageInfo->files.empty()) {
+        packageInfo.emplace().files = std::exchange(package.packageInfo->files, std::vector<std::string>());
+    }
+    installInfo = std::exchange(package.installInfo, std::nullopt);
+}
+
+/*!
+ * \brief Moves the data of this object back into the specified \a package.
+ * \remarks The package info and the source info are only moved entirely if \a package has none (records of former versions).
+ */
+inline void PackageColdData::moveTo(Package &package)
+{
+    if (packageInfo) {
+        if (package.packageInfo) {
+            package.packageInfo->files = std::move(packageInfo->files);
+        } else {
+            package.packageInfo = std::move(packageInfo);
+        }
+        packageInfo.reset();
+    }
+    if (sourceInfo && !package.sourceInfo) {
+        package.sourceInfo = std::move(sourceInfo);
+    }
+    sourceInfo.reset();
+    if (installInfo) {
+        package.installInfo = std::exchange(installInfo, std::nullopt);
+    }
+}
+
+/*!
+ * \brief Takes over the parts of the \a other cold data this object lacks.
+ */
+inline void PackageColdData::addMissingFrom(const PackageColdData &other)
+{
+    if (!packageInfo) {
+        packageInfo = other.packageInfo;
+    }
+    if (!installInfo) {
+        installInfo = other.installInfo;
+    }
+}
+
 inline bool PackageBase::isSame(const PackageBase &other) const
 {
     return name == other.name && version == other.version;
 }
 
+/*!
+ * \brief Returns whether the package is the same build as \a other, so not only name and version but also the build date match.
+ */
+inline bool PackageBase::isSameBuild(const PackageBase &other) const
+{
+    return isSame(other) && buildDate == other.buildDate;
+}
+
 inline bool PackageBase::isDebug() const
 {
     return name.ends_with(debugSuffix);
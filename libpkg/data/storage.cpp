@@ -3,7 +3,11 @@
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/ansiescapecodes.h>
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace CppUtilities;
 
@@ -21,15 +25,82 @@ auto StorageCacheEntries<StorageEntryType>::find(const IndexType &ref) -> Storag
     return nullptr;
 }
 
-template <typename StorageEntryType> auto StorageCacheEntries<StorageEntryType>::insert(StorageEntry &&entry) -> StorageEntry &
+/*!
+ * \brief Inserts the specified \a entry or updates the existing entry with the same ref and ID.
+ * \remarks
+ * - Existing entries which have the same ref but a different ID (or vice versa) are removed.
+ * - The IDs of removed entries are added to \a evicted if specified.
+ * - Returns nullptr if the entry is not retained because it exceeds the limit on its own.
+ */
+template <typename StorageEntryType> auto StorageCacheEntries<StorageEntryType>::insert(StorageEntry &&entry, EvictedIDs *evicted) -> StorageEntry *
 {
+    const auto evict = [evicted](const StorageEntry &existingEntry) {
+        if (evicted) {
+            evicted->emplace_back(ByID()(existingEntry));
+        }
+    };
+    auto &byRef = m_entries.template get<Ref>();
+    if (const auto i = byRef.find(entry.ref); i != byRef.end() && i->id != entry.id) {
+        evict(*i);
+        m_memoryUsage -= i->size;
+        byRef.erase(i);
+    }
+    auto &byID = m_entries.template get<typename ByID::result_type>();
+    if (const auto i = byID.find(ByID()(entry)); i != byID.end() && !(i->ref == entry.ref)) {
+        evict(*i);
+        m_memoryUsage -= i->size;
+        byID.erase(i);
+    }
+    if (entry.size > m_limit) {
+        // do not evict all other entries for an entry that would exceed the limit on its own anyways
+        erase(entry.ref, evicted);
+        return nullptr;
+    }
     const auto [i, newItem] = m_entries.emplace_front(entry);
+    auto &insertedEntry = i.get_node()->value();
     if (!newItem) {
+        // update existing entry; assigning the name is fine as it is equal anyways
+        m_memoryUsage = m_memoryUsage - insertedEntry.size + entry.size;
+        insertedEntry.ref.entryName = entry.ref.entryName;
+        insertedEntry.size = entry.size;
+        insertedEntry.entry = std::move(entry.entry);
         m_entries.relocate(m_entries.begin(), i);
-    } else if (m_entries.size() > m_limit) {
-        m_entries.pop_back();
+    } else {
+        m_memoryUsage += entry.size;
+    }
+    // evict least recently used entries; the inserted entry is at the front and fits into the limit so it is retained
+    while (m_memoryUsage > m_limit) {
+        evictLeastRecentlyUsed(evicted);
+    }
+    return &insertedEntry;
+}
+
+template <typename StorageEntryType> void StorageCacheEntries<StorageEntryType>::evictLeastRecentlyUsed(EvictedIDs *evicted)
+{
+    const auto &entry = m_entries.back();
+    if (evicted) {
+        evicted->emplace_back(ByID()(entry));
+    }
+    m_memoryUsage -= entry.size;
+    m_entries.pop_back();
+    ++m_evictions;
+}
+
+template <typename StorageEntryType>
+template <typename IndexType>
+std::size_t StorageCacheEntries<StorageEntryType>::erase(const IndexType &key, EvictedIDs *evicted)
+{
+    auto &index = m_entries.template get<IndexType>();
+    const auto i = index.find(key);
+    if (i == index.end()) {
+        return 0;
     }
-    return i.get_node()->value();
+    if (evicted) {
+        evicted->emplace_back(ByID()(*i));
+    }
+    m_memoryUsage -= i->size;
+    index.erase(i);
+    return 1;
 }
 
 template <typename StorageEntryType> std::size_t StorageCacheEntries<StorageEntryType>::clear(const Storage &storage)
@@ -37,6 +108,7 @@ template <typename StorageEntryType> std::size_t StorageCacheEntries<StorageEntr
     auto count = std::size_t();
     for (auto i = m_entries.begin(); i != m_entries.end();) {
         if (i->ref.relatedStorage == &storage) {
+            m_memoryUsage -= i->size;
             i = m_entries.erase(i);
             ++count;
         } else {
@@ -46,11 +118,97 @@ template <typename StorageEntryType> std::size_t StorageCacheEntries<StorageEntr
     return count;
 }
 
-template <typename StorageEntryType> void StorageCacheEntries<StorageEntryType>::setLimit(std::size_t limit)
+template <typename StorageEntryType> void StorageCacheEntries<StorageEntryType>::setLimit(std::size_t limit, EvictedIDs *evicted)
 {
     m_limit = limit;
-    while (m_entries.size() > limit) {
-        m_entries.pop_back();
+    while (m_memoryUsage > limit && !m_entries.empty()) {
+        evictLeastRecentlyUsed(evicted);
+    }
+}
+
+/*!
+ * \brief Looks up the entry for the specified \a key within the specified \a shard.
+ * \remarks Only a shared lock is required for the lookup itself. The entry is only marked as recently used
+ *          if the shard can be locked exclusively without waiting.
+ */
+template <typename StorageEntriesType, typename StorageType, typename SpecType>
+template <typename IndexType>
+auto StorageCache<StorageEntriesType, StorageType, SpecType>::lookup(Shard &shard, const IndexType &key) -> SpecType
+{
+    auto readLock = std::shared_lock(shard.mutex);
+    const auto *const existingCacheEntry = shard.entries.peek(key);
+    if (!existingCacheEntry) {
+        return SpecType(0, std::shared_ptr<Entry>());
+    }
+    auto res = SpecType(existingCacheEntry->id, existingCacheEntry->entry);
+    readLock.unlock();
+    if (auto writeLock = std::unique_lock(shard.mutex, std::try_to_lock)) {
+        shard.entries.find(key);
+    }
+    return res;
+}
+
+/*!
+ * \brief Returns the index of the shard the entry with the specified \a entryByID has been stored in.
+ * \remarks Returns shardCount if the entry is not known to be cached.
+ */
+template <typename StorageEntriesType, typename StorageType, typename SpecType>
+std::size_t StorageCache<StorageEntriesType, StorageType, SpecType>::lookupShardIndex(const EntryByID &entryByID)
+{
+    auto &idShard = this->idShard(entryByID);
+    const auto lock = std::shared_lock(idShard.mutex);
+    const auto i = idShard.shardByID.find(entryByID);
+    return i != idShard.shardByID.end() ? i->second : shardCount;
+}
+
+/*!
+ * \brief Inserts the specified \a cacheEntry for \a entry into the shard with the specified \a shardIndex.
+ * \remarks
+ * - An entry previously cached under the same ID but a different name might live in another shard. It is
+ *   removed from that shard first so it cannot be found via its old name anymore.
+ * - The ID-shard mutexes are only ever acquired last so locking them while holding the shard mutex is fine.
+ */
+template <typename StorageEntriesType, typename StorageType, typename SpecType>
+void StorageCache<StorageEntriesType, StorageType, SpecType>::insert(
+    std::size_t shardIndex, typename Entries::StorageEntry &&cacheEntry, const std::shared_ptr<Entry> &entry)
+{
+    cacheEntry.ref.entryName = &entry->name;
+    cacheEntry.size = entry->approximateMemoryUsage();
+    cacheEntry.entry = entry;
+    auto evicted = typename Entries::EvictedIDs();
+    const auto previousEntryByID = typename Entries::ByID()(cacheEntry);
+    if (const auto previousIndex = lookupShardIndex(previousEntryByID); previousIndex < shardCount && previousIndex != shardIndex) {
+        auto &previousShard = m_shards[previousIndex];
+        const auto previousLock = std::unique_lock(previousShard.mutex);
+        previousShard.entries.erase(previousEntryByID, &evicted);
+        forgetIDs(previousIndex, evicted);
+        evicted.clear();
+    }
+    auto &shard = m_shards[shardIndex];
+    const auto lock = std::unique_lock(shard.mutex);
+    const auto *const insertedEntry = shard.entries.insert(std::move(cacheEntry), &evicted);
+    forgetIDs(shardIndex, evicted);
+    if (!insertedEntry) {
+        return;
+    }
+    const auto entryByID = typename Entries::ByID()(*insertedEntry);
+    auto &idShard = this->idShard(entryByID);
+    const auto idLock = std::unique_lock(idShard.mutex);
+    idShard.shardByID[entryByID] = shardIndex;
+}
+
+/*!
+ * \brief Removes the hints for the specified \a ids if they still point to the shard with the specified \a shardIndex.
+ */
+template <typename StorageEntriesType, typename StorageType, typename SpecType>
+void StorageCache<StorageEntriesType, StorageType, SpecType>::forgetIDs(std::size_t shardIndex, const typename Entries::EvictedIDs &ids)
+{
+    for (const auto &entryByID : ids) {
+        auto &idShard = this->idShard(entryByID);
+        const auto idLock = std::unique_lock(idShard.mutex);
+        if (const auto i = idShard.shardByID.find(entryByID); i != idShard.shardByID.end() && i->second == shardIndex) {
+            idShard.shardByID.erase(i);
+        }
     }
 }
 
@@ -58,24 +216,22 @@ template <typename StorageEntriesType, typename StorageType, typename SpecType>
 auto StorageCache<StorageEntriesType, StorageType, SpecType>::retrieve(Storage &storage, ROTxn *txn, StorageID storageID) -> SpecType
 {
     // check for package in cache, should be ok even if the db is being updated
-    const auto ref = typename StorageEntryByID<typename Entries::StorageEntry>::result_type{ storageID, &storage };
-    auto lock = std::unique_lock(m_mutex);
-    if (auto *const existingCacheEntry = m_entries.find(ref)) {
-        return SpecType(existingCacheEntry->id, existingCacheEntry->entry);
+    const auto ref = EntryByID{ storageID, &storage };
+    if (const auto index = lookupShardIndex(ref); index < shardCount) {
+        if (auto res = lookup(m_shards[index], ref); res.pkg) {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return res;
+        }
     }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
     // check for package in storage, populate cache entry
-    lock.unlock();
     auto entry = std::make_shared<Entry>();
     if (auto id = txn ? txn->get(storageID, *entry) : storage.packages.getROTransaction().get(storageID, *entry)) {
         // try to acquire update lock to avoid update existing cache entries while db is being updated
         if (const auto updateLock = std::unique_lock(storage.updateMutex, std::try_to_lock)) {
             using CacheEntry = typename Entries::StorageEntry;
-            using CacheRef = typename Entries::Ref;
-            auto newCacheEntry = CacheEntry(CacheRef(storage, entry), id);
-            newCacheEntry.entry = entry;
-            lock = std::unique_lock(m_mutex);
-            m_entries.insert(std::move(newCacheEntry));
-            lock.unlock();
+            const auto cacheRef = Ref(storage, entry);
+            insert(shardIndex(cacheRef), CacheEntry(cacheRef, id), entry);
         }
         return SpecType(id, entry);
     }
@@ -96,24 +252,20 @@ auto StorageCache<StorageEntriesType, StorageType, SpecType>::retrieve(Storage &
         return SpecType(0, std::shared_ptr<Entry>());
     }
     // check for package in cache, should be ok even if the db is being updated
-    using CacheRef = typename Entries::Ref;
-    const auto ref = CacheRef(storage, entryName);
-    auto lock = std::unique_lock(m_mutex);
-    if (auto *const existingCacheEntry = m_entries.find(ref)) {
-        return SpecType(existingCacheEntry->id, existingCacheEntry->entry);
+    const auto ref = Ref(storage, entryName);
+    const auto index = shardIndex(ref);
+    if (auto res = lookup(m_shards[index], ref); res.pkg) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return res;
     }
-    lock.unlock();
+    m_misses.fetch_add(1, std::memory_order_relaxed);
     // check for package in storage, populate cache entry
     auto entry = std::make_shared<Entry>();
     if (auto id = txn ? txn->template get<0>(entryName, *entry) : storage.packages.getROTransaction().template get<0>(entryName, *entry)) {
         // try to acquire update lock to avoid update existing cache entries while db is being updated
         if (const auto updateLock = std::unique_lock(storage.updateMutex, std::try_to_lock)) {
             using CacheEntry = typename Entries::StorageEntry;
-            auto newCacheEntry = CacheEntry(CacheRef(storage, entry), id);
-            newCacheEntry.entry = entry;
-            lock = std::unique_lock(m_mutex);
-            m_entries.insert(std::move(newCacheEntry));
-            lock.unlock();
+            insert(index, CacheEntry(Ref(storage, entry), id), entry);
         }
         return SpecType(id, entry);
     }
@@ -128,52 +280,67 @@ auto StorageCache<StorageEntriesType, StorageType, SpecType>::retrieve(Storage &
 
 /*!
  * \brief Stores the specified \a entry.
- * \remarks The entry may exist or may not exist. A lookup for an existing entry is done to take over
- *          deps/provides from the existing entry if it makes sense.
+ * \remarks
+ * - The entry may exist or may not exist. A lookup for an existing entry is done to take over
+ *   deps/provides from the existing entry if it makes sense.
+ * - The cold data of \a entry replaces the stored one. It is moved out of \a entry into StoreResult::coldData
+ *   so the cached entry only keeps hot data.
+ * - The cold data of an existing entry is loaded into StoreResult::oldColdData unless \a isOldColdDataNeeded
+ *   returns false for its ID. It is always loaded if \a entry takes over the package info of the existing entry or
+ *   if \a entry is the cached entry itself. In the latter case the stored cold data is kept.
  */
 template <typename StorageEntriesType, typename StorageType, typename SpecType>
-auto StorageCache<StorageEntriesType, StorageType, SpecType>::store(Storage &storage, RWTxn &txn, const std::shared_ptr<Entry> &entry) -> StoreResult
+auto StorageCache<StorageEntriesType, StorageType, SpecType>::store(
+    Storage &storage, RWTxn &txn, const std::shared_ptr<Entry> &entry, const std::function<bool(StorageID)> &isOldColdDataNeeded) -> StoreResult
 {
     // check for package in cache
     using CacheEntry = typename Entries::StorageEntry;
-    using CacheRef = typename Entries::Ref;
     auto res = StorageCache::StoreResult();
     if (entry->name.empty()) {
         return res;
     }
-    const auto ref = CacheRef(storage, entry);
-    auto lock = std::unique_lock(m_mutex);
-    auto *cacheEntry = m_entries.find(ref);
-    if (cacheEntry) {
-        // retain certain information obtained from package contents if this is actually the same package as before
-        res.id = cacheEntry->id;
-        res.oldEntry = cacheEntry->entry;
-        entry->addDepsAndProvidesFromOtherPackage(*res.oldEntry);
+    const auto ref = Ref(storage, entry);
+    const auto index = shardIndex(ref);
+    if (auto cached = lookup(m_shards[index], ref); cached.pkg) {
+        res.id = cached.id;
+        res.oldEntry = std::move(cached.pkg);
     }
-    lock.unlock();
 
     // check for package in storage
     if (!res.oldEntry) {
         res.oldEntry = std::make_shared<Entry>();
-        if ((res.id = txn.template get<0>(entry->name, *res.oldEntry))) {
-            entry->addDepsAndProvidesFromOtherPackage(*res.oldEntry);
-        } else {
+        if (!(res.id = txn.template get<0>(entry->name, *res.oldEntry))) {
             res.oldEntry.reset();
         }
     }
 
+    // retain certain information obtained from package contents if this is actually the same package as before
+    // note: The cold data of the existing entry is also needed if \a entry has just been retrieved from the cache (and therefore
+    //       lacks its cold data) to keep it.
+    const auto isCachedEntry = res.oldEntry == entry;
+    if (res.oldEntry) {
+        const auto hadPackageInfo = entry->packageInfo.has_value();
+        entry->addDepsAndProvidesFromOtherPackage(*res.oldEntry);
+        const auto tookOverPackageInfo = !hadPackageInfo && entry->packageInfo.has_value();
+        if ((isCachedEntry || tookOverPackageInfo || !isOldColdDataNeeded || isOldColdDataNeeded(res.id))
+            && !storage.getColdData(**txn.getTransactionHandle(), res.id, res.oldColdData)) {
+            // packages not migrated via rebuildDb() yet contain their cold data within the main record
+            res.oldColdData.takeFrom(*res.oldEntry);
+        }
+        if (tookOverPackageInfo && res.oldColdData.packageInfo) {
+            entry->packageInfo->files = res.oldColdData.packageInfo->files;
+        }
+    }
+
     // update package in storage
-    res.id = txn.put(*entry, res.id);
+    res.coldData.takeFrom(*entry);
+    if (isCachedEntry) {
+        res.coldData.addMissingFrom(res.oldColdData);
+    }
+    res.id = storage.putPackage(txn, *entry, res.coldData, res.id);
 
     // update cache entry
-    lock = std::unique_lock(m_mutex);
-    if (cacheEntry) {
-        cacheEntry->ref.entryName = &entry->name;
-    } else {
-        cacheEntry = &m_entries.insert(CacheEntry(ref, res.id));
-    }
-    cacheEntry->entry = entry;
-    lock.unlock();
+    insert(index, CacheEntry(ref, res.id), entry);
 
     res.updated = true;
     return res;
@@ -181,22 +348,31 @@ auto StorageCache<StorageEntriesType, StorageType, SpecType>::store(Storage &sto
 
 /*!
  * \brief Stores the specified \a entry with the specified \a storageID.
- * \remarks This is used to update an existing entry with a known ID.
+ * \remarks
+ * - This is used to update an existing entry with a known ID.
+ * - The cold data of \a entry is moved out of it into StoreResult::coldData. Parts of the cold data \a entry does
+ *   not contain (e.g. because it has been retrieved from the cache) are taken over from the stored cold data which
+ *   is loaded into StoreResult::oldColdData.
  */
 template <typename StorageEntriesType, typename StorageType, typename SpecType>
 auto StorageCache<StorageEntriesType, StorageType, SpecType>::store(
-    Storage &storage, RWTxn &txn, StorageID storageID, const std::shared_ptr<Entry> &entry) -> void
+    Storage &storage, RWTxn &txn, StorageID storageID, const std::shared_ptr<Entry> &entry) -> StoreResult
 {
+    auto res = StorageCache::StoreResult();
+    storage.getColdData(**txn.getTransactionHandle(), storageID, res.oldColdData);
+    res.coldData.takeFrom(*entry);
+    res.coldData.addMissingFrom(res.oldColdData);
+
     // update package in storage
-    const auto id = txn.put(*entry, storageID);
+    res.id = storage.putPackage(txn, *entry, res.coldData, storageID);
 
     // update cache entry
     using CacheEntry = typename Entries::StorageEntry;
-    using CacheRef = typename Entries::Ref;
-    const auto ref = CacheRef(storage, entry);
-    const auto lock = std::unique_lock(m_mutex);
-    const auto cacheEntry = &m_entries.insert(CacheEntry(ref, id));
-    cacheEntry->entry = entry;
+    const auto ref = Ref(storage, entry);
+    insert(shardIndex(ref), CacheEntry(ref, res.id), entry);
+
+    res.updated = true;
+    return res;
 }
 
 template <typename StorageEntriesType, typename StorageType, typename SpecType>
@@ -207,6 +383,7 @@ bool StorageCache<StorageEntriesType, StorageType, SpecType>::invalidate(Storage
     // remove package from storage
     auto txn = storage.packages.getRWTransaction();
     if (auto i = txn.template find<0>(entryName); i != txn.end()) {
+        storage.deletePackageColdData(txn, i.getID());
         i.del();
         txn.commit();
         return true;
@@ -217,9 +394,13 @@ bool StorageCache<StorageEntriesType, StorageType, SpecType>::invalidate(Storage
 template <typename StorageEntriesType, typename StorageType, typename SpecType>
 bool StorageCache<StorageEntriesType, StorageType, SpecType>::invalidateCacheOnly(Storage &storage, const std::string &entryName)
 {
-    const auto ref = typename Entries::Ref(storage, entryName);
-    const auto lock = std::unique_lock(m_mutex);
-    m_entries.erase(ref);
+    const auto ref = Ref(storage, entryName);
+    const auto index = shardIndex(ref);
+    auto &shard = m_shards[index];
+    auto evicted = typename Entries::EvictedIDs();
+    const auto lock = std::unique_lock(shard.mutex);
+    shard.entries.erase(ref, &evicted);
+    forgetIDs(index, evicted);
     return true;
 }
 
@@ -230,29 +411,53 @@ void StorageCache<StorageEntriesType, StorageType, SpecType>::clear(Storage &sto
     auto packagesTxn = storage.packages.getRWTransaction();
     auto txnHandle = packagesTxn.getTransactionHandle();
     packagesTxn.clear();
-    auto providedDepsTxn = storage.providedDeps.getRWTransaction(txnHandle);
-    providedDepsTxn.clear();
-    auto requiredDepsTxn = storage.requiredDeps.getRWTransaction(txnHandle);
-    requiredDepsTxn.clear();
-    auto providedLibsTxn = storage.providedLibs.getRWTransaction(txnHandle);
-    providedLibsTxn.clear();
-    auto requiredLibsTxn = storage.requiredLibs.getRWTransaction(txnHandle);
-    requiredLibsTxn.clear();
+    (*txnHandle)->clear(storage.packagesColdDbi);
+    storage.clearDependencies(**txnHandle);
+    storage.packageNameTrigrams.clear(**txnHandle);
+    storage.clearFileIndex(packagesTxn);
     packagesTxn.commit();
 }
 
 template <typename StorageEntriesType, typename StorageType, typename SpecType>
 void StorageCache<StorageEntriesType, StorageType, SpecType>::clearCacheOnly(Storage &storage)
 {
-    const auto lock = std::unique_lock(m_mutex);
-    m_entries.clear(storage);
+    for (auto &shard : m_shards) {
+        const auto lock = std::unique_lock(shard.mutex);
+        shard.entries.clear(storage);
+    }
+    for (auto &idShard : m_idShards) {
+        const auto lock = std::unique_lock(idShard.mutex);
+        std::erase_if(idShard.shardByID, [&storage](const auto &hint) { return hint.first.storage == &storage; });
+    }
 }
 
 template <typename StorageEntriesType, typename StorageType, typename SpecType>
 void StorageCache<StorageEntriesType, StorageType, SpecType>::setLimit(std::size_t limit)
 {
-    const auto lock = std::unique_lock(m_mutex);
-    m_entries.setLimit(limit);
+    const auto limitPerShard = limit / shardCount + (limit % shardCount ? 1 : 0);
+    for (auto index = std::size_t(); index != shardCount; ++index) {
+        auto &shard = m_shards[index];
+        auto evicted = typename Entries::EvictedIDs();
+        const auto lock = std::unique_lock(shard.mutex);
+        shard.entries.setLimit(limitPerShard, &evicted);
+        forgetIDs(index, evicted);
+    }
+}
+
+template <typename StorageEntriesType, typename StorageType, typename SpecType>
+StorageCacheStatistics StorageCache<StorageEntriesType, StorageType, SpecType>::statistics()
+{
+    auto stats = StorageCacheStatistics();
+    for (auto &shard : m_shards) {
+        const auto lock = std::shared_lock(shard.mutex);
+        stats.entries += shard.entries.size();
+        stats.size += shard.entries.memoryUsage();
+        stats.limit += shard.entries.limit();
+        stats.evictions += shard.entries.evictions();
+    }
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    return stats;
 }
 
 template struct StorageCacheRef<DatabaseStorage, Package>;
@@ -261,20 +466,1217 @@ template class StorageCacheEntries<PackageCacheEntry>;
 template struct StorageCache<PackageCacheEntries, PackageStorage, PackageSpec>;
 
 StorageDistribution::StorageDistribution(const char *path, std::uint32_t maxDbs)
+    : m_env(LMDBSafe::getMDBEnv(path, MDB_NOSUBDIR, 0600, maxDbs))
+    , m_compressionDbi(m_env->openDB("compression", MDB_CREATE))
+    , m_binaryInfoDbi(m_env->openDB("binaryinfo", MDB_CREATE))
+    , m_allProvides(m_env)
 {
-    m_env = LMDBSafe::getMDBEnv(path, MDB_NOSUBDIR, 0600, maxDbs);
+    // load dictionaries for compressing cold data and activate the configured one
+    auto txn = m_env->getROTransaction();
+    auto cursor = txn->getROCursor(m_compressionDbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    auto activeDictionaryID = std::uint32_t();
+    for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+        if (const auto keyString = key.get<std::string_view>(); keyString == "active") {
+            activeDictionaryID = value.get<std::uint32_t>();
+        } else if (keyString.starts_with("dictionary-")) {
+            m_compressionDictionaries.add(value.get<std::string_view>());
+        }
+    }
+    if (activeDictionaryID) {
+        m_compressionDictionaries.setActive(activeDictionaryID);
+    }
+}
+
+/*!
+ * \brief Stores \a dictionary and uses it for compressing cold data from now on; an empty \a dictionary disables compression.
+ * \remarks
+ * - Dictionaries are never deleted so records compressed with a previous dictionary can still be read.
+ * - Existing records are not touched. Use Database::rewriteColdData() to re-compress them.
+ */
+void StorageDistribution::setCompressionDictionary(std::string_view dictionary)
+{
+    auto txn = m_env->getRWTransaction();
+    if (dictionary.empty()) {
+        txn->del(m_compressionDbi, LMDBSafe::MDBInVal(std::string_view("active")));
+        txn->commit();
+        m_compressionDictionaries.setActive(0);
+        return;
+    }
+    const auto id = m_compressionDictionaries.add(dictionary);
+    txn->put(m_compressionDbi, LMDBSafe::MDBInVal(argsToString("dictionary-", id)), LMDBSafe::MDBInVal(dictionary));
+    txn->put(m_compressionDbi, LMDBSafe::MDBInVal(std::string_view("active")), LMDBSafe::MDBInVal(id));
+    txn->commit();
+    m_compressionDictionaries.setActive(id);
 }
 
-DatabaseStorage::DatabaseStorage(const std::shared_ptr<LMDBSafe::MDBEnv> &env, PackageCache &packageCache, std::string_view uniqueDatabaseName)
+std::unique_ptr<DatabaseStorage> StorageDistribution::forDatabase(std::string_view uniqueDatabaseName)
+{
+    return std::make_unique<DatabaseStorage>(m_env, m_packageCache, m_allProvides, m_compressionDictionaries, uniqueDatabaseName);
+}
+
+/*!
+ * \brief Opens the tables of the database with the specified \a uniqueDatabaseName.
+ * \remarks
+ * If packages have been stored by a version which did not have some of the indexes yet, the missing indexes are built
+ * from all packages of the database right away. This happens only once but within one read-write transaction so the
+ * startup takes considerably longer (in the order of seconds for big databases like "extra") and no other writes to the
+ * storage are possible meanwhile. When the indexes of dependencies are built that way the tables former versions used
+ * to store dependencies are dropped as well.
+ */
+DatabaseStorage::DatabaseStorage(const std::shared_ptr<LMDBSafe::MDBEnv> &env, PackageCache &packageCache, ProvidesIndex &allProvides,
+    CompressionDictionaries &compressionDictionaries, std::string_view uniqueDatabaseName)
     : packageCache(packageCache)
+    , allProvides(allProvides)
     , packages(env, argsToString(uniqueDatabaseName, "_packages"))
-    , providedDeps(env, argsToString(uniqueDatabaseName, "_provides"))
-    , requiredDeps(env, argsToString(uniqueDatabaseName, "_requires"))
-    , providedLibs(env, argsToString(uniqueDatabaseName, "_libprovides"))
-    , requiredLibs(env, argsToString(uniqueDatabaseName, "_librequires"))
+    , packagesDbi(env->openDB(argsToString(uniqueDatabaseName, "_packages"), MDB_CREATE))
+    , packagesColdDbi(env->openDB(argsToString(uniqueDatabaseName, "_packagescold"), MDB_CREATE))
+    , compressionDictionaries(compressionDictionaries)
+    , providedDeps(env, argsToString(uniqueDatabaseName, "_provideddeps"))
+    , requiredDeps(env, argsToString(uniqueDatabaseName, "_requireddeps"))
+    , providedLibs(env, argsToString(uniqueDatabaseName, "_providedlibs"))
+    , requiredLibs(env, argsToString(uniqueDatabaseName, "_requiredlibs"))
+    , packageNameTrigrams(env, argsToString(uniqueDatabaseName, "_trigrams"))
+    , filePathsDbi(env->openDB(argsToString(uniqueDatabaseName, "_filepaths"), MDB_CREATE | MDB_DUPSORT))
+    , fileNamesDbi(env->openDB(argsToString(uniqueDatabaseName, "_filenames"), MDB_CREATE | MDB_DUPSORT))
     , m_env(env)
+    , m_uniqueDatabaseName(uniqueDatabaseName)
 {
     std::cout << EscapeCodes::Phrases::InfoMessage << "Initialized database storage for \"" << uniqueDatabaseName << "\"\n";
+
+    // build indexes if packages have been stored before the indexes existed
+    // note: Every package provides at least its own name so the index of provided dependencies is never empty if there are packages.
+    auto buildDependencies = false, buildTrigrams = false, buildFileIndex = false, hasPackages = false;
+    {
+        auto txn = packages.getROTransaction();
+        auto &txnHandle = **txn.getTransactionHandle();
+        databaseID = allProvides.findDatabaseID(txnHandle, uniqueDatabaseName);
+        if ((hasPackages = txn.size())) {
+            buildDependencies = providedDeps.empty(txnHandle);
+            buildTrigrams = packageNameTrigrams.empty(txnHandle);
+            buildFileIndex = isFileIndexMissing(txn);
+        }
+    }
+    if (databaseID && !buildDependencies && !buildTrigrams && !buildFileIndex) {
+        return;
+    }
+    auto txn = packages.getRWTransaction();
+    if (!databaseID) {
+        // add provides to the index of all databases (within the same transaction so they can not get out of sync)
+        auto &txnHandle = **txn.getTransactionHandle();
+        databaseID = allProvides.assignDatabaseID(txnHandle, uniqueDatabaseName);
+        if (hasPackages && !buildDependencies) {
+            providedDeps.forEach(txnHandle, [this, &txnHandle](const DependencyIndexEntry &entry) {
+                allProvides.add(txnHandle, databaseID, entry.name, entry.packageID, entry.version, entry.mode);
+                return false;
+            });
+            std::cout << EscapeCodes::Phrases::InfoMessage << "Added provides of \"" << uniqueDatabaseName << "\" to index of all databases\n";
+        }
+    }
+    if (buildDependencies) {
+        const auto packageCount = rebuildDependencies(txn);
+        std::cout << EscapeCodes::Phrases::InfoMessage << "Built indexes of dependencies for \"" << uniqueDatabaseName << "\" (" << packageCount
+                  << " packages)\n";
+        if (const auto legacyTables = dropLegacyDependencyTables(txn)) {
+            std::cout << EscapeCodes::Phrases::InfoMessage << "Dropped " << legacyTables << " tables of \"" << uniqueDatabaseName
+                      << "\" used by former versions to store dependencies\n";
+        }
+    }
+    if (buildTrigrams) {
+        const auto trigramCount = rebuildNameTrigrams(txn);
+        std::cout << EscapeCodes::Phrases::InfoMessage << "Built index of package names for \"" << uniqueDatabaseName << "\" (" << trigramCount
+                  << " trigrams)\n";
+    }
+    if (buildFileIndex) {
+        const auto packageCount = rebuildFileIndex(txn);
+        std::cout << EscapeCodes::Phrases::InfoMessage << "Built index of files for \"" << uniqueDatabaseName << "\" (" << packageCount << " packages with files)\n";
+    }
+    txn.commit();
+}
+
+/*!
+ * \brief Stores \a coldData under the specified \a packageID compressing it with the active dictionary (if any).
+ */
+void DatabaseStorage::putColdData(LMDBSafe::MDBRWTransactionImpl &txn, StorageID packageID, const PackageColdData &coldData)
+{
+    const auto record = compressionDictionaries.compress(LMDBSafe::serToString<PackageColdData>(coldData));
+    txn.put(packagesColdDbi, LMDBSafe::MDBInVal(packageID), LMDBSafe::MDBInVal(std::string_view(record)));
+}
+
+/// \cond
+namespace {
+void decodeColdData(const CompressionDictionaries &dictionaries, std::string_view record, PackageColdData &coldData)
+{
+    if (CompressionDictionaries::isCompressed(record)) {
+        LMDBSafe::serFromString<PackageColdData>(dictionaries.decompress(record), coldData);
+    } else {
+        LMDBSafe::serFromString<PackageColdData>(record, coldData);
+    }
+}
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Reads the cold data stored under the specified \a packageID into \a coldData decompressing it if necessary.
+ * \returns Returns whether cold data is stored under \a packageID.
+ */
+bool DatabaseStorage::getColdData(LMDBSafe::MDBROTransactionImpl &txn, StorageID packageID, PackageColdData &coldData)
+{
+    auto value = LMDBSafe::MDBOutVal();
+    if (txn.get(packagesColdDbi, LMDBSafe::MDBInVal(packageID), value) == MDB_NOTFOUND) {
+        return false;
+    }
+    decodeColdData(compressionDictionaries, value.get<std::string_view>(), coldData);
+    return true;
+}
+
+/*!
+ * \brief Invokes \a visitor for all cold data stored within \a txn in the order of the package IDs.
+ * \remarks Stops when \a visitor returns true.
+ */
+void DatabaseStorage::forEachColdData(LMDBSafe::MDBROTransactionImpl &txn, const std::function<bool(StorageID, PackageColdData &&)> &visitor)
+{
+    auto cursor = txn.getROCursor(packagesColdDbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+        auto coldData = PackageColdData();
+        decodeColdData(compressionDictionaries, value.get<std::string_view>(), coldData);
+        if (visitor(key.get<StorageID>(), std::move(coldData))) {
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief Returns the IDs of all packages cold data is stored for within \a txn.
+ */
+std::vector<StorageID> DatabaseStorage::coldDataIDs(LMDBSafe::MDBROTransactionImpl &txn)
+{
+    auto packageIDs = std::vector<StorageID>();
+    auto cursor = txn.getROCursor(packagesColdDbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+        packageIDs.emplace_back(key.get<StorageID>());
+    }
+    return packageIDs;
+}
+
+/*!
+ * \brief Stores the specified \a package and its \a coldData which is kept in a separate table.
+ * \remarks The cold data is supposed to be moved out of \a package before via PackageColdData::takeFrom().
+ * \returns Returns the ID of the package.
+ */
+StorageID DatabaseStorage::putPackage(
+    PackageStorage::RWTransaction &txn, const Package &package, const PackageColdData &coldData, StorageID packageID)
+{
+    packageID = txn.put(package, packageID);
+    if (coldData.empty()) {
+        deletePackageColdData(txn, packageID);
+    } else {
+        putColdData(**txn.getTransactionHandle(), packageID, coldData);
+    }
+    return packageID;
+}
+
+/*!
+ * \brief Deletes the cold data of the package with the specified \a packageID.
+ * \remarks This needs to be called when deleting the package itself.
+ */
+void DatabaseStorage::deletePackageColdData(PackageStorage::RWTransaction &txn, StorageID packageID)
+{
+    (*txn.getTransactionHandle())->del(packagesColdDbi, LMDBSafe::MDBInVal(packageID));
+}
+
+/*!
+ * \brief Loads the cold data of the package with the specified \a packageID into \a package.
+ * \remarks
+ * Packages which have not been migrated via rebuildDb() yet still contain their cold data within the
+ * main table. In this case no separate cold data exists and \a package is left as-is.
+ */
+template <typename PackagesTransaction> bool DatabaseStorage::loadPackageColdData(PackagesTransaction &txn, StorageID packageID, Package &package)
+{
+    auto coldData = PackageColdData();
+    const auto found = getColdData(**txn.getTransactionHandle(), packageID, coldData);
+    if (found) {
+        coldData.moveTo(package);
+    }
+    return found;
+}
+
+template bool DatabaseStorage::loadPackageColdData(PackageStorage::ROTransaction &txn, StorageID packageID, Package &package);
+
+/// \cond
+namespace {
+
+/*!
+ * \brief The maximum key size of LMDB (with its default build configuration).
+ * \remarks With MDB_DUPSORT this also applies to the data.
+ */
+constexpr auto maxKeySize = std::size_t(511);
+
+/*!
+ * \brief The size of the mode and the package ID following the version within an entry of a DependencyIndex.
+ */
+constexpr auto dependencyIndexSuffixSize = std::size_t(1 + sizeof(StorageID));
+
+inline void appendBigEndian(std::string &data, std::uint32_t value)
+{
+    for (auto shift = 24; shift >= 0; shift -= 8) {
+        data += static_cast<char>((value >> shift) & 0xFF);
+    }
+}
+
+inline std::uint32_t readBigEndian(std::string_view data)
+{
+    auto value = std::uint32_t();
+    for (const auto c : data.substr(0, 4)) {
+        value = (value << 8) | static_cast<unsigned char>(c);
+    }
+    return value;
+}
+
+/*!
+ * \brief Returns the data stored within a DependencyIndex for the specified \a version, \a mode and \a packageID.
+ * \remarks
+ * - The \a databaseID is prepended if non-zero (for the ProvidesIndex).
+ * - Returns an empty string if the version is too long to be indexed.
+ */
+std::string encodeDependencyIndexEntry(std::string_view version, DependencyMode mode, StorageID packageID, std::uint32_t databaseID = 0)
+{
+    auto entry = std::string();
+    const auto prefixSize = databaseID ? sizeof(databaseID) : std::size_t();
+    if (prefixSize + version.size() + 1 + dependencyIndexSuffixSize > maxKeySize) {
+        return entry;
+    }
+    entry.reserve(prefixSize + version.size() + 1 + dependencyIndexSuffixSize);
+    if (databaseID) {
+        appendBigEndian(entry, databaseID);
+    }
+    entry.append(version);
+    entry += '\0';
+    entry += static_cast<char>(mode);
+    appendBigEndian(entry, packageID);
+    return entry;
+}
+
+/*!
+ * \brief Populates \a entry from the specified \a data stored within a DependencyIndex.
+ * \returns Returns whether \a data is valid.
+ */
+bool decodeDependencyIndexEntry(std::string_view data, DependencyIndexEntry &entry)
+{
+    if (data.size() < 1 + dependencyIndexSuffixSize) {
+        return false;
+    }
+    const auto suffix = data.substr(data.size() - dependencyIndexSuffixSize);
+    entry.version = data.substr(0, data.size() - dependencyIndexSuffixSize - 1);
+    entry.mode = static_cast<DependencyMode>(suffix.front());
+    entry.packageID = readBigEndian(suffix.substr(1));
+    return true;
+}
+
+inline bool isIndexableName(std::string_view name)
+{
+    return !name.empty();
+}
+
+/*!
+ * \brief Returns the key under which \a name is stored within a DependencyIndex or ProvidesIndex.
+ * \remarks
+ * - Names exceeding the maximum key size are stored under their prefix followed by the FNV-1a hash of the whole name (as
+ *   hex string). The key is then stored within \a buffer.
+ * - Keys read from an index are returned as-is so they can be passed to the functions of the index again.
+ */
+std::string_view indexKey(std::string_view name, std::string &buffer)
+{
+    if (name.size() <= maxKeySize) {
+        return name;
+    }
+    constexpr auto hashSize = std::size_t(16);
+    auto hash = std::uint64_t(0xcbf29ce484222325);
+    for (const auto c : name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * std::uint64_t(0x100000001b3);
+    }
+    buffer.reserve(maxKeySize);
+    buffer.assign(name.substr(0, maxKeySize - hashSize));
+    for (auto shift = static_cast<int>(hashSize * 4 - 4); shift >= 0; shift -= 4) {
+        buffer += "0123456789abcdef"[(hash >> shift) & 0xF];
+    }
+    return buffer;
+}
+
+void warnAboutUnindexableVersion(std::string_view name, StorageID packageID, std::string_view version)
+{
+    std::cerr << EscapeCodes::Phrases::WarningMessage << "Unable to index \"" << name << "\" of package " << packageID << ": version is "
+              << version.size() << " bytes long which exceeds the maximum size" << EscapeCodes::Phrases::End;
+}
+
+} // namespace
+/// \endcond
+
+DependencyIndex::DependencyIndex(const std::shared_ptr<LMDBSafe::MDBEnv> &env, const std::string &tableName)
+    : dbi(env->openDB(tableName, MDB_CREATE | MDB_DUPSORT))
+{
+}
+
+/*!
+ * \brief Adds an entry for the package with the specified \a packageID to the entries of \a name.
+ * \remarks Adding an existing entry has no effect.
+ */
+void DependencyIndex::add(LMDBSafe::MDBRWTransactionImpl &txn, std::string_view name, StorageID packageID, std::string_view version, DependencyMode mode)
+{
+    if (!isIndexableName(name)) {
+        return;
+    }
+    if (const auto entry = encodeDependencyIndexEntry(version, mode, packageID); !entry.empty()) {
+        auto keyBuffer = std::string();
+        txn.put(dbi, LMDBSafe::MDBInVal(indexKey(name, keyBuffer)), LMDBSafe::MDBInVal(std::string_view(entry)));
+    } else {
+        warnAboutUnindexableVersion(name, packageID, version);
+    }
+}
+
+/*!
+ * \brief Removes the entry for the package with the specified \a packageID from the entries of \a name.
+ * \remarks Removing a non-existing entry has no effect. Entries of other packages are not touched.
+ */
+void DependencyIndex::remove(
+    LMDBSafe::MDBRWTransactionImpl &txn, std::string_view name, StorageID packageID, std::string_view version, DependencyMode mode)
+{
+    if (!isIndexableName(name)) {
+        return;
+    }
+    if (const auto entry = encodeDependencyIndexEntry(version, mode, packageID); !entry.empty()) {
+        auto keyBuffer = std::string();
+        txn.del(dbi, LMDBSafe::MDBInVal(indexKey(name, keyBuffer)), LMDBSafe::MDBInVal(std::string_view(entry)));
+    }
+}
+
+void DependencyIndex::clear(LMDBSafe::MDBRWTransactionImpl &txn)
+{
+    txn.clear(dbi);
+}
+
+/*!
+ * \brief Adds an entry for the package with the specified \a packageID to \a entries for loading it via bulkLoad().
+ * \remarks The \a name must stay valid until bulkLoad() has been called.
+ */
+void DependencyIndex::addToBulk(BulkEntries &entries, std::string_view name, StorageID packageID, std::string_view version, DependencyMode mode)
+{
+    if (!isIndexableName(name)) {
+        return;
+    }
+    auto entry = encodeDependencyIndexEntry(version, mode, packageID);
+    if (entry.empty()) {
+        warnAboutUnindexableVersion(name, packageID, version);
+        return;
+    }
+    if (name.size() > maxKeySize) {
+        auto keyBuffer = std::string();
+        indexKey(name, keyBuffer);
+        name = entries.hashedNames.emplace_back(std::move(keyBuffer));
+    }
+    entries.entries.emplace_back(name, std::move(entry));
+}
+
+/*!
+ * \brief Adds the specified \a entries to the index which must be empty.
+ * \remarks
+ * - The \a entries are sorted in the order LMDB uses for keys and duplicates (which is the order of std::string_view and
+ *   std::string) and written via MDB_APPEND/MDB_APPENDDUP. This way LMDB skips looking up where to put each entry and
+ *   fills pages completely which makes populating an index from scratch a lot faster than adding entries one by one.
+ * - The \a entries are cleared.
+ */
+void DependencyIndex::bulkLoad(LMDBSafe::MDBRWTransactionImpl &txn, BulkEntries &entries)
+{
+    auto &sortedEntries = entries.entries;
+    std::sort(sortedEntries.begin(), sortedEntries.end());
+    sortedEntries.erase(std::unique(sortedEntries.begin(), sortedEntries.end()), sortedEntries.end());
+    auto previousName = std::string_view();
+    for (const auto &[name, entry] : sortedEntries) {
+        txn.put(dbi, LMDBSafe::MDBInVal(name), LMDBSafe::MDBInVal(std::string_view(entry)), name == previousName ? MDB_APPENDDUP : MDB_APPEND);
+        previousName = name;
+    }
+    sortedEntries.clear();
+    entries.hashedNames.clear();
+}
+
+/*!
+ * \brief Returns whether there is at least one entry for \a name.
+ */
+bool DependencyIndex::contains(LMDBSafe::MDBROTransactionImpl &txn, std::string_view name)
+{
+    if (!isIndexableName(name)) {
+        return false;
+    }
+    auto keyBuffer = std::string();
+    auto value = LMDBSafe::MDBOutVal();
+    return txn.get(dbi, LMDBSafe::MDBInVal(indexKey(name, keyBuffer)), value) != MDB_NOTFOUND;
+}
+
+bool DependencyIndex::empty(LMDBSafe::MDBROTransactionImpl &txn)
+{
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    return txn.getROCursor(dbi).first(key, value) == MDB_NOTFOUND;
+}
+
+/*!
+ * \brief Visits the entries of \a name ordered by version, mode and package ID.
+ * \remarks Stops when \a visitor returns true.
+ */
+void DependencyIndex::forEach(LMDBSafe::MDBROTransactionImpl &txn, std::string_view name, const Visitor &visitor)
+{
+    if (!isIndexableName(name)) {
+        return;
+    }
+    auto keyBuffer = std::string();
+    auto cursor = txn.getROCursor(dbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    auto entry = DependencyIndexEntry{ .name = name };
+    for (auto rc = cursor.find(LMDBSafe::MDBInVal(indexKey(name, keyBuffer)), key, value); rc != MDB_NOTFOUND; rc = cursor.get(key, value, MDB_NEXT_DUP)) {
+        if (decodeDependencyIndexEntry(value.get<std::string_view>(), entry) && visitor(entry)) {
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief Visits all entries ordered by name, version, mode and package ID.
+ * \remarks Stops when \a visitor returns true.
+ */
+void DependencyIndex::forEach(LMDBSafe::MDBROTransactionImpl &txn, const Visitor &visitor)
+{
+    auto cursor = txn.getROCursor(dbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    auto entry = DependencyIndexEntry();
+    for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+        entry.name = key.get<std::string_view>();
+        if (decodeDependencyIndexEntry(value.get<std::string_view>(), entry) && visitor(entry)) {
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief Visits all entries with names within [\a begin, \a end) ordered by name, version, mode and package ID.
+ * \remarks
+ * - An empty \a begin means the range starts at the first name, an empty \a end means the range ends after the last name.
+ * - Stops when \a visitor returns true.
+ */
+void DependencyIndex::forEachInRange(LMDBSafe::MDBROTransactionImpl &txn, std::string_view begin, std::string_view end, const Visitor &visitor)
+{
+    auto cursor = txn.getROCursor(dbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    auto entry = DependencyIndexEntry();
+    for (auto rc = begin.empty() ? cursor.first(key, value) : cursor.lower_bound(LMDBSafe::MDBInVal(begin), key, value); rc != MDB_NOTFOUND;
+         rc = cursor.next(key, value)) {
+        entry.name = key.get<std::string_view>();
+        if (!end.empty() && entry.name >= end) {
+            return;
+        }
+        if (decodeDependencyIndexEntry(value.get<std::string_view>(), entry) && visitor(entry)) {
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief Splits the names into up to \a partCount ranges with roughly the same number of names.
+ * \returns Returns the first name of each range except the first one; the ranges can be passed to forEachInRange().
+ * \remarks All entries of a name end up within the same range.
+ */
+std::vector<std::string> DependencyIndex::partition(LMDBSafe::MDBROTransactionImpl &txn, std::size_t partCount)
+{
+    auto names = std::vector<std::string_view>();
+    auto boundaries = std::vector<std::string>();
+    if (partCount < 2) {
+        return boundaries;
+    }
+    auto cursor = txn.getROCursor(dbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.get(key, value, MDB_NEXT_NODUP)) {
+        names.emplace_back(key.get<std::string_view>());
+    }
+    partCount = std::min(partCount, names.size());
+    boundaries.reserve(partCount ? partCount - 1 : 0);
+    for (auto part = std::size_t(1); part < partCount; ++part) {
+        boundaries.emplace_back(names[names.size() * part / partCount]);
+    }
+    return boundaries;
+}
+
+ProvidesIndex::ProvidesIndex(const std::shared_ptr<LMDBSafe::MDBEnv> &env)
+    : dbi(env->openDB("allprovides", MDB_CREATE | MDB_DUPSORT))
+    , databasesDbi(env->openDB("databaseids", MDB_CREATE))
+{
+}
+
+/*!
+ * \brief Returns the ID of the database with the specified \a uniqueDatabaseName or zero if none has been assigned yet.
+ */
+std::uint32_t ProvidesIndex::findDatabaseID(LMDBSafe::MDBROTransactionImpl &txn, std::string_view uniqueDatabaseName)
+{
+    auto value = LMDBSafe::MDBOutVal();
+    return txn.get(databasesDbi, LMDBSafe::MDBInVal(uniqueDatabaseName), value) != MDB_NOTFOUND ? value.get<std::uint32_t>() : 0;
+}
+
+/*!
+ * \brief Returns the ID of the database with the specified \a uniqueDatabaseName assigning a new one if none has been assigned yet.
+ */
+std::uint32_t ProvidesIndex::assignDatabaseID(LMDBSafe::MDBRWTransactionImpl &txn, std::string_view uniqueDatabaseName)
+{
+    if (const auto existingID = findDatabaseID(txn, uniqueDatabaseName)) {
+        return existingID;
+    }
+    // assign IDs sequentially; there are only a few databases so counting them is cheap
+    auto cursor = txn.getROCursor(databasesDbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    auto id = std::uint32_t(1);
+    for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+        id = std::max(id, value.get<std::uint32_t>() + 1);
+    }
+    txn.put(databasesDbi, LMDBSafe::MDBInVal(uniqueDatabaseName), LMDBSafe::MDBInVal(id));
+    return id;
+}
+
+void ProvidesIndex::add(LMDBSafe::MDBRWTransactionImpl &txn, std::uint32_t databaseID, std::string_view name, StorageID packageID,
+    std::string_view version, DependencyMode mode)
+{
+    if (!isIndexableName(name)) {
+        return;
+    }
+    if (const auto entry = encodeDependencyIndexEntry(version, mode, packageID, databaseID); !entry.empty()) {
+        auto keyBuffer = std::string();
+        txn.put(dbi, LMDBSafe::MDBInVal(indexKey(name, keyBuffer)), LMDBSafe::MDBInVal(std::string_view(entry)));
+    }
+}
+
+void ProvidesIndex::remove(LMDBSafe::MDBRWTransactionImpl &txn, std::uint32_t databaseID, std::string_view name, StorageID packageID,
+    std::string_view version, DependencyMode mode)
+{
+    if (!isIndexableName(name)) {
+        return;
+    }
+    if (const auto entry = encodeDependencyIndexEntry(version, mode, packageID, databaseID); !entry.empty()) {
+        auto keyBuffer = std::string();
+        txn.del(dbi, LMDBSafe::MDBInVal(indexKey(name, keyBuffer)), LMDBSafe::MDBInVal(std::string_view(entry)));
+    }
+}
+
+/*!
+ * \brief Visits the entries of \a name ordered by database ID, version, mode and package ID.
+ * \remarks Stops when \a visitor returns true.
+ */
+void ProvidesIndex::forEach(LMDBSafe::MDBROTransactionImpl &txn, std::string_view name, const Visitor &visitor)
+{
+    if (!isIndexableName(name)) {
+        return;
+    }
+    auto keyBuffer = std::string();
+    auto cursor = txn.getROCursor(dbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    auto entry = DependencyIndexEntry{ .name = name };
+    for (auto rc = cursor.find(LMDBSafe::MDBInVal(indexKey(name, keyBuffer)), key, value); rc != MDB_NOTFOUND; rc = cursor.get(key, value, MDB_NEXT_DUP)) {
+        const auto data = value.get<std::string_view>();
+        if (data.size() > sizeof(std::uint32_t) && decodeDependencyIndexEntry(data.substr(sizeof(std::uint32_t)), entry)
+            && visitor(readBigEndian(data), entry)) {
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief Removes the databases for which \a isObsolete returns true from the index, including all of their entries.
+ * \returns Returns the number of removed databases.
+ * \remarks This needs to scan all entries but it is only required when databases are removed from the configuration.
+ */
+std::size_t ProvidesIndex::removeDatabases(LMDBSafe::MDBRWTransactionImpl &txn, const std::function<bool(std::uint32_t databaseID)> &isObsolete)
+{
+    auto obsoleteNames = std::vector<std::string>();
+    auto obsoleteIDs = std::unordered_set<std::uint32_t>();
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    {
+        auto cursor = txn.getROCursor(databasesDbi);
+        for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+            if (const auto id = value.get<std::uint32_t>(); isObsolete(id)) {
+                obsoleteNames.emplace_back(key.get<std::string_view>());
+                obsoleteIDs.emplace(id);
+            }
+        }
+    }
+    if (obsoleteIDs.empty()) {
+        return 0;
+    }
+    auto obsoleteEntries = std::vector<std::pair<std::string, std::string>>();
+    {
+        auto cursor = txn.getROCursor(dbi);
+        for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+            if (const auto data = value.get<std::string_view>(); data.size() > sizeof(std::uint32_t) && obsoleteIDs.contains(readBigEndian(data))) {
+                obsoleteEntries.emplace_back(key.get<std::string_view>(), data);
+            }
+        }
+    }
+    for (const auto &[name, data] : obsoleteEntries) {
+        txn.del(dbi, LMDBSafe::MDBInVal(std::string_view(name)), LMDBSafe::MDBInVal(std::string_view(data)));
+    }
+    for (const auto &name : obsoleteNames) {
+        txn.del(databasesDbi, LMDBSafe::MDBInVal(std::string_view(name)));
+    }
+    return obsoleteNames.size();
+}
+
+/*!
+ * \brief Adds the dependencies and libraries provided/required by the specified \a package to the indexes.
+ * \remarks A package always provides itself (with its version).
+ */
+void DatabaseStorage::addPackageDependencies(LMDBSafe::MDBRWTransactionImpl &txn, StorageID packageID, const Package &package)
+{
+    providedDeps.add(txn, package.name, packageID, package.version);
+    allProvides.add(txn, databaseID, package.name, packageID, package.version);
+    for (const auto &dep : package.provides) {
+        providedDeps.add(txn, dep.name, packageID, dep.version, dep.mode);
+        allProvides.add(txn, databaseID, dep.name, packageID, dep.version, dep.mode);
+    }
+    for (const auto &dep : package.dependencies) {
+        requiredDeps.add(txn, dep.name, packageID, dep.version, dep.mode);
+    }
+    for (const auto &dep : package.optionalDependencies) {
+        requiredDeps.add(txn, dep.name, packageID, dep.version, dep.mode);
+    }
+    for (const auto &lib : package.libprovides) {
+        providedLibs.add(txn, lib, packageID);
+    }
+    for (const auto &lib : package.libdepends) {
+        requiredLibs.add(txn, lib, packageID);
+    }
+    addToProvidesFilter(package);
+}
+
+/*!
+ * \brief Removes the dependencies and libraries provided/required by the specified \a package from the indexes.
+ */
+void DatabaseStorage::removePackageDependencies(LMDBSafe::MDBRWTransactionImpl &txn, StorageID packageID, const Package &package)
+{
+    providedDeps.remove(txn, package.name, packageID, package.version);
+    allProvides.remove(txn, databaseID, package.name, packageID, package.version);
+    for (const auto &dep : package.provides) {
+        providedDeps.remove(txn, dep.name, packageID, dep.version, dep.mode);
+        allProvides.remove(txn, databaseID, dep.name, packageID, dep.version, dep.mode);
+    }
+    for (const auto &dep : package.dependencies) {
+        requiredDeps.remove(txn, dep.name, packageID, dep.version, dep.mode);
+    }
+    for (const auto &dep : package.optionalDependencies) {
+        requiredDeps.remove(txn, dep.name, packageID, dep.version, dep.mode);
+    }
+    for (const auto &lib : package.libprovides) {
+        providedLibs.remove(txn, lib, packageID);
+    }
+    for (const auto &lib : package.libdepends) {
+        requiredLibs.remove(txn, lib, packageID);
+    }
+}
+
+/*!
+ * \brief Removes all entries from the indexes of dependencies and libraries.
+ * \remarks
+ * - The entries of this database are removed from the index of all databases as well.
+ * - The trigram index of package names is not affected.
+ */
+void DatabaseStorage::clearDependencies(LMDBSafe::MDBRWTransactionImpl &txn)
+{
+    providedDeps.forEach(txn, [this, &txn](const DependencyIndexEntry &entry) {
+        allProvides.remove(txn, databaseID, entry.name, entry.packageID, entry.version, entry.mode);
+        return false;
+    });
+    providedDeps.clear(txn);
+    requiredDeps.clear(txn);
+    providedLibs.clear(txn);
+    requiredLibs.clear(txn);
+    invalidateProvidesFilter();
+}
+
+/*!
+ * \brief Returns whether a package might provide the dependency or library with the specified \a name; returns false
+ *        only if no package provides it.
+ * \remarks
+ * - Checks the in-memory Bloom filter over the names within providedDeps and providedLibs so most negative lookups need
+ *   no LMDB lookup. The filter is (re)built on the first call after it has been invalidated.
+ * - Building the filter requires the update lock so it is never built from a state which is about to change. If the
+ *   database is being updated this function returns true and the caller needs to consult the indexes.
+ * - Removals are not applied to the filter so it might yield further false positives until the next rebuild.
+ */
+bool DatabaseStorage::mightProvide(std::string_view name)
+{
+    auto keyBuffer = std::string();
+    name = indexKey(name, keyBuffer);
+    {
+        const auto lock = std::shared_lock(providesFilterMutex);
+        if (isProvidesFilterValid) {
+            return providesFilter.mightContain(name);
+        }
+    }
+    const auto updateLock = std::unique_lock(updateMutex, std::try_to_lock);
+    if (!updateLock) {
+        return true;
+    }
+
+    // collect hashes of the distinct names first to size the filter; entries are sorted by name
+    auto hashes = std::vector<std::uint64_t>();
+    auto txn = packages.getROTransaction();
+    auto &txnHandle = **txn.getTransactionHandle();
+    for (auto *const index : { &providedDeps, &providedLibs }) {
+        auto previousName = std::string();
+        auto first = true;
+        index->forEach(txnHandle, [&](const DependencyIndexEntry &entry) {
+            if (first || entry.name != previousName) {
+                first = false;
+                previousName = entry.name;
+                hashes.emplace_back(BloomFilter::hash(entry.name));
+            }
+            return false;
+        });
+    }
+    auto filter = BloomFilter(hashes.size());
+    for (const auto hash : hashes) {
+        filter.add(hash);
+    }
+
+    const auto lock = std::unique_lock(providesFilterMutex);
+    providesFilter = std::move(filter);
+    isProvidesFilterValid = true;
+    return providesFilter.mightContain(name);
+}
+
+/*!
+ * \brief Adds the names provided by \a package to the Bloom filter used by mightProvide().
+ * \remarks The update lock must be acquired.
+ */
+void DatabaseStorage::addToProvidesFilter(const Package &package)
+{
+    const auto lock = std::unique_lock(providesFilterMutex);
+    if (!isProvidesFilterValid) {
+        return;
+    }
+    auto keyBuffer = std::string();
+    providesFilter.add(indexKey(package.name, keyBuffer));
+    for (const auto &dep : package.provides) {
+        providesFilter.add(indexKey(dep.name, keyBuffer));
+    }
+    for (const auto &lib : package.libprovides) {
+        providesFilter.add(indexKey(lib, keyBuffer));
+    }
+}
+
+/*!
+ * \brief Invalidates the Bloom filter used by mightProvide() so it is rebuilt on the next call.
+ * \remarks The update lock must be acquired.
+ */
+void DatabaseStorage::invalidateProvidesFilter()
+{
+    const auto lock = std::unique_lock(providesFilterMutex);
+    isProvidesFilterValid = false;
+    providesFilter = BloomFilter();
+}
+
+/*!
+ * \brief Re-creates the indexes of dependencies and libraries from the packages present within \a txn.
+ * \returns Returns the number of packages.
+ */
+std::size_t DatabaseStorage::rebuildDependencies(PackageStorage::RWTransaction &txn)
+{
+    auto &txnHandle = **txn.getTransactionHandle();
+    clearDependencies(txnHandle);
+    auto packageCount = std::size_t();
+    const auto end = txn.end();
+    for (auto i = txn.begin(); i != end; ++i, ++packageCount) {
+        addPackageDependencies(txnHandle, i.getID(), i.value());
+    }
+    return packageCount;
+}
+
+/*!
+ * \brief Drops the tables used to store dependencies, libraries and trigrams before the indexes were using MDB_DUPSORT.
+ * \returns Returns the number of such tables which were present.
+ */
+std::size_t DatabaseStorage::dropLegacyDependencyTables(PackageStorage::RWTransaction &txn)
+{
+    auto &txnHandle = **txn.getTransactionHandle();
+    auto dropped = std::size_t();
+    for (const auto *const table : { "_provides", "_requires", "_libprovides", "_librequires", "_nametrigrams" }) {
+        for (const auto *const suffix : { "", "_0" }) {
+            auto dbi = MDB_dbi();
+            try {
+                dbi = txnHandle.openDB(argsToString(m_uniqueDatabaseName, table, suffix), 0);
+            } catch (const std::runtime_error &) {
+                // the table does not exist (anymore)
+                continue;
+            }
+            // note: lmdb-safe only allows emptying a table so mdb_drop() is used directly to delete it (which also closes the DBI)
+            if (const auto rc = mdb_drop(txnHandle, dbi, 1)) {
+                throw std::runtime_error(argsToString("Unable to drop table \"", m_uniqueDatabaseName, table, suffix, "\": ", mdb_strerror(rc)));
+            }
+            ++dropped;
+        }
+    }
+    return dropped;
+}
+
+/*!
+ * \brief Re-creates the trigram index of package names from the packages present within \a txn.
+ * \returns Returns the number of distinct trigrams.
+ */
+std::size_t DatabaseStorage::rebuildNameTrigrams(PackageStorage::RWTransaction &txn)
+{
+    auto &txnHandle = **txn.getTransactionHandle();
+    packageNameTrigrams.clear(txnHandle);
+    auto trigrams = std::unordered_set<std::string>();
+    const auto end = txn.end();
+    for (auto i = txn.begin(); i != end; ++i) {
+        for (auto &trigram : nameTrigrams(i.value().name)) {
+            packageNameTrigrams.add(txnHandle, trigram, i.getID());
+            trigrams.emplace(std::move(trigram));
+        }
+    }
+    return trigrams.size();
+}
+
+/// \cond
+namespace {
+
+/*!
+ * \brief Adds the paths and names of the specified \a files to \a paths and \a names.
+ * \remarks Directories are skipped.
+ */
+void collectFileIndexKeys(
+    const std::vector<std::string> *files, std::unordered_set<std::string_view> &paths, std::unordered_set<std::string_view> &names)
+{
+    if (!files) {
+        return;
+    }
+    for (const auto &file : *files) {
+        if (file.empty() || file.back() == '/' || file.size() > maxKeySize) {
+            continue;
+        }
+        const auto path = std::string_view(file);
+        const auto nameBegin = path.rfind('/');
+        paths.emplace(path);
+        names.emplace(nameBegin == std::string_view::npos ? path : path.substr(nameBegin + 1));
+    }
+}
+
+const std::vector<std::string> *filesOf(const PackageColdData *coldData)
+{
+    return coldData && coldData->packageInfo && !coldData->packageInfo->files.empty() ? &coldData->packageInfo->files : nullptr;
+}
+
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Updates the index of files for the package with the specified \a packageID.
+ * \remarks
+ * - Pass nullptr for \a oldColdData when adding the package and for \a newColdData when removing it.
+ * - Only paths which are present in either \a oldColdData or \a newColdData but not in both are touched.
+ */
+void DatabaseStorage::updateFileIndex(
+    PackageStorage::RWTransaction &txn, StorageID packageID, const PackageColdData *oldColdData, const PackageColdData *newColdData)
+{
+    const auto *const oldFiles = filesOf(oldColdData), *const newFiles = filesOf(newColdData);
+    if (!oldFiles && !newFiles) {
+        return;
+    }
+    auto oldPaths = std::unordered_set<std::string_view>(), oldNames = std::unordered_set<std::string_view>();
+    auto newPaths = std::unordered_set<std::string_view>(), newNames = std::unordered_set<std::string_view>();
+    collectFileIndexKeys(oldFiles, oldPaths, oldNames);
+    collectFileIndexKeys(newFiles, newPaths, newNames);
+    auto &txnHandle = txn.getTransactionHandle();
+    const auto id = LMDBSafe::MDBInVal(packageID);
+    const auto update = [&txnHandle, &id](LMDBSafe::MDBDbi &dbi, const auto &oldKeys, const auto &newKeys) {
+        for (const auto key : oldKeys) {
+            if (!newKeys.contains(key)) {
+                (*txnHandle)->del(dbi, LMDBSafe::MDBInVal(key), id);
+            }
+        }
+        for (const auto key : newKeys) {
+            if (!oldKeys.contains(key)) {
+                (*txnHandle)->put(dbi, LMDBSafe::MDBInVal(key), id);
+            }
+        }
+    };
+    update(filePathsDbi, oldPaths, newPaths);
+    update(fileNamesDbi, oldNames, newNames);
+}
+
+/*!
+ * \brief Removes all entries from the index of files.
+ */
+void DatabaseStorage::clearFileIndex(PackageStorage::RWTransaction &txn)
+{
+    auto &txnHandle = txn.getTransactionHandle();
+    (*txnHandle)->clear(filePathsDbi);
+    (*txnHandle)->clear(fileNamesDbi);
+}
+
+/*!
+ * \brief Re-creates the index of files from the cold data of the packages present within \a txn.
+ * \returns Returns the number of packages containing files.
+ */
+std::size_t DatabaseStorage::rebuildFileIndex(PackageStorage::RWTransaction &txn)
+{
+    clearFileIndex(txn);
+    auto packagesWithFiles = std::size_t();
+    forEachColdData(**txn.getTransactionHandle(), [this, &txn, &packagesWithFiles](StorageID packageID, PackageColdData &&coldData) {
+        if (filesOf(&coldData)) {
+            updateFileIndex(txn, packageID, nullptr, &coldData);
+            ++packagesWithFiles;
+        }
+        return false;
+    });
+    return packagesWithFiles;
+}
+
+/*!
+ * \brief Returns whether there are packages containing files but the index of files is empty.
+ * \remarks This is the case if packages have been stored before the index existed.
+ */
+bool DatabaseStorage::isFileIndexMissing(PackageStorage::ROTransaction &txn)
+{
+    auto &txnHandle = txn.getTransactionHandle();
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    if ((*txnHandle)->getROCursor(filePathsDbi).first(key, value) != MDB_NOTFOUND) {
+        return false;
+    }
+    auto hasFiles = false;
+    forEachColdData(**txnHandle, [&hasFiles](StorageID, PackageColdData &&coldData) {
+        return hasFiles = coldData.packageInfo && !coldData.packageInfo->files.empty();
+    });
+    return hasFiles;
+}
+
+/*!
+ * \brief Returns the distinct trigrams (substrings of three bytes) of the specified package \a name in sorted order.
+ * \remarks Names shorter than three bytes have no trigrams.
+ */
+std::vector<std::string> nameTrigrams(std::string_view name)
+{
+    auto trigrams = std::vector<std::string>();
+    if (name.size() < 3) {
+        return trigrams;
+    }
+    trigrams.reserve(name.size() - 2);
+    for (auto i = std::size_t(); i + 3 <= name.size(); ++i) {
+        trigrams.emplace_back(name.substr(i, 3));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+/// \cond
+namespace {
+
+/*!
+ * \brief The most recent version of serialized Package records that can be decoded by decodePackageView().
+ * \remarks Must be kept in sync with the version Package derives from ReflectiveRapidJSON::BinarySerializable with.
+ */
+constexpr auto maxPackageViewVersion = std::uint64_t(1);
+
+/*!
+ * \brief The SerializedReader struct decodes the binary format of reflective-rapidjson without copying strings.
+ */
+struct SerializedReader {
+    std::string_view data;
+    bool ok = true;
+
+    std::uint64_t readVariableLengthUInt()
+    {
+        if (data.empty()) {
+            ok = false;
+            return 0;
+        }
+        auto first = static_cast<unsigned char>(data.front());
+        auto mask = static_cast<unsigned char>(0x80);
+        auto size = std::size_t(1);
+        for (; size <= 8 && !(first & mask); ++size, mask >>= 1)
+            ;
+        if (size > 8 || size > data.size()) {
+            ok = false;
+            return 0;
+        }
+        auto value = static_cast<std::uint64_t>(first & (mask - 1));
+        for (auto i = std::size_t(1); i != size; ++i) {
+            value = (value << 8) | static_cast<unsigned char>(data[i]);
+        }
+        data.remove_prefix(size);
+        return value;
+    }
+
+    template <typename IntType> IntType readIntBE()
+    {
+        if (data.size() < sizeof(IntType)) {
+            ok = false;
+            return IntType();
+        }
+        auto value = std::uint64_t();
+        for (auto i = std::size_t(); i != sizeof(IntType); ++i) {
+            value = (value << 8) | static_cast<unsigned char>(data[i]);
+        }
+        data.remove_prefix(sizeof(IntType));
+        return static_cast<IntType>(value);
+    }
+
+    std::string_view readString()
+    {
+        const auto size = readVariableLengthUInt();
+        if (!ok || size > data.size()) {
+            ok = false;
+            return std::string_view();
+        }
+        const auto str = data.substr(0, size);
+        data.remove_prefix(size);
+        return str;
+    }
+
+    CppUtilities::DateTime readDateTime()
+    {
+        return CppUtilities::DateTime(static_cast<std::uint64_t>(readIntBE<std::int64_t>()));
+    }
+};
+
+/*!
+ * \brief Decodes the members of PackageBase from the specified \a serializedPackage into \a view.
+ * \remarks
+ * - Serialized Package records start with the version of the record followed by the members of PackageBase. (That is
+ *   also what allows deserializing PackageBase from them.)
+ * - Returns false if the record has an unknown version or is truncated so the caller can fall back to the regular
+ *   deserialization for that record.
+ */
+bool decodePackageView(std::string_view serializedPackage, PackageView &view)
+{
+    auto reader = SerializedReader{ serializedPackage };
+    if (const auto version = reader.readVariableLengthUInt(); !reader.ok || version > maxPackageViewVersion) {
+        return false;
+    }
+    view.origin = static_cast<PackageOrigin>(reader.readIntBE<std::int32_t>());
+    view.timestamp = reader.readDateTime();
+    view.buildDate = reader.readDateTime();
+    view.name = reader.readString();
+    view.version = reader.readString();
+    view.arch = reader.readString();
+    view.archCount = reader.readVariableLengthUInt();
+    const auto archsBegin = reader.data.data();
+    for (auto i = std::size_t(); i != view.archCount && reader.ok; ++i) {
+        reader.readString();
+    }
+    view.serializedArchs = std::string_view(archsBegin, static_cast<std::size_t>(reader.data.data() - archsBegin));
+    view.deserializedArchs = nullptr;
+    view.description = reader.readString();
+    return reader.ok;
+}
+
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Returns the archs of the package.
+ */
+std::vector<std::string_view> PackageView::archs() const
+{
+    auto archs = std::vector<std::string_view>();
+    if (deserializedArchs) {
+        archs.reserve(deserializedArchs->size());
+        for (const auto &arch : *deserializedArchs) {
+            archs.emplace_back(arch);
+        }
+        return archs;
+    }
+    archs.reserve(archCount);
+    auto reader = SerializedReader{ serializedArchs };
+    for (auto i = std::size_t(); i != archCount && reader.ok; ++i) {
+        archs.emplace_back(reader.readString());
+    }
+    return archs;
+}
+
+/*!
+ * \brief Returns a copy of the viewed package which remains valid after the transaction has been closed.
+ */
+PackageBase PackageView::toPackageBase() const
+{
+    auto package = PackageBase();
+    package.origin = origin;
+    package.timestamp = timestamp;
+    package.buildDate = buildDate;
+    package.name = name;
+    package.version = version;
+    package.arch = arch;
+    for (const auto arch : archs()) {
+        package.archs.emplace_back(arch);
+    }
+    package.description = description;
+    return package;
+}
+
+PackageViewReader::PackageViewReader(DatabaseStorage &storage, PackageStorage::ROTransaction &txn)
+    : m_storage(storage)
+    , m_txn(txn)
+{
+}
+
+/*!
+ * \brief Reads the package with the specified \a packageID into \a view.
+ * \returns Returns whether the package could be read.
+ */
+bool PackageViewReader::read(StorageID packageID, PackageView &view)
+{
+    auto &txnHandle = m_txn.getTransactionHandle();
+    auto value = LMDBSafe::MDBOutVal();
+    if ((*txnHandle)->get(m_storage.packagesDbi, LMDBSafe::MDBInVal(packageID), value) == MDB_NOTFOUND) {
+        return false;
+    }
+    return read(packageID, value.get<std::string_view>(), view);
+}
+
+/*!
+ * \brief Invokes \a visitor for all packages in ascending order of their IDs until \a visitor returns true.
+ */
+void PackageViewReader::forEach(const std::function<bool(StorageID, const PackageView &)> &visitor)
+{
+    auto &txnHandle = m_txn.getTransactionHandle();
+    auto cursor = (*txnHandle)->getROCursor(m_storage.packagesDbi);
+    auto key = LMDBSafe::MDBOutVal(), value = LMDBSafe::MDBOutVal();
+    auto view = PackageView();
+    for (auto rc = cursor.first(key, value); rc != MDB_NOTFOUND; rc = cursor.next(key, value)) {
+        const auto packageID = key.get<StorageID>();
+        if (read(packageID, value.get<std::string_view>(), view) && visitor(packageID, view)) {
+            return;
+        }
+    }
+}
+
+bool PackageViewReader::read(StorageID packageID, std::string_view serializedPackage, PackageView &view)
+{
+    return decodePackageView(serializedPackage, view) || readFallback(packageID, view);
+}
+
+bool PackageViewReader::readFallback(StorageID packageID, PackageView &view)
+{
+    m_fallback = PackageBase();
+    if (!m_txn.get<PackageBase>(packageID, m_fallback)) {
+        return false;
+    }
+    view.origin = m_fallback.origin;
+    view.timestamp = m_fallback.timestamp;
+    view.buildDate = m_fallback.buildDate;
+    view.name = m_fallback.name;
+    view.version = m_fallback.version;
+    view.arch = m_fallback.arch;
+    view.description = m_fallback.description;
+    view.serializedArchs = std::string_view();
+    view.archCount = m_fallback.archs.size();
+    view.deserializedArchs = &m_fallback.archs;
+    return true;
 }
 
 std::size_t hash_value(const PackageCacheRef &ref)
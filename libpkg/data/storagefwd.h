@@ -1,6 +1,7 @@
 #ifndef LIBPKG_DATA_STORAGE_FWD_H
 #define LIBPKG_DATA_STORAGE_FWD_H
 
+#include <cstddef>
 #include <cstdint>
 
 namespace LibPkg {
@@ -8,6 +9,20 @@ namespace LibPkg {
 using StorageID = std::uint32_t;
 struct StorageDistribution;
 struct DatabaseStorage;
+class BinaryInfoCache;
+
+/*!
+ * \brief The StorageCacheStatistics struct holds statistics about a storage cache.
+ * \remarks Sizes are in bytes and only an approximation of the actual heap usage.
+ */
+struct StorageCacheStatistics {
+    std::size_t entries = 0;
+    std::size_t size = 0;
+    std::size_t limit = 0;
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+};
 
 } // namespace LibPkg
 
@@ -10,13 +10,19 @@
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index_container.hpp>
 
+#include "./storagefwd.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace LibPkg {
 
-using StorageID = std::uint32_t;
-
 template <typename StorageType, typename EntryType> struct StorageCacheRef {
     using Storage = StorageType;
     explicit StorageCacheRef(const StorageType &relatedStorage, const std::shared_ptr<EntryType> &entry);
@@ -53,6 +59,7 @@ template <typename StorageRefType, typename EntryType> struct StorageCacheEntry
     explicit StorageCacheEntry(const StorageRefType &ref, StorageID id);
     StorageRefType ref;
     StorageID id;
+    std::size_t size = 0; // approximate memory usage of entry in bytes
     std::shared_ptr<EntryType> entry;
 };
 
@@ -92,21 +99,30 @@ public:
             boost::multi_index::hashed_unique<boost::multi_index::tag<typename ByID::result_type>, ByID>,
             boost::multi_index::hashed_unique<boost::multi_index::tag<Ref>, BOOST_MULTI_INDEX_MEMBER(StorageEntryType, Ref, ref)>>>;
     using iterator = typename EntryList::iterator;
+    using EvictedIDs = std::vector<typename ByID::result_type>;
 
-    explicit StorageCacheEntries(std::size_t limit = 1000);
+    explicit StorageCacheEntries(std::size_t limit);
 
     template <typename IndexType> StorageEntry *find(const IndexType &ref);
-    StorageEntry &insert(StorageEntry &&entry);
-    std::size_t erase(const Ref &ref);
+    template <typename IndexType> const StorageEntry *peek(const IndexType &ref) const;
+    StorageEntry *insert(StorageEntry &&entry, EvictedIDs *evicted = nullptr);
+    template <typename IndexType> std::size_t erase(const IndexType &key, EvictedIDs *evicted = nullptr);
     std::size_t clear(const Storage &storage);
     iterator begin();
     iterator end();
-    void setLimit(std::size_t limit);
+    void setLimit(std::size_t limit, EvictedIDs *evicted = nullptr);
+    std::size_t limit() const;
     std::size_t size() const;
+    std::size_t memoryUsage() const;
+    std::size_t evictions() const;
 
 private:
+    void evictLeastRecentlyUsed(EvictedIDs *evicted);
+
     EntryList m_entries;
     std::size_t m_limit;
+    std::size_t m_memoryUsage = 0;
+    std::size_t m_evictions = 0;
 };
 
 template <typename StorageEntryType>
@@ -115,9 +131,17 @@ inline StorageCacheEntries<StorageEntryType>::StorageCacheEntries(std::size_t li
 {
 }
 
-template <typename StorageEntryType> inline std::size_t StorageCacheEntries<StorageEntryType>::erase(const Ref &ref)
+/*!
+ * \brief Returns the entry for the specified \a ref without marking it as recently used.
+ * \remarks Unlike find() this does not modify the container so a shared lock is sufficient.
+ */
+template <typename StorageEntryType>
+template <typename IndexType>
+inline auto StorageCacheEntries<StorageEntryType>::peek(const IndexType &ref) const -> const StorageEntry *
 {
-    return m_entries.template get<typename StorageEntryType::Ref>().erase(ref);
+    const auto &index = m_entries.template get<IndexType>();
+    const auto i = index.find(ref);
+    return i != index.end() ? &*i : nullptr;
 }
 
 template <typename StorageEntryType> inline auto StorageCacheEntries<StorageEntryType>::begin() -> iterator
@@ -130,45 +154,120 @@ template <typename StorageEntryType> inline auto StorageCacheEntries<StorageEntr
     return m_entries.end();
 }
 
+template <typename StorageEntryType> inline std::size_t StorageCacheEntries<StorageEntryType>::limit() const
+{
+    return m_limit;
+}
+
 template <typename StorageEntryType> inline std::size_t StorageCacheEntries<StorageEntryType>::size() const
 {
     return m_entries.size();
 }
 
+/*!
+ * \brief Returns the approximate memory usage of all entries in bytes.
+ */
+template <typename StorageEntryType> inline std::size_t StorageCacheEntries<StorageEntryType>::memoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+/*!
+ * \brief Returns the number of entries which have been evicted so far to stay within the limit.
+ */
+template <typename StorageEntryType> inline std::size_t StorageCacheEntries<StorageEntryType>::evictions() const
+{
+    return m_evictions;
+}
+
+/*!
+ * \brief The StorageCache struct caches entries of multiple storages.
+ * \remarks
+ * - The cache is partitioned into shards so concurrent lookups of different entries do not contend on a
+ *   single mutex. An entry lives in the shard determined by its storage and name. The ID-shards only hold
+ *   a hint in which shard an entry with a certain ID lives.
+ * - Lookups only acquire shared locks (also on the ID-shard when looking up by ID). Marking an entry as recently used
+ *   is skipped if the shard is busy.
+ * - The limit is the approximate memory usage of all entries in bytes. It applies per shard (the specified
+ *   overall limit is divided by the number of shards).
+ */
 template <typename StorageEntriesType, typename StorageType, typename SpecType> struct StorageCache {
     using Entries = StorageEntriesType;
     using Entry = typename Entries::Entry;
     using ROTxn = typename StorageType::ROTransaction;
     using RWTxn = typename StorageType::RWTransaction;
     using Storage = typename Entries::Storage;
+    using Ref = typename Entries::Ref;
+    using EntryByID = typename Entries::ByID::result_type;
     struct StoreResult {
         StorageID id = 0;
         bool updated = false;
         std::shared_ptr<typename Entries::Entry> oldEntry;
+        typename Storage::ColdData oldColdData; // cold data stored before, see store()
+        typename Storage::ColdData coldData; // cold data which has been moved out of the stored entry
     };
+    static constexpr std::size_t shardCount = 16;
+    static constexpr std::size_t defaultLimit = 64 * 1024 * 1024;
 
     SpecType retrieve(Storage &storage, ROTxn *, StorageID storageID);
     SpecType retrieve(Storage &storage, StorageID storageID);
     SpecType retrieve(Storage &storage, RWTxn *, const std::string &entryName);
     SpecType retrieve(Storage &storage, const std::string &entryName);
-    StoreResult store(Storage &storage, RWTxn &txn, const std::shared_ptr<Entry> &entry);
-    void store(Storage &storage, RWTxn &txn, StorageID storageID, const std::shared_ptr<Entry> &entry);
+    StoreResult store(Storage &storage, RWTxn &txn, const std::shared_ptr<Entry> &entry,
+        const std::function<bool(StorageID)> &isOldColdDataNeeded = std::function<bool(StorageID)>());
+    StoreResult store(Storage &storage, RWTxn &txn, StorageID storageID, const std::shared_ptr<Entry> &entry);
     bool invalidate(Storage &storage, const std::string &entryName);
     bool invalidateCacheOnly(Storage &storage, const std::string &entryName);
     void clear(Storage &storage);
     void clearCacheOnly(Storage &storage);
     void setLimit(std::size_t limit);
     std::size_t size();
+    StorageCacheStatistics statistics();
 
 private:
-    Entries m_entries;
-    std::mutex m_mutex;
+    struct Shard {
+        Entries entries{ defaultLimit / shardCount };
+        std::shared_mutex mutex;
+    };
+    struct IDShard {
+        std::unordered_map<EntryByID, std::size_t, boost::hash<EntryByID>> shardByID;
+        std::shared_mutex mutex;
+    };
+
+    std::size_t shardIndex(const Ref &ref) const;
+    IDShard &idShard(const EntryByID &entryByID);
+    template <typename IndexType> SpecType lookup(Shard &shard, const IndexType &key);
+    std::size_t lookupShardIndex(const EntryByID &entryByID);
+    void insert(std::size_t shardIndex, typename Entries::StorageEntry &&cacheEntry, const std::shared_ptr<Entry> &entry);
+    void forgetIDs(std::size_t shardIndex, const typename Entries::EvictedIDs &ids);
+
+    std::array<Shard, shardCount> m_shards;
+    std::array<IDShard, shardCount> m_idShards;
+    std::atomic_size_t m_hits = 0;
+    std::atomic_size_t m_misses = 0;
 };
 
+template <typename StorageEntriesType, typename StorageType, typename SpecType>
+inline std::size_t StorageCache<StorageEntriesType, StorageType, SpecType>::shardIndex(const Ref &ref) const
+{
+    return boost::hash<Ref>()(ref) % shardCount;
+}
+
+template <typename StorageEntriesType, typename StorageType, typename SpecType>
+inline auto StorageCache<StorageEntriesType, StorageType, SpecType>::idShard(const EntryByID &entryByID) -> IDShard &
+{
+    return m_idShards[boost::hash<EntryByID>()(entryByID) % shardCount];
+}
+
 template <typename StorageEntriesType, typename StorageType, typename SpecType>
 std::size_t StorageCache<StorageEntriesType, StorageType, SpecType>::size()
 {
-    return m_entries.size();
+    auto size = std::size_t();
+    for (auto &shard : m_shards) {
+        const auto lock = std::shared_lock(shard.mutex);
+        size += shard.entries.size();
+    }
+    return size;
 }
 
 } // namespace LibPkg
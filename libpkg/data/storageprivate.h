@@ -1,17 +1,23 @@
 #ifndef LIBPKG_DATA_STORAGE_PRIVATE_H
 #define LIBPKG_DATA_STORAGE_PRIVATE_H
 
+#include "./bloomfilter.h"
+#include "./compression.h"
 #include "./package.h"
 #include "./storagegeneric.h"
 
+#include <deque>
+#include <functional>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace LibPkg {
 
 using PackageStorage = LMDBSafe::TypedDBI<Package, LMDBSafe::index_on_base_member<Package, std::string, PackageBase, &PackageBase::name>>;
-using DependencyStorage = LMDBSafe::TypedDBI<DatabaseDependency, LMDBSafe::index_on<Dependency, std::string, &DatabaseDependency::name>>;
-using LibraryDependencyStorage
-    = LMDBSafe::TypedDBI<DatabaseLibraryDependency, LMDBSafe::index_on<DatabaseLibraryDependency, std::string, &DatabaseLibraryDependency::name>>;
 using PackageCacheRef = StorageCacheRef<DatabaseStorage, Package>;
 using PackageCacheEntry = StorageCacheEntry<PackageCacheRef, Package>;
 using PackageCacheEntries = StorageCacheEntries<PackageCacheEntry>;
@@ -23,41 +29,193 @@ extern template struct StorageCacheEntry<PackageCacheRef, Package>;
 extern template class StorageCacheEntries<PackageCacheEntry>;
 extern template struct StorageCache<PackageCacheEntries, PackageStorage, PackageSpec>;
 
+/*!
+ * \brief The DependencyIndexEntry struct is an entry of a DependencyIndex.
+ * \remarks The views are only valid as long as the transaction the entry has been read from is alive.
+ */
+struct DependencyIndexEntry {
+    std::string_view name;
+    std::string_view version;
+    DependencyMode mode = DependencyMode::Any;
+    StorageID packageID = 0;
+};
+
+/*!
+ * \brief The DependencyIndex struct maps names of dependencies/libraries to the IDs of packages providing/requiring them.
+ * \remarks
+ * - The index is an LMDB table with MDB_DUPSORT. The name is the key and each package is a sorted duplicate consisting of
+ *   the version, a zero byte, the mode and the package ID (big endian). So entries with the same version and mode are
+ *   adjacent and adding/removing a package does not rewrite the entries of other packages.
+ * - Libraries and trigrams are stored with an empty version and DependencyMode::Any.
+ * - Names exceeding LMDB's maximum key size are stored under their prefix followed by a hash of the whole name. Visiting
+ *   all entries yields such keys instead of the names; they can be passed to the other functions like names.
+ * - Entries with versions exceeding LMDB's maximum key size are not indexed; a warning is logged.
+ */
+struct DependencyIndex {
+    using Visitor = std::function<bool(const DependencyIndexEntry &)>;
+    struct BulkEntries {
+        std::vector<std::pair<std::string_view, std::string>> entries; // names and encoded entries for bulkLoad()
+        std::deque<std::string> hashedNames; // keys of names exceeding the maximum key size, referred to by entries
+    };
+
+    explicit DependencyIndex(const std::shared_ptr<LMDBSafe::MDBEnv> &env, const std::string &tableName);
+    void add(LMDBSafe::MDBRWTransactionImpl &txn, std::string_view name, StorageID packageID, std::string_view version = std::string_view(),
+        DependencyMode mode = DependencyMode::Any);
+    void remove(LMDBSafe::MDBRWTransactionImpl &txn, std::string_view name, StorageID packageID, std::string_view version = std::string_view(),
+        DependencyMode mode = DependencyMode::Any);
+    void clear(LMDBSafe::MDBRWTransactionImpl &txn);
+    static void addToBulk(BulkEntries &entries, std::string_view name, StorageID packageID, std::string_view version = std::string_view(),
+        DependencyMode mode = DependencyMode::Any);
+    void bulkLoad(LMDBSafe::MDBRWTransactionImpl &txn, BulkEntries &entries);
+    bool contains(LMDBSafe::MDBROTransactionImpl &txn, std::string_view name);
+    bool empty(LMDBSafe::MDBROTransactionImpl &txn);
+    void forEach(LMDBSafe::MDBROTransactionImpl &txn, std::string_view name, const Visitor &visitor);
+    void forEach(LMDBSafe::MDBROTransactionImpl &txn, const Visitor &visitor);
+    void forEachInRange(LMDBSafe::MDBROTransactionImpl &txn, std::string_view begin, std::string_view end, const Visitor &visitor);
+    std::vector<std::string> partition(LMDBSafe::MDBROTransactionImpl &txn, std::size_t partCount);
+
+    LMDBSafe::MDBDbi dbi;
+};
+
+/*!
+ * \brief The ProvidesIndex struct maps names of dependencies to the packages providing them across all databases.
+ * \remarks
+ * - It mirrors DatabaseStorage::providedDeps of all databases so finding the packages providing a dependency within all
+ *   databases takes only a single lookup. Entries are stored like in a DependencyIndex but prefixed with the ID of the
+ *   database (big endian).
+ * - Databases get their ID assigned when their storage is initialized for the first time. The IDs are stored within a
+ *   separate table under the unique name of the database. Databases removed from the configuration are removed from the
+ *   index via removeDatabases(); when configured again they get a new ID and their provides are added again.
+ * - The priority of databases is not stored as it is determined by the configuration; see Config::findPackage().
+ */
+struct ProvidesIndex {
+    using Visitor = std::function<bool(std::uint32_t databaseID, const DependencyIndexEntry &)>;
+
+    explicit ProvidesIndex(const std::shared_ptr<LMDBSafe::MDBEnv> &env);
+    std::uint32_t findDatabaseID(LMDBSafe::MDBROTransactionImpl &txn, std::string_view uniqueDatabaseName);
+    std::uint32_t assignDatabaseID(LMDBSafe::MDBRWTransactionImpl &txn, std::string_view uniqueDatabaseName);
+    void add(LMDBSafe::MDBRWTransactionImpl &txn, std::uint32_t databaseID, std::string_view name, StorageID packageID,
+        std::string_view version = std::string_view(), DependencyMode mode = DependencyMode::Any);
+    void remove(LMDBSafe::MDBRWTransactionImpl &txn, std::uint32_t databaseID, std::string_view name, StorageID packageID,
+        std::string_view version = std::string_view(), DependencyMode mode = DependencyMode::Any);
+    void forEach(LMDBSafe::MDBROTransactionImpl &txn, std::string_view name, const Visitor &visitor);
+    std::size_t removeDatabases(LMDBSafe::MDBRWTransactionImpl &txn, const std::function<bool(std::uint32_t databaseID)> &isObsolete);
+
+    LMDBSafe::MDBDbi dbi;
+    LMDBSafe::MDBDbi databasesDbi; // maps unique names of databases to their IDs
+};
+
 struct StorageDistribution {
     explicit StorageDistribution(const char *path, std::uint32_t maxDbs);
 
     std::unique_ptr<DatabaseStorage> forDatabase(std::string_view uniqueDatabaseName);
     PackageCache &packageCache();
+    ProvidesIndex &allProvides();
+    std::shared_ptr<LMDBSafe::MDBEnv> &env();
+    LMDBSafe::MDBDbi &binaryInfoDbi();
+    void setCompressionDictionary(std::string_view dictionary);
 
 private:
     std::shared_ptr<LMDBSafe::MDBEnv> m_env;
+    LMDBSafe::MDBDbi m_compressionDbi; // dictionaries for compressing cold data and the ID of the active one
+    CompressionDictionaries m_compressionDictionaries; // the dictionaries from m_compressionDbi, used by all DatabaseStorage instances
+    LMDBSafe::MDBDbi m_binaryInfoDbi; // info parsed from binaries, see BinaryInfoCache
     PackageCache m_packageCache;
+    ProvidesIndex m_allProvides;
 };
 
-inline std::unique_ptr<DatabaseStorage> StorageDistribution::forDatabase(std::string_view uniqueDatabaseName)
+inline PackageCache &StorageDistribution::packageCache()
 {
-    return std::make_unique<DatabaseStorage>(m_env, m_packageCache, uniqueDatabaseName);
+    return m_packageCache;
 }
 
-inline PackageCache &StorageDistribution::packageCache()
+inline ProvidesIndex &StorageDistribution::allProvides()
 {
-    return m_packageCache;
+    return m_allProvides;
+}
+
+inline std::shared_ptr<LMDBSafe::MDBEnv> &StorageDistribution::env()
+{
+    return m_env;
+}
+
+inline LMDBSafe::MDBDbi &StorageDistribution::binaryInfoDbi()
+{
+    return m_binaryInfoDbi;
 }
 
 struct DatabaseStorage {
-    explicit DatabaseStorage(const std::shared_ptr<LMDBSafe::MDBEnv> &env, PackageCache &packageCache, std::string_view uniqueDatabaseName);
+    using ColdData = PackageColdData;
+    explicit DatabaseStorage(const std::shared_ptr<LMDBSafe::MDBEnv> &env, PackageCache &packageCache, ProvidesIndex &allProvides,
+        CompressionDictionaries &compressionDictionaries, std::string_view uniqueDatabaseName);
     PackageCache &packageCache;
+    ProvidesIndex &allProvides; // index of provides across all databases, kept in sync with providedDeps
+    std::uint32_t databaseID = 0; // the ID of the database within allProvides
     PackageStorage packages;
-    DependencyStorage providedDeps;
-    DependencyStorage requiredDeps;
-    LibraryDependencyStorage providedLibs;
-    LibraryDependencyStorage requiredLibs;
+    LMDBSafe::MDBDbi packagesDbi; // the DBI used by packages, for accessing serialized packages directly
+    LMDBSafe::MDBDbi packagesColdDbi; // cold data of packages stored under the ID of the package, see putColdData()/getColdData()
+    CompressionDictionaries &compressionDictionaries; // the dictionaries for compressing cold data, owned by the StorageDistribution
+    DependencyIndex providedDeps;
+    DependencyIndex requiredDeps;
+    DependencyIndex providedLibs;
+    DependencyIndex requiredLibs;
+    DependencyIndex packageNameTrigrams; // maps trigrams of package names to the IDs of packages with such names
+    LMDBSafe::MDBDbi filePathsDbi; // maps paths of files contained by packages to the IDs of those packages (MDB_DUPSORT)
+    LMDBSafe::MDBDbi fileNamesDbi; // maps names of files (paths without directory) to the IDs of packages containing such files (MDB_DUPSORT)
     std::mutex updateMutex; // must be acquired to update packages, concurrent reads should still be possible
+    BloomFilter providesFilter; // names of provided dependencies and libraries, see mightProvide()
+    std::shared_mutex providesFilterMutex;
+    bool isProvidesFilterValid = false;
+
+    StorageID putPackage(PackageStorage::RWTransaction &txn, const Package &package, const PackageColdData &coldData, StorageID packageID = 0);
+    void deletePackageColdData(PackageStorage::RWTransaction &txn, StorageID packageID);
+    template <typename PackagesTransaction> bool loadPackageColdData(PackagesTransaction &txn, StorageID packageID, Package &package);
+    void putColdData(LMDBSafe::MDBRWTransactionImpl &txn, StorageID packageID, const PackageColdData &coldData);
+    bool getColdData(LMDBSafe::MDBROTransactionImpl &txn, StorageID packageID, PackageColdData &coldData);
+    void forEachColdData(LMDBSafe::MDBROTransactionImpl &txn, const std::function<bool(StorageID, PackageColdData &&)> &visitor);
+    std::vector<StorageID> coldDataIDs(LMDBSafe::MDBROTransactionImpl &txn);
+    void addPackageDependencies(LMDBSafe::MDBRWTransactionImpl &txn, StorageID packageID, const Package &package);
+    void removePackageDependencies(LMDBSafe::MDBRWTransactionImpl &txn, StorageID packageID, const Package &package);
+    void clearDependencies(LMDBSafe::MDBRWTransactionImpl &txn);
+    bool mightProvide(std::string_view name);
+    void addToProvidesFilter(const Package &package);
+    void invalidateProvidesFilter();
+    std::size_t rebuildDependencies(PackageStorage::RWTransaction &txn);
+    std::size_t dropLegacyDependencyTables(PackageStorage::RWTransaction &txn);
+    std::size_t rebuildNameTrigrams(PackageStorage::RWTransaction &txn);
+    void updateFileIndex(
+        PackageStorage::RWTransaction &txn, StorageID packageID, const PackageColdData *oldColdData, const PackageColdData *newColdData);
+    void clearFileIndex(PackageStorage::RWTransaction &txn);
+    std::size_t rebuildFileIndex(PackageStorage::RWTransaction &txn);
+    bool isFileIndexMissing(PackageStorage::ROTransaction &txn);
 
 private:
     std::shared_ptr<LMDBSafe::MDBEnv> m_env;
+    std::string m_uniqueDatabaseName;
+};
+
+/*!
+ * \brief The PackageViewReader struct reads PackageView objects directly from the memory-mapped package records.
+ * \remarks
+ * - The binary format of reflective-rapidjson is decoded manually to avoid copying. Records of an unknown version
+ *   or which cannot be decoded are deserialized into a PackageBase instead; the view then refers to that object.
+ * - Returned views are only valid until the next read and as long as the specified transaction is alive.
+ */
+struct PackageViewReader {
+    explicit PackageViewReader(DatabaseStorage &storage, PackageStorage::ROTransaction &txn);
+    bool read(StorageID packageID, PackageView &view);
+    void forEach(const std::function<bool(StorageID, const PackageView &)> &visitor);
+
+private:
+    bool read(StorageID packageID, std::string_view serializedPackage, PackageView &view);
+    bool readFallback(StorageID packageID, PackageView &view);
+
+    DatabaseStorage &m_storage;
+    PackageStorage::ROTransaction &m_txn;
+    PackageBase m_fallback;
 };
 
+std::vector<std::string> nameTrigrams(std::string_view name);
 std::size_t hash_value(const PackageCacheRef &ref);
 std::size_t hash_value(const PackageCacheEntryByID &entryByID);
 
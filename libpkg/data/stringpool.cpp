@@ -0,0 +1,110 @@
+#include "./stringpool.h"
+
+#include <mutex>
+#include <ostream>
+
+namespace LibPkg {
+
+const std::string StringPool::emptyString = std::string();
+
+/*!
+ * \brief Returns the process-wide string pool.
+ */
+StringPool &StringPool::global()
+{
+    static auto pool = StringPool();
+    return pool;
+}
+
+/*!
+ * \brief Returns the pooled copy of \a str, adding a copy to the pool if not present yet.
+ */
+const std::string &StringPool::intern(std::string_view str)
+{
+    m_requests.fetch_add(1, std::memory_order_relaxed);
+    m_requestedSize.fetch_add(str.size(), std::memory_order_relaxed);
+    if (str.empty()) {
+        return emptyString;
+    }
+    const auto hash = Hash()(str);
+    auto &shard = m_shards[hash % shardCount];
+    {
+        const auto lock = std::shared_lock(shard.mutex);
+        if (const auto i = shard.strings.find(str); i != shard.strings.end()) {
+            return *i;
+        }
+    }
+    const auto lock = std::unique_lock(shard.mutex);
+    const auto [i, inserted] = shard.strings.emplace(str);
+    if (inserted) {
+        shard.size += str.size();
+    }
+    return *i;
+}
+
+/*!
+ * \brief Returns statistics about the pool, e.g. to compare the memory usage with the memory copies would have required.
+ */
+StringPoolStatistics StringPool::statistics() const
+{
+    auto stats = StringPoolStatistics();
+    for (const auto &shard : m_shards) {
+        const auto lock = std::shared_lock(shard.mutex);
+        stats.strings += shard.strings.size();
+        stats.size += shard.size;
+    }
+    stats.requests = m_requests.load(std::memory_order_relaxed);
+    stats.requestedSize = m_requestedSize.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::ostream &operator<<(std::ostream &o, const InternedString &str)
+{
+    return o << str.str();
+}
+
+} // namespace LibPkg
+
+namespace ReflectiveRapidJSON {
+
+namespace JsonReflector {
+
+template <>
+LIBPKG_EXPORT void push<LibPkg::InternedString>(
+    const LibPkg::InternedString &reflectable, RAPIDJSON_NAMESPACE::Value &value, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator)
+{
+    push<std::string>(reflectable.str(), value, allocator);
+}
+
+template <>
+LIBPKG_EXPORT void pull<LibPkg::InternedString>(LibPkg::InternedString &reflectable,
+    const RAPIDJSON_NAMESPACE::GenericValue<RAPIDJSON_NAMESPACE::UTF8<char>> &value, JsonDeserializationErrors *errors)
+{
+    auto str = std::string();
+    pull<std::string>(str, value, errors);
+    reflectable.assign(str);
+}
+
+} // namespace JsonReflector
+
+namespace BinaryReflector {
+
+template <>
+LIBPKG_EXPORT void writeCustomType<LibPkg::InternedString>(BinarySerializer &serializer, const LibPkg::InternedString &str, BinaryVersion version)
+{
+    serializer.write(str.str(), version);
+}
+
+template <>
+LIBPKG_EXPORT BinaryVersion readCustomType<LibPkg::InternedString>(
+    BinaryDeserializer &deserializer, LibPkg::InternedString &str, BinaryVersion version)
+{
+    auto buffer = std::string();
+    deserializer.read(buffer, version);
+    str.assign(buffer);
+    return 0;
+}
+
+} // namespace BinaryReflector
+
+} // namespace ReflectiveRapidJSON
@@ -0,0 +1,340 @@
+#ifndef LIBPKG_DATA_STRING_POOL_H
+#define LIBPKG_DATA_STRING_POOL_H
+
+#include "../global.h"
+
+#include <reflective_rapidjson/binary/serializable.h>
+#include <reflective_rapidjson/json/serializable.h>
+
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace LibPkg {
+
+struct StringPoolStatistics {
+    std::size_t strings = 0; // number of distinct strings
+    std::size_t size = 0; // number of bytes of distinct strings
+    std::size_t requests = 0; // number of intern() calls
+    std::size_t requestedSize = 0; // number of bytes passed to intern(), so the size copies would have required
+};
+
+/*!
+ * \brief The StringPool class interns strings so frequently repeated strings are only stored once.
+ * \remarks
+ * - Interned strings are never freed. So only strings from a limited set (e.g. dependency names and archs but
+ *   not versions or descriptions) should be interned.
+ * - The returned references stay valid for the lifetime of the pool. The global pool lives until the process exits.
+ * - Interning is thread-safe. The pool is sharded so concurrent callers rarely contend for the same lock.
+ */
+class LIBPKG_EXPORT StringPool {
+public:
+    static StringPool &global();
+    const std::string &intern(std::string_view str);
+    StringPoolStatistics statistics() const;
+
+    static const std::string emptyString;
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view str) const
+        {
+            return std::hash<std::string_view>()(str);
+        }
+    };
+    struct Shard {
+        std::unordered_set<std::string, Hash, std::equal_to<>> strings;
+        std::size_t size = 0;
+        mutable std::shared_mutex mutex;
+    };
+    static constexpr std::size_t shardCount = 16;
+
+    std::array<Shard, shardCount> m_shards;
+    std::atomic_size_t m_requests = 0, m_requestedSize = 0;
+};
+
+/*!
+ * \brief The InternedString class is an immutable string which refers to its copy within the global StringPool.
+ * \remarks
+ * - Copying an InternedString only copies a pointer and all instances of equal strings share the same memory. That
+ *   makes it suitable for the names of dependencies, archs, licenses, groups and libraries which repeat across all
+ *   packages held in memory.
+ * - Equal strings are always interned at the same address so comparing two InternedStrings for equality only
+ *   compares pointers. Ordering is lexicographical like for std::string.
+ * - It converts implicitly to std::string and std::string_view so it can be passed to functions taking those. It
+ *   deliberately provides no iterators so reflective-rapidjson (de)serializes it like a std::string (instead of as
+ *   an array of characters) via the custom (de)serializers declared below.
+ */
+class LIBPKG_EXPORT InternedString {
+public:
+    static constexpr auto npos = std::string::npos;
+
+    InternedString() noexcept = default;
+    InternedString(std::string_view str);
+    InternedString(const std::string &str);
+    InternedString(const char *str);
+    InternedString(const char *str, std::size_t size);
+
+    InternedString &assign(std::string_view str);
+    InternedString &assign(const char *str, std::size_t size);
+    void clear() noexcept;
+
+    const std::string &str() const noexcept;
+    operator const std::string &() const noexcept;
+    operator std::string_view() const noexcept;
+    const char *data() const noexcept;
+    const char *c_str() const noexcept;
+    std::size_t size() const noexcept;
+    std::size_t length() const noexcept;
+    bool empty() const noexcept;
+    char operator[](std::size_t pos) const noexcept;
+    char front() const noexcept;
+    char back() const noexcept;
+    bool starts_with(std::string_view prefix) const noexcept;
+    bool starts_with(char prefix) const noexcept;
+    bool ends_with(std::string_view suffix) const noexcept;
+    bool ends_with(char suffix) const noexcept;
+    std::size_t find(std::string_view str, std::size_t pos = 0) const noexcept;
+    std::size_t find(char c, std::size_t pos = 0) const noexcept;
+    std::size_t rfind(std::string_view str, std::size_t pos = npos) const noexcept;
+    std::size_t rfind(char c, std::size_t pos = npos) const noexcept;
+    std::string substr(std::size_t pos = 0, std::size_t count = npos) const;
+    int compare(std::string_view str) const noexcept;
+
+    friend bool operator==(const InternedString &lhs, const InternedString &rhs) noexcept
+    {
+        return lhs.m_str == rhs.m_str;
+    }
+    friend bool operator==(const InternedString &lhs, std::string_view rhs) noexcept
+    {
+        return std::string_view(*lhs.m_str) == rhs;
+    }
+    friend bool operator==(const InternedString &lhs, const std::string &rhs) noexcept
+    {
+        return *lhs.m_str == rhs;
+    }
+    friend bool operator==(const InternedString &lhs, const char *rhs) noexcept
+    {
+        return *lhs.m_str == rhs;
+    }
+    friend std::strong_ordering operator<=>(const InternedString &lhs, const InternedString &rhs) noexcept
+    {
+        return lhs.m_str == rhs.m_str ? std::strong_ordering::equal : *lhs.m_str <=> *rhs.m_str;
+    }
+    friend std::strong_ordering operator<=>(const InternedString &lhs, std::string_view rhs) noexcept
+    {
+        return std::string_view(*lhs.m_str) <=> rhs;
+    }
+    friend std::strong_ordering operator<=>(const InternedString &lhs, const std::string &rhs) noexcept
+    {
+        return *lhs.m_str <=> rhs;
+    }
+    friend std::strong_ordering operator<=>(const InternedString &lhs, const char *rhs) noexcept
+    {
+        return *lhs.m_str <=> rhs;
+    }
+
+private:
+    const std::string *m_str = &StringPool::emptyString;
+};
+
+/*!
+ * \brief A set of interned strings which can be searched for std::string and std::string_view without interning them.
+ */
+using InternedStringSet = std::set<InternedString, std::less<>>;
+
+inline InternedString::InternedString(std::string_view str)
+    : m_str(&StringPool::global().intern(str))
+{
+}
+
+inline InternedString::InternedString(const std::string &str)
+    : InternedString(std::string_view(str))
+{
+}
+
+inline InternedString::InternedString(const char *str)
+    : InternedString(std::string_view(str))
+{
+}
+
+inline InternedString::InternedString(const char *str, std::size_t size)
+    : InternedString(std::string_view(str, size))
+{
+}
+
+inline InternedString &InternedString::assign(std::string_view str)
+{
+    m_str = &StringPool::global().intern(str);
+    return *this;
+}
+
+inline InternedString &InternedString::assign(const char *str, std::size_t size)
+{
+    return assign(std::string_view(str, size));
+}
+
+inline void InternedString::clear() noexcept
+{
+    m_str = &StringPool::emptyString;
+}
+
+inline const std::string &InternedString::str() const noexcept
+{
+    return *m_str;
+}
+
+inline InternedString::operator const std::string &() const noexcept
+{
+    return *m_str;
+}
+
+inline InternedString::operator std::string_view() const noexcept
+{
+    return *m_str;
+}
+
+inline const char *InternedString::data() const noexcept
+{
+    return m_str->data();
+}
+
+inline const char *InternedString::c_str() const noexcept
+{
+    return m_str->c_str();
+}
+
+inline std::size_t InternedString::size() const noexcept
+{
+    return m_str->size();
+}
+
+inline std::size_t InternedString::length() const noexcept
+{
+    return m_str->size();
+}
+
+inline bool InternedString::empty() const noexcept
+{
+    return m_str->empty();
+}
+
+inline char InternedString::operator[](std::size_t pos) const noexcept
+{
+    return (*m_str)[pos];
+}
+
+inline char InternedString::front() const noexcept
+{
+    return m_str->front();
+}
+
+inline char InternedString::back() const noexcept
+{
+    return m_str->back();
+}
+
+inline bool InternedString::starts_with(std::string_view prefix) const noexcept
+{
+    return m_str->starts_with(prefix);
+}
+
+inline bool InternedString::starts_with(char prefix) const noexcept
+{
+    return m_str->starts_with(prefix);
+}
+
+inline bool InternedString::ends_with(std::string_view suffix) const noexcept
+{
+    return m_str->ends_with(suffix);
+}
+
+inline bool InternedString::ends_with(char suffix) const noexcept
+{
+    return m_str->ends_with(suffix);
+}
+
+inline std::size_t InternedString::find(std::string_view str, std::size_t pos) const noexcept
+{
+    return m_str->find(str, pos);
+}
+
+inline std::size_t InternedString::find(char c, std::size_t pos) const noexcept
+{
+    return m_str->find(c, pos);
+}
+
+inline std::size_t InternedString::rfind(std::string_view str, std::size_t pos) const noexcept
+{
+    return m_str->rfind(str, pos);
+}
+
+inline std::size_t InternedString::rfind(char c, std::size_t pos) const noexcept
+{
+    return m_str->rfind(c, pos);
+}
+
+inline std::string InternedString::substr(std::size_t pos, std::size_t count) const
+{
+    return m_str->substr(pos, count);
+}
+
+inline int InternedString::compare(std::string_view str) const noexcept
+{
+    return std::string_view(*m_str).compare(str);
+}
+
+LIBPKG_EXPORT std::ostream &operator<<(std::ostream &o, const InternedString &str);
+
+} // namespace LibPkg
+
+namespace std {
+
+template <> struct hash<LibPkg::InternedString> {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view str) const
+    {
+        return hash<std::string_view>()(str);
+    }
+};
+
+} // namespace std
+
+namespace ReflectiveRapidJSON {
+
+namespace JsonReflector {
+
+// declare custom (de)serialization for InternedString
+template <>
+LIBPKG_EXPORT void push<LibPkg::InternedString>(
+    const LibPkg::InternedString &reflectable, RAPIDJSON_NAMESPACE::Value &value, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator);
+template <>
+LIBPKG_EXPORT void pull<LibPkg::InternedString>(LibPkg::InternedString &reflectable,
+    const RAPIDJSON_NAMESPACE::GenericValue<RAPIDJSON_NAMESPACE::UTF8<char>> &value, JsonDeserializationErrors *errors);
+
+} // namespace JsonReflector
+
+namespace BinaryReflector {
+
+// declare custom (de)serialization for InternedString
+template <>
+LIBPKG_EXPORT void writeCustomType<LibPkg::InternedString>(
+    BinarySerializer &serializer, const LibPkg::InternedString &str, BinaryVersion version);
+template <>
+LIBPKG_EXPORT BinaryVersion readCustomType<LibPkg::InternedString>(
+    BinaryDeserializer &deserializer, LibPkg::InternedString &str, BinaryVersion version);
+
+} // namespace BinaryReflector
+
+} // namespace ReflectiveRapidJSON
+
+#endif // LIBPKG_DATA_STRING_POOL_H
@@ -2,16 +2,26 @@
 
 #include "./binary.h"
 
+#include "../data/binaryinfocache.h"
+
 #include <c++utilities/conversion/stringbuilder.h>
-#include <c++utilities/io/binaryreader.h>
+#include <c++utilities/conversion/stringconversion.h>
 #include <c++utilities/io/path.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
 #include <exception>
-#include <filesystem>
-#include <fstream>
-#include <memory>
+#include <limits>
 #include <string_view>
+#include <system_error>
 
 using namespace std;
 using namespace CppUtilities;
@@ -93,6 +103,311 @@ enum KnownValues : std::uint32_t {
 };
 }
 
+/// \cond
+namespace {
+/*!
+ * \brief The BinaryContentTruncated class is thrown when parsing requires more than the buffered prefix of a binary.
+ */
+class BinaryContentTruncated : public std::runtime_error {
+public:
+    explicit BinaryContentTruncated(std::uint64_t requiredSize);
+    std::uint64_t requiredSize() const;
+
+private:
+    std::uint64_t m_requiredSize;
+};
+
+BinaryContentTruncated::BinaryContentTruncated(std::uint64_t requiredSize)
+    : std::runtime_error(argsToString("binary content has been truncated, ", requiredSize, " bytes required"))
+    , m_requiredSize(requiredSize)
+{
+}
+
+std::uint64_t BinaryContentTruncated::requiredSize() const
+{
+    return m_requiredSize;
+}
+
+/*!
+ * \brief Appends \a value to \a data in big-endian byte order.
+ */
+template <typename IntType> void appendBigEndian(std::string &data, IntType value)
+{
+    for (auto shift = sizeof(IntType) * 8; shift;) {
+        shift -= 8;
+        data += static_cast<char>((value >> shift) & 0xFF);
+    }
+}
+
+/*!
+ * \brief Returns the XXH64 hash of \a data.
+ * \remarks This is the 64-bit variant of xxHash implemented here to avoid a dependency just for hashing.
+ */
+std::uint64_t xxHash64(std::string_view data, std::uint64_t seed = 0)
+{
+    static constexpr auto prime1 = std::uint64_t(0x9E3779B185EBCA87), prime2 = std::uint64_t(0xC2B2AE3D27D4EB4F);
+    static constexpr auto prime3 = std::uint64_t(0x165667B19E3779F9), prime4 = std::uint64_t(0x85EBCA77C2B2AE63);
+    static constexpr auto prime5 = std::uint64_t(0x27D4EB2F165667C5);
+    const auto readLE = [](const char *input, auto value) {
+        std::memcpy(&value, input, sizeof(value));
+        if constexpr (std::endian::native == std::endian::big) {
+            value = std::byteswap(value);
+        }
+        return value;
+    };
+    const auto round = [](std::uint64_t acc, std::uint64_t input) { return std::rotl(acc + input * prime2, 31) * prime1; };
+    const auto mergeRound = [&round](std::uint64_t acc, std::uint64_t value) { return (acc ^ round(0, value)) * prime1 + prime4; };
+
+    auto input = data.data();
+    const auto end = input + data.size();
+    auto hash = std::uint64_t();
+    if (data.size() >= 32) {
+        std::uint64_t v1 = seed + prime1 + prime2, v2 = seed + prime2, v3 = seed, v4 = seed - prime1;
+        for (const auto limit = end - 32; input <= limit; input += 32) {
+            v1 = round(v1, readLE(input, std::uint64_t()));
+            v2 = round(v2, readLE(input + 8, std::uint64_t()));
+            v3 = round(v3, readLE(input + 16, std::uint64_t()));
+            v4 = round(v4, readLE(input + 24, std::uint64_t()));
+        }
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        hash = mergeRound(mergeRound(mergeRound(mergeRound(hash, v1), v2), v3), v4);
+    } else {
+        hash = seed + prime5;
+    }
+    hash += static_cast<std::uint64_t>(data.size());
+    for (; end - input >= 8; input += 8) {
+        hash = std::rotl(hash ^ round(0, readLE(input, std::uint64_t())), 27) * prime1 + prime4;
+    }
+    if (end - input >= 4) {
+        hash = std::rotl(hash ^ (readLE(input, std::uint32_t()) * prime1), 23) * prime2 + prime3;
+        input += 4;
+    }
+    for (; input != end; ++input) {
+        hash = std::rotl(hash ^ (static_cast<unsigned char>(*input) * prime5), 11) * prime1;
+    }
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/*!
+ * \brief Returns the key of the information parsed from \a content within a BinaryInfoCache.
+ * \remarks The key consists of Binary::infoVersion, the size and the hash of \a content.
+ */
+std::string binaryInfoKey(std::string_view content)
+{
+    auto key = std::string();
+    key.reserve(17);
+    key += Binary::infoVersion;
+    appendBigEndian(key, static_cast<std::uint64_t>(content.size()));
+    appendBigEndian(key, xxHash64(content));
+    return key;
+}
+
+/*!
+ * \brief Returns whether \a content starts like an ELF file, a PE file or an archive; Binary::parse() ignores anything else.
+ */
+bool hasBinaryMagic(std::string_view content)
+{
+    return content.starts_with("\x7F" "ELF") || content.starts_with("MZ") || content.starts_with("!<arch>\n");
+}
+} // namespace
+/// \endcond
+
+/*!
+ * \brief The BinaryContentReader class reads integers and strings from the buffered or memory-mapped content of a binary.
+ * \remarks
+ * - The buffered content might only be a prefix of the file. Reading beyond the prefix throws BinaryContentTruncated
+ *   which tells how much of the file is required.
+ * - Reading beyond the end of the file throws std::runtime_error so truncated files are treated like any other parsing error.
+ */
+class BinaryContentReader {
+public:
+    explicit BinaryContentReader(std::string_view content, std::uint64_t size, std::uint64_t offset = 0);
+
+    std::string_view content() const;
+    std::uint64_t size() const;
+    std::uint64_t offset() const;
+    std::uint64_t remainingSize() const;
+    BinaryContentReader at(std::uint64_t offset) const;
+    void seek(std::uint64_t offset);
+    void skip(std::uint64_t bytes);
+    std::string_view read(std::uint64_t size);
+    template <typename IntType> IntType readInt(bool isBigEndian = false);
+    std::string readTerminatedString(std::uint64_t maxSize = std::numeric_limits<std::uint64_t>::max(), char terminator = '\0');
+
+private:
+    std::string_view m_content;
+    std::uint64_t m_size;
+    std::uint64_t m_offset;
+};
+
+inline BinaryContentReader::BinaryContentReader(std::string_view content, std::uint64_t size, std::uint64_t offset)
+    : m_content(content)
+    , m_size(size)
+    , m_offset(offset)
+{
+}
+
+/*!
+ * \brief Returns the buffered content which is either the full file or a prefix of it.
+ */
+inline std::string_view BinaryContentReader::content() const
+{
+    return m_content;
+}
+
+/*!
+ * \brief Returns the size of the file.
+ */
+inline std::uint64_t BinaryContentReader::size() const
+{
+    return m_size;
+}
+
+inline std::uint64_t BinaryContentReader::offset() const
+{
+    return m_offset;
+}
+
+inline std::uint64_t BinaryContentReader::remainingSize() const
+{
+    return m_offset < m_size ? m_size - m_offset : 0;
+}
+
+/*!
+ * \brief Returns a reader for the same content starting at \a offset.
+ */
+inline BinaryContentReader BinaryContentReader::at(std::uint64_t offset) const
+{
+    return BinaryContentReader(m_content, m_size, offset);
+}
+
+inline void BinaryContentReader::seek(std::uint64_t offset)
+{
+    m_offset = offset;
+}
+
+inline void BinaryContentReader::skip(std::uint64_t bytes)
+{
+    m_offset += bytes;
+}
+
+/*!
+ * \brief Returns the next \a size bytes without copying them.
+ */
+inline std::string_view BinaryContentReader::read(std::uint64_t size)
+{
+    if (size > remainingSize()) {
+        throw runtime_error(argsToString("unexpected end of binary when reading ", size, " bytes at offset ", m_offset));
+    }
+    if (m_offset + size > m_content.size()) {
+        throw BinaryContentTruncated(m_offset + size);
+    }
+    const auto data = m_content.substr(static_cast<std::size_t>(m_offset), static_cast<std::size_t>(size));
+    m_offset += size;
+    return data;
+}
+
+template <typename IntType> inline IntType BinaryContentReader::readInt(bool isBigEndian)
+{
+    const auto bytes = read(sizeof(IntType));
+    auto value = IntType();
+    for (auto i = std::size_t(); i != sizeof(IntType); ++i) {
+        const auto byte = static_cast<unsigned char>(bytes[isBigEndian ? i : sizeof(IntType) - 1 - i]);
+        value = static_cast<IntType>((static_cast<std::uint64_t>(value) << 8) | byte);
+    }
+    return value;
+}
+
+/*!
+ * \brief Reads up to \a maxSize bytes until \a terminator is reached; the terminator is consumed but not returned.
+ * \remarks Only the buffered content is searched for the terminator so a string never requires more than the bytes up to its end.
+ */
+std::string BinaryContentReader::readTerminatedString(std::uint64_t maxSize, char terminator)
+{
+    const auto size = std::min(maxSize, remainingSize());
+    const auto bufferedSize = m_offset < m_content.size() ? std::min<std::uint64_t>(size, m_content.size() - m_offset) : 0;
+    const auto bufferedOffset = static_cast<std::size_t>(std::min<std::uint64_t>(m_offset, m_content.size()));
+    const auto data = m_content.substr(bufferedOffset, static_cast<std::size_t>(bufferedSize));
+    if (const auto end = data.find(terminator); end != std::string_view::npos) {
+        m_offset += end + 1;
+        return std::string(data.substr(0, end));
+    }
+    if (bufferedSize < size) {
+        throw BinaryContentTruncated(m_offset + bufferedSize + 1);
+    }
+    if (size < maxSize) {
+        throw runtime_error(argsToString("unexpected end of binary when reading terminated string at offset ", m_offset));
+    }
+    m_offset += size;
+    return std::string(data);
+}
+
+/// \cond
+namespace {
+/*!
+ * \brief The MappedFile class maps a file read-only into memory so it can be parsed without copying it through a stream buffer.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path);
+    MappedFile(const MappedFile &) = delete;
+    ~MappedFile();
+
+    std::string_view content() const;
+    bool isRegularFile() const;
+
+private:
+    void *m_data = MAP_FAILED;
+    std::size_t m_size = 0;
+    bool m_isRegularFile = false;
+};
+
+MappedFile::MappedFile(const std::string &path)
+{
+    const auto fd = ::open(path.data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), argsToString("unable to open \"", path, '\"'));
+    }
+    struct stat fileInfo = {};
+    if (::fstat(fd, &fileInfo)) {
+        const auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), argsToString("unable to stat \"", path, '\"'));
+    }
+    m_isRegularFile = S_ISREG(fileInfo.st_mode);
+    m_size = static_cast<std::size_t>(fileInfo.st_size);
+    if (m_size && (m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+        const auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), argsToString("unable to map \"", path, '\"'));
+    }
+    ::close(fd); // the mapping stays valid after closing the file descriptor
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != MAP_FAILED) {
+        ::munmap(m_data, m_size);
+    }
+}
+
+std::string_view MappedFile::content() const
+{
+    return m_data != MAP_FAILED ? std::string_view(static_cast<const char *>(m_data), m_size) : std::string_view();
+}
+
+bool MappedFile::isRegularFile() const
+{
+    return m_isRegularFile;
+}
+} // namespace
+/// \endcond
+
 std::uint64_t VirtualAddressMapping::virtualAddressToFileOffset(std::uint64_t virtualAddress) const
 {
     for (const VirtualAddressMappingEntry &entry : *this) {
@@ -179,12 +494,18 @@ ostream &operator<<(ostream &o, const BinaryClass &mode)
     return o;
 }
 
-void Binary::load(std::string_view filePath)
+/*!
+ * \brief Parses the binary at \a filePath.
+ * \remarks
+ * - The file is memory-mapped and only the parts relevant for the requested information are read. For ELF files this
+ *   means the headers and the dynamic section; the symbol tables are only read when BinaryParseOptions::Symbols is
+ *   specified. For PE files only the headers and the import directory are read.
+ * - Throws std::runtime_error if the file can not be opened or parsed.
+ */
+void Binary::load(std::string_view filePath, BinaryParseOptions options)
 {
-    ifstream file;
-    file.exceptions(ios_base::failbit | ios_base::badbit);
-    file.open(filePath.data(), ios_base::in | ios_base::binary);
-    parse(file);
+    const auto file = MappedFile(std::string(filePath));
+    parse(file.content(), file.content().size(), options);
     switch (type) {
     case BinaryType::Pe:
         // use name of library file as there's no soname field in PEs
@@ -192,7 +513,7 @@ void Binary::load(std::string_view filePath)
         break;
     case BinaryType::Elf:
         // use name of regular file as library name if no soname could be determined
-        if (auto ec = std::error_code(); name.empty() && filePath.ends_with(".so") && std::filesystem::is_regular_file(filePath, ec) && !ec) {
+        if (name.empty() && filePath.ends_with(".so") && file.isRegularFile()) {
             name = fileName(filePath);
         }
         break;
@@ -200,38 +521,59 @@ void Binary::load(std::string_view filePath)
     }
 }
 
-void Binary::load(std::string_view fileContent, std::string_view fileName, std::string_view directoryPath, bool isRegularFile)
+/*!
+ * \brief Parses the binary with the specified, already buffered \a fileContent.
+ * \remarks The content is parsed in-place; see the other overload for details.
+ */
+void Binary::load(std::string_view fileContent, std::string_view fileName, std::string_view directoryPath, bool isRegularFile, BinaryParseOptions options)
 {
-    stringstream fileStream(ios_base::in | ios_base::out | ios_base::binary);
-    fileStream.exceptions(ios_base::failbit | ios_base::badbit);
-#if defined(__GLIBCXX__) && !defined(_LIBCPP_VERSION)
-    fileStream.rdbuf()->pubsetbuf(const_cast<char *>(fileContent.data()), static_cast<streamoff>(fileContent.size()));
-#else
-    fileStream.write(fileContent.data(), static_cast<std::streamsize>(fileContent.size()));
-#endif
-    parse(fileStream, &fileContent);
-    switch (type) {
-    case BinaryType::Pe:
-        // use name of library file as there's no soname field in PEs
-        name = fileName;
-        break;
-    case BinaryType::Elf:
-        // use name of regular file as library name if no soname could be determined
-        if (name.empty() && isRegularFile && fileName.ends_with(".so")) {
-            name = fileName;
-        }
-        // add prefix to Android and compat libs to avoid confusion with normal GNU/Linux ELFs
-        // note: Relying on the path is not nice. Have Android libs any special header to be distinguishable?
-        if (directoryPath.starts_with("opt/android-libs")
-            || (directoryPath.starts_with("opt/android-ndk")
-                && (directoryPath.find("/sysroot/") != std::string::npos || directoryPath.find("/lib/linux/") != std::string::npos))) {
-            extraPrefix = "android-";
-        } else if (directoryPath.starts_with("usr/static-compat/lib") && fileName.find(".so") != std::string::npos) {
-            extraPrefix = "static-compat-";
-        }
-        break;
-    default:;
+    parse(fileContent, fileContent.size(), options);
+    applyFileInfo(fileName, directoryPath, isRegularFile);
+}
+
+/*!
+ * \brief Parses the binary with the specified, already buffered \a fileContent unless \a cache already knows the result.
+ * \remarks
+ * - Behaves like the overload without cache (using the default options) but only parses \a fileContent if it has not
+ *   been parsed before. The result is added to \a cache in that case.
+ * - Entries are keyed by the size and a 64-bit hash of \a fileContent so cached results are only re-used for identical
+ *   content, e.g. for files that have not changed across a pkgrel bump.
+ * - Files which are not binaries at all are not cached as telling them apart is cheaper than a lookup.
+ */
+void Binary::load(BinaryInfoCache &cache, std::string_view fileContent, std::string_view fileName, std::string_view directoryPath, bool isRegularFile)
+{
+    if (!hasBinaryMagic(fileContent)) {
+        load(fileContent, fileName, directoryPath, isRegularFile);
+        return;
     }
+    auto key = binaryInfoKey(fileContent);
+    auto info = std::string();
+    if (!cache.find(key, info) || !restoreInfo(info)) {
+        parse(fileContent, fileContent.size(), BinaryParseOptions::None);
+        cache.add(std::move(key), serializeInfo());
+    }
+    applyFileInfo(fileName, directoryPath, isRegularFile);
+}
+
+/*!
+ * \brief Returns how many bytes of a file with the specified \a fileSize are required to load it via load().
+ * \remarks
+ * - Returns 0 if \a contentPrefix suffices; loading just the prefix then yields the same result as loading the whole file.
+ * - Otherwise returns the size of the prefix needed to continue parsing. The next call with a prefix of at least that size
+ *   might require even more as, for instance, the dynamic section of an ELF file is only located after reading its headers.
+ * - Returns 0 as well if the file is not a supported binary at all.
+ */
+std::uint64_t Binary::requiredContentSize(std::string_view contentPrefix, std::uint64_t fileSize, BinaryParseOptions options)
+{
+    try {
+        auto binary = Binary();
+        binary.parse(contentPrefix, fileSize, options);
+    } catch (const BinaryContentTruncated &e) {
+        return e.requiredSize();
+    } catch (const std::runtime_error &) {
+        // loading the binary would fail regardless of how much of it is buffered
+    }
+    return 0;
 }
 
 static constexpr auto toLower(auto c)
@@ -265,40 +607,125 @@ std::string Binary::addPrefix(std::string_view dependencyName) const
     }
 }
 
-void Binary::parse(std::istream &stream, const std::string_view *fileContent)
+/*!
+ * \brief Applies the information which depends on the file the binary has been loaded from rather than its content.
+ */
+void Binary::applyFileInfo(std::string_view fileName, std::string_view directoryPath, bool isRegularFile)
+{
+    switch (type) {
+    case BinaryType::Pe:
+        // use name of library file as there's no soname field in PEs
+        name = fileName;
+        break;
+    case BinaryType::Elf:
+        // use name of regular file as library name if no soname could be determined
+        if (name.empty() && isRegularFile && fileName.ends_with(".so")) {
+            name = fileName;
+        }
+        // add prefix to Android and compat libs to avoid confusion with normal GNU/Linux ELFs
+        // note: Relying on the path is not nice. Have Android libs any special header to be distinguishable?
+        if (directoryPath.starts_with("opt/android-libs")
+            || (directoryPath.starts_with("opt/android-ndk")
+                && (directoryPath.find("/sysroot/") != std::string::npos || directoryPath.find("/lib/linux/") != std::string::npos))) {
+            extraPrefix = "android-";
+        } else if (directoryPath.starts_with("usr/static-compat/lib") && fileName.find(".so") != std::string::npos) {
+            extraPrefix = "static-compat-";
+        }
+        break;
+    default:;
+    }
+}
+
+/*!
+ * \brief Returns the information parse() has read for storing it in a BinaryInfoCache.
+ * \remarks Only the information relevant for dependencies is stored (no symbols and no virtual address mapping).
+ */
+std::string Binary::serializeInfo() const
+{
+    auto info = std::string();
+    info += static_cast<char>(type);
+    appendBigEndian(info, static_cast<std::uint16_t>(subType));
+    info += static_cast<char>(binaryClass);
+    info += static_cast<char>(isBigEndian);
+    for (const auto &string : { std::string_view(name), std::string_view(architecture), std::string_view(rpath) }) {
+        appendBigEndian(info, static_cast<std::uint32_t>(string.size()));
+        info.append(string);
+    }
+    appendBigEndian(info, static_cast<std::uint32_t>(requiredLibs.size()));
+    for (const auto &requiredLib : requiredLibs) {
+        appendBigEndian(info, static_cast<std::uint32_t>(requiredLib.size()));
+        info.append(requiredLib);
+    }
+    return info;
+}
+
+/*!
+ * \brief Restores the information parse() would read from \a info returned by serializeInfo().
+ * \returns Returns whether \a info is valid; the binary is left untouched otherwise.
+ */
+bool Binary::restoreInfo(std::string_view info)
+{
+    try {
+        auto reader = BinaryContentReader(info, info.size());
+        const auto readString = [&reader] { return std::string(reader.read(reader.readInt<std::uint32_t>(true))); };
+        const auto restoredType = static_cast<BinaryType>(reader.readInt<std::uint8_t>());
+        const auto restoredSubType = static_cast<BinarySubType>(reader.readInt<std::uint16_t>(true));
+        const auto restoredClass = static_cast<BinaryClass>(reader.readInt<std::uint8_t>());
+        const auto restoredBigEndian = reader.readInt<std::uint8_t>() != 0;
+        auto restoredName = readString(), restoredArchitecture = readString(), restoredRPath = readString();
+        auto restoredRequiredLibs = std::set<std::string>();
+        for (auto count = reader.readInt<std::uint32_t>(true); count; --count) {
+            restoredRequiredLibs.emplace(readString());
+        }
+        if (reader.remainingSize()) {
+            return false;
+        }
+        type = restoredType;
+        subType = restoredSubType;
+        binaryClass = restoredClass;
+        isBigEndian = restoredBigEndian;
+        name = std::move(restoredName);
+        architecture = std::move(restoredArchitecture);
+        rpath = std::move(restoredRPath);
+        requiredLibs = std::move(restoredRequiredLibs);
+        return true;
+    } catch (const std::runtime_error &) {
+        return false;
+    }
+}
+
+void Binary::parse(std::string_view content, std::uint64_t size, BinaryParseOptions options)
 {
     type = BinaryType::Invalid;
 
-    BinaryReader reader(&stream);
-    const auto magic = reader.readUInt32BE();
+    auto reader = BinaryContentReader(content, size);
+    const auto magic = reader.readInt<std::uint32_t>(true);
     if (magic == 0x7f454c46) {
         type = BinaryType::Elf;
-        parseElf(reader, fileContent);
+        parseElf(reader, options);
         return;
     }
 
     if ((magic & 0xffff0000) == 0x4d5a0000) {
-        stream.seekg(0x3C, ios_base::beg);
-        stream.seekg(reader.readUInt32LE(), ios_base::beg);
-        if (reader.readUInt32BE() == 0x50450000) {
+        reader.seek(0x3C);
+        reader.seek(reader.readInt<std::uint32_t>());
+        if (reader.readInt<std::uint32_t>(true) == 0x50450000) {
             type = BinaryType::Pe;
             parsePe(reader);
         }
         return;
     }
 
-    if (magic == 0x213C6172 && reader.readUInt32BE() == 0x63683E0A) {
+    if (magic == 0x213C6172 && reader.readInt<std::uint32_t>(true) == 0x63683E0A) {
         type = BinaryType::Ar;
         parseAr(reader);
     }
 }
 
-void Binary::parseElf(BinaryReader &reader, const std::string_view *fileContent)
+void Binary::parseElf(BinaryContentReader &reader, BinaryParseOptions options)
 {
-    istream &stream = *reader.stream();
-
     // read class
-    switch (reader.readByte()) {
+    switch (reader.readInt<std::uint8_t>()) {
     case 1:
         binaryClass = BinaryClass::Class32Bit;
         break;
@@ -311,22 +738,22 @@ void Binary::parseElf(BinaryReader &reader, const std::string_view *fileContent)
     }
 
     // read byte-order
-    const auto endianness = reader.readByte();
+    const auto endianness = reader.readInt<std::uint8_t>();
     if (endianness != 1 && endianness != 2) {
         throw runtime_error("invalid endianness");
     }
     isBigEndian = endianness == 2;
 
     // check version
-    if (reader.readByte() != 1) {
+    if (reader.readInt<std::uint8_t>() != 1) {
         throw runtime_error("invalid ELF version");
     }
 
     // skip padding
-    stream.seekg(9, ios_base::cur);
+    reader.skip(9);
 
     // read sub type
-    const std::uint16_t subType = reader.readUInt16LE();
+    const std::uint16_t subType = readElfInt16(reader);
     if (subType < 5 || subType == static_cast<std::uint16_t>(BinarySubType::LoProc) || subType == static_cast<std::uint16_t>(BinarySubType::HiProc)) {
         this->subType = static_cast<BinarySubType>(subType);
     } else {
@@ -334,7 +761,7 @@ void Binary::parseElf(BinaryReader &reader, const std::string_view *fileContent)
     }
 
     // read machine/architecture
-    switch (reader.readUInt16LE()) {
+    switch (readElfInt16(reader)) {
     case 0x02:
         architecture = "sparc";
         break;
@@ -367,40 +794,43 @@ void Binary::parseElf(BinaryReader &reader, const std::string_view *fileContent)
     }
 
     // check version
-    if (reader.readUInt32LE() != 1) {
+    if (readElfInt32(reader) != 1) {
         throw runtime_error("invalid section ELF version");
     }
 
     // skip entry point
     //const uint64 entryPoint = readElfAddress(reader);
-    stream.seekg(binaryClass == BinaryClass::Class64Bit ? 8 : 4, ios_base::cur);
+    const auto is64Bit = binaryClass == BinaryClass::Class64Bit;
+    reader.skip(is64Bit ? 8 : 4);
     // read offsets
     const std::uint64_t programHeaderOffset = readElfAddress(reader);
     const std::uint64_t sectionTableOffset = readElfAddress(reader);
     // skip flags
-    stream.seekg(4, ios_base::cur);
+    reader.skip(4);
     // read sizes
     /*const std::uint16_t elfHeaderSize = */ readElfInt16(reader);
-    /*const std::uint16_t programHeaderEntrySize = */ readElfInt16(reader);
+    const std::uint16_t programHeaderEntrySize = readElfInt16(reader);
     const std::uint16_t programHeaderEntryCount = readElfInt16(reader);
-    /*const std::uint16_t sectionHeaderSize = */ readElfInt16(reader);
+    const std::uint16_t sectionHeaderEntrySize = readElfInt16(reader);
     const std::uint16_t sectionHeaderCount = readElfInt16(reader);
     /*const std::uint16_t nameTableIndex = */ readElfInt16(reader);
 
-    // read program header
-    stream.seekg(static_cast<istream::off_type>(programHeaderOffset));
+    // read program header to map virtual addresses to file offsets and to locate the dynamic section
+    if (programHeaderEntryCount && programHeaderEntrySize < (is64Bit ? 56 : 32)) {
+        throw runtime_error("invalid size of program header entries");
+    }
+    std::uint64_t dynamicSectionOffset = 0, dynamicSectionSize = 0;
     virtualAddressMapping.reserve(2);
     for (std::uint16_t programHeaderIndex = 0; programHeaderIndex != programHeaderEntryCount; ++programHeaderIndex) {
+        reader.seek(programHeaderOffset + programHeaderIndex * std::uint64_t(programHeaderEntrySize));
         std::uint64_t fileOffset, virtualAddr, /*physicalAddr,*/ fileSize, virtualSize /*, flags, align*/;
         const std::uint32_t type = readElfInt32(reader);
-        if (binaryClass == BinaryClass::Class32Bit) {
+        if (!is64Bit) {
             fileOffset = readElfInt32(reader);
             virtualAddr = readElfInt32(reader);
             /*physicalAddr = */ readElfInt32(reader);
             fileSize = readElfInt32(reader);
             virtualSize = readElfInt32(reader);
-            /*flags = */ readElfInt32(reader);
-            /*align = */ readElfInt32(reader);
         } else {
             /*flags = */ readElfInt32(reader);
             fileOffset = readElfAddress(reader);
@@ -408,87 +838,144 @@ void Binary::parseElf(BinaryReader &reader, const std::string_view *fileContent)
             /*physicalAddr = */ readElfAddress(reader);
             fileSize = readElfAddress(reader);
             virtualSize = readElfAddress(reader);
-            /*align = */ readElfAddress(reader);
         }
         switch (type) {
         case ProgramHeaderTypes::Load:
             virtualAddressMapping.emplace_back(fileOffset, fileSize, virtualAddr, virtualSize);
             break;
+        case ProgramHeaderTypes::Dynamic:
+            dynamicSectionOffset = fileOffset;
+            dynamicSectionSize = fileSize;
+            break;
         }
     }
 
-    // read section header
-    /*std::uint64_t stringTableOffset = 0, stringTableSize = 0;*/
-    stream.seekg(static_cast<istream::off_type>(sectionTableOffset));
-    for (std::uint16_t sectionHeaderIndex = 0; sectionHeaderIndex != sectionHeaderCount; ++sectionHeaderIndex) {
-        /*const std::uint32_t nameOffset = */ readElfInt32(reader);
-        const std::uint32_t type = readElfInt32(reader);
-        /*const std::uint64_t attributes = */ readElfAddress(reader);
-        /*const std::uint64_t virtualMemoryAddress = */ readElfAddress(reader);
-        const std::uint64_t offset = readElfAddress(reader);
-        const std::uint64_t size = readElfAddress(reader);
-        /*const std::uint32_t indexInAssociatedSection = */ readElfInt32(reader);
-        /*const std::uint32_t extraInfo = */ readElfInt32(reader);
-        /*const std::uint64_t requiredAlignment = */ readElfAddress(reader);
-        /*const std::uint64_t entrySize = */ readElfAddress(reader);
-        const auto nextSectionHeaderOffset = stream.tellg();
-
-        // read section
-        switch (type) {
-        case BinarySectionTypes::StringTable: {
-            /*stringTableOffset = offset;
-            stringTableSize = size;*/
-            break;
+    // read section header only if the dynamic section has not been found via the program header or if symbols are requested
+    // note: The section header is usually at the end of the file so reading it would likely cause additional page faults.
+    const auto readSymbols = static_cast<bool>(options & BinaryParseOptions::Symbols);
+    if ((!dynamicSectionSize || readSymbols) && sectionHeaderCount) {
+        if (sectionHeaderEntrySize < (is64Bit ? 64 : 40)) {
+            throw runtime_error("invalid size of section header entries");
         }
-        case BinarySectionTypes::DynamicLinkingInfo: {
-            // read string address of properties
-            stream.seekg(static_cast<istream::off_type>(offset));
-            std::uint64_t dynamicStringTableAddress = 0, dynamicStringTableSize = 0, sonameAddr = 0, rpathAddr = 0;
-            vector<std::uint64_t> neededLibs;
-            for (std::uint64_t read = 0; read < size; read += (binaryClass == BinaryClass::Class64Bit ? 16 : 8)) {
-                const std::uint64_t tag = readElfAddress(reader);
-                const std::uint64_t value = readElfAddress(reader);
-                switch (tag) {
-                case BinaryDynamicTags::StringTableAddress:
-                    dynamicStringTableAddress = value;
-                    break;
-                case BinaryDynamicTags::StringTableSize:
-                    dynamicStringTableSize = value;
-                    break;
-                case BinaryDynamicTags::Soname:
-                    sonameAddr = value;
-                    break;
-                case BinaryDynamicTags::RPath:
-                    rpathAddr = value;
-                    break;
-                case BinaryDynamicTags::RunPath:
-                    rpathAddr = value;
-                    break;
-                case BinaryDynamicTags::Needed:
-                    neededLibs.push_back(value);
-                    break;
-                default:;
-                }
-            }
-
-            // lookup string address in string table to get actual strings
-            if (dynamicStringTableAddress && dynamicStringTableSize) {
-                if (sonameAddr) {
-                    name = readElfString(stream, fileContent, dynamicStringTableAddress, dynamicStringTableSize, sonameAddr);
+        struct SectionHeader {
+            std::uint32_t type;
+            std::uint64_t offset, size;
+            std::uint32_t link;
+            std::uint64_t entrySize;
+        };
+        const auto readSectionHeader = [&](std::uint64_t sectionHeaderIndex) {
+            auto section = SectionHeader();
+            reader.seek(sectionTableOffset + sectionHeaderIndex * sectionHeaderEntrySize);
+            /*const std::uint32_t nameOffset = */ readElfInt32(reader);
+            section.type = readElfInt32(reader);
+            /*const std::uint64_t attributes = */ readElfAddress(reader);
+            /*const std::uint64_t virtualMemoryAddress = */ readElfAddress(reader);
+            section.offset = readElfAddress(reader);
+            section.size = readElfAddress(reader);
+            section.link = readElfInt32(reader);
+            /*const std::uint32_t extraInfo = */ readElfInt32(reader);
+            /*const std::uint64_t requiredAlignment = */ readElfAddress(reader);
+            section.entrySize = readElfAddress(reader);
+            return section;
+        };
+        for (std::uint16_t sectionHeaderIndex = 0; sectionHeaderIndex != sectionHeaderCount; ++sectionHeaderIndex) {
+            const auto section = readSectionHeader(sectionHeaderIndex);
+            switch (section.type) {
+            case BinarySectionTypes::DynamicLinkingInfo:
+                if (!dynamicSectionSize) {
+                    dynamicSectionOffset = section.offset;
+                    dynamicSectionSize = section.size;
                 }
-                if (rpathAddr) {
-                    rpath = readElfString(stream, fileContent, dynamicStringTableAddress, dynamicStringTableSize, rpathAddr);
-                }
-                for (const std::uint64_t neededLibStrAddr : neededLibs) {
-                    requiredLibs.emplace(readElfString(stream, fileContent, dynamicStringTableAddress, dynamicStringTableSize, neededLibStrAddr));
+                break;
+            case BinarySectionTypes::DynamicLinkerSymbolTable:
+                if (readSymbols && section.link < sectionHeaderCount) {
+                    const auto stringTable = readSectionHeader(section.link);
+                    parseElfSymbols(reader, section.offset, section.size, section.entrySize, stringTable.offset, stringTable.size);
                 }
+                break;
+            default:; // section not relevant
             }
+        }
+    }
+
+    // read string addresses of properties from dynamic section
+    if (!dynamicSectionSize) {
+        return;
+    }
+    reader.seek(dynamicSectionOffset);
+    std::uint64_t dynamicStringTableAddress = 0, dynamicStringTableSize = 0, sonameAddr = 0, rpathAddr = 0;
+    auto neededLibs = std::vector<std::uint64_t>();
+    for (std::uint64_t read = 0; read < dynamicSectionSize; read += (is64Bit ? 16 : 8)) {
+        const std::uint64_t tag = readElfAddress(reader);
+        const std::uint64_t value = readElfAddress(reader);
+        switch (tag) {
+        case BinaryDynamicTags::Null:
+            read = dynamicSectionSize; // end of dynamic section reached
             break;
+        case BinaryDynamicTags::StringTableAddress:
+            dynamicStringTableAddress = value;
+            break;
+        case BinaryDynamicTags::StringTableSize:
+            dynamicStringTableSize = value;
+            break;
+        case BinaryDynamicTags::Soname:
+            sonameAddr = value;
+            break;
+        case BinaryDynamicTags::RPath:
+            rpathAddr = value;
+            break;
+        case BinaryDynamicTags::RunPath:
+            rpathAddr = value;
+            break;
+        case BinaryDynamicTags::Needed:
+            neededLibs.push_back(value);
+            break;
+        default:;
         }
-        default:; // section not relevant
+    }
+
+    // lookup string address in string table to get actual strings
+    if (!dynamicStringTableAddress || !dynamicStringTableSize) {
+        return;
+    }
+    if (sonameAddr) {
+        name = readElfString(reader, dynamicStringTableAddress, dynamicStringTableSize, sonameAddr);
+    }
+    if (rpathAddr) {
+        rpath = readElfString(reader, dynamicStringTableAddress, dynamicStringTableSize, rpathAddr);
+    }
+    for (const std::uint64_t neededLibStrAddr : neededLibs) {
+        requiredLibs.emplace(readElfString(reader, dynamicStringTableAddress, dynamicStringTableSize, neededLibStrAddr));
+    }
+}
+
+/*!
+ * \brief Adds the names of the defined global and weak symbols of the specified symbol table to symbols.
+ */
+void Binary::parseElfSymbols(BinaryContentReader &reader, std::uint64_t symbolTableOffset, std::uint64_t symbolTableSize,
+    std::uint64_t symbolEntrySize, std::uint64_t stringTableOffset, std::uint64_t stringTableSize)
+{
+    const auto is64Bit = binaryClass == BinaryClass::Class64Bit;
+    if (symbolEntrySize < (is64Bit ? 24 : 16)) {
+        throw runtime_error("invalid size of symbol table entries");
+    }
+    const auto stringTable = reader.at(stringTableOffset).read(stringTableSize);
+    const auto symbolCount = symbolTableSize / symbolEntrySize;
+    for (std::uint64_t symbolIndex = 1; symbolIndex < symbolCount; ++symbolIndex) { // skip the undefined symbol at index 0
+        reader.seek(symbolTableOffset + symbolIndex * symbolEntrySize);
+        const auto nameOffset = readElfInt32(reader);
+        reader.skip(is64Bit ? 0 : 8); // skip value and size which come first in 32-bit ELFs
+        const auto info = reader.readInt<std::uint8_t>();
+        reader.skip(1); // skip visibility
+        const auto sectionIndex = readElfInt16(reader);
+        const auto binding = info >> 4;
+        if (!sectionIndex || (binding != 1 && binding != 2) || nameOffset >= stringTable.size()) {
+            continue; // skip undefined and local symbols
+        }
+        const auto name = stringTable.substr(nameOffset);
+        if (const auto nameSize = name.find('\0'); nameSize) {
+            symbols.emplace(name.substr(0, nameSize));
         }
-        // read next section header
-        stream.seekg(nextSectionHeaderOffset);
     }
 }
 
@@ -504,18 +991,18 @@ struct PeSectionData {
     std::uint16_t lineNumbersCount;
     std::uint32_t characteristics;
 
-    void read(BinaryReader &reader)
+    void read(BinaryContentReader &reader)
     {
-        reader.read(name, 8);
-        virtualSize = reader.readUInt32LE();
-        virtualAddress = reader.readUInt32LE();
-        fileSize = reader.readUInt32LE();
-        fileOffset = reader.readUInt32LE();
-        relocationPtr = reader.readUInt32LE();
-        lineNumbersPtr = reader.readUInt32LE();
-        relocationCount = reader.readUInt16LE();
-        lineNumbersCount = reader.readUInt16LE();
-        characteristics = reader.readUInt32LE();
+        reader.read(sizeof(name)).copy(name, sizeof(name));
+        virtualSize = reader.readInt<std::uint32_t>();
+        virtualAddress = reader.readInt<std::uint32_t>();
+        fileSize = reader.readInt<std::uint32_t>();
+        fileOffset = reader.readInt<std::uint32_t>();
+        relocationPtr = reader.readInt<std::uint32_t>();
+        lineNumbersPtr = reader.readInt<std::uint32_t>();
+        relocationCount = reader.readInt<std::uint16_t>();
+        lineNumbersCount = reader.readInt<std::uint16_t>();
+        characteristics = reader.readInt<std::uint32_t>();
     }
 };
 
@@ -526,13 +1013,13 @@ struct PeImportTableEntry {
     std::uint32_t nameVirtualAddress;
     std::uint32_t firstThunk;
 
-    void read(BinaryReader &reader)
+    void read(BinaryContentReader &reader)
     {
-        originalFirstThunk = reader.readUInt32LE();
-        timeDateStamp = reader.readUInt32LE();
-        forwarderChain = reader.readUInt32LE();
-        nameVirtualAddress = reader.readUInt32LE();
-        firstThunk = reader.readUInt32LE();
+        originalFirstThunk = reader.readInt<std::uint32_t>();
+        timeDateStamp = reader.readInt<std::uint32_t>();
+        forwarderChain = reader.readInt<std::uint32_t>();
+        nameVirtualAddress = reader.readInt<std::uint32_t>();
+        firstThunk = reader.readInt<std::uint32_t>();
     }
 
     constexpr bool isEmpty() const
@@ -541,12 +1028,10 @@ struct PeImportTableEntry {
     }
 };
 
-void Binary::parsePe(BinaryReader &reader, iostream::off_type baseFileOffset)
+void Binary::parsePe(BinaryContentReader &reader, std::uint64_t baseFileOffset)
 {
-    istream &stream = *reader.stream();
-
     // read machine/architecture
-    switch (reader.readUInt16LE()) {
+    switch (reader.readInt<std::uint16_t>()) {
     case 0x14c:
         architecture = "i386";
         break;
@@ -574,30 +1059,30 @@ void Binary::parsePe(BinaryReader &reader, iostream::off_type baseFileOffset)
     }
 
     // read rest of COFF header
-    const auto numberOfSections = reader.readUInt16LE();
-    /*const auto timeDateStamp = */ reader.readUInt32LE();
-    /*const auto symbolTableOffset = */ reader.readUInt32LE();
-    /*const auto symbolTableSize = */ reader.readUInt32LE();
-    const auto optionHeaderSize = reader.readUInt16LE();
-    /*const auto characteristics = */ reader.readUInt16LE();
+    const auto numberOfSections = reader.readInt<std::uint16_t>();
+    /*const auto timeDateStamp = */ reader.readInt<std::uint32_t>();
+    /*const auto symbolTableOffset = */ reader.readInt<std::uint32_t>();
+    /*const auto symbolTableSize = */ reader.readInt<std::uint32_t>();
+    const auto optionHeaderSize = reader.readInt<std::uint16_t>();
+    /*const auto characteristics = */ reader.readInt<std::uint16_t>();
 
     // read PE optional header
     int64_t /*exportDirVirtualAddress = -1, exportDirSize = -1, */ importDirVirtualAddress = -1 /*, importDirSize = -1*/;
     if (optionHeaderSize) {
-        const auto optionHeaderStart = static_cast<long>(stream.tellg());
+        const auto optionHeaderStart = reader.offset();
         unsigned char minPeHeaderSize;
         /*uint64_t imageBase;*/
-        switch (reader.readUInt16LE()) {
+        switch (reader.readInt<std::uint16_t>()) {
         case 0x020b:
             binaryClass = BinaryClass::Class64Bit;
-            stream.seekg(optionHeaderStart + 24, ios_base::beg);
-            /*imageBase = */ reader.readUInt64LE();
+            reader.seek(optionHeaderStart + 24);
+            /*imageBase = */ reader.readInt<std::uint64_t>();
             minPeHeaderSize = 112;
             break;
         case 0x010b:
             binaryClass = BinaryClass::Class32Bit;
-            stream.seekg(optionHeaderStart + 28, ios_base::beg);
-            /*imageBase = */ reader.readUInt32LE();
+            reader.seek(optionHeaderStart + 28);
+            /*imageBase = */ reader.readInt<std::uint32_t>();
             minPeHeaderSize = 96;
             break;
             // case 0x0107: ROM image, not relevant
@@ -608,17 +1093,17 @@ void Binary::parsePe(BinaryReader &reader, iostream::off_type baseFileOffset)
             throw runtime_error("PE optional header is truncated");
         }
         // read virtual addresses of directories
-        stream.seekg(optionHeaderStart + minPeHeaderSize - 4);
-        const auto numberOfDirs = reader.readUInt32LE();
+        reader.seek(optionHeaderStart + minPeHeaderSize - 4);
+        const auto numberOfDirs = reader.readInt<std::uint32_t>();
         if (numberOfDirs < 16) {
             throw runtime_error("expected at least 16 directories in PE file");
         }
-        /*exportDirVirtualAddress = */ reader.readUInt32LE();
-        /*exportDirSize = */ reader.readUInt32LE();
-        importDirVirtualAddress = reader.readUInt32LE();
-        /*importDirSize = */ reader.readUInt32LE();
+        /*exportDirVirtualAddress = */ reader.readInt<std::uint32_t>();
+        /*exportDirSize = */ reader.readInt<std::uint32_t>();
+        importDirVirtualAddress = reader.readInt<std::uint32_t>();
+        /*importDirSize = */ reader.readInt<std::uint32_t>();
         // skip remaining dirs (not relevant here)
-        stream.seekg(optionHeaderStart + optionHeaderSize, ios_base::beg);
+        reader.seek(optionHeaderStart + optionHeaderSize);
     }
 
     // read section table for mapping virtual addresses to file offsets
@@ -627,7 +1112,8 @@ void Binary::parsePe(BinaryReader &reader, iostream::off_type baseFileOffset)
     for (auto sectionsLeft = numberOfSections; sectionsLeft; --sectionsLeft) {
         importDataSection.read(reader);
         // read the import library DLL name; ld from binutils writes it to ".idata$7" and lld to ".idata$6"
-        if (importLibraryDllNameOffset < 0 && (!strncmp(importDataSection.name, ".idata$7", 8) || !strncmp(importDataSection.name, ".idata$6", 8))) {
+        if (const auto sectionName = std::string_view(importDataSection.name, sizeof(importDataSection.name));
+            importLibraryDllNameOffset < 0 && (sectionName == ".idata$7" || sectionName == ".idata$6")) {
             importLibraryDllNameOffset = importDataSection.fileOffset;
             importLibraryDllNameSize = importDataSection.fileSize;
         }
@@ -637,36 +1123,34 @@ void Binary::parsePe(BinaryReader &reader, iostream::off_type baseFileOffset)
 
     // read import dir to get dependencies
     if (importDirVirtualAddress >= 0) {
-        const auto importDirFileAddress
-            = static_cast<istream::off_type>(virtualAddressMapping.virtualAddressToFileOffset(static_cast<uint32_t>(importDirVirtualAddress)));
+        const auto importDirFileAddress = virtualAddressMapping.virtualAddressToFileOffset(static_cast<uint32_t>(importDirVirtualAddress));
         if (!importDirFileAddress) {
             throw runtime_error("unable to map virtual address of import directory to its file offset");
         }
-        stream.seekg(baseFileOffset + importDirFileAddress, ios_base::beg);
+        reader.seek(baseFileOffset + importDirFileAddress);
         PeImportTableEntry importEntry;
-        vector<istream::off_type> dllNameOffsets;
+        auto dllNameOffsets = std::vector<std::uint64_t>();
         for (;;) {
             importEntry.read(reader);
             if (importEntry.isEmpty()) {
                 break;
             }
-            const auto nameFileAddress
-                = static_cast<istream::off_type>(virtualAddressMapping.virtualAddressToFileOffset(importEntry.nameVirtualAddress));
+            const auto nameFileAddress = virtualAddressMapping.virtualAddressToFileOffset(importEntry.nameVirtualAddress);
             if (!nameFileAddress) {
                 throw runtime_error("unable to map virtual address of import DLL name to its file offset");
             }
             dllNameOffsets.emplace_back(nameFileAddress);
         }
         for (const auto dllNameOffset : dllNameOffsets) {
-            stream.seekg(dllNameOffset, ios_base::beg);
+            reader.seek(baseFileOffset + dllNameOffset);
             requiredLibs.emplace(reader.readTerminatedString());
         }
     }
 
     // read import library name
     if (importLibraryDllNameOffset >= 0) {
-        stream.seekg(baseFileOffset + importLibraryDllNameOffset, ios_base::beg);
-        name = reader.readTerminatedString(static_cast<size_t>(importLibraryDllNameSize), 0);
+        reader.seek(baseFileOffset + static_cast<std::uint64_t>(importLibraryDllNameOffset));
+        name = reader.readTerminatedString(static_cast<std::uint64_t>(importLibraryDllNameSize));
     }
 }
 
@@ -680,29 +1164,28 @@ static bool isDllOrDrv(std::string_view fileNameView)
 /*!
  * \sa https://en.wikipedia.org/wiki/Ar_(Unix)
  */
-void Binary::parseAr(BinaryReader &reader)
+void Binary::parseAr(BinaryContentReader &reader)
 {
-    const auto size = reader.readStreamsize();
+    const auto size = reader.size();
     auto extendedFileNames = std::vector<std::string>();
-    for (auto remainingSize = size; remainingSize >= 60;) {
+    while (reader.remainingSize() >= 60) {
         // skip odd offsets as archive members are aligned to even byte boundaries
-        const auto startOffset = reader.stream()->tellg();
-        if ((startOffset % 2) != 0) {
-            if (reader.readByte() != '\n') {
+        if ((reader.offset() % 2) != 0) {
+            if (reader.readInt<std::uint8_t>() != '\n') {
                 throw runtime_error("padding/newline to align archive entry on even byte boundaries is not present");
             }
-            if ((remainingSize -= 1) < 60) {
+            if (reader.remainingSize() < 60) {
                 break;
             }
         }
 
         // read file header
         char fileName[17] = { 0 };
-        reader.read(fileName, sizeof(fileName) - 1);
-        reader.stream()->seekg(12 + 6 + 6 + 8, ios_base::cur); // skip file modification timestamp, owner, group and file mode
+        reader.read(sizeof(fileName) - 1).copy(fileName, sizeof(fileName) - 1);
+        reader.skip(12 + 6 + 6 + 8); // skip file modification timestamp, owner, group and file mode
         char fileSizeStr[11] = { 0 };
-        reader.read(fileSizeStr, sizeof(fileSizeStr) - 1);
-        if (reader.readUInt16BE() != 0x600A) {
+        reader.read(sizeof(fileSizeStr) - 1).copy(fileSizeStr, sizeof(fileSizeStr) - 1);
+        if (reader.readInt<std::uint16_t>(true) != 0x600A) {
             throw runtime_error("ending characters not present");
         }
 
@@ -724,9 +1207,9 @@ void Binary::parseAr(BinaryReader &reader)
             }
         }
 
-        const auto fileOffset = reader.stream()->tellg();
+        const auto fileOffset = reader.offset();
         static_assert(std::is_scalar_v<std::decay_t<decltype(fileSizeStr)>>);
-        const auto fileSize = stringToNumber<iostream::off_type>(fileSizeStr);
+        const auto fileSize = stringToNumber<std::uint64_t>(fileSizeStr);
         const auto nextFileOffset = fileOffset + fileSize;
         auto fileNameView = std::string_view(fileName);
         if (fileNameView != "//" && fileNameView.starts_with('/')) {
@@ -752,12 +1235,12 @@ void Binary::parseAr(BinaryReader &reader)
                 }
             }
         } else if (const auto dllOrDrv = isDllOrDrv(fileNameView); dllOrDrv || fileNameView.ends_with(".o")) {
-            const auto magic = reader.readUInt32BE();
+            const auto magic = reader.readInt<std::uint32_t>(true);
             if (magic == 0x7f454c46u) {
                 return; // we're not interested in static libraries containing ELF files
             }
 
-            reader.stream()->seekg(-4, ios_base::cur);
+            reader.seek(fileOffset);
             parsePe(reader, fileOffset);
             if (name.empty() && dllOrDrv) {
                 name = fileNameView;
@@ -769,38 +1252,37 @@ void Binary::parseAr(BinaryReader &reader)
         }
 
         // parse the next file
-        remainingSize -= fileOffset - startOffset + fileSize;
         if (nextFileOffset >= size) {
             break;
         }
-        reader.stream()->seekg(nextFileOffset);
+        reader.seek(nextFileOffset);
     }
 }
 
-std::uint64_t Binary::readElfAddress(BinaryReader &reader)
+std::uint64_t Binary::readElfAddress(BinaryContentReader &reader)
 {
     switch (binaryClass) {
     case BinaryClass::Class64Bit:
-        return isBigEndian ? reader.readUInt64BE() : reader.readUInt64LE();
+        return reader.readInt<std::uint64_t>(isBigEndian);
     case BinaryClass::Class32Bit:
-        return isBigEndian ? reader.readUInt32BE() : reader.readUInt32LE();
+        return reader.readInt<std::uint32_t>(isBigEndian);
     default:
         throw runtime_error("Invalid binary class");
     }
 }
 
-std::uint32_t Binary::readElfInt32(BinaryReader &reader)
+std::uint32_t Binary::readElfInt32(BinaryContentReader &reader)
 {
-    return isBigEndian ? reader.readUInt32BE() : reader.readUInt32LE();
+    return reader.readInt<std::uint32_t>(isBigEndian);
 }
 
-std::uint16_t Binary::readElfInt16(BinaryReader &reader)
+std::uint16_t Binary::readElfInt16(BinaryContentReader &reader)
 {
-    return isBigEndian ? reader.readUInt16BE() : reader.readUInt16LE();
+    return reader.readInt<std::uint16_t>(isBigEndian);
 }
 
-std::string Binary::readElfString(std::istream &stream, const std::string_view *fileContent, std::uint64_t stringTableAddress,
-    std::uint64_t stringTableSize, std::uint64_t relativeStringAddress)
+std::string Binary::readElfString(
+    const BinaryContentReader &reader, std::uint64_t stringTableAddress, std::uint64_t stringTableSize, std::uint64_t relativeStringAddress)
 {
     // check bounds
     if (relativeStringAddress >= stringTableSize) {
@@ -808,21 +1290,11 @@ std::string Binary::readElfString(std::istream &stream, const std::string_view *
             argsToString("string address ", relativeStringAddress, " exceeds size of string table (", stringTableSize, ") at ", stringTableAddress));
     }
 
-    // take shortcut when file content has already been buffered
-    if (fileContent) {
-        return string(fileContent->data() + virtualAddressMapping.virtualAddressToFileOffset(stringTableAddress + relativeStringAddress));
+    // read string from content
+    const auto stringOffset = virtualAddressMapping.virtualAddressToFileOffset(stringTableAddress + relativeStringAddress);
+    if (!stringOffset) {
+        throw runtime_error(argsToString("unable to map virtual address of string at ", stringTableAddress + relativeStringAddress, " to its file offset"));
     }
-
-    // read string from stream
-    const auto stringOffset
-        = static_cast<istream::off_type>(virtualAddressMapping.virtualAddressToFileOffset(stringTableAddress + relativeStringAddress));
-    stream.seekg(stringOffset);
-    size_t strSize = 0, bytesAvailable = stringTableSize - relativeStringAddress;
-    for (; stream.get() && bytesAvailable; ++strSize, --bytesAvailable)
-        ;
-    stream.seekg(stringOffset);
-    auto buffer = make_unique<char[]>(strSize);
-    stream.read(buffer.get(), static_cast<streamsize>(strSize));
-    return string(buffer.get(), strSize);
+    return reader.at(stringOffset).readTerminatedString(stringTableSize - relativeStringAddress);
 }
 } // namespace LibPkg
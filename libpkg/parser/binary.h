@@ -3,16 +3,15 @@
 
 #include "../global.h"
 
+#include <c++utilities/misc/flagenumclass.h>
+
 #include <cstdint>
 #include <iostream>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
-namespace CppUtilities {
-class BinaryReader;
-}
-
 namespace LibPkg {
 
 enum class BinaryType { Invalid, Elf, Pe, Ar };
@@ -27,6 +26,11 @@ enum class BinaryClass { Invalid, Class32Bit, Class64Bit };
 
 LIBPKG_EXPORT std::ostream &operator<<(std::ostream &o, const BinaryClass &mode);
 
+enum class BinaryParseOptions {
+    None = 0,
+    Symbols = (1 << 0), /*! The exported symbols are read from the dynamic symbol table of ELF files (skipped by default). */
+};
+
 struct LIBPKG_EXPORT VirtualAddressMappingEntry {
     constexpr VirtualAddressMappingEntry(std::uint64_t fileOffset, std::uint64_t fileSize, std::uint64_t virtualAddress, std::uint64_t virtualSize);
 
@@ -82,11 +86,26 @@ inline VirtualAddressMapping::VirtualAddressMapping()
 {
 }
 
+class BinaryContentReader;
+class BinaryInfoCache;
+
 struct LIBPKG_EXPORT Binary {
-    void load(std::string_view filePath);
-    void load(std::string_view fileContent, std::string_view fileName, std::string_view directoryPath, bool isRegularFile = false);
+    void load(std::string_view filePath, BinaryParseOptions options = BinaryParseOptions::None);
+    void load(std::string_view fileContent, std::string_view fileName, std::string_view directoryPath, bool isRegularFile = false,
+        BinaryParseOptions options = BinaryParseOptions::None);
+    void load(BinaryInfoCache &cache, std::string_view fileContent, std::string_view fileName, std::string_view directoryPath,
+        bool isRegularFile = false);
+    static std::uint64_t requiredContentSize(
+        std::string_view contentPrefix, std::uint64_t fileSize, BinaryParseOptions options = BinaryParseOptions::None);
     std::string addPrefix(std::string_view dependencyName) const;
 
+    /*!
+     * \brief The version of the info stored in a BinaryInfoCache.
+     * \remarks Increment it when the parser yields different results or the format of serializeInfo() or of the entries of
+     *          BinaryInfoCache changes. Entries of other versions are removed by BinaryInfoCache::removeStaleEntries().
+     */
+    static constexpr auto infoVersion = char(2);
+
     BinaryType type = BinaryType::Invalid;
     BinarySubType subType = BinarySubType::None;
     std::string name;
@@ -100,17 +119,24 @@ struct LIBPKG_EXPORT Binary {
     VirtualAddressMapping virtualAddressMapping;
 
 private:
-    void parse(std::istream &stream, const std::string_view *fileContent = nullptr);
-    void parseElf(CppUtilities::BinaryReader &reader, const std::string_view *fileContent = nullptr);
-    void parsePe(CppUtilities::BinaryReader &reader, typename std::iostream::off_type baseFileOffset = 0);
-    void parseAr(CppUtilities::BinaryReader &reader);
-
-    std::uint64_t readElfAddress(CppUtilities::BinaryReader &reader);
-    std::uint32_t readElfInt32(CppUtilities::BinaryReader &reader);
-    std::uint16_t readElfInt16(CppUtilities::BinaryReader &reader);
-    std::string readElfString(std::istream &stream, const std::string_view *fileContent, std::uint64_t stringTableOffset,
-        std::uint64_t stringTableSize, std::uint64_t stringOffset);
+    void parse(std::string_view content, std::uint64_t size, BinaryParseOptions options);
+    void applyFileInfo(std::string_view fileName, std::string_view directoryPath, bool isRegularFile);
+    std::string serializeInfo() const;
+    bool restoreInfo(std::string_view info);
+    void parseElf(BinaryContentReader &reader, BinaryParseOptions options);
+    void parseElfSymbols(BinaryContentReader &reader, std::uint64_t symbolTableOffset, std::uint64_t symbolTableSize, std::uint64_t symbolEntrySize,
+        std::uint64_t stringTableOffset, std::uint64_t stringTableSize);
+    void parsePe(BinaryContentReader &reader, std::uint64_t baseFileOffset = 0);
+    void parseAr(BinaryContentReader &reader);
+
+    std::uint64_t readElfAddress(BinaryContentReader &reader);
+    std::uint32_t readElfInt32(BinaryContentReader &reader);
+    std::uint16_t readElfInt16(BinaryContentReader &reader);
+    std::string readElfString(
+        const BinaryContentReader &reader, std::uint64_t stringTableAddress, std::uint64_t stringTableSize, std::uint64_t relativeStringAddress);
 };
 } // namespace LibPkg
 
+CPP_UTILITIES_MARK_FLAG_ENUM_CLASS(LibPkg, LibPkg::BinaryParseOptions)
+
 #endif // LIBPKG_PARSER_BINARY_H
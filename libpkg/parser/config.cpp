@@ -1,12 +1,21 @@
 #include "./config.h"
+#include "./utils.h"
+
+#include "../data/boundedqueue.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/ansiescapecodes.h>
 #include <c++utilities/io/inifile.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 #include <sys/utsname.h> // for uname
@@ -143,15 +152,187 @@ void Config::loadPacmanConfig(const char *pacmanConfigPath)
     }
 }
 
+/// \cond
+namespace {
+struct ParsedDatabase {
+    Database *db = nullptr;
+    std::uint64_t fileSize = 0;
+    DateTime lastModified;
+    std::vector<std::shared_ptr<Package>> packages;
+    std::exception_ptr error;
+};
+
+/*!
+ * \brief The InFlightLimit struct limits the total size of the databases held in memory at the same time.
+ * \remarks A database is always admitted if no other database is in flight so databases exceeding the limit on
+ *          their own can still be loaded.
+ */
+struct InFlightLimit {
+    explicit InFlightLimit(std::uint64_t limit);
+    bool acquire(std::uint64_t size);
+    void release(std::uint64_t size);
+    void abort();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_released;
+    std::uint64_t m_used = 0, m_limit;
+    bool m_aborted = false;
+};
+
+InFlightLimit::InFlightLimit(std::uint64_t limit)
+    : m_limit(limit)
+{
+}
+
+/*!
+ * \brief Waits until a database of the specified \a size fits into the limit and accounts it.
+ * \returns Returns false if abort() has been called.
+ */
+bool InFlightLimit::acquire(std::uint64_t size)
+{
+    auto lock = std::unique_lock(m_mutex);
+    m_released.wait(lock, [&] { return m_aborted || !m_used || m_used + size <= m_limit; });
+    if (m_aborted) {
+        return false;
+    }
+    m_used += size;
+    return true;
+}
+
+void InFlightLimit::release(std::uint64_t size)
+{
+    {
+        const auto lock = std::lock_guard(m_mutex);
+        m_used -= size;
+    }
+    m_released.notify_all();
+}
+
+void InFlightLimit::abort()
+{
+    {
+        const auto lock = std::lock_guard(m_mutex);
+        m_aborted = true;
+    }
+    m_released.notify_all();
+}
+
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Loads the packages of all databases from the configured paths.
+ * \remarks
+ * - Databases are parsed concurrently on a pool of worker threads. The parsed packages are passed to the calling thread
+ *   which commits them one database at a time as LMDB only allows one write transaction at a time anyway. So parsing
+ *   further databases overlaps with committing and the overall time approaches the time for the largest database.
+ * - Each worker runs a reader thread and several parser threads via Package::fromDatabaseFile(). The number of workers
+ *   is chosen so all threads together do not exceed the number of CPU cores.
+ * - Each database is committed within its own transaction so an error only affects the database it occurred in.
+ * - The databases held in memory at the same time (being parsed, waiting to be committed or being committed) are
+ *   limited by the size of their files: Together they must not exceed twice the size of the largest database. So
+ *   the memory usage stays within about twice the memory usage of loading the largest database on its own.
+ */
 void Config::loadAllPackages(bool withFiles, bool force)
 {
+    // determine databases which need to be loaded
+    struct DatabaseToLoad {
+        Database *db;
+        std::string path;
+        std::uint64_t fileSize;
+    };
+    auto toLoad = std::vector<DatabaseToLoad>();
+    auto largestFileSize = std::uint64_t();
     for (auto &db : databases) {
         try {
-            db.loadPackagesFromConfiguredPaths(withFiles, force);
+            if (auto dbPath = db.configuredPackagesPath(withFiles, force).first; !dbPath.empty()) {
+                auto ec = std::error_code();
+                auto fileSize = std::filesystem::file_size(dbPath, ec);
+                if (ec) {
+                    fileSize = 0;
+                }
+                largestFileSize = std::max<std::uint64_t>(largestFileSize, fileSize);
+                toLoad.emplace_back(DatabaseToLoad{ .db = &db, .path = std::move(dbPath), .fileSize = fileSize });
+            }
         } catch (const runtime_error &e) {
             cerr << Phrases::ErrorMessage << "Unable to load database \"" << db.name << "\": " << e.what() << Phrases::EndFlush;
         }
     }
+    if (toLoad.empty()) {
+        return;
+    }
+
+    // parse databases concurrently, splitting the available cores between the workers and their reader and parser threads
+    // note: The worker thread itself only collects the parsed packages so it is not taken into account.
+    const auto cpuCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 2);
+    constexpr auto minParserCount = std::size_t(3);
+    const auto workerCount = std::min(toLoad.size(), std::max<std::size_t>(cpuCount / (minParserCount + 1), 1));
+    const auto parserCount = std::max<std::size_t>(cpuCount / workerCount, 2) - 1;
+    auto parsed = BoundedQueue<ParsedDatabase>(workerCount);
+    auto inFlight = InFlightLimit(largestFileSize * 2);
+    auto nextIndex = std::atomic_size_t();
+    auto remainingWorkers = std::atomic_size_t(workerCount);
+    auto workers = std::vector<std::thread>(workerCount);
+    for (auto &worker : workers) {
+        worker = std::thread([&] {
+            for (auto index = nextIndex++; index < toLoad.size(); index = nextIndex++) {
+                auto &[db, dbPath, fileSize] = toLoad[index];
+                if (!inFlight.acquire(fileSize)) {
+                    break;
+                }
+                auto result = ParsedDatabase{ .db = db, .fileSize = fileSize };
+                try {
+                    result.lastModified = lastModified(dbPath);
+                    Package::fromDatabaseFile(
+                        dbPath,
+                        [&packages = result.packages](const std::shared_ptr<Package> &package) {
+                            packages.emplace_back(package);
+                            return false;
+                        },
+                        parserCount);
+                } catch (...) {
+                    result.packages.clear();
+                    result.error = std::current_exception();
+                }
+                if (!parsed.push(std::move(result))) {
+                    break;
+                }
+            }
+            if (remainingWorkers.fetch_sub(1) == 1) {
+                parsed.close();
+            }
+        });
+    }
+
+    // commit parsed databases as they become available
+    auto error = std::exception_ptr();
+    try {
+        while (auto result = parsed.pop()) {
+            try {
+                if (result->error) {
+                    std::rethrow_exception(result->error);
+                }
+                result->db->loadPackages(result->packages, result->lastModified, force);
+            } catch (const runtime_error &e) {
+                cerr << Phrases::ErrorMessage << "Unable to load database \"" << result->db->name << "\": " << e.what() << Phrases::EndFlush;
+            }
+            // free the packages before admitting further databases
+            const auto fileSize = result->fileSize;
+            result.reset();
+            inFlight.release(fileSize);
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    inFlight.abort();
+    parsed.abort();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
 }
 
 std::uint64_t Config::restoreFromCache()
@@ -21,7 +21,13 @@ bool Database::isFileRelevant(const char *filePath, const char *fileName, mode_t
     return !std::strcmp(fileName, "desc") || !std::strcmp(fileName, "depends") || !std::strcmp(fileName, "files");
 }
 
-void Database::loadPackagesFromConfiguredPaths(bool withFiles, bool force)
+/*!
+ * \brief Returns the path of the database file to load packages from and its modification time.
+ * \remarks Returns an empty path if the packages have already been loaded from the current version of the file (unless
+ *          \a force is set).
+ * \throws Throws std::runtime_error if no path has been configured.
+ */
+std::pair<std::string, DateTime> Database::configuredPackagesPath(bool withFiles, bool force) const
 {
     const auto &dbPath = withFiles && !filesPath.empty() ? filesPath : path;
     if (dbPath.empty()) {
@@ -29,16 +35,43 @@ void Database::loadPackagesFromConfiguredPaths(bool withFiles, bool force)
     }
     const auto lastFileUpdate = lastModified(dbPath);
     if (force || lastFileUpdate > lastUpdate) {
-        loadPackages(dbPath, lastFileUpdate);
+        return std::make_pair(dbPath, lastFileUpdate);
+    }
+    return std::make_pair(std::string(), lastFileUpdate);
+}
+
+void Database::loadPackagesFromConfiguredPaths(bool withFiles, bool force)
+{
+    if (const auto [dbPath, lastFileUpdate] = configuredPackagesPath(withFiles, force); !dbPath.empty()) {
+        loadPackages(dbPath, lastFileUpdate, force);
     }
 }
 
-void Database::loadPackages(const std::string &databaseFilePath, DateTime lastModified)
+/*!
+ * \brief Loads the packages from the specified \a databaseFilePath modified at \a lastModified.
+ * \remarks Only packages which have actually changed are updated unless \a force is set. Then all packages are re-written
+ *          and the indexes are re-created, e.g. to repair them.
+ */
+void Database::loadPackages(const std::string &databaseFilePath, DateTime lastModified, bool force)
 {
-    auto updater = PackageUpdater(*this, true);
+    auto updater = PackageUpdater(*this, force ? PackageUpdaterMode::Clear : PackageUpdaterMode::Diff);
     updater.insertFromDatabaseFile(databaseFilePath);
     updater.commit();
     lastUpdate = lastModified;
 }
 
+/*!
+ * \brief Loads the specified \a packages which have been parsed before from a database file modified at \a lastModified.
+ * \remarks This allows parsing the database file without holding a write transaction. See the other overload regarding \a force.
+ */
+void Database::loadPackages(const std::vector<std::shared_ptr<Package>> &packages, DateTime lastModified, bool force)
+{
+    auto updater = PackageUpdater(*this, force ? PackageUpdaterMode::Clear : PackageUpdaterMode::Diff);
+    for (const auto &package : packages) {
+        updater.insert(package);
+    }
+    updater.commit();
+    lastUpdate = lastModified;
+}
+
 } // namespace LibPkg
@@ -3,6 +3,7 @@
 #include "./binary.h"
 #include "./utils.h"
 
+#include "../data/boundedqueue.h"
 #include "../data/database.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
@@ -10,10 +11,17 @@
 #include <c++utilities/io/ansiescapecodes.h>
 #include <c++utilities/io/path.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <exception>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <regex>
+#include <span>
+#include <thread>
 
 #include <sys/stat.h>
 
@@ -156,15 +164,15 @@ std::string Dependency::toString() const
         break;
     default:
         // mode is any, but a desc is present
-        return argsToString(name, ':', ' ', description);
+        return argsToString(name.str(), ':', ' ', description);
     }
 
     // no desc but mode
     if (description.empty()) {
-        return argsToString(name, modeStr, version);
+        return argsToString(name.str(), modeStr, version);
     }
     // all parts present
-    return argsToString(name, modeStr, version, ':', ' ', description);
+    return argsToString(name.str(), modeStr, version, ':', ' ', description);
 }
 
 PackageVersion PackageVersion::fromString(const char *versionString, size_t versionStringSize)
@@ -482,6 +490,7 @@ static void parsePkgInfo(const std::string &info, const std::function<Package *(
 
     // do actual parsing via state machine
     Package *currentPackage = nullptr;
+    const char *const infoEnd = info.data() + info.size();
     for (const char *i = info.data(); *i; ++i) {
         const char c = *i;
         switch (state) {
@@ -588,10 +597,13 @@ static void parsePkgInfo(const std::string &info, const std::function<Package *(
                 currentFieldNameSize = currentFieldValueSize = 0;
                 break;
             default:
+                // skip to the end of the value in bulk
                 if (!currentFieldValue) {
                     currentFieldValue = i;
                 }
-                ++currentFieldValueSize;
+                const auto *const valueEnd = findLineEnd(i, infoEnd);
+                currentFieldValueSize += static_cast<std::size_t>(valueEnd - i);
+                i = valueEnd - 1;
             }
             break;
         case Comment:
@@ -629,12 +641,24 @@ std::vector<PackageSpec> Package::fromInfo(const std::string &info, bool isPacka
  * \brief Parses the specified \a descriptionParts and returns the results as package.
  */
 std::shared_ptr<Package> Package::fromDescription(const std::vector<std::string> &descriptionParts)
+{
+    auto parts = std::vector<std::string_view>(descriptionParts.begin(), descriptionParts.end());
+    return fromDescription(std::span<const std::string_view>(parts));
+}
+
+/*!
+ * \brief Parses the specified \a descriptionParts (e.g. the contents of "desc" and "files") and returns the results as package.
+ * \remarks
+ * - The parts are not copied and do not need to be null-terminated. Only the values which end up in the package are copied.
+ * - This overload allows parsing database files without buffering the parts in intermediate containers.
+ */
+std::shared_ptr<Package> Package::fromDescription(std::span<const std::string_view> descriptionParts)
 {
     auto package = std::make_shared<Package>();
     package->origin = PackageOrigin::Database;
     package->sourceInfo = std::make_optional<SourceInfo>();
     package->packageInfo = std::make_optional<PackageInfo>();
-    for (const auto &desc : descriptionParts) {
+    for (const auto desc : descriptionParts) {
         // states
         enum {
             FieldName, // reading field name
@@ -650,7 +674,7 @@ std::shared_ptr<Package> Package::fromDescription(const std::vector<std::string>
         std::size_t currentFieldValueSize = 0;
 
         // do actual parsing via state machine
-        for (const char *i = desc.data(); *i; ++i) {
+        for (const char *i = desc.data(), *end = desc.data() + desc.size(); i != end && *i; ++i) {
             const char c = *i;
             switch (state) {
             case FieldName:
@@ -708,10 +732,13 @@ std::shared_ptr<Package> Package::fromDescription(const std::vector<std::string>
                     currentFieldValueSize = 0;
                     break;
                 default:
+                    // skip to the end of the value in bulk
                     if (!currentFieldValue) {
                         currentFieldValue = i;
                     }
-                    ++currentFieldValueSize;
+                    const auto *const valueEnd = findLineEnd(i, end);
+                    currentFieldValueSize += static_cast<std::size_t>(valueEnd - i);
+                    i = valueEnd - 1;
                 }
             }
         }
@@ -723,41 +750,114 @@ std::shared_ptr<Package> Package::fromDescription(const std::vector<std::string>
     return package;
 }
 
-void Package::fromDatabaseFile(const std::string &archivePath, const std::function<bool(const std::shared_ptr<Package> &)> &visitor)
+/*!
+ * \brief Parses the packages from the database file \a archivePath and passes them to \a visitor.
+ * \remarks
+ * - Decompression, parsing and visiting are done in a pipeline: one thread walks through the archive, \a parserCount
+ *   threads (or one less than the number of CPU cores if zero) parse the descriptions and \a visitor is invoked
+ *   from the calling thread. So \a visitor is never invoked concurrently.
+ * - The order in which packages are passed to \a visitor is not deterministic.
+ * - Errors which occur when reading the archive are re-thrown after all packages read so far have been visited.
+ */
+void Package::fromDatabaseFile(
+    const std::string &archivePath, const std::function<bool(const std::shared_ptr<Package> &)> &visitor, std::size_t parserCount)
 {
-    // walk though archive, file-by-file; parse files as soon as desc/files available and return via visitor
-    auto packages = std::unordered_map<std::string, std::vector<std::string>>();
-    walkThroughArchive(
-        archivePath, &Database::isFileRelevant,
-        [&packages, &visitor](std::string_view path, ArchiveFile &&file) {
-            auto i = packages.find(std::string(path)); // FIXME: this should actually accept std::string_view in C++20
-            if (i == packages.end()) {
-                i = packages.emplace(std::string(path), 2).first;
-            }
-            auto &parts = i->second;
-            if (file.name == "desc") {
-                parts[0] = std::move(file.content);
-            } else if (file.name == "files") {
-                parts[1] = std::move(file.content);
+    if (!parserCount) {
+        parserCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+    }
+    const auto queueCapacity = parserCount * 16;
+    auto descriptions = BoundedQueue<std::array<std::string, 2>>(queueCapacity);
+    auto packages = BoundedQueue<std::shared_ptr<Package>>(queueCapacity);
+    auto error = std::exception_ptr();
+    auto errorMutex = std::mutex();
+    const auto setError = [&error, &errorMutex] {
+        const auto lock = std::lock_guard(errorMutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    };
+
+    // walk though archive, file-by-file; pass desc/files to parsers as soon as all files of a package are available
+    // note: The files of a package are expected to be stored consecutively (as done by repo-add) so only the files
+    //       of the current package need to be buffered.
+    auto reader = std::thread([&] {
+        auto currentPath = std::string();
+        auto currentParts = std::array<std::string, 2>();
+        auto aborted = false;
+        const auto submitCurrentParts = [&currentParts, &descriptions, &aborted] {
+            if (!aborted && !currentParts[0].empty()) {
+                aborted = !descriptions.push(std::move(currentParts));
             }
-            if (!parts[0].empty() && !parts[1].empty()) {
-                if (visitor(Package::fromDescription(parts))) {
-                    return true;
+            currentParts[0].clear();
+            currentParts[1].clear();
+        };
+        try {
+            walkThroughArchive(
+                archivePath, &Database::isFileRelevant,
+                [&](std::string_view path, ArchiveFile &&file) {
+                    if (path != currentPath) {
+                        // take care of the previous package if it had no "files" file
+                        submitCurrentParts();
+                        currentPath = path;
+                    }
+                    if (file.name == "desc") {
+                        currentParts[0] = std::move(file.content);
+                    } else if (file.name == "files") {
+                        currentParts[1] = std::move(file.content);
+                    }
+                    if (!currentParts[0].empty() && !currentParts[1].empty()) {
+                        submitCurrentParts();
+                    }
+                    return aborted;
+                },
+                [](std::string_view) { return false; });
+            submitCurrentParts();
+        } catch (...) {
+            setError();
+        }
+        descriptions.close();
+    });
+
+    // parse descriptions concurrently
+    auto parsers = std::vector<std::thread>(parserCount);
+    auto remainingParsers = std::atomic_size_t(parserCount);
+    for (auto &parser : parsers) {
+        parser = std::thread([&] {
+            try {
+                while (auto parts = descriptions.pop()) {
+                    const std::string_view partViews[] = { (*parts)[0], (*parts)[1] };
+                    if (!packages.push(Package::fromDescription(partViews))) {
+                        break;
+                    }
                 }
-                // remove buffered data immediately to avoid using too much memory
-                packages.erase(i);
+            } catch (...) {
+                setError();
+                descriptions.abort();
             }
-            return false;
-        },
-        [](std::string_view) { return false; });
+            if (remainingParsers.fetch_sub(1) == 1) {
+                packages.close();
+            }
+        });
+    }
 
-    // take care of packages without "files" file
-    for (auto &[packageName, parts] : packages) {
-        if (!parts[0].empty()) {
-            if (visitor(Package::fromDescription(parts))) {
-                return;
+    // pass parsed packages to visitor
+    try {
+        while (auto package = packages.pop()) {
+            if (visitor(*package)) {
+                break;
             }
         }
+    } catch (...) {
+        setError();
+    }
+    descriptions.abort();
+    packages.abort();
+    reader.join();
+    for (auto &parser : parsers) {
+        parser.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
     }
 }
 
@@ -767,6 +867,16 @@ bool Package::isPkgInfoFileOrBinary(const char *filePath, const char *fileName,
         || strstr(fileName, ".so") > fileName || strstr(fileName, ".dll") > fileName || strstr(fileName, ".a") > fileName;
 }
 
+/*!
+ * \brief Returns how much of a file matched by isPkgInfoFileOrBinary() needs to be read.
+ * \remarks The .PKGINFO file is read completely. Of other files only the prefix Binary::load() needs is read; that is
+ *          usually just the headers and the dynamic section of ELF files and the headers and the import directory of PE files.
+ */
+std::uint64_t Package::requiredSizeOfPkgInfoFileOrBinary(const char *fileName, std::string_view contentPrefix, std::uint64_t fileSize)
+{
+    return !strcmp(fileName, ".PKGINFO") ? fileSize : Binary::requiredContentSize(contentPrefix, fileSize);
+}
+
 bool LibPkg::Package::isLicense(const char *filePath, const char *fileName, mode_t mode)
 {
     CPP_UTILITIES_UNUSED(mode)
@@ -805,8 +915,12 @@ void Package::addDepsAndProvidesFromContainedDirectory(std::string_view director
     }
 }
 
+/*!
+ * \brief Adds the library dependencies and provides of the specified \a file if it is a binary.
+ * \remarks If \a binaryInfoCache is specified, \a file is only parsed if its content has not been parsed before.
+ */
 void Package::addDepsAndProvidesFromContainedFile(
-    std::string_view directoryPath, const ArchiveFile &file, std::set<std::string> &dllsReferencedByImportLibs)
+    std::string_view directoryPath, const ArchiveFile &file, std::set<std::string> &dllsReferencedByImportLibs, BinaryInfoCache *binaryInfoCache)
 {
     // ignore files under "/opt" except Android libraries as those files are not for system-wide use
     // note: Otherwise, if a package contains e.g. an old version of libxml2 this library would be considered available and a possibly required rebuild
@@ -822,7 +936,11 @@ void Package::addDepsAndProvidesFromContainedFile(
     }
     try {
         Binary binary;
-        binary.load(file.content, file.name, directoryPath, file.type == ArchiveFileType::Regular);
+        if (binaryInfoCache) {
+            binary.load(*binaryInfoCache, file.content, file.name, directoryPath, file.type == ArchiveFileType::Regular);
+        } else {
+            binary.load(file.content, file.name, directoryPath, file.type == ArchiveFileType::Regular);
+        }
         if (!binary.name.empty()) {
             if (binary.type == BinaryType::Ar && binary.subType == BinarySubType::WindowsImportLibrary) {
                 dllsReferencedByImportLibs.emplace(binary.addPrefix(binary.name));
@@ -848,7 +966,7 @@ std::vector<std::string> Package::processDllsReferencedByImportLibs(std::set<str
         return issues;
     } else if (name == "mingw-w64-crt" || (name.starts_with("mingw-w64-clang-") && name.ends_with("-crt"))) {
         // assume the CRT references DLLs provided by Windows itself
-        libprovides = std::move(dllsReferencedByImportLibs);
+        libprovides = InternedStringSet(dllsReferencedByImportLibs.begin(), dllsReferencedByImportLibs.end());
         return issues;
     }
     for (const auto &referencedDLL : dllsReferencedByImportLibs) {
@@ -862,7 +980,7 @@ std::vector<std::string> Package::processDllsReferencedByImportLibs(std::set<str
 /*!
  * \brief Adds dependencies and provides from the specified \a contents.
  * \deprecated This function is not actually used anymore because ReloadLibraryDependencies does this in a better way
- *             using LibPkg::walkThroughArchive().
+ *             using LibPkg::walkThroughArchivePartially().
  */
 void Package::addDepsAndProvidesFromContents(const FileMap &contents)
 {
@@ -881,8 +999,8 @@ std::shared_ptr<Package> Package::fromPkgFile(const string &path)
     std::set<std::string> dllsReferencedByImportLibs;
     Package tmpPackageForLibraryDeps;
     shared_ptr<Package> package;
-    CppUtilities::walkThroughArchive(
-        path, &LibPkg::Package::isPkgInfoFileOrBinary,
+    walkThroughArchivePartially(
+        path, &LibPkg::Package::isPkgInfoFileOrBinary, &LibPkg::Package::requiredSizeOfPkgInfoFileOrBinary,
         [&package, &tmpPackageForLibraryDeps, &dllsReferencedByImportLibs](std::string_view directoryPath, CppUtilities::ArchiveFile &&file) {
             if (directoryPath.empty() && file.name == ".PKGINFO") {
                 if (package) {
@@ -975,8 +1093,8 @@ std::vector<PackageSpec> Package::fromAurRpcJson(const char *jsonData, std::size
         package->version = std::move(result.Version);
         package->description = std::move(result.Description);
         package->upstreamUrl = std::move(result.URL);
-        package->licenses = std::move(result.License);
-        package->groups = std::move(result.Groups);
+        package->licenses.assign(result.License.begin(), result.License.end());
+        package->groups.assign(result.Groups.begin(), result.Groups.end());
         package->conflicts.reserve(result.Conflicts.size());
         for (const auto &dep : result.Conflicts) {
             package->conflicts.emplace_back(dep.data(), dep.size());
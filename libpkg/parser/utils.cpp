@@ -10,9 +10,19 @@
 
 #include <sys/time.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LIBPKG_HAS_X86_SCANNER
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <chrono>
 #include <exception>
 #include <filesystem>
+#include <limits>
+#include <memory>
 #include <regex>
 
 using namespace std;
@@ -36,6 +46,238 @@ const char *firstNonAlphanumericCharacter(const char *str, const char *end)
     return str;
 }
 
+/// \cond
+namespace {
+
+const char *findLineEndScalar(const char *str, const char *end)
+{
+    for (; str != end; ++str) {
+        switch (*str) {
+        case '\n':
+        case '\r':
+        case '\0':
+            return str;
+        default:;
+        }
+    }
+    return str;
+}
+
+#ifdef LIBPKG_HAS_X86_SCANNER
+__attribute__((target("sse2"))) const char *findLineEndSse2(const char *str, const char *end)
+{
+    const auto newLine = _mm_set1_epi8('\n'), carriageReturn = _mm_set1_epi8('\r'), zero = _mm_setzero_si128();
+    for (; end - str >= 16; str += 16) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str));
+        const auto matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, newLine), _mm_cmpeq_epi8(chunk, carriageReturn)), _mm_cmpeq_epi8(chunk, zero));
+        if (const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(matches))) {
+            return str + std::countr_zero(mask);
+        }
+    }
+    return findLineEndScalar(str, end);
+}
+
+__attribute__((target("avx2"))) const char *findLineEndAvx2(const char *str, const char *end)
+{
+    const auto newLine = _mm256_set1_epi8('\n'), carriageReturn = _mm256_set1_epi8('\r'), zero = _mm256_setzero_si256();
+    for (; end - str >= 32; str += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str));
+        const auto matches = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, newLine), _mm256_cmpeq_epi8(chunk, carriageReturn)), _mm256_cmpeq_epi8(chunk, zero));
+        if (const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(matches))) {
+            return str + std::countr_zero(mask);
+        }
+    }
+    return findLineEndSse2(str, end);
+}
+#endif
+
+/*!
+ * \brief Returns the best implementation of findLineEnd() supported by the CPU.
+ */
+FindLineEnd selectFindLineEnd()
+{
+#ifdef LIBPKG_HAS_X86_SCANNER
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return &findLineEndAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return &findLineEndSse2;
+    }
+#endif
+    return &findLineEndScalar;
+}
+
+/*!
+ * \brief Returns the implementation used by findLineEnd().
+ */
+std::atomic<FindLineEnd> &findLineEndImplementation()
+{
+    static auto implementation = std::atomic<FindLineEnd>(selectFindLineEnd());
+    return implementation;
+}
+
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Returns the first line ending ('\n' or '\r') or null-byte within \a str.
+ * \remarks
+ * - The \a end is returned if \a str contains none of these characters.
+ * - Scans 32/16 bytes at once via AVX2/SSE2 if supported by the CPU (selected at runtime); otherwise one byte at a time.
+ *   This allows the parsers to skip over field values in bulk.
+ */
+const char *findLineEnd(const char *str, const char *end)
+{
+    return findLineEndImplementation().load(std::memory_order_relaxed)(str, end);
+}
+
+/*!
+ * \brief Returns all implementations of findLineEnd() supported by the CPU.
+ * \remarks This allows testing all implementations against each other (and not just the one selected at runtime).
+ */
+std::vector<FindLineEndImplementation> supportedFindLineEndImplementations()
+{
+    auto implementations = std::vector<FindLineEndImplementation>{ { "scalar", &findLineEndScalar } };
+#ifdef LIBPKG_HAS_X86_SCANNER
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        implementations.emplace_back(FindLineEndImplementation{ "sse2", &findLineEndSse2 });
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        implementations.emplace_back(FindLineEndImplementation{ "avx2", &findLineEndAvx2 });
+    }
+#endif
+    return implementations;
+}
+
+/*!
+ * \brief Makes findLineEnd() (and thus the parsers) use the specified \a implementation.
+ * \remarks
+ * - Pass nullptr to use the best implementation supported by the CPU again.
+ * - This is meant for testing; the \a implementation must be one returned by supportedFindLineEndImplementations().
+ */
+void overrideFindLineEnd(FindLineEnd implementation)
+{
+    findLineEndImplementation().store(implementation ? implementation : selectFindLineEnd(), std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Returns literal substrings any string matched by the specified ECMAScript \a regex must contain.
+ * \remarks
+ * - The returned substrings are views into \a regex.
+ * - This is conservative: Alternatives, groups, character classes and escape sequences are not analyzed so
+ *   the returned substrings might not be all required substrings. No substrings are returned if the regex
+ *   contains alternatives at all.
+ */
+std::vector<std::string_view> requiredSubstringsOfRegex(std::string_view regex)
+{
+    auto substrings = std::vector<std::string_view>();
+    if (regex.find('|') != std::string_view::npos) {
+        return substrings;
+    }
+    auto depth = std::size_t();
+    auto begin = std::size_t(), end = std::size_t();
+    const auto flush = [&](std::size_t next) {
+        if (end > begin) {
+            substrings.emplace_back(regex.substr(begin, end - begin));
+        }
+        begin = end = next;
+    };
+    for (auto i = std::size_t(); i < regex.size(); ++i) {
+        switch (regex[i]) {
+        case '*':
+        case '?':
+        case '{':
+            // the previous character is optional (or repeated a variable number of times)
+            if (end > begin && end == i) {
+                --end;
+            }
+            if (regex[i] == '{' && (i = regex.find('}', i)) == std::string_view::npos) {
+                return substrings;
+            }
+            flush(i + 1);
+            break;
+        case '\\':
+            // skip escape sequence; multi-character escapes like "\x41" or "\u0041" do not stand for their characters literally
+            if (++i < regex.size()) {
+                switch (regex[i]) {
+                case 'x':
+                    i += 2;
+                    break;
+                case 'u':
+                    i += 4;
+                    break;
+                case 'c':
+                    i += 1;
+                    break;
+                default:
+                    // skip all digits of back references
+                    while (i + 1 < regex.size() && regex[i] >= '0' && regex[i] <= '9' && regex[i + 1] >= '0' && regex[i + 1] <= '9') {
+                        ++i;
+                    }
+                }
+            }
+            flush(std::min(i, regex.size()) + 1);
+            break;
+        case '[':
+            // skip character class; a "]" directly after "[" or "[^" is part of the class as well as escaped
+            // characters and the contents of "[:alpha:]", "[.a.]" and "[=a=]"
+            if (auto classEnd = i + 1; classEnd < regex.size()) {
+                if (regex[classEnd] == '^') {
+                    ++classEnd;
+                }
+                if (classEnd < regex.size() && regex[classEnd] == ']') {
+                    ++classEnd;
+                }
+                for (; classEnd < regex.size() && regex[classEnd] != ']'; ++classEnd) {
+                    if (regex[classEnd] == '\\') {
+                        ++classEnd;
+                    } else if (const auto next = classEnd + 1;
+                               regex[classEnd] == '[' && next < regex.size() && (regex[next] == ':' || regex[next] == '.' || regex[next] == '=')) {
+                        const char delimiter[] = { regex[next], ']' };
+                        if ((classEnd = regex.find(std::string_view(delimiter, 2), next + 1)) == std::string_view::npos) {
+                            return substrings;
+                        }
+                        ++classEnd;
+                    }
+                }
+                if (classEnd >= regex.size()) {
+                    return substrings;
+                }
+                i = classEnd;
+            }
+            flush(i + 1);
+            break;
+        case '(':
+            ++depth;
+            flush(i + 1);
+            break;
+        case ')':
+            if (depth) {
+                --depth;
+            }
+            flush(i + 1);
+            break;
+        case '+':
+        case '.':
+        case '^':
+        case '$':
+            flush(i + 1);
+            break;
+        default:
+            if (depth) {
+                begin = end = i + 1;
+            } else {
+                end = i + 1;
+            }
+        }
+    }
+    flush(regex.size());
+    return substrings;
+}
+
 /*!
  * \brief Determines when the file with the specified \a path has been modified the last time.
  * \fixme Make no assumptions on the internal resolution so the code is portable (seems not possible with C++17).
@@ -64,6 +306,136 @@ bool setLastModified(const string &path, DateTime lastModified)
     return utimes(path.data(), tv) == 0;
 }
 
+/*!
+ * \brief Walks through the archive at \a archivePath like CppUtilities::walkThroughArchive() but buffers only as much of
+ *        each file as needed.
+ * \remarks
+ * - \a requiredContentSize is invoked with the buffered prefix of each relevant regular file, initially with an empty one.
+ *   It returns how many bytes of the file are needed or 0 if the prefix suffices. Data is read until that size is buffered;
+ *   then \a requiredContentSize is invoked again. The rest of the file is skipped without being buffered.
+ * - \a fileHandler receives the buffered prefix as ArchiveFile::content. It is only the full content if \a requiredContentSize
+ *   asked for it, e.g. by returning the file size.
+ * - Files of unknown size are treated as if they were arbitrarily big; reading stops at their actual end.
+ * - Holes of sparse files are filled with zeroes.
+ * - Directories and symlinks are passed to the handlers as by CppUtilities::walkThroughArchive().
+ * - Throws an ArchiveException if the archive cannot be opened or read.
+ */
+void walkThroughArchivePartially(std::string_view archivePath, const FilePredicate &isFileRelevant, const RequiredContentSize &requiredContentSize,
+    FileHandler &&fileHandler, DirectoryHandler &&directoryHandler)
+{
+    // open archive file using libarchive
+    const auto ar = std::unique_ptr<struct archive, decltype(&archive_read_free)>(archive_read_new(), &archive_read_free);
+    archive_read_support_filter_all(ar.get());
+    archive_read_support_format_all(ar.get());
+    if (archive_read_open_filename(ar.get(), std::string(archivePath).data(), 10240) != ARCHIVE_OK) {
+        const auto *const error = archive_error_string(ar.get());
+        throw ArchiveException(argsToString("Unable to open archive \"", archivePath, "\": ", error ? error : "unknown error"));
+    }
+
+    const auto throwReadError = [&ar, archivePath] {
+        const auto *const error = archive_error_string(ar.get());
+        throw ArchiveException(argsToString("Unable to read archive \"", archivePath, "\": ", error ? error : "unknown error"));
+    };
+
+    // iterate through all archive entries
+    auto *entry = static_cast<struct archive_entry *>(nullptr);
+    for (;;) {
+        if (const auto returnCode = archive_read_next_header(ar.get(), &entry); returnCode == ARCHIVE_EOF) {
+            break;
+        } else if (returnCode != ARCHIVE_OK && returnCode != ARCHIVE_WARN) {
+            throwReadError();
+        }
+        // check entry type (only dirs, files and symlinks relevant here)
+        const auto entryType = archive_entry_filetype(entry);
+        if (entryType != AE_IFDIR && entryType != AE_IFREG && entryType != AE_IFLNK) {
+            continue;
+        }
+        const char *filePath = archive_entry_pathname_utf8(entry);
+        if (!filePath && !(filePath = archive_entry_pathname(entry))) {
+            continue;
+        }
+
+        // pass directories without trailing slashes
+        if (entryType == AE_IFDIR) {
+            auto directoryPath = std::string_view(filePath);
+            while (directoryPath.ends_with('/')) {
+                directoryPath.remove_suffix(1);
+            }
+            if (directoryHandler && directoryHandler(directoryPath)) {
+                return;
+            }
+            continue;
+        }
+
+        // split the path into directory path and file name and check whether the file is relevant
+        const char *fileName = filePath, *directoryEnd = filePath;
+        for (const char *i = filePath; *i; ++i) {
+            if (*i == '/') {
+                fileName = i + 1;
+                directoryEnd = i;
+            }
+        }
+        if (isFileRelevant && !isFileRelevant(filePath, fileName, archive_entry_mode(entry))) {
+            continue;
+        }
+        const auto directoryPath = std::string_view(filePath, static_cast<std::size_t>(directoryEnd - filePath));
+        const auto creationTime = DateTime::fromTimeStampGmt(archive_entry_ctime(entry));
+        const auto modificationTime = DateTime::fromTimeStampGmt(archive_entry_mtime(entry));
+
+        // pass symlinks
+        if (entryType == AE_IFLNK) {
+            const char *target = archive_entry_symlink_utf8(entry);
+            if (!target && !(target = archive_entry_symlink(entry))) {
+                target = "";
+            }
+            if (fileHandler && fileHandler(directoryPath, ArchiveFile(fileName, target, ArchiveFileType::Link, creationTime, modificationTime))) {
+                return;
+            }
+            continue;
+        }
+
+        // buffer the file content until the buffered prefix suffices; libarchive skips the rest when reading the next header
+        const auto entrySize = archive_entry_size_is_set(entry) ? archive_entry_size(entry) : la_int64_t(-1);
+        const auto fileSize = entrySize >= 0 ? static_cast<std::uint64_t>(entrySize) : std::numeric_limits<std::uint64_t>::max();
+        auto content = std::string();
+        for (auto isComplete = false; !isComplete;) {
+            const auto requiredSize = requiredContentSize ? requiredContentSize(fileName, content, fileSize) : fileSize;
+            if (requiredSize <= content.size()) {
+                break;
+            }
+            if (fileSize != std::numeric_limits<std::uint64_t>::max()) {
+                content.reserve(static_cast<std::size_t>(std::min(requiredSize, fileSize)));
+            }
+            while (content.size() < requiredSize) {
+                const void *block = nullptr;
+                auto blockSize = std::size_t();
+                auto blockOffset = la_int64_t();
+                const auto returnCode = archive_read_data_block(ar.get(), &block, &blockSize, &blockOffset);
+                if (returnCode == ARCHIVE_EOF) {
+                    // zero-fill a hole at the end of sparse files
+                    if (fileSize != std::numeric_limits<std::uint64_t>::max() && content.size() < std::min(requiredSize, fileSize)) {
+                        content.resize(static_cast<std::size_t>(std::min(requiredSize, fileSize)));
+                    }
+                    isComplete = true;
+                    break;
+                }
+                if (returnCode != ARCHIVE_OK) {
+                    throwReadError();
+                }
+                // zero-fill holes of sparse files
+                if (blockOffset > 0 && static_cast<std::uint64_t>(blockOffset) > content.size()) {
+                    content.resize(static_cast<std::size_t>(blockOffset));
+                }
+                content.append(static_cast<const char *>(block), blockSize);
+            }
+        }
+        if (fileHandler
+            && fileHandler(directoryPath, ArchiveFile(fileName, std::move(content), ArchiveFileType::Regular, creationTime, modificationTime))) {
+            return;
+        }
+    }
+}
+
 /*!
  * \brief Override an overridden variable assignment (to ensure the configured default value is actually used and not overridden).
  */
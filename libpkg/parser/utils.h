@@ -4,8 +4,13 @@
 #include "../global.h"
 
 #include <c++utilities/chrono/datetime.h>
+#include <c++utilities/io/archive.h>
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace LibPkg {
 
@@ -53,9 +58,31 @@ LIBPKG_EXPORT AmendedVersions amendPkgbuild(const std::string &path, const Packa
  */
 
 LIBPKG_EXPORT const char *firstNonAlphanumericCharacter(const char *str, const char *end);
+LIBPKG_EXPORT const char *findLineEnd(const char *str, const char *end);
+/// \brief A function returning the first line ending or null-byte within a string like findLineEnd().
+using FindLineEnd = const char *(*)(const char *str, const char *end);
+/// \brief An implementation of findLineEnd() (e.g. "scalar", "sse2" or "avx2").
+struct LIBPKG_EXPORT FindLineEndImplementation {
+    std::string_view name;
+    FindLineEnd function = nullptr;
+};
+LIBPKG_EXPORT std::vector<FindLineEndImplementation> supportedFindLineEndImplementations();
+LIBPKG_EXPORT void overrideFindLineEnd(FindLineEnd implementation);
+LIBPKG_EXPORT std::vector<std::string_view> requiredSubstringsOfRegex(std::string_view regex);
 LIBPKG_EXPORT CppUtilities::DateTime lastModified(const std::string &path);
 LIBPKG_EXPORT bool setLastModified(const std::string &path, CppUtilities::DateTime lastModified);
 
+/*
+ * Archive helper
+ */
+
+/// \brief Returns how many bytes of a file are required given its \a fileName, its buffered \a contentPrefix and its \a fileSize.
+using RequiredContentSize = std::function<std::uint64_t(const char *fileName, std::string_view contentPrefix, std::uint64_t fileSize)>;
+
+LIBPKG_EXPORT void walkThroughArchivePartially(std::string_view archivePath, const CppUtilities::FilePredicate &isFileRelevant,
+    const RequiredContentSize &requiredContentSize, CppUtilities::FileHandler &&fileHandler,
+    CppUtilities::DirectoryHandler &&directoryHandler = CppUtilities::DirectoryHandler());
+
 } // namespace LibPkg
 
 #endif // LIBPKG_PARSER_UTILS_H
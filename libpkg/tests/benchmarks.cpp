@@ -0,0 +1,650 @@
+#include "../data/config.h"
+#include "../data/storageprivate.h"
+#include "../data/stringpool.h"
+#include "../parser/binary.h"
+
+#include "resources/config.h"
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/misc.h>
+#include <c++utilities/tests/testutils.h>
+
+#include <sys/resource.h>
+
+using CppUtilities::operator<<; // must be visible prior to the call site
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef LIBPKG_COUNT_ALLOCATIONS
+/// \cond
+static std::atomic_size_t allocationCount;
+/// \endcond
+
+// count allocations for benchmarks; only compiled in if enabled at build time as this replaces the allocator of all tests
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto *const ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+using namespace std;
+using namespace CPPUNIT_NS;
+using namespace CppUtilities;
+using namespace CppUtilities::Literals;
+using namespace LibPkg;
+
+/*!
+ * \brief The BenchmarkTests class contains benchmarks which are only executed if
+ *        the environment variable LIBPKG_ENABLE_BENCHMARKS is set.
+ * \remarks The results are printed to std::cerr; the assertions only check whether the benchmarked
+ *          code produces sane results.
+ */
+class BenchmarkTests : public TestFixture {
+    CPPUNIT_TEST_SUITE(BenchmarkTests);
+    CPPUNIT_TEST(benchmarkPackageCacheContention);
+    CPPUNIT_TEST(benchmarkPackageViews);
+    CPPUNIT_TEST(benchmarkHotColdSplit);
+    CPPUNIT_TEST(benchmarkParsingDatabaseFile);
+    CPPUNIT_TEST(benchmarkAllocationsWhenParsingDescriptions);
+    CPPUNIT_TEST(benchmarkSearchingByNameContaining);
+    CPPUNIT_TEST(benchmarkCommittingPackageUpdates);
+    CPPUNIT_TEST(benchmarkCheckingForUpdates);
+    CPPUNIT_TEST(benchmarkComparingVersions);
+    CPPUNIT_TEST(benchmarkParsingThroughput);
+    CPPUNIT_TEST(benchmarkExtractingBinaries);
+    CPPUNIT_TEST(benchmarkStringInterning);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+    void tearDown() override;
+
+    void benchmarkPackageCacheContention();
+    void benchmarkPackageViews();
+    void benchmarkHotColdSplit();
+    void benchmarkParsingDatabaseFile();
+    void benchmarkAllocationsWhenParsingDescriptions();
+    void benchmarkSearchingByNameContaining();
+    void benchmarkCommittingPackageUpdates();
+    void benchmarkCheckingForUpdates();
+    void benchmarkComparingVersions();
+    void benchmarkParsingThroughput();
+    void benchmarkExtractingBinaries();
+    void benchmarkStringInterning();
+
+private:
+    Database *setupCoreDb();
+
+    std::string m_dbFile;
+    Config m_config;
+    bool m_enabled = false;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BenchmarkTests);
+
+void BenchmarkTests::setUp()
+{
+    m_enabled = CppUtilities::isEnvVariableSet(PROJECT_VARNAME_UPPER "_ENABLE_BENCHMARKS").value_or(false);
+}
+
+void BenchmarkTests::tearDown()
+{
+}
+
+Database *BenchmarkTests::setupCoreDb()
+{
+    m_dbFile = workingCopyPath("benchmark-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    auto *const db = m_config.findOrCreateDatabase("core"sv, "x86_64"sv);
+    db->path = testFilePath("core.db");
+    auto updater = PackageUpdater(*db, true);
+    updater.insertFromDatabaseFile(db->path);
+    updater.commit();
+    return db;
+}
+
+static std::size_t benchmarkThreadCount()
+{
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 4);
+}
+
+/*!
+ * \brief Looks up packages by name and by ID from many threads at the same time to measure lock contention
+ *        within the package cache.
+ * \remarks Lookups by ID and by name are measured separately as lookups by ID additionally go through the ID-shards.
+ */
+void BenchmarkTests::benchmarkPackageCacheContention()
+{
+    if (!m_enabled) {
+        return;
+    }
+    auto *const db = setupCoreDb();
+    auto packages = std::vector<PackageSpec>();
+    db->allPackagesByName([&packages](std::string_view, const std::function<PackageSpec(void)> &getPackage) {
+        packages.emplace_back(getPackage());
+        return false;
+    });
+    CPPUNIT_ASSERT_MESSAGE("packages present", !packages.empty());
+    m_config.setPackageCacheLimit(1024 * 1024 * 1024);
+
+    static constexpr auto iterations = 200000;
+    for (const auto byID : { true, false }) {
+        for (auto threadCount = std::size_t(1), maxThreadCount = benchmarkThreadCount(); threadCount <= maxThreadCount; threadCount *= 2) {
+            auto threads = std::vector<std::thread>();
+            auto misses = std::atomic_size_t();
+            threads.reserve(threadCount);
+            const auto start = std::chrono::steady_clock::now();
+            for (auto threadIndex = std::size_t(); threadIndex != threadCount; ++threadIndex) {
+                threads.emplace_back([db, &packages, &misses, threadIndex, byID] {
+                    for (auto i = std::size_t(); i != iterations; ++i) {
+                        const auto &spec = packages[(i + threadIndex * 7) % packages.size()];
+                        const auto package = byID ? db->findPackage(spec.id) : db->findPackage(spec.pkg->name);
+                        if (!package) {
+                            ++misses;
+                        }
+                    }
+                });
+            }
+            for (auto &thread : threads) {
+                thread.join();
+            }
+            const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const auto lookups = static_cast<double>(threadCount * iterations);
+            std::cerr << "Package cache contention (by " << (byID ? "ID" : "name") << "), " << threadCount
+                      << " thread(s): " << static_cast<std::size_t>(lookups / duration) << " lookups/s overall, "
+                      << static_cast<std::size_t>(lookups / duration / static_cast<double>(threadCount)) << " lookups/s per thread\n";
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("all packages found", 0_st, misses.load());
+        }
+    }
+}
+
+/*!
+ * \brief Compares scanning all packages via views with scanning all packages via deserialized PackageBase objects.
+ */
+void BenchmarkTests::benchmarkPackageViews()
+{
+    if (!m_enabled) {
+        return;
+    }
+    auto *const db = setupCoreDb();
+    static constexpr auto iterations = 200;
+    auto baseCount = std::size_t(), viewCount = std::size_t(), baseChars = std::size_t(), viewChars = std::size_t();
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i != iterations; ++i) {
+        db->allPackagesBase([&](StorageID, std::shared_ptr<PackageBase> &&package) {
+            ++baseCount;
+            baseChars += package->name.size() + package->description.size();
+            return false;
+        });
+    }
+    const auto baseDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (auto i = 0; i != iterations; ++i) {
+        db->allPackagesView([&](StorageID, const PackageView &package) {
+            ++viewCount;
+            viewChars += package.name.size() + package.description.size();
+            return false;
+        });
+    }
+    const auto viewDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Scanning packages via PackageBase: " << static_cast<std::size_t>(static_cast<double>(baseCount) / baseDuration)
+              << " packages/s\nScanning packages via PackageView: " << static_cast<std::size_t>(static_cast<double>(viewCount) / viewDuration)
+              << " packages/s\n";
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same number of packages visited", baseCount, viewCount);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same data visited", baseChars, viewChars);
+}
+
+/*!
+ * \brief Compares the throughput of scanning PackageBase objects (like Database::allPackagesBase() does) when packages
+ *        from a files database are stored with their cold data within the same record and when it is stored separately.
+ */
+void BenchmarkTests::benchmarkHotColdSplit()
+{
+    if (!m_enabled) {
+        return;
+    }
+    m_dbFile = workingCopyPath("benchmark-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    auto packages = std::vector<std::shared_ptr<Package>>();
+    Package::fromDatabaseFile(testFilePath("core.files"), [&packages](const std::shared_ptr<Package> &package) {
+        packages.emplace_back(package);
+        return false;
+    });
+    CPPUNIT_ASSERT_MESSAGE("packages present", !packages.empty());
+
+    // store packages in the combined format used before the split and in the split format
+    auto combined = m_config.storage()->forDatabase("combined@x86_64"sv);
+    auto split = m_config.storage()->forDatabase("split@x86_64"sv);
+    {
+        auto txn = combined->packages.getRWTransaction();
+        for (const auto &package : packages) {
+            txn.put(*package);
+        }
+        txn.commit();
+    }
+    {
+        auto txn = split->packages.getRWTransaction();
+        for (const auto &package : packages) {
+            split->putPackage(txn, *package);
+        }
+        txn.commit();
+    }
+
+    static constexpr auto iterations = 200;
+    const auto scan = [](DatabaseStorage &storage) {
+        auto visited = std::size_t();
+        const auto start = std::chrono::steady_clock::now();
+        for (auto iteration = 0; iteration != iterations; ++iteration) {
+            auto txn = storage.packages.getROTransaction();
+            for (auto i = txn.begin<std::shared_ptr, PackageBase>(); i != txn.end(); ++i) {
+                visited += !i->name.empty();
+            }
+        }
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return std::make_pair(visited, static_cast<std::size_t>(static_cast<double>(visited) / duration));
+    };
+    const auto [combinedCount, combinedRate] = scan(*combined);
+    const auto [splitCount, splitRate] = scan(*split);
+    std::cerr << "Scanning PackageBase objects of " << packages.size() << " packages with file lists:\n"
+              << " - cold data within package record: " << combinedRate << " packages/s\n"
+              << " - cold data in separate table:     " << splitRate << " packages/s\n";
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same number of packages visited", combinedCount, splitCount);
+}
+
+/*!
+ * \brief Measures how parsing a files database via Package::fromDatabaseFile() scales with the number of parser threads.
+ */
+void BenchmarkTests::benchmarkParsingDatabaseFile()
+{
+    if (!m_enabled) {
+        return;
+    }
+    const auto filesPath = testFilePath("core.files");
+    static constexpr auto iterations = 20;
+    auto expectedCount = std::size_t();
+    for (auto parserCount = std::size_t(1), maxParserCount = benchmarkThreadCount(); parserCount <= maxParserCount; parserCount *= 2) {
+        auto count = std::size_t();
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i != iterations; ++i) {
+            Package::fromDatabaseFile(
+                filesPath,
+                [&count](const std::shared_ptr<Package> &) {
+                    ++count;
+                    return false;
+                },
+                parserCount);
+        }
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << "Parsing core.files, " << parserCount << " parser thread(s): " << static_cast<std::size_t>(static_cast<double>(count) / duration)
+                  << " packages/s\n";
+        if (!expectedCount) {
+            expectedCount = count;
+        }
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("all packages parsed", expectedCount, count);
+    }
+}
+
+/*!
+ * \brief Counts the allocations per package when parsing core.db and core.files.
+ * \remarks
+ * - Only allocations via operator new are counted. This includes allocations for the parsed packages themselves
+ *   and allocations of the archive walker but not allocations libarchive does via malloc().
+ * - Requires the build option BENCHMARK_ALLOCATION_COUNTING.
+ */
+void BenchmarkTests::benchmarkAllocationsWhenParsingDescriptions()
+{
+    if (!m_enabled) {
+        return;
+    }
+#ifndef LIBPKG_COUNT_ALLOCATIONS
+    std::cerr << "Skipping allocation benchmark; configure with BENCHMARK_ALLOCATION_COUNTING=ON to enable it\n";
+#else
+    for (const auto *const fileName : { "core.db", "core.files" }) {
+        const auto path = testFilePath(fileName);
+        auto packages = std::vector<std::shared_ptr<Package>>();
+        packages.reserve(1000);
+        const auto allocationsBefore = allocationCount.load();
+        Package::fromDatabaseFile(path, [&packages](const std::shared_ptr<Package> &package) {
+            packages.emplace_back(package);
+            return false;
+        });
+        const auto allocations = allocationCount.load() - allocationsBefore;
+        std::cerr << "Parsing " << fileName << ": " << (static_cast<double>(allocations) / static_cast<double>(packages.size()))
+                  << " allocations per package\n";
+
+        // parse the in-memory descriptions again to see how many allocations are required for the packages themselves
+        auto descriptions = std::vector<std::string>();
+        descriptions.reserve(packages.size());
+        for (const auto &package : packages) {
+            descriptions.emplace_back(argsToString("%NAME%\n", package->name, "\n\n%VERSION%\n", package->version, "\n\n%DESC%\n",
+                package->description, "\n\n%ARCH%\n", package->arch.str(), "\n"));
+        }
+        const auto parserAllocationsBefore = allocationCount.load();
+        for (const auto &description : descriptions) {
+            const std::string_view parts[] = { description };
+            CPPUNIT_ASSERT(Package::fromDescription(parts));
+        }
+        const auto parserAllocations = allocationCount.load() - parserAllocationsBefore;
+        std::cerr << "Parsing minimal in-memory descriptions of " << fileName << ": "
+                  << (static_cast<double>(parserAllocations) / static_cast<double>(packages.size())) << " allocations per package\n";
+    }
+#endif
+}
+
+/*!
+ * \brief Compares searching packages by a substring of their name via a full scan with searching via the trigram index.
+ */
+void BenchmarkTests::benchmarkSearchingByNameContaining()
+{
+    if (!m_enabled) {
+        return;
+    }
+    auto *const db = setupCoreDb();
+    static constexpr auto iterations = 2000;
+    static constexpr std::string_view substrings[] = { "python"sv, "lib"sv, "-utils"sv, "systemd"sv };
+    auto scanCount = std::size_t(), indexCount = std::size_t();
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i != iterations; ++i) {
+        for (const auto substring : substrings) {
+            db->allPackagesByName([&](std::string_view packageName, const std::function<StorageID(PackageView &)> &) {
+                scanCount += packageName.find(substring) != std::string_view::npos;
+                return false;
+            });
+        }
+    }
+    const auto scanDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (auto i = 0; i != iterations; ++i) {
+        for (const auto &substring : substrings) {
+            db->packagesByNameContaining(std::span<const std::string_view>(&substring, 1),
+                [&](std::string_view, const std::function<StorageID(PackageView &)> &) {
+                    ++indexCount;
+                    return false;
+                });
+        }
+    }
+    const auto indexDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto searches = static_cast<double>(iterations * std::size(substrings));
+    std::cerr << "Searching by name via full scan: " << static_cast<std::size_t>(searches / scanDuration)
+              << " searches/s\nSearching by name via trigram index: " << static_cast<std::size_t>(searches / indexDuration) << " searches/s\n";
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same number of packages found", scanCount, indexCount);
+}
+
+/*!
+ * \brief Measures committing a PackageUpdater (which updates the indexes of dependencies, libraries and trigrams) when
+ *        loading core.files initially and when loading it again into the populated database.
+ */
+void BenchmarkTests::benchmarkCommittingPackageUpdates()
+{
+    if (!m_enabled) {
+        return;
+    }
+    m_dbFile = workingCopyPath("benchmark-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    auto *const db = m_config.findOrCreateDatabase("core"sv, "x86_64"sv);
+    db->path = testFilePath("core.files");
+    static constexpr auto iterations = 10;
+    for (const auto mode : { PackageUpdaterMode::Clear, PackageUpdaterMode::Update, PackageUpdaterMode::Diff }) {
+        auto commitDuration = 0.0;
+        for (auto i = 0; i != iterations; ++i) {
+            auto updater = PackageUpdater(*db, mode);
+            updater.insertFromDatabaseFile(db->path);
+            const auto start = std::chrono::steady_clock::now();
+            updater.commit();
+            commitDuration += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        const auto modeName = mode == PackageUpdaterMode::Clear ? "clear"sv : (mode == PackageUpdaterMode::Update ? "update"sv : "diff"sv);
+        std::cerr << "Committing " << db->packageCount() << " packages from core.files (" << modeName
+                  << "): " << (commitDuration * 1000.0 / iterations) << " ms per commit\n";
+    }
+    auto providingPackages = std::size_t();
+    db->providingPackagesBase(Dependency("sh"), false, [&providingPackages](StorageID, std::shared_ptr<PackageBase> &&) {
+        ++providingPackages;
+        return false;
+    });
+    CPPUNIT_ASSERT_MESSAGE("indexes still populated", providingPackages > 0);
+}
+
+void BenchmarkTests::benchmarkCheckingForUpdates()
+{
+    if (!m_enabled) {
+        return;
+    }
+    m_dbFile = workingCopyPath("benchmark-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    m_config.findOrCreateDatabase("staging"sv, "x86_64"sv);
+    m_config.findOrCreateDatabase("upstream"sv, "x86_64"sv);
+    auto &db = m_config.databases.front(), &updateSource = m_config.databases.back();
+
+    // populate both databases with 15k packages; every 10th package of the update source is newer, every 100th is missing
+    static constexpr auto packageCount = 15000;
+    auto updater = PackageUpdater(db, PackageUpdaterMode::Clear), sourceUpdater = PackageUpdater(updateSource, PackageUpdaterMode::Clear);
+    for (auto i = 0; i != packageCount; ++i) {
+        auto package = std::make_shared<Package>();
+        package->name = argsToString(i % 3 ? "package-"sv : "mingw-w64-package-"sv, i);
+        package->version = "1.0-1";
+        auto sourcePackage = std::make_shared<Package>(*package);
+        if (!(i % 10)) {
+            sourcePackage->version = "1.1-1";
+        }
+        updater.insert(package);
+        if (i % 100) {
+            sourceUpdater.insert(sourcePackage);
+        }
+    }
+    updater.commit();
+    sourceUpdater.commit();
+
+    static constexpr auto iterations = 10;
+    auto results = PackageUpdates();
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i != iterations; ++i) {
+        results = db.checkForUpdates({ &updateSource }, UpdateCheckOptions::ConsiderRegularPackage);
+    }
+    const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Checking " << packageCount << " packages for updates against " << updateSource.packageCount()
+              << " packages: " << (duration * 1000.0 / iterations) << " ms per check\n";
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("newer packages found", 1350_st, results.versionUpdates.size());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("missing packages found", 150_st, results.orphans.size());
+}
+
+void BenchmarkTests::benchmarkComparingVersions()
+{
+    if (!m_enabled) {
+        return;
+    }
+    auto versions = std::vector<std::string>();
+    Package::fromDatabaseFile(testFilePath("core.db"), [&versions](const std::shared_ptr<Package> &package) {
+        versions.emplace_back(package->version);
+        return false;
+    });
+
+    // compare all versions with each other, once by parsing them and once via precomputed keys
+    auto checksum = std::size_t(), keyChecksum = std::size_t();
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &version1 : versions) {
+        for (const auto &version2 : versions) {
+            checksum += static_cast<std::size_t>(PackageVersion::compare(version1, version2));
+        }
+    }
+    const auto parsingDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    auto keys = std::vector<PackageVersionKey>();
+    keys.reserve(versions.size());
+    for (const auto &version : versions) {
+        keys.emplace_back(PackageVersionKey::fromString(version));
+    }
+    const auto keyComputationDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (const auto &key1 : keys) {
+        for (const auto &key2 : keys) {
+            keyChecksum += static_cast<std::size_t>(key1.compare(key2));
+        }
+    }
+    const auto keyDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto comparisons = static_cast<double>(versions.size() * versions.size());
+    std::cerr << "Comparing versions of core.db (" << comparisons << " comparisons): " << (parsingDuration * 1e9 / comparisons)
+              << " ns per comparison when parsing, " << (keyDuration * 1e9 / comparisons) << " ns per comparison via keys (plus "
+              << (keyComputationDuration * 1e3) << " ms for computing keys)\n";
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same results", checksum, keyChecksum);
+}
+
+void BenchmarkTests::benchmarkParsingThroughput()
+{
+    if (!m_enabled) {
+        return;
+    }
+    const auto desc = readFile(testFilePath("linux-4.7.6-1-desc")), files = readFile(testFilePath("linux-4.7.6-1-files"));
+    const auto srcInfo = readFile(testFilePath("mingw-w64-harfbuzz/SRCINFO")), pkgInfo = readFile(testFilePath("mingw-w64-harfbuzz/PKGINFO"));
+    const auto measure = [](std::string_view what, std::size_t bytes, const std::function<std::size_t()> &parse) {
+        static constexpr auto minDuration = 0.5;
+        auto iterations = std::size_t(), packages = std::size_t();
+        auto duration = 0.0;
+        const auto start = std::chrono::steady_clock::now();
+        for (; duration < minDuration; ++iterations) {
+            packages += parse();
+            duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        std::cerr << "Parsing " << what << ": " << (static_cast<double>(bytes * iterations) / duration / 1024.0 / 1024.0) << " MiB/s\n";
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("packages parsed", iterations, packages);
+    };
+    measure("desc and files of linux"sv, desc.size() + files.size(), [&] { return Package::fromDescription({ desc, files })->packageInfo->files.size() / 4595; });
+    measure(".SRCINFO of mingw-w64-harfbuzz"sv, srcInfo.size(), [&] { return Package::fromInfo(srcInfo, false).size() / 2; });
+    measure(".PKGINFO of mingw-w64-harfbuzz"sv, pkgInfo.size(), [&] { return Package::fromInfo(pkgInfo, true).size(); });
+}
+
+/*!
+ * \brief Compares extracting the binaries of a package completely and partially via walkThroughArchivePartially().
+ * \remarks
+ * - The package can be specified via the environment variable LIBPKG_BENCHMARK_PACKAGE (e.g. to use qt6-base or mingw-w64-gcc);
+ *   by default mingw-w64-crt from the test files is used.
+ * - The peak RSS of the process only grows so the partial extraction is done first. The largest buffered file is printed as
+ *   well as it is a more precise measure of the memory needed by the extraction itself.
+ */
+void BenchmarkTests::benchmarkExtractingBinaries()
+{
+    if (!m_enabled) {
+        return;
+    }
+    const auto *const customPackagePath = std::getenv(PROJECT_VARNAME_UPPER "_BENCHMARK_PACKAGE");
+    const auto packagePath = customPackagePath ? std::string(customPackagePath) : testFilePath("mingw-w64-crt/mingw-w64-crt-6.0.0-1-any.pkg.tar.xz");
+    const auto measure = [&packagePath](std::string_view what, const RequiredContentSize &requiredContentSize) {
+        auto bufferedSize = std::size_t(), largestBufferedSize = std::size_t(), dependencyCount = std::size_t();
+        const auto start = std::chrono::steady_clock::now();
+        walkThroughArchivePartially(
+            packagePath, &Package::isPkgInfoFileOrBinary, requiredContentSize, [&](std::string_view directoryPath, ArchiveFile &&file) {
+                bufferedSize += file.content.size();
+                largestBufferedSize = std::max(largestBufferedSize, file.content.size());
+                try {
+                    auto binary = Binary();
+                    binary.load(file.content, file.name, directoryPath, file.type == ArchiveFileType::Regular);
+                    dependencyCount += binary.requiredLibs.size() + !binary.name.empty();
+                } catch (const std::runtime_error &) {
+                }
+                return false;
+            });
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        auto usage = rusage();
+        getrusage(RUSAGE_SELF, &usage);
+        std::cerr << "Extracting binaries " << what << ": " << (duration * 1e3) << " ms, " << (bufferedSize / 1024 / 1024) << " MiB buffered, "
+                  << (largestBufferedSize / 1024) << " KiB largest file, " << (usage.ru_maxrss / 1024) << " MiB peak RSS\n";
+        return dependencyCount;
+    };
+    const auto partialDependencyCount = measure("partially"sv, &Package::requiredSizeOfPkgInfoFileOrBinary);
+    const auto fullDependencyCount = measure("completely"sv, RequiredContentSize());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same dependencies/provides found", fullDependencyCount, partialDependencyCount);
+}
+
+/*!
+ * \brief Returns the current resident set size of the process in KiB or zero if it can not be determined.
+ */
+static std::size_t residentSetSize()
+{
+    auto status = std::ifstream("/proc/self/status");
+    for (auto line = std::string(); std::getline(status, line);) {
+        if (line.starts_with("VmRSS:")) {
+            return std::strtoull(line.data() + 6, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+/*!
+ * \brief Loads databases via Config::loadAllPackages(), keeps all their packages in memory and reports the RSS as well as
+ *        the memory interning dependency names, archs, licenses, groups and library names saves.
+ * \remarks
+ * - The databases can be specified via the environment variable LIBPKG_BENCHMARK_DATABASES as a colon-separated list of
+ *   paths (e.g. to use the databases of a real mirror); by default core.db and core.files from the test files are used.
+ * - The saving is computed from the strings interned when deserializing the packages kept in memory: With interning each
+ *   of them takes a pointer and the whole pool is counted; without interning each would take a std::string plus a heap
+ *   allocation of its size unless it is short enough to be stored inline (so the latter is an upper bound).
+ */
+void BenchmarkTests::benchmarkStringInterning()
+{
+    if (!m_enabled) {
+        return;
+    }
+    const auto *const customDatabasePaths = std::getenv(PROJECT_VARNAME_UPPER "_BENCHMARK_DATABASES");
+    const auto databasePaths = customDatabasePaths ? splitString<std::vector<std::string>>(customDatabasePaths, ":", EmptyPartsTreat::Omit)
+                                                   : std::vector<std::string>{ testFilePath("core.db"), testFilePath("core.files") };
+    m_dbFile = workingCopyPath("benchmark-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    for (const auto &databasePath : databasePaths) {
+        auto *const db = m_config.findOrCreateDatabase(argsToString("db", m_config.databases.size()), "x86_64"sv);
+        db->path = databasePath;
+    }
+
+    const auto rssBefore = residentSetSize();
+    const auto start = std::chrono::steady_clock::now();
+    m_config.loadAllPackages(false, true);
+    const auto statsBefore = StringPool::global().statistics();
+    auto packages = std::vector<std::shared_ptr<Package>>();
+    for (auto &db : m_config.databases) {
+        db.allPackages([&packages](StorageID, std::shared_ptr<Package> &&package) {
+            packages.emplace_back(std::move(package));
+            return false;
+        });
+    }
+    const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto rssAfter = residentSetSize();
+    const auto statsAfter = StringPool::global().statistics();
+
+    const auto requests = statsAfter.requests - statsBefore.requests;
+    const auto requestedSize = statsAfter.requestedSize - statsBefore.requestedSize;
+    const auto withInterning = requests * sizeof(InternedString) + statsAfter.size;
+    const auto withoutInterning = requests * sizeof(std::string) + requestedSize;
+    std::cerr << "Loading " << databasePaths.size() << " databases with " << packages.size() << " packages: " << (duration * 1e3)
+              << " ms, RSS grew by " << ((rssAfter - rssBefore) / 1024) << " MiB (" << (rssAfter / 1024) << " MiB in total)\n"
+              << "Interned strings of packages in memory: " << requests << " strings, " << statsAfter.strings << " distinct strings in pool, "
+              << (withInterning / 1024) << " KiB with interning vs. up to " << (withoutInterning / 1024) << " KiB without\n";
+    CPPUNIT_ASSERT_MESSAGE("packages loaded", !packages.empty());
+    CPPUNIT_ASSERT_MESSAGE("strings interned", requests > 0);
+}
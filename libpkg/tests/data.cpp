@@ -1,4 +1,8 @@
+#include "../data/binaryinfocache.h"
 #include "../data/config.h"
+#include "../data/storageprivate.h"
+#include "../data/stringpool.h"
+#include "../parser/binary.h"
 
 #include "resources/config.h"
 
@@ -12,10 +16,14 @@ using CppUtilities::operator<<; // must be visible prior to the call site
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <initializer_list>
+#include <span>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -27,9 +35,16 @@ using namespace LibPkg;
 class DataTests : public TestFixture {
     CPPUNIT_TEST_SUITE(DataTests);
     CPPUNIT_TEST(testPackageVersionComparsion);
+    CPPUNIT_TEST(testPackageVersionKeys);
     CPPUNIT_TEST(testDependencyStringConversion);
     CPPUNIT_TEST(testDependencyMatching);
     CPPUNIT_TEST(testPackageSearch);
+    CPPUNIT_TEST(testPackageSearchByNameContaining);
+    CPPUNIT_TEST(testPackageSearchByFile);
+    CPPUNIT_TEST(testDependencyIndexes);
+    CPPUNIT_TEST(testBulkLoadingDependencyIndexes);
+    CPPUNIT_TEST(testProvidesAcrossDatabases);
+    CPPUNIT_TEST(testBloomFilter);
     CPPUNIT_TEST(testComputingFileName);
     CPPUNIT_TEST(testDetectingUnresolved);
     CPPUNIT_TEST(testComputingBuildOrder);
@@ -40,6 +55,13 @@ class DataTests : public TestFixture {
     CPPUNIT_TEST(testAddingDepsAndProvidesFromOtherPackage);
     CPPUNIT_TEST(testDependencyExport);
     CPPUNIT_TEST(testPackageUpdater);
+    CPPUNIT_TEST(testPackageUpdaterDiff);
+    CPPUNIT_TEST(testPackageCache);
+    CPPUNIT_TEST(testPackageView);
+    CPPUNIT_TEST(testPackageColdData);
+    CPPUNIT_TEST(testPackageColdDataCompression);
+    CPPUNIT_TEST(testBinaryInfoCache);
+    CPPUNIT_TEST(testStringPool);
     CPPUNIT_TEST(stresstestPackageUpdater);
     CPPUNIT_TEST(testProtectedName);
     CPPUNIT_TEST(testMisc);
@@ -50,9 +72,16 @@ public:
     void tearDown() override;
 
     void testPackageVersionComparsion();
+    void testPackageVersionKeys();
     void testDependencyStringConversion();
     void testDependencyMatching();
     void testPackageSearch();
+    void testPackageSearchByNameContaining();
+    void testPackageSearchByFile();
+    void testDependencyIndexes();
+    void testBulkLoadingDependencyIndexes();
+    void testProvidesAcrossDatabases();
+    void testBloomFilter();
     void testComputingFileName();
     void testDetectingUnresolved();
     void testComputingBuildOrder();
@@ -66,6 +95,13 @@ public:
     void testAddingDepsAndProvidesFromOtherPackage();
     void testDependencyExport();
     void testPackageUpdater();
+    void testPackageUpdaterDiff();
+    void testPackageCache();
+    void testPackageView();
+    void testPackageColdData();
+    void testPackageColdDataCompression();
+    void testBinaryInfoCache();
+    void testStringPool();
     void stresstestPackageUpdater();
     void testProtectedName();
     void testMisc();
@@ -139,6 +175,81 @@ void DataTests::testPackageVersionComparsion()
     CPPUNIT_ASSERT_EQUAL(PackageVersionComparison::NewerThanSyncVersion, pkg1.compareVersion(pkg2));
 }
 
+void DataTests::testPackageVersionKeys()
+{
+    // generate all strings up to 4 characters from an alphabet covering all cases of the version comparison
+    static constexpr auto alphabet = std::string_view("01a.-:");
+    auto versions = std::vector<std::string>{ std::string() };
+    for (auto begin = std::size_t(), length = std::size_t(); length != 4; ++length) {
+        const auto end = versions.size();
+        for (auto i = begin; i != end; ++i) {
+            for (const auto c : alphabet) {
+                versions.emplace_back(versions[i] + c);
+            }
+        }
+        begin = end;
+    }
+    versions.emplace_back("1:2.3.0010-1");
+    versions.emplace_back("1:2.3.10-1");
+    versions.emplace_back("2.3.10-1.1");
+    versions.emplace_back("000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+                          "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+                          "0000000000000000000000000000000000000000000000000000000000001");
+    versions.emplace_back(std::string(300, '9'));
+    versions.emplace_back(std::string(256, '9'));
+
+    // compare all pairs of versions and parts
+    auto parsedVersions = std::vector<PackageVersion>(), keys = std::vector<PackageVersionKey>();
+    auto partKeys = std::vector<std::string>();
+    for (const auto &version : versions) {
+        parsedVersions.emplace_back(PackageVersion::fromString(version));
+        keys.emplace_back(PackageVersionKey::fromVersion(parsedVersions.back()));
+        partKeys.emplace_back(PackageVersionKey::partKey(version));
+    }
+    for (auto i = std::size_t(); i != versions.size(); ++i) {
+        for (auto j = std::size_t(); j != versions.size(); ++j) {
+            const auto expected = parsedVersions[i].compare(parsedVersions[j]);
+            const auto actual = keys[i].compare(keys[j]);
+            if (expected != actual) {
+                auto message = std::stringstream();
+                message << "comparing \"" << versions[i] << "\" with \"" << versions[j] << "\" via keys yields \"" << actual << "\" instead of \""
+                        << expected << '"';
+                CPPUNIT_FAIL(message.str());
+            }
+            const auto expectedPartComparison = PackageVersion::compareParts(versions[i], versions[j]);
+            const auto partComparison = partKeys[i].compare(partKeys[j]);
+            const auto actualPartComparison = partComparison > 0
+                ? PackageVersionPartComparison::Newer
+                : (partComparison < 0 ? PackageVersionPartComparison::Older : PackageVersionPartComparison::Equal);
+            if (expectedPartComparison != actualPartComparison) {
+                auto message = std::stringstream();
+                message << "comparing part \"" << versions[i] << "\" with \"" << versions[j] << "\" via keys yields \"" << actualPartComparison
+                        << "\" instead of \"" << expectedPartComparison << '"';
+                CPPUNIT_FAIL(message.str());
+            }
+        }
+    }
+
+    // check versions against dependencies via matcher (which only falls back to the regular comparison for implicit pkgrel)
+    for (const auto mode : { DependencyMode::Any, DependencyMode::Equal, DependencyMode::GreatherEqual, DependencyMode::LessEqual,
+             DependencyMode::GreatherThan, DependencyMode::LessThan }) {
+        for (const auto &requiredVersion : versions) {
+            if (requiredVersion.size() > 3) {
+                continue;
+            }
+            auto matcher = DependencyVersionMatcher(mode, requiredVersion);
+            for (const auto &version : versions) {
+                if (version.size() <= 3 && matcher.matches(version) != Dependency::matches(mode, requiredVersion, version)) {
+                    auto message = std::stringstream();
+                    message << "matcher yields different result for \"" << version << "\" and dependency with mode \"" << mode << "\" and version \""
+                            << requiredVersion << '"';
+                    CPPUNIT_FAIL(message.str());
+                }
+            }
+        }
+    }
+}
+
 void DataTests::testDependencyStringConversion()
 {
     CPPUNIT_ASSERT_EQUAL("foo>=4.5: bar"s, Dependency("foo", "4.5", DependencyMode::GreatherEqual, "bar").toString());
@@ -280,6 +391,69 @@ void DataTests::testPackageSearch()
     CPPUNIT_ASSERT_EQUAL(0_st, pkgs.size());
 }
 
+void DataTests::testPackageSearchByNameContaining()
+{
+    m_dbFile = workingCopyPath("test-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    auto *const db = m_config.findOrCreateDatabase("test"sv, "x86_64"sv);
+    db->path = testFilePath("core.db");
+    auto updater = PackageUpdater(*db, true);
+    updater.insertFromDatabaseFile(db->path);
+    updater.commit();
+
+    const auto search = [db](std::initializer_list<std::string_view> substrings) {
+        auto names = std::vector<std::string>();
+        db->packagesByNameContaining(std::span<const std::string_view>(substrings.begin(), substrings.size()),
+            [&names](std::string_view packageName, const std::function<StorageID(PackageView &)> &getPackage) {
+                auto view = PackageView();
+                CPPUNIT_ASSERT_MESSAGE("package found via ID from index", getPackage(view));
+                CPPUNIT_ASSERT_EQUAL(packageName, view.name);
+                names.emplace_back(packageName);
+                return false;
+            });
+        return names;
+    };
+    const auto scan = [db](std::initializer_list<std::string_view> substrings) {
+        auto names = std::vector<std::string>();
+        db->allPackagesByName([&](std::string_view packageName, const std::function<StorageID(PackageView &)> &) {
+            if (std::all_of(substrings.begin(), substrings.end(),
+                    [packageName](std::string_view substring) { return packageName.find(substring) != std::string_view::npos; })) {
+                names.emplace_back(packageName);
+            }
+            return false;
+        });
+        return names;
+    };
+    const auto checkSearch = [&search, &scan](std::initializer_list<std::string_view> substrings) {
+        const auto found = search(substrings), expected = scan(substrings);
+        CPPUNIT_ASSERT_MESSAGE("index lookup returns same packages as full scan", found == expected);
+        return found.size();
+    };
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all packages when no substring given", db->packageCount(), checkSearch({}));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all packages when substring empty", db->packageCount(), checkSearch({ ""sv }));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("short substring", scan({ "gc"sv }).size(), checkSearch({ "gc"sv }));
+    CPPUNIT_ASSERT_MESSAGE("packages containing lib", checkSearch({ "lib"sv }) > 1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("exact name", 1_st, checkSearch({ "autoconf"sv }));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("multiple substrings", 1_st, checkSearch({ "auto"sv, "conf"sv }));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("trigrams present but not substring", 0_st, checkSearch({ "confauto"sv }));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("unknown trigram", 0_st, checkSearch({ "qqq"sv }));
+
+    // index is updated when adding and removing packages
+    auto package = std::make_shared<Package>();
+    package->name = "autoconf-archive-git";
+    package->version = "1-1";
+    db->updatePackage(package);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("added package found", 2_st, checkSearch({ "autoconf"sv }));
+    db->removePackage("autoconf");
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("removed package not found", 1_st, checkSearch({ "autoconf"sv }));
+    auto updater2 = PackageUpdater(*db, PackageUpdaterMode::Diff);
+    updater2.insertFromDatabaseFile(db->path);
+    updater2.commit();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("index updated by diff", 1_st, checkSearch({ "autoconf"sv }));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("index updated by diff (2)", "autoconf"s, search({ "autoconf"sv }).front());
+}
+
 void DataTests::testComputingFileName()
 {
     auto pkg = Package();
@@ -306,6 +480,34 @@ void DataTests::testDetectingUnresolved()
     const auto failures = db1.detectUnresolvedPackages(m_config, { m_pkg2 }, removedPackages);
     CPPUNIT_ASSERT_EQUAL(1_st, failures.size());
     CPPUNIT_ASSERT_EQUAL(m_pkgId1, failures.begin()->first.id);
+
+    // add packages with lots of missing dependencies/libraries so the check is split into several ranges
+    auto expectedDeps = std::vector<std::string>(), expectedLibs = std::vector<std::string>();
+    auto missing = std::make_shared<Package>();
+    missing->name = "missing";
+    missing->version = "1-1";
+    for (auto i = 0; i != 200; ++i) {
+        const auto &dep = expectedDeps.emplace_back(argsToString("dep-", i / 100, i / 10 % 10, i % 10));
+        const auto &lib = expectedLibs.emplace_back(argsToString("elf-x86_64::lib", i / 100, i / 10 % 10, i % 10, ".so"));
+        missing->dependencies.emplace_back(dep);
+        missing->libdepends.emplace(lib);
+    }
+    const auto missingID = db1.updatePackage(missing);
+    auto other = std::make_shared<Package>(*missing);
+    other->name = "other";
+    const auto otherID = db1.updatePackage(other);
+    const auto unresolved = db1.detectUnresolvedPackages(m_config, {}, {});
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("only new packages unresolved", 2_st, unresolved.size());
+    for (const auto id : { missingID, otherID }) {
+        const auto i = unresolved.find(PackageSpec(id));
+        CPPUNIT_ASSERT_MESSAGE("package with missing dependencies unresolved", i != unresolved.end());
+        auto deps = std::vector<std::string>();
+        for (const auto &dep : i->second.deps) {
+            deps.emplace_back(dep.name);
+        }
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("all missing deps present in order", expectedDeps, deps);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("all missing libs present in order", expectedLibs, i->second.libs);
+    }
 }
 
 void DataTests::testComputingBuildOrder()
@@ -446,6 +648,18 @@ void DataTests::testUpdateCheck()
     CPPUNIT_ASSERT_EQUAL(0_st, result.downgrades.size());
     CPPUNIT_ASSERT_EQUAL(1_st, result.orphans.size());
     CPPUNIT_ASSERT_EQUAL(m_pkgId2, result.orphans.front().id);
+
+    // consider regular package when checking a variant
+    auto variant = std::make_shared<Package>();
+    variant->name = "mingw-w64-foo";
+    variant->version = "5.6-6";
+    const auto variantID = db1.updatePackage(variant);
+    const auto variantResult = db1.checkForUpdates({ &db2 }, UpdateCheckOptions::ConsiderRegularPackage);
+    CPPUNIT_ASSERT_EQUAL(2_st, variantResult.versionUpdates.size());
+    CPPUNIT_ASSERT_EQUAL(m_pkgId1, variantResult.versionUpdates.front().oldVersion.id);
+    CPPUNIT_ASSERT_EQUAL(variantID, variantResult.versionUpdates.back().oldVersion.id);
+    CPPUNIT_ASSERT_EQUAL(m_pkgId3, variantResult.versionUpdates.back().newVersion.id);
+    CPPUNIT_ASSERT_EQUAL(2_st, variantResult.orphans.size());
 }
 
 void DataTests::testLocatePackage()
@@ -574,6 +788,788 @@ void DataTests::testPackageUpdater()
     CPPUNIT_ASSERT_EQUAL("zlib"s, newPkg->name);
 }
 
+void DataTests::testPackageSearchByFile()
+{
+    m_dbFile = workingCopyPath("test-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    auto *const db = m_config.findOrCreateDatabase("test"sv, "x86_64"sv);
+    db->path = testFilePath("core.files");
+    auto updater = PackageUpdater(*db, true);
+    updater.insertFromDatabaseFile(db->path);
+    updater.commit();
+
+    const auto search = [db](std::string_view path, FileSearchMode mode) {
+        auto hits = std::vector<std::string>();
+        db->packagesContainingFile(path, mode, [db, &hits](StorageID packageID, std::string_view foundPath) {
+            const auto package = db->findPackage(packageID);
+            CPPUNIT_ASSERT_MESSAGE("package found via ID from index", package);
+            hits.emplace_back(argsToString(package->name, ':', foundPath));
+            return false;
+        });
+        return hits;
+    };
+
+    CPPUNIT_ASSERT_MESSAGE("exact path", search("usr/lib/libz.so"sv, FileSearchMode::Path) == std::vector<std::string>{ "zlib:usr/lib/libz.so" });
+    CPPUNIT_ASSERT_MESSAGE("exact path with leading slash",
+        search("/usr/lib/libz.so"sv, FileSearchMode::Path) == std::vector<std::string>{ "zlib:usr/lib/libz.so" });
+    CPPUNIT_ASSERT_MESSAGE("directories not indexed", search("usr/lib/"sv, FileSearchMode::Path).empty());
+    CPPUNIT_ASSERT_MESSAGE("unknown path", search("usr/lib/libfoo.so"sv, FileSearchMode::Path).empty());
+    const auto expectedPrefixHits = std::vector<std::string>{
+        "zlib:usr/lib/libz.a",
+        "zlib:usr/lib/libz.so",
+        "zlib:usr/lib/libz.so.1",
+        "zlib:usr/lib/libz.so.1.2.8",
+    };
+    CPPUNIT_ASSERT_MESSAGE("prefix", search("usr/lib/libz."sv, FileSearchMode::PathPrefix) == expectedPrefixHits);
+    CPPUNIT_ASSERT_MESSAGE("file name", search("libz.so.1"sv, FileSearchMode::Name) == std::vector<std::string>{ "zlib:libz.so.1" });
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("file name present in multiple packages (listed once per package)", 33_st,
+        search("LICENSE"sv, FileSearchMode::Name).size());
+    auto viewHits = std::vector<std::string>();
+    auto view = PackageView();
+    db->packagesContainingFile("usr/lib/libz.so"sv, FileSearchMode::Path,
+        [&](StorageID, std::string_view foundPath, const std::function<bool(PackageView &)> &getPackage) {
+            CPPUNIT_ASSERT_MESSAGE("view read via ID from index", getPackage(view));
+            viewHits.emplace_back(argsToString(view.name, ':', view.version, ':', foundPath));
+            return false;
+        });
+    CPPUNIT_ASSERT_MESSAGE("view of package", viewHits == std::vector<std::string>{ "zlib:1.2.8-4:usr/lib/libz.so" });
+
+    // index is updated when removing and updating packages
+    db->removePackage("zlib");
+    CPPUNIT_ASSERT_MESSAGE("files of removed package not found", search("usr/lib/libz.so"sv, FileSearchMode::Path).empty());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("file name of removed package not found", 32_st, search("LICENSE"sv, FileSearchMode::Name).size());
+    auto updater2 = PackageUpdater(*db, PackageUpdaterMode::Diff);
+    updater2.insertFromDatabaseFile(db->path);
+    updater2.commit();
+    CPPUNIT_ASSERT_MESSAGE("files re-added by diff", search("usr/lib/libz."sv, FileSearchMode::PathPrefix) == expectedPrefixHits);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("file name re-added by diff", 33_st, search("LICENSE"sv, FileSearchMode::Name).size());
+    const auto zlib = db->findPackage("zlib");
+    CPPUNIT_ASSERT(zlib);
+    CPPUNIT_ASSERT(zlib->packageInfo);
+    auto modifiedZlib = std::make_shared<Package>(*zlib);
+    modifiedZlib->version = "1.2.8-5";
+    modifiedZlib->packageInfo->files = { "usr/", "usr/lib/", "usr/lib/libz-ng.so" };
+    db->updatePackage(modifiedZlib);
+    CPPUNIT_ASSERT_MESSAGE("old files gone", search("usr/lib/libz."sv, FileSearchMode::PathPrefix).empty());
+    CPPUNIT_ASSERT_MESSAGE("new file present", search("usr/lib/libz"sv, FileSearchMode::PathPrefix) == std::vector<std::string>{ "zlib:usr/lib/libz-ng.so" });
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("old file name gone", 32_st, search("LICENSE"sv, FileSearchMode::Name).size());
+
+    // files are added by diff when loading the files database after the regular database
+    db->loadPackages(testFilePath("core.db"), DateTime(), true);
+    CPPUNIT_ASSERT_MESSAGE("no files after forced load of regular db", search("usr/lib/libz."sv, FileSearchMode::PathPrefix).empty());
+    auto updater3 = PackageUpdater(*db, PackageUpdaterMode::Diff);
+    updater3.insertFromDatabaseFile(db->path);
+    updater3.commit();
+    CPPUNIT_ASSERT_MESSAGE("files added by diff", search("usr/lib/libz."sv, FileSearchMode::PathPrefix) == expectedPrefixHits);
+    auto updater4 = PackageUpdater(*db, PackageUpdaterMode::Diff);
+    updater4.insertFromDatabaseFile(testFilePath("core.db"));
+    updater4.commit();
+    CPPUNIT_ASSERT_MESSAGE("files kept when loading regular db via diff", search("usr/lib/libz."sv, FileSearchMode::PathPrefix) == expectedPrefixHits);
+}
+
+void DataTests::testDependencyIndexes()
+{
+    m_dbFile = workingCopyPath("test-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    auto *const db = m_config.findOrCreateDatabase("test"sv, "x86_64"sv);
+    const auto makePackage = [](const char *name, const char *requiredVersion, DependencyMode mode) {
+        auto package = std::make_shared<Package>();
+        package->name = name;
+        package->version = "1-1";
+        package->dependencies.emplace_back("bar", requiredVersion, mode);
+        package->libdepends.emplace("libbar.so");
+        return package;
+    };
+    const auto requiring = [db](const Dependency &dependency) {
+        auto names = std::vector<std::string>();
+        db->providingPackages(dependency, true, [&names](StorageID, const std::shared_ptr<Package> &package) {
+            names.emplace_back(package->name);
+            return false;
+        });
+        std::sort(names.begin(), names.end());
+        return names;
+    };
+    const auto requiringLib = [db](const std::string &library) {
+        auto names = std::vector<std::string>();
+        db->providingPackages(library, true, [&names](StorageID, const std::shared_ptr<Package> &package) {
+            names.emplace_back(package->name);
+            return false;
+        });
+        std::sort(names.begin(), names.end());
+        return names;
+    };
+
+    db->updatePackage(makePackage("foo", "1", DependencyMode::GreatherEqual));
+    db->updatePackage(makePackage("baz", "1", DependencyMode::GreatherEqual));
+    CPPUNIT_ASSERT_MESSAGE("packages sharing a dependency", requiring(Dependency("bar")) == std::vector<std::string>{ "baz", "foo" });
+    CPPUNIT_ASSERT_MESSAGE("packages sharing a library", requiringLib("libbar.so") == std::vector<std::string>{ "baz", "foo" });
+    CPPUNIT_ASSERT_MESSAGE("package provides itself", db->provides(Dependency("foo=1-1")));
+
+    db->updatePackage(makePackage("foo", "2", DependencyMode::Equal));
+    CPPUNIT_ASSERT_MESSAGE("changed constraint does not affect other package", requiring(Dependency("bar")) == std::vector<std::string>{ "baz", "foo" });
+
+    db->removePackage("baz");
+    CPPUNIT_ASSERT_MESSAGE("removed package not present anymore", requiring(Dependency("bar")) == std::vector<std::string>{ "foo" });
+    CPPUNIT_ASSERT_MESSAGE("removed package does not require library anymore", requiringLib("libbar.so") == std::vector<std::string>{ "foo" });
+
+    db->removePackage("foo");
+    CPPUNIT_ASSERT_MESSAGE("no package requires dependency anymore", !db->provides(Dependency("bar"), true));
+    CPPUNIT_ASSERT_MESSAGE("no package requires library anymore", !db->provides("libbar.so"s, true));
+    CPPUNIT_ASSERT_MESSAGE("no package provides itself anymore", !db->provides(Dependency("foo")));
+
+    // provides filter must not hide packages added after it has been built
+    auto updater = PackageUpdater(*db);
+    auto newPackage = makePackage("qux", "1", DependencyMode::GreatherEqual);
+    newPackage->libprovides.emplace("libqux.so");
+    updater.insert(newPackage);
+    updater.commit();
+    CPPUNIT_ASSERT_MESSAGE("package added via updater provides itself", db->provides(Dependency("qux")));
+    CPPUNIT_ASSERT_MESSAGE("library added via updater provided", db->provides("libqux.so"s));
+    db->updatePackage(makePackage("foo", "1", DependencyMode::GreatherEqual));
+    CPPUNIT_ASSERT_MESSAGE("package added via updatePackage() provides itself", db->provides(Dependency("foo")));
+
+    // names exceeding the maximum key size of LMDB are indexed as well
+    const auto longName = std::string(600, 'l'), longLibraryName = longName + ".so";
+    auto longNamePackage = makePackage("longprovider", "1", DependencyMode::GreatherEqual);
+    longNamePackage->provides.emplace_back(longName);
+    longNamePackage->libprovides.emplace(longLibraryName);
+    db->updatePackage(longNamePackage);
+    CPPUNIT_ASSERT_MESSAGE("long name provided", db->provides(Dependency(longName)));
+    CPPUNIT_ASSERT_MESSAGE("long library name provided", db->provides(longLibraryName));
+    CPPUNIT_ASSERT_MESSAGE("other long name with same prefix not provided", !db->provides(Dependency(longName + 'x')));
+    db->removePackage("longprovider");
+    CPPUNIT_ASSERT_MESSAGE("long name not provided anymore", !db->provides(Dependency(longName)));
+    auto clearingUpdater = PackageUpdater(*db, true);
+    clearingUpdater.insert(longNamePackage);
+    clearingUpdater.commit();
+    CPPUNIT_ASSERT_MESSAGE("long name provided after bulk-loading indexes", db->provides(Dependency(longName)));
+    CPPUNIT_ASSERT_MESSAGE("long library name provided after bulk-loading indexes", db->provides(longLibraryName));
+}
+
+void DataTests::testBulkLoadingDependencyIndexes()
+{
+    m_dbFile = workingCopyPath("test-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    auto *const bulkDb = m_config.findOrCreateDatabase("bulk"sv, "x86_64"sv);
+    auto *const incrementalDb = m_config.findOrCreateDatabase("incremental"sv, "x86_64"sv);
+    const auto makePackage = [](const char *name, const char *version) {
+        auto package = std::make_shared<Package>();
+        package->name = name;
+        package->version = version;
+        package->dependencies.emplace_back("bar");
+        return package;
+    };
+
+    // populate one database from scratch so the indexes are bulk-loaded and the other one incrementally (as it is not empty)
+    incrementalDb->updatePackage(makePackage("seed", "1-1"));
+    for (auto *const db : { bulkDb, incrementalDb }) {
+        auto updater = PackageUpdater(*db);
+        auto foo = makePackage("foo", "1-1");
+        foo->dependencies.emplace_back("dropped-dep");
+        foo->provides.emplace_back("dropped-provide");
+        foo->libprovides.emplace("libdropped.so");
+        foo->libdepends.emplace("libdropped-dep.so");
+        updater.update(foo);
+        updater.update(makePackage("baz", "1-1"));
+        // replace foo within the same updater dropping some of its dependencies/provides
+        auto newFoo = makePackage("foo", "2-1");
+        newFoo->provides.emplace_back("new-provide");
+        newFoo->libprovides.emplace("libnew.so");
+        updater.update(newFoo);
+        updater.commit();
+    }
+
+    const auto providing = [](Database *db, const auto &dependency, bool reverse) {
+        auto names = std::vector<std::string>();
+        db->providingPackages(dependency, reverse, [&names](StorageID, const std::shared_ptr<Package> &package) {
+            if (package->name != "seed") {
+                names.emplace_back(package->name);
+            }
+            return false;
+        });
+        std::sort(names.begin(), names.end());
+        return names;
+    };
+    const auto expectEntries = [&](const auto &dependency, bool reverse, const std::vector<std::string> &expected) {
+        const auto bulk = providing(bulkDb, dependency, reverse), incremental = providing(incrementalDb, dependency, reverse);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("bulk-loaded index equals incrementally built index", incremental, bulk);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("expected entries present", expected, bulk);
+    };
+    using Names = std::vector<std::string>;
+    expectEntries(Dependency("bar"), true, Names{ "baz", "foo" });
+    expectEntries(Dependency("dropped-dep"), true, Names{});
+    expectEntries(Dependency("dropped-provide"), false, Names{});
+    expectEntries(Dependency("new-provide"), false, Names{ "foo" });
+    expectEntries(Dependency("foo=1-1"), false, Names{});
+    expectEntries(Dependency("foo=2-1"), false, Names{ "foo" });
+    expectEntries("libdropped.so"s, false, Names{});
+    expectEntries("libdropped-dep.so"s, true, Names{});
+    expectEntries("libnew.so"s, false, Names{ "foo" });
+    CPPUNIT_ASSERT_MESSAGE("dropped provide not found across databases", !m_config.findPackage(Dependency("dropped-provide")).pkg);
+}
+
+void DataTests::testBloomFilter()
+{
+    auto filter = BloomFilter(1000);
+    for (auto i = 0; i != 1000; ++i) {
+        filter.add(argsToString("key-", i));
+    }
+    for (auto i = 0; i != 1000; ++i) {
+        CPPUNIT_ASSERT_MESSAGE("no false negatives", filter.mightContain(argsToString("key-", i)));
+    }
+    auto falsePositives = std::size_t();
+    for (auto i = 0; i != 10000; ++i) {
+        falsePositives += filter.mightContain(argsToString("other-", i));
+    }
+    CPPUNIT_ASSERT_MESSAGE(argsToString("few false positives (", falsePositives, ')'), falsePositives < 300);
+    CPPUNIT_ASSERT_MESSAGE("empty filter contains nothing", !BloomFilter().mightContain("key-0"sv));
+}
+
+void DataTests::testProvidesAcrossDatabases()
+{
+    m_dbFile = workingCopyPath("test-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    m_config.findOrCreateDatabase("core"sv, "x86_64"sv);
+    m_config.findOrCreateDatabase("extra"sv, "x86_64"sv);
+    auto *const core = m_config.findDatabase("core"sv, "x86_64"sv);
+    auto *const extra = m_config.findDatabase("extra"sv, "x86_64"sv);
+    CPPUNIT_ASSERT_MESSAGE("databases get distinct IDs", core->storageID() && extra->storageID() && core->storageID() != extra->storageID());
+    const auto makePackage = [](const char *name, const char *version, const char *provides) {
+        auto package = std::make_shared<Package>();
+        package->name = name;
+        package->version = version;
+        package->provides.emplace_back(provides, version, DependencyMode::Equal);
+        return package;
+    };
+
+    extra->updatePackage(makePackage("sh-extra", "2-1", "sh"));
+    auto result = m_config.findPackage(Dependency("sh"));
+    CPPUNIT_ASSERT_MESSAGE("provider in extra found", result.db == extra && result.pkg && result.pkg->name == "sh-extra");
+    CPPUNIT_ASSERT_MESSAGE("version constraint considered", !m_config.findPackage(Dependency("sh", "3", DependencyMode::GreatherEqual)).pkg);
+
+    core->updatePackage(makePackage("bash", "5-1", "sh"));
+    result = m_config.findPackage(Dependency("sh"));
+    CPPUNIT_ASSERT_MESSAGE("provider in database with higher priority preferred", result.db == core && result.pkg && result.pkg->name == "bash");
+    extra->updatePackage(makePackage("sh", "1-1", "posix-sh"));
+    result = m_config.findPackage(Dependency("sh"));
+    CPPUNIT_ASSERT_MESSAGE("exact name match preferred", result.db == extra && result.pkg && result.pkg->name == "sh");
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all providers found", 3_st, m_config.findPackages(Dependency("sh")).size());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("limit considered", 1_st, m_config.findPackages(Dependency("sh"), false, 1).size());
+
+    extra->removePackage("sh");
+    core->updatePackage(makePackage("bash", "5-1", "bourne-shell"));
+    result = m_config.findPackage(Dependency("sh"));
+    CPPUNIT_ASSERT_MESSAGE("updates and removals reflected", result.db == extra && result.pkg && result.pkg->name == "sh-extra");
+
+    extra->clearPackages();
+    CPPUNIT_ASSERT_MESSAGE("cleared database not considered anymore", !m_config.findPackage(Dependency("sh")).pkg);
+    CPPUNIT_ASSERT_MESSAGE("other database still considered", m_config.findPackage(Dependency("bourne-shell")).db == core);
+
+    // discarded databases are removed from the index; when configured again their provides are added again
+    extra->updatePackage(makePackage("sh-extra", "2-1", "sh"));
+    const auto extraID = extra->storageID();
+    extra->toBeDiscarded = true;
+    m_config.discardDatabases();
+    auto &storage = *m_config.storage();
+    auto entriesOfExtra = std::size_t();
+    storage.allProvides().forEach(*storage.env()->getROTransaction(), "sh", [&](std::uint32_t databaseID, const DependencyIndexEntry &) {
+        entriesOfExtra += databaseID == extraID;
+        return false;
+    });
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("entries of discarded database removed", 0_st, entriesOfExtra);
+    CPPUNIT_ASSERT_MESSAGE("remaining database still considered", m_config.findPackage(Dependency("bourne-shell")).db == core);
+    auto *const configuredAgain = m_config.findOrCreateDatabase("extra"sv, "x86_64"sv);
+    result = m_config.findPackage(Dependency("sh"));
+    CPPUNIT_ASSERT_MESSAGE(
+        "provides of database configured again present", result.db == configuredAgain && result.pkg && result.pkg->name == "sh-extra");
+}
+
+void DataTests::testPackageUpdaterDiff()
+{
+    m_dbFile = workingCopyPath("test-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    auto *const db = m_config.findOrCreateDatabase("test"sv, "x86_64"sv);
+    db->path = testFilePath("core.db");
+    const auto countProviders = [db](const char *name) {
+        auto count = std::size_t();
+        db->providingPackages(Dependency(name), false, [&count](StorageID, const std::shared_ptr<Package> &) {
+            ++count;
+            return false;
+        });
+        return count;
+    };
+
+    // initial load adds all packages
+    auto updater = PackageUpdater(*db, PackageUpdaterMode::Diff);
+    updater.insertFromDatabaseFile(db->path);
+    updater.commit();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all packages added", 220_st, updater.diff().added);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("nothing updated", 0_st, updater.diff().updated);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("nothing unchanged", 0_st, updater.diff().unchanged);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("nothing removed", 0_st, updater.diff().removed);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("autoconf provided", 1_st, countProviders("autoconf"));
+
+    // modify one package and add another one which is not present in the database file
+    const auto autoconf = db->findPackage("autoconf");
+    CPPUNIT_ASSERT(autoconf);
+    auto modifiedAutoconf = std::make_shared<Package>(*autoconf);
+    modifiedAutoconf->version = "2.69-3";
+    modifiedAutoconf->provides.emplace_back("autoconf-legacy");
+    db->updatePackage(modifiedAutoconf);
+    auto foo = std::make_shared<Package>();
+    foo->name = "foo";
+    foo->version = "1-1";
+    db->updatePackage(foo);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("legacy autoconf provided", 1_st, countProviders("autoconf-legacy"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("foo provided", 1_st, countProviders("foo"));
+
+    // reload only touches changed packages
+    auto updater2 = PackageUpdater(*db, PackageUpdaterMode::Diff);
+    updater2.insertFromDatabaseFile(db->path);
+    updater2.commit();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("nothing added", 0_st, updater2.diff().added);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("modified package updated", 1_st, updater2.diff().updated);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("other packages unchanged", 219_st, updater2.diff().unchanged);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("extra package removed", 1_st, updater2.diff().removed);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("package count after commit", 220_st, db->packageCount());
+    CPPUNIT_ASSERT_MESSAGE("extra package gone", !db->findPackage("foo"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("version restored", "2.69-4"s, db->findPackage("autoconf")->version);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("autoconf still provided", 1_st, countProviders("autoconf"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("legacy autoconf no longer provided", 0_st, countProviders("autoconf-legacy"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("foo no longer provided", 0_st, countProviders("foo"));
+}
+
+void DataTests::testPackageCache()
+{
+    setupPackages();
+    auto *const db1 = m_config.findDatabase("db1"sv, "x86_64"sv);
+    auto *const db2 = m_config.findDatabase("db2"sv, "x86_64"sv);
+    CPPUNIT_ASSERT(db1);
+    CPPUNIT_ASSERT(db2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("stored packages cached", 3_st, m_config.cachedPackages());
+
+    // lookup via name and ID refers to the same cache entry
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("lookup via name", m_pkg1, db1->findPackage("foo"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("lookup via ID", m_pkg1, db1->findPackage(m_pkgId1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same name in other db", m_pkg3, db2->findPackage("foo"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("lookup via ID in other db", m_pkg3, db2->findPackage(m_pkgId3));
+
+    // entries are evicted but still found in the storage
+    m_config.setPackageCacheLimit(0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("cache empty", 0_st, m_config.cachedPackages());
+    auto pkg = db1->findPackage(m_pkgId2);
+    CPPUNIT_ASSERT_MESSAGE("package found via ID after eviction", pkg);
+    CPPUNIT_ASSERT_EQUAL("bar"s, pkg->name);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("entries not re-added if limit is zero", 0_st, m_config.cachedPackages());
+
+    // removing a package invalidates the lookup via ID as well
+    m_config.setPackageCacheLimit(1024 * 1024);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("package found via ID", m_pkgId1, db1->findPackageWithID("foo").id);
+    CPPUNIT_ASSERT_MESSAGE("package found via ID", db1->findPackage(m_pkgId1));
+    db1->removePackage("foo");
+    CPPUNIT_ASSERT_MESSAGE("removed package not found via name", !db1->findPackage("foo"));
+    CPPUNIT_ASSERT_MESSAGE("removed package not found via ID", !db1->findPackage(m_pkgId1));
+    CPPUNIT_ASSERT_MESSAGE("package from other db still present", db2->findPackage("foo"));
+
+    // clearing a db only affects entries of that db
+    db1->clearPackages();
+    CPPUNIT_ASSERT_MESSAGE("package of cleared db not found", !db1->findPackage(m_pkgId2));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("package of other db still found", m_pkg3, db2->findPackage(m_pkgId3));
+
+    // the limit is based on the approximate memory usage so huge packages are not cached
+    m_config.setPackageCacheLimit(PackageCache::shardCount * 4096);
+    auto hugePackage = std::make_shared<Package>();
+    hugePackage->name = "huge";
+    hugePackage->version = "1-1";
+    hugePackage->description.assign(8192, 'x');
+    CPPUNIT_ASSERT_MESSAGE("huge package exceeds limit", hugePackage->approximateMemoryUsage() > 4096);
+    CPPUNIT_ASSERT_MESSAGE("small package fits into limit", m_pkg3->approximateMemoryUsage() < 4096);
+    const auto statsBefore = m_config.packageCacheStatistics();
+    db2->updatePackage(hugePackage);
+    auto stats = m_config.packageCacheStatistics();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("huge package not cached", statsBefore.entries, stats.entries);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("no other packages evicted", statsBefore.evictions, stats.evictions);
+    CPPUNIT_ASSERT_MESSAGE("huge package still stored", db2->findPackage("huge"));
+    CPPUNIT_ASSERT_MESSAGE("memory usage within limit", stats.size <= stats.limit);
+    CPPUNIT_ASSERT_MESSAGE("memory usage tracked", stats.size >= m_pkg3->approximateMemoryUsage());
+    CPPUNIT_ASSERT_MESSAGE("hits tracked", stats.hits > 0);
+    CPPUNIT_ASSERT_MESSAGE("misses tracked", stats.misses > 0);
+
+    // storing an existing ID under a new name removes the entry cached under the old name (which might live in another shard)
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("package cached under old name", m_pkg3, db2->findPackage("foo"));
+    auto renamedPackage = std::make_shared<Package>(*m_pkg3);
+    renamedPackage->name = "foo-renamed";
+    auto updater = PackageUpdater(*db2);
+    updater.beginUpdate(m_pkgId3, m_pkg3);
+    updater.endUpdate(m_pkgId3, renamedPackage);
+    updater.commit();
+    CPPUNIT_ASSERT_MESSAGE("package not found via old name", !db2->findPackage("foo"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("package found via new name", renamedPackage, db2->findPackage("foo-renamed"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("package found via ID", renamedPackage, db2->findPackage(m_pkgId3));
+
+    // files do not count against the limit as only hot data is cached
+    auto packageWithFiles = std::make_shared<Package>();
+    packageWithFiles->name = "many-files";
+    packageWithFiles->version = "1-1";
+    packageWithFiles->packageInfo.emplace().files.resize(1000, "usr/share/some/rather/long/path/to/a/file/exceeding/the/small/string/buffer");
+    CPPUNIT_ASSERT_MESSAGE("package with files exceeds limit", packageWithFiles->approximateMemoryUsage() > 4096);
+    const auto packageWithFilesID = db2->updatePackage(packageWithFiles);
+    const auto hitsBefore = m_config.packageCacheStatistics().hits;
+    const auto cachedPackageWithFiles = db2->findPackage("many-files");
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("package with files cached", hitsBefore + 1, m_config.packageCacheStatistics().hits);
+    CPPUNIT_ASSERT_MESSAGE("files not cached", cachedPackageWithFiles->packageInfo && cachedPackageWithFiles->packageInfo->files.empty());
+    const auto packageWithColdData = db2->findPackageWithColdData(packageWithFilesID);
+    CPPUNIT_ASSERT(packageWithColdData);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("files loaded explicitly", 1000_st, packageWithColdData->packageInfo->files.size());
+}
+
+void DataTests::testPackageView()
+{
+    m_dbFile = workingCopyPath("test-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    auto *const db = m_config.findOrCreateDatabase("test"sv, "x86_64"sv);
+    auto updater = LibPkg::PackageUpdater(*db, true);
+    updater.insertFromDatabaseFile(testFilePath("core.db"));
+    updater.commit();
+    auto splitPackage = std::make_shared<Package>();
+    splitPackage->name = "split";
+    splitPackage->version = "1-1";
+    splitPackage->arch = "x86_64";
+    splitPackage->archs = { "x86_64", "aarch64" };
+    splitPackage->description = "a package overriding archs";
+    const auto splitPackageID = db->updatePackage(splitPackage);
+
+    // views are equal to the regularly deserialized packages
+    auto expected = std::unordered_map<StorageID, PackageBase>();
+    db->allPackagesBase([&expected](StorageID id, std::shared_ptr<PackageBase> &&package) {
+        expected.emplace(id, *package);
+        return false;
+    });
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all packages present", 221_st, expected.size());
+    auto visited = std::size_t();
+    db->allPackagesView([&](StorageID id, const PackageView &view) {
+        const auto i = expected.find(id);
+        CPPUNIT_ASSERT_MESSAGE("ID of view valid", i != expected.end());
+        const auto copy = view.toPackageBase();
+        CPPUNIT_ASSERT_EQUAL(i->second.name, copy.name);
+        CPPUNIT_ASSERT_EQUAL(i->second.version, copy.version);
+        CPPUNIT_ASSERT_EQUAL(i->second.arch, copy.arch);
+        CPPUNIT_ASSERT_EQUAL(i->second.description, copy.description);
+        CPPUNIT_ASSERT_MESSAGE("archs equal", i->second.archs == copy.archs);
+        CPPUNIT_ASSERT_MESSAGE("build date equal", i->second.buildDate == copy.buildDate);
+        CPPUNIT_ASSERT_MESSAGE("timestamp equal", i->second.timestamp == copy.timestamp);
+        CPPUNIT_ASSERT_MESSAGE("origin equal", i->second.origin == copy.origin);
+        ++visited;
+        return false;
+    });
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all packages visited", expected.size(), visited);
+
+    // views can be obtained by name as well
+    auto view = PackageView();
+    db->allPackagesByName([&](std::string_view packageName, const std::function<StorageID(PackageView &)> &getPackage) {
+        if (packageName != "split"sv) {
+            return false;
+        }
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("ID returned", splitPackageID, getPackage(view));
+        CPPUNIT_ASSERT_EQUAL("split"sv, view.name);
+        CPPUNIT_ASSERT_EQUAL("1-1"sv, view.version);
+        CPPUNIT_ASSERT_EQUAL("a package overriding archs"sv, view.description);
+        CPPUNIT_ASSERT_MESSAGE("archs present", (std::vector<std::string_view>{ "x86_64"sv, "aarch64"sv }) == view.archs());
+        return true;
+    });
+}
+
+void DataTests::testPackageColdData()
+{
+    setupPackages();
+    auto *const db1 = m_config.findDatabase("db1"sv, "x86_64"sv);
+    CPPUNIT_ASSERT(db1);
+    m_pkg2->packageInfo.emplace().files = { "usr/bin/bar", "usr/lib/libbar.so" };
+    m_pkg2->packageInfo->fileName = "bar-5.6-6-x86_64.pkg.tar.zst";
+    m_pkg2->sourceInfo.emplace().name = "bar";
+    m_pkg2->installInfo.emplace().installedSize = 42;
+    m_pkg2->libprovides.emplace("elf-x86_64::libbar.so");
+    db1->updatePackage(m_pkg2);
+    CPPUNIT_ASSERT_MESSAGE("files taken away from stored package", m_pkg2->packageInfo->files.empty());
+    CPPUNIT_ASSERT_MESSAGE("install info taken away from stored package", !m_pkg2->installInfo.has_value());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("remaining package info kept", "bar-5.6-6-x86_64.pkg.tar.zst"s, m_pkg2->packageInfo->fileName);
+    CPPUNIT_ASSERT_MESSAGE("source info kept", m_pkg2->sourceInfo.has_value());
+
+    // only hot data is loaded when retrieving the package via the cache
+    m_config.setPackageCacheLimit(0);
+    const auto checkHotData = [&](const std::shared_ptr<Package> &pkg) {
+        CPPUNIT_ASSERT(pkg);
+        CPPUNIT_ASSERT_MESSAGE("package info present", pkg->packageInfo.has_value());
+        CPPUNIT_ASSERT_EQUAL("bar-5.6-6-x86_64.pkg.tar.zst"s, pkg->packageInfo->fileName);
+        CPPUNIT_ASSERT_MESSAGE("source info present", pkg->sourceInfo.has_value());
+        CPPUNIT_ASSERT_EQUAL("bar"s, pkg->sourceInfo->name);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("libprovides present", 1_st, pkg->libprovides.size());
+    };
+    const auto checkColdData = [&] {
+        const auto pkg = db1->findPackage("bar");
+        checkHotData(pkg);
+        CPPUNIT_ASSERT_MESSAGE("no files loaded", pkg->packageInfo->files.empty());
+        CPPUNIT_ASSERT_MESSAGE("no install info loaded", !pkg->installInfo.has_value());
+        const auto pkgWithColdData = db1->findPackageWithColdData(m_pkgId2);
+        checkHotData(pkgWithColdData);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("files loaded explicitly", 2_st, pkgWithColdData->packageInfo->files.size());
+        CPPUNIT_ASSERT_MESSAGE("install info loaded explicitly", pkgWithColdData->installInfo.has_value());
+        CPPUNIT_ASSERT_EQUAL(std::uint32_t(42), pkgWithColdData->installInfo->installedSize);
+    };
+    checkColdData();
+    CPPUNIT_ASSERT_MESSAGE("no files found via predicate",
+        db1->findPackages([](const Database &, const Package &package) { return package.packageInfo && !package.packageInfo->files.empty(); })
+            .empty());
+    auto visited = std::size_t();
+    db1->allPackages([&visited](StorageID, std::shared_ptr<Package> &&package) {
+        CPPUNIT_ASSERT_MESSAGE(
+            "no cold data loaded by default", !package->installInfo && (!package->packageInfo || package->packageInfo->files.empty()));
+        visited += package->name == "bar" && package->sourceInfo.has_value();
+        return false;
+    });
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("hot data loaded", 1_st, visited);
+    visited = 0;
+    db1->allPackages(
+        [&visited](StorageID, std::shared_ptr<Package> &&package) {
+            visited += package->name == "bar" && package->packageInfo && package->packageInfo->files.size() == 2;
+            return false;
+        },
+        true);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("cold data loaded if requested", 1_st, visited);
+
+    // cold data is kept when updating a package retrieved from the cache
+    m_config.setPackageCacheLimit(PackageCache::defaultLimit);
+    {
+        auto updater = PackageUpdater(*db1);
+        const auto [cachedID, cachedPackage] = updater.findPackageWithID("bar");
+        CPPUNIT_ASSERT_EQUAL(m_pkgId2, cachedID);
+        updater.beginUpdate(cachedID, cachedPackage);
+        cachedPackage->description = "updated";
+        updater.endUpdate(cachedID, cachedPackage);
+        updater.commit();
+    }
+    checkColdData();
+    CPPUNIT_ASSERT_EQUAL("updated"s, db1->findPackageWithColdData(m_pkgId2)->description);
+    const auto pkgFromCache = db1->findPackage("bar");
+    pkgFromCache->description = "updated again";
+    db1->updatePackage(pkgFromCache);
+    checkColdData();
+    CPPUNIT_ASSERT_EQUAL("updated again"s, db1->findPackageWithColdData(m_pkgId2)->description);
+
+    // cold data is preserved when rebuilding the db and removed with its package
+    db1->rebuildDb();
+    checkColdData();
+    m_pkg2 = std::make_shared<Package>(*db1->findPackage("bar"));
+    m_pkg2->packageInfo.reset();
+    m_pkg2->sourceInfo.reset();
+    db1->updatePackage(m_pkg2);
+    const auto pkg = db1->findPackageWithColdData(m_pkgId2);
+    CPPUNIT_ASSERT(pkg);
+    CPPUNIT_ASSERT_MESSAGE("cold data removed", !pkg->packageInfo && !pkg->sourceInfo && !pkg->installInfo);
+}
+
+void DataTests::testPackageColdDataCompression()
+{
+    m_dbFile = workingCopyPath("test-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    m_config.setPackageCacheLimit(0);
+    auto *const db = m_config.findOrCreateDatabase("test"sv, "x86_64"sv);
+    auto updater = PackageUpdater(*db, true);
+    updater.insertFromDatabaseFile(testFilePath("core.files"));
+    updater.commit();
+    const auto [zlibID, cachedZlib] = db->findPackageWithID("zlib");
+    CPPUNIT_ASSERT(cachedZlib);
+    const auto expectedFiles = db->findPackageWithColdData(zlibID)->packageInfo->files;
+    CPPUNIT_ASSERT_MESSAGE("files present", !expectedFiles.empty());
+    const auto checkFiles = [&] {
+        const auto zlib = db->findPackageWithColdData(zlibID);
+        CPPUNIT_ASSERT(zlib);
+        CPPUNIT_ASSERT_MESSAGE("package info present", zlib->packageInfo.has_value());
+        CPPUNIT_ASSERT_MESSAGE("files preserved", zlib->packageInfo->files == expectedFiles);
+    };
+
+    // records are stored uncompressed by default
+    const auto uncompressed = db->packageStorageStatistics();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("one record per package with files", 215_st, uncompressed.records);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("no record compressed", 0_st, uncompressed.compressedRecords);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("stored size equals uncompressed size", uncompressed.storedBytes, uncompressed.uncompressedBytes);
+
+    // enabling compression re-writes existing records
+    const auto compressed = m_config.setPackageCompression(true);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("records preserved", uncompressed.records, compressed.records);
+    CPPUNIT_ASSERT_MESSAGE("records compressed", compressed.compressedRecords > 0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("uncompressed size preserved", uncompressed.uncompressedBytes, compressed.uncompressedBytes);
+    CPPUNIT_ASSERT_MESSAGE("less space used", compressed.storedBytes < uncompressed.storedBytes);
+    checkFiles();
+
+    // new records are compressed transparently
+    auto package = std::make_shared<Package>();
+    package->name = "foo";
+    package->version = "1-1";
+    package->packageInfo.emplace().files = expectedFiles;
+    const auto fooID = db->updatePackage(package);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("new record compressed", compressed.compressedRecords + 1, db->packageStorageStatistics().compressedRecords);
+    const auto foo = db->findPackageWithColdData(fooID);
+    CPPUNIT_ASSERT(foo);
+    CPPUNIT_ASSERT_MESSAGE("files of new package preserved", foo->packageInfo && foo->packageInfo->files == expectedFiles);
+
+    // disabling compression re-writes records uncompressed again
+    const auto decompressed = m_config.setPackageCompression(false);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("no record compressed anymore", 0_st, decompressed.compressedRecords);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("stored size equals uncompressed size again", decompressed.storedBytes, decompressed.uncompressedBytes);
+    checkFiles();
+}
+
+void DataTests::testBinaryInfoCache()
+{
+    m_dbFile = workingCopyPath("test-data.db", WorkingCopyMode::Cleanup);
+    m_config.initStorage(m_dbFile.data());
+    const auto elf = readFile(testFilePath("c++utilities/libc++utilities.so.4.5.0"));
+    const auto pe = readFile(testFilePath("c++utilities/c++utilities.dll"));
+    auto expected = Binary();
+    expected.load(elf, "libc++utilities.so.4.5.0"sv, "usr/lib"sv, true);
+
+    // binaries are parsed on a cache miss
+    auto cache = BinaryInfoCache(*m_config.storage());
+    auto parsed = Binary();
+    parsed.load(cache, elf, "libc++utilities.so.4.5.0"sv, "usr/lib"sv, true);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("miss", 1_st, cache.statistics().misses);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("no hit", 0_st, cache.statistics().hits);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("name parsed", expected.name, parsed.name);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("new entries buffered", 0_st, cache.statistics().stored);
+    cache.flush();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("new entries stored", 1_st, cache.statistics().stored);
+
+    // the info of unchanged binaries is taken from the cache, also by other instances
+    auto otherCache = BinaryInfoCache(*m_config.storage());
+    auto cached = Binary();
+    cached.load(otherCache, elf, "libc++utilities.so.4.5.0"sv, "opt/android-libs/aarch64/lib"sv, true);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("hit", 1_st, otherCache.statistics().hits);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("no miss", 0_st, otherCache.statistics().misses);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("type", expected.type, cached.type);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("sub type", expected.subType, cached.subType);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("class", expected.binaryClass, cached.binaryClass);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("name", expected.name, cached.name);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("arch", expected.architecture, cached.architecture);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("rpath", expected.rpath, cached.rpath);
+    CPPUNIT_ASSERT_MESSAGE("required libs", expected.requiredLibs == cached.requiredLibs);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("prefix still depends on path", "android-"sv, cached.extraPrefix);
+
+    // info depending on the file name is not cached
+    for (const auto fileName : { "c++utilities.dll"sv, "renamed.dll"sv }) {
+        auto dll = Binary();
+        dll.load(otherCache, pe, fileName, "usr/x86_64-w64-mingw32/bin"sv, true);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("PE type", BinaryType::Pe, dll.type);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("PE name from file name", std::string(fileName), dll.name);
+        otherCache.flush();
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("PE parsed once", 1_st, otherCache.statistics().misses);
+
+    // files which are not binaries are not cached
+    auto script = Binary();
+    script.load(otherCache, "#!/bin/sh\n"sv, "foo"sv, "usr/bin"sv, true);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("script not a binary", BinaryType::Invalid, script.type);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("script not looked up", 1_st, otherCache.statistics().misses);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("script not stored", 1_st, otherCache.statistics().stored);
+
+    // entries of other parser versions are removed
+    otherCache.add(std::string(1, static_cast<char>(Binary::infoVersion + 1)) + "stale", "info");
+    otherCache.flush();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("stale entry removed", 1_st, otherCache.removeStaleEntries());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("current entries kept", 0_st, otherCache.removeStaleEntries());
+    Binary().load(otherCache, elf, "libc++utilities.so.4.5.0"sv, "usr/lib"sv, true);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("current entry still found", 3_st, otherCache.statistics().hits);
+
+    // entries are kept no matter how many reloads did not use them, e.g. when a package is skipped for being unchanged
+    constexpr auto skippedReloads = std::uint64_t(20);
+    auto reloadCache = BinaryInfoCache(*m_config.storage());
+    for (auto generation = std::uint64_t(1); generation <= skippedReloads; ++generation) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("generation incremented", generation, reloadCache.startGeneration());
+        Binary().load(reloadCache, pe, "c++utilities.dll"sv, "usr/x86_64-w64-mingw32/bin"sv, true);
+        reloadCache.flush();
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("entries within the limit kept", 0_st, reloadCache.removeStaleEntries());
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("generation persisted", skippedReloads, BinaryInfoCache(*m_config.storage()).generation());
+    reloadCache.startGeneration();
+    Binary().load(reloadCache, elf, "libc++utilities.so.4.5.0"sv, "usr/lib"sv, true);
+    reloadCache.flush();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+        "entry of package skipped for many reloads found when bumped", static_cast<std::size_t>(skippedReloads + 1), reloadCache.statistics().hits);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("nothing parsed again", 0_st, reloadCache.statistics().misses);
+
+    // the least recently used entries are removed when exceeding the limit (the PE entry has not been used by the latest reload)
+    const auto size = reloadCache.size();
+    CPPUNIT_ASSERT_MESSAGE("size of entries determined", size > 0);
+    auto limitedCache = BinaryInfoCache(*m_config.storage(), size - 1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("limit", size - 1, limitedCache.limit());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("least recently used entry removed", 1_st, limitedCache.removeStaleEntries());
+    CPPUNIT_ASSERT_MESSAGE("size within limit", limitedCache.size() <= limitedCache.limit());
+    Binary().load(limitedCache, elf, "libc++utilities.so.4.5.0"sv, "usr/lib"sv, true);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("recently used entry still found", 1_st, limitedCache.statistics().hits);
+    Binary().load(limitedCache, pe, "c++utilities.dll"sv, "usr/x86_64-w64-mingw32/bin"sv, true);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("least recently used entry parsed again", 1_st, limitedCache.statistics().misses);
+
+    // rebuilding the storage clears all entries
+    m_config.rebuildDb();
+    Binary().load(otherCache, elf, "libc++utilities.so.4.5.0"sv, "usr/lib"sv, true);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("entry cleared", 2_st, otherCache.statistics().misses);
+}
+
+void DataTests::testStringPool()
+{
+    // equal strings are only stored once
+    auto pool = StringPool();
+    const auto &foo1 = pool.intern("libfoo.so"sv);
+    const auto &foo2 = pool.intern(std::string("libfoo.so"));
+    const auto &bar = pool.intern("libbar.so"sv);
+    CPPUNIT_ASSERT_EQUAL("libfoo.so"s, foo1);
+    CPPUNIT_ASSERT_EQUAL("libbar.so"s, bar);
+    CPPUNIT_ASSERT_MESSAGE("equal strings share storage", &foo1 == &foo2);
+    CPPUNIT_ASSERT_MESSAGE("empty string not added", &pool.intern(std::string_view()) == &StringPool::emptyString);
+    const auto stats = pool.statistics();
+    CPPUNIT_ASSERT_EQUAL(2_st, stats.strings);
+    CPPUNIT_ASSERT_EQUAL(18_st, stats.size);
+    CPPUNIT_ASSERT_EQUAL(4_st, stats.requests);
+    CPPUNIT_ASSERT_EQUAL(27_st, stats.requestedSize);
+
+    // interned strings compare like std::string
+    const auto interned = InternedString("libfoo.so");
+    CPPUNIT_ASSERT_MESSAGE("equal interned strings share storage", interned.data() == InternedString("libfoo.so"s).data());
+    CPPUNIT_ASSERT_MESSAGE("default-constructed interned string empty", InternedString().empty() && InternedString() == ""sv);
+    CPPUNIT_ASSERT_MESSAGE("comparison with std::string", interned == "libfoo.so"s && interned != "libbar.so"s);
+    CPPUNIT_ASSERT_MESSAGE("ordering", InternedString("a") < InternedString("b") && interned > "libbar.so"sv);
+    const auto libs = InternedStringSet{ "libfoo.so", "libbar.so" };
+    CPPUNIT_ASSERT_MESSAGE("lookup without interning", libs.find("libbar.so"sv) != libs.end() && libs.find("libbaz.so"s) == libs.end());
+
+    // (de)serializing packages with interned fields preserves them
+    auto package = Package();
+    package.name = "foo";
+    package.version = "1-1";
+    package.arch = "x86_64";
+    package.archs = { "x86_64", "aarch64" };
+    package.licenses = { "GPL", "custom:foo" };
+    package.groups = { "bar" };
+    package.dependencies.emplace_back("baz>=1");
+    package.libprovides = { "elf-x86_64::libfoo.so.1" };
+    package.libdepends = { "elf-x86_64::libc.so.6" };
+    const auto check = [&package](const Package &deserialized, const char *format) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(format, package.arch, deserialized.arch);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(format, package.archs, deserialized.archs);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(format, package.licenses, deserialized.licenses);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(format, package.groups, deserialized.groups);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(format, package.dependencies, deserialized.dependencies);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(format, package.libprovides, deserialized.libprovides);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(format, package.libdepends, deserialized.libdepends);
+        CPPUNIT_ASSERT_MESSAGE("deserialized strings interned", deserialized.arch.data() == package.arch.data());
+    };
+    const auto json = package.toJson();
+    CPPUNIT_ASSERT_MESSAGE("serialized as JSON string", std::string_view(json.GetString()).find("\"arch\":\"x86_64\"") != std::string_view::npos);
+    check(Package::fromJson(json.GetString(), json.GetSize()), "JSON");
+    auto binary = std::stringstream(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    package.toBinary(binary);
+    check(Package::fromBinary(binary), "binary");
+}
+
 void DataTests::stresstestPackageUpdater()
 {
     if (!CppUtilities::isEnvVariableSet(PROJECT_VARNAME_UPPER "_ENABLE_STRESS_TESTS").value_or(false)) {
@@ -589,8 +1585,8 @@ void DataTests::stresstestPackageUpdater()
 
     static constexpr auto iterations = 1000;
     static const auto packageToModify = "android-sdk"s;
-    static const auto newLibdepends = std::set<std::string>{ "foo", "bar", "baz" };
-    static const auto newLibprovides = std::set<std::string>{ "a", "b", "c" };
+    static const auto newLibdepends = InternedStringSet{ "foo", "bar", "baz" };
+    static const auto newLibprovides = InternedStringSet{ "a", "b", "c" };
     for (auto i = 0; i != iterations; ++i) {
         if (i % (iterations / 100) == 0) {
             std::cerr << "\rRunning stress test: " << (i * 100 / iterations) << " %";
@@ -3,6 +3,7 @@
 #include "../parser/binary.h"
 #include "../parser/config.h"
 #include "../parser/package.h"
+#include "../parser/utils.h"
 
 namespace CppUtilities {
 inline std::ostream &operator<<(std::ostream &out, const LibPkg::SourceInfo &sourceInfo)
@@ -23,9 +24,14 @@ using CppUtilities::operator<<; // must be visible prior to the call site
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <algorithm>
+#include <cstring>
+#include <map>
 #include <ostream>
 #include <regex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace std;
@@ -49,6 +55,7 @@ class ParserTests : public TestFixture {
     CPPUNIT_TEST(testParsingDatabase);
     CPPUNIT_TEST(testExtractingPkgFile);
     CPPUNIT_TEST(testParsingDescriptions);
+    CPPUNIT_TEST(testParsingAllTestFiles);
     CPPUNIT_TEST(testParsingDatabaseAndOverallStorageBehavior);
     CPPUNIT_TEST(testParsingSignatureLevel);
     CPPUNIT_TEST(testSerializingDatabaseSignatureLevel);
@@ -70,6 +77,7 @@ public:
     void testParsingDatabase();
     void testExtractingPkgFile();
     void testParsingDescriptions();
+    void testParsingAllTestFiles();
     void testParsingDatabaseAndOverallStorageBehavior();
     void testParsingSignatureLevel();
     void testSerializingDatabaseSignatureLevel();
@@ -88,22 +96,22 @@ void ParserTests::tearDown()
 void ParserTests::testParsingDependencies()
 {
     const auto ffmpeg = Dependency("ffmpeg>1:4.2-3");
-    CPPUNIT_ASSERT_EQUAL("ffmpeg"s, ffmpeg.name);
+    CPPUNIT_ASSERT_EQUAL("ffmpeg"s, ffmpeg.name.str());
     CPPUNIT_ASSERT_EQUAL("1:4.2-3"s, ffmpeg.version);
     CPPUNIT_ASSERT_EQUAL(string(), ffmpeg.description);
 
     const auto ffmpeg2 = Dependency("ffmpeg: support more formats");
-    CPPUNIT_ASSERT_EQUAL("ffmpeg"s, ffmpeg2.name);
+    CPPUNIT_ASSERT_EQUAL("ffmpeg"s, ffmpeg2.name.str());
     CPPUNIT_ASSERT_EQUAL(string(), ffmpeg2.version);
     CPPUNIT_ASSERT_EQUAL("support more formats"s, ffmpeg2.description);
 
     const auto ffmpeg3 = Dependency("ffmpeg:support more formats");
-    CPPUNIT_ASSERT_EQUAL("ffmpeg"s, ffmpeg3.name);
+    CPPUNIT_ASSERT_EQUAL("ffmpeg"s, ffmpeg3.name.str());
     CPPUNIT_ASSERT_EQUAL(string(), ffmpeg3.version);
     CPPUNIT_ASSERT_EQUAL("support more formats"s, ffmpeg3.description);
 
     const auto ffmpeg4 = Dependency("ffmpeg=1:4.3:support more formats");
-    CPPUNIT_ASSERT_EQUAL("ffmpeg"s, ffmpeg4.name);
+    CPPUNIT_ASSERT_EQUAL("ffmpeg"s, ffmpeg4.name.str());
     CPPUNIT_ASSERT_EQUAL("1:4.3"s, ffmpeg4.version);
     CPPUNIT_ASSERT_EQUAL("support more formats"s, ffmpeg4.description);
 }
@@ -282,7 +290,7 @@ void ParserTests::testParsingSplitPackageSrcInfo()
     CPPUNIT_ASSERT_MESSAGE("no package info present (2)", !pkg2.packageInfo.has_value());
     CPPUNIT_ASSERT_EQUAL_MESSAGE("pkgbase (1)"s, "mingw-w64-harfbuzz"s, pkg1.sourceInfo->name);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("pkgbase (2)"s, "mingw-w64-harfbuzz"s, pkg2.sourceInfo->name);
-    const vector<string> archs = { "any"s };
+    const vector<InternedString> archs = { "any"s };
     CPPUNIT_ASSERT_EQUAL_MESSAGE("arch (1)"s, archs, pkg1.sourceInfo->archs);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("arch (2)"s, archs, pkg2.sourceInfo->archs);
 }
@@ -301,10 +309,10 @@ void ParserTests::testParsingSplitPackageSrcInfoWithDifferentArchs()
     CPPUNIT_ASSERT_EQUAL_MESSAGE("jre name", "jre"s, jre->name);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("jdk name", "jdk"s, jdk->name);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("jdk-doc name", "jdk-doc"s, doc->name);
-    CPPUNIT_ASSERT_EQUAL_MESSAGE("base archs", std::vector{ "x86_64"s }, jre->sourceInfo->archs);
-    CPPUNIT_ASSERT_EQUAL_MESSAGE("jre archs (empty, base applies)", std::vector<std::string>{}, jre->archs);
-    CPPUNIT_ASSERT_EQUAL_MESSAGE("jdk archs (empty, base applies)", std::vector<std::string>{}, jdk->archs);
-    CPPUNIT_ASSERT_EQUAL_MESSAGE("jdk-doc archs (overridden)", std::vector{ "any"s }, doc->archs);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("base archs", std::vector<InternedString>{ "x86_64"s }, jre->sourceInfo->archs);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("jre archs (empty, base applies)", std::vector<InternedString>{}, jre->archs);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("jdk archs (empty, base applies)", std::vector<InternedString>{}, jdk->archs);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("jdk-doc archs (overridden)", std::vector<InternedString>{ "any"s }, doc->archs);
 }
 
 void ParserTests::testParsingPkgInfo()
@@ -322,7 +330,7 @@ void ParserTests::testParsingPkgName()
     CPPUNIT_ASSERT_EQUAL_MESSAGE("origin", PackageOrigin::PackageFileName, pkg->origin);
     CPPUNIT_ASSERT_EQUAL("texlive-localmanager-git"s, pkg->name);
     CPPUNIT_ASSERT_EQUAL("0.4.6.r0.gd71966e-1"s, pkg->version);
-    CPPUNIT_ASSERT_EQUAL("any"s, pkg->arch);
+    CPPUNIT_ASSERT_EQUAL("any"s, pkg->arch.str());
 }
 
 void ParserTests::testParsingDatabase()
@@ -342,6 +350,28 @@ void ParserTests::testParsingDatabase()
     TESTUTILS_ASSERT_LIKE_FLAGS("truncation not silently ignored", ".*(unable|error).*extra.files.truncated.tar.gz.*truncated.*",
         std::regex::ECMAScript | std::regex::icase, error);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("was able to parse the first few packages despite truncation", expectedPackages, parsedPackages);
+
+    // the result does not depend on the number of parser threads
+    const auto parse = [filesPath = testFilePath("core.files")](std::size_t parserCount) {
+        auto packages = std::map<std::string, std::size_t>();
+        LibPkg::Package::fromDatabaseFile(
+            filesPath,
+            [&](const std::shared_ptr<LibPkg::Package> &package) {
+                packages[package->name] = package->packageInfo ? package->packageInfo->files.size() : 0;
+                return false;
+            },
+            parserCount);
+        return packages;
+    };
+    const auto parsedWithOneThread = parse(1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all packages parsed", 215_st, parsedWithOneThread.size());
+    CPPUNIT_ASSERT_MESSAGE("same packages parsed with multiple threads", parsedWithOneThread == parse(4));
+
+    // stopping early is possible
+    auto visited = std::size_t();
+    LibPkg::Package::fromDatabaseFile(
+        testFilePath("core.files"), [&visited](const std::shared_ptr<LibPkg::Package> &) { return ++visited == 5; }, 4);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("visiting stopped", 5_st, visited);
 }
 
 void ParserTests::testExtractingPkgFile()
@@ -363,6 +393,243 @@ void ParserTests::testParsingDescriptions()
     CPPUNIT_ASSERT_EQUAL_MESSAGE("md5sum"s, "a05d4618090b0294bc075e85791485f8"s, pkg->packageInfo->md5);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("sha256sum"s, "ff62339041c19d2a986eed8231fb8e1be723b3afd354cca833946305456e8ec7"s, pkg->packageInfo->sha256);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("sha256sum"s, "ff62339041c19d2a986eed8231fb8e1be723b3afd354cca833946305456e8ec7"s, pkg->packageInfo->sha256);
+
+    // parts passed as std::string_view do not need to be null-terminated
+    const auto descWithTrailingData = desc + "%FILES%\nusr/bin/foo\n";
+    const std::string_view parts[] = { std::string_view(descWithTrailingData).substr(0, desc.size()) };
+    const auto pkgFromView = Package::fromDescription(parts);
+    checkHarfbuzzPackage(*pkgFromView);
+    CPPUNIT_ASSERT_MESSAGE("trailing data ignored", pkgFromView->packageInfo->files.empty());
+}
+
+/// \cond
+namespace {
+
+/// \brief The values of each field within a desc/.SRCINFO/.PKGINFO file, read line-by-line as reference for the parsers.
+using ReferenceFields = std::map<std::string, std::vector<std::string>, std::less<>>;
+
+/// \brief The fields of a .SRCINFO/.PKGINFO file before the first "pkgname" (base) and the fields of each package.
+struct ReferenceInfo {
+    ReferenceFields base;
+    std::vector<ReferenceFields> packages;
+};
+
+/// \brief Visits the lines of \a contents up to the first null-byte, skipping leading spaces/tabs and empty lines.
+template <typename Visitor> void forEachLine(std::string_view contents, Visitor &&visitor)
+{
+    contents = contents.substr(0, contents.find('\0'));
+    for (auto lineStart = std::size_t(); lineStart < contents.size();) {
+        const auto lineEnd = std::min(contents.find_first_of("\r\n", lineStart), contents.size());
+        auto line = contents.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        if (const auto contentStart = line.find_first_not_of(" \t"); contentStart != std::string_view::npos) {
+            visitor(line.substr(contentStart));
+        }
+    }
+}
+
+/// \brief Adds the fields of the specified part of a description (e.g. the contents of "desc" or "files") to \a fields.
+void readReferenceDescription(std::string_view desc, ReferenceFields &fields)
+{
+    auto fieldName = std::string_view();
+    forEachLine(desc, [&](std::string_view line) {
+        if (line.front() == '%') {
+            fieldName = line.substr(1, line.find('%', 1) - 1);
+        } else {
+            fields[std::string(fieldName)].emplace_back(line);
+        }
+    });
+}
+
+/// \brief Reads the fields of a .SRCINFO/.PKGINFO file; abbreviated field names (e.g. "depend") are expanded like the parser does.
+ReferenceInfo readReferenceInfo(std::string_view info)
+{
+    static constexpr std::string_view knownFields[] = { "pkgbase", "pkgname", "epoch", "pkgver", "pkgrel", "pkgdesc", "url", "arch", "license",
+        "depends", "makedepends", "checkdepends", "optdepends", "conflicts", "provides", "replaces", "source", "size", "builddate", "packager" };
+    auto reference = ReferenceInfo();
+    forEachLine(info, [&](std::string_view line) {
+        const auto nameEnd = line.find(' '), equationSign = line.find('=');
+        if (line.front() == '#' || nameEnd == std::string_view::npos || equationSign < nameEnd || equationSign + 1 >= line.size()
+            || line[equationSign + 1] != ' ') {
+            return;
+        }
+        const auto name = line.substr(0, nameEnd), value = line.substr(equationSign + 2);
+        const auto *const field
+            = std::find_if(std::begin(knownFields), std::end(knownFields), [name](auto knownField) { return knownField.starts_with(name); });
+        if (field == std::end(knownFields)) {
+            return;
+        }
+        if (*field == "pkgname") {
+            reference.packages.emplace_back(reference.base);
+        }
+        (reference.packages.empty() ? reference.base : reference.packages.back())[std::string(*field)].emplace_back(value);
+    });
+    return reference;
+}
+
+/// \brief Returns the last value of the specified \a field or an empty string if not present.
+std::string lastValue(const ReferenceFields &fields, std::string_view field)
+{
+    const auto i = fields.find(field);
+    return i != fields.end() && !i->second.empty() ? i->second.back() : std::string();
+}
+
+/// \brief Returns the values of the specified \a field.
+std::vector<std::string> values(const ReferenceFields &fields, std::string_view field)
+{
+    const auto i = fields.find(field);
+    return i != fields.end() ? i->second : std::vector<std::string>();
+}
+
+/// \brief Returns the values of the specified \a field as interned strings.
+std::vector<InternedString> internedValues(const ReferenceFields &fields, std::string_view field)
+{
+    const auto i = fields.find(field);
+    return i != fields.end() ? std::vector<InternedString>(i->second.begin(), i->second.end()) : std::vector<InternedString>();
+}
+
+/// \brief Returns the values of the specified \a field as dependencies.
+std::vector<Dependency> dependencies(const ReferenceFields &fields, std::string_view field)
+{
+    auto dependencies = std::vector<Dependency>();
+    for (const auto &value : values(fields, field)) {
+        dependencies.emplace_back(Dependency::fromString(value.data(), value.size()));
+    }
+    return dependencies;
+}
+
+/// \brief Checks whether \a package has been parsed from a description with the specified reference \a fields.
+void checkDescription(const Package &package, const ReferenceFields &fields, const std::string &context)
+{
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("name of " + context, lastValue(fields, "NAME"), package.name);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("version of " + context, lastValue(fields, "VERSION"), package.version);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("description of " + context, lastValue(fields, "DESC"), package.description);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("URL of " + context, lastValue(fields, "URL"), package.upstreamUrl);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("arch of " + context, lastValue(fields, "ARCH"), package.arch.str());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("base of " + context, lastValue(fields, "BASE"), package.sourceInfo->name);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("packager of " + context, lastValue(fields, "PACKAGER"), package.packageInfo->packager);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("file name of " + context, lastValue(fields, "FILENAME"), package.packageInfo->fileName);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("licenses of " + context, internedValues(fields, "LICENSE"), package.licenses);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("groups of " + context, internedValues(fields, "GROUPS"), package.groups);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("files of " + context, values(fields, "FILES"), package.packageInfo->files);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("dependencies of " + context, dependencies(fields, "DEPENDS"), package.dependencies);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("optional dependencies of " + context, dependencies(fields, "OPTDEPENDS"), package.optionalDependencies);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("make dependencies of " + context, dependencies(fields, "MAKEDEPENDS"), package.sourceInfo->makeDependencies);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("check dependencies of " + context, dependencies(fields, "CHECKDEPENDS"), package.sourceInfo->checkDependencies);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("conflicts of " + context, dependencies(fields, "CONFLICTS"), package.conflicts);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("replaces of " + context, dependencies(fields, "REPLACES"), package.replaces);
+    auto expectedProvides = dependencies(fields, "PROVIDES");
+    expectedProvides.emplace_back(package.name, package.version);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("provides of " + context, expectedProvides, package.provides);
+}
+
+/// \brief Checks whether \a packages have been parsed from a .SRCINFO/.PKGINFO file with the specified \a reference.
+void checkInfo(const std::vector<PackageSpec> &packages, const ReferenceInfo &reference, const std::string &context)
+{
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("number of packages in " + context, reference.packages.size(), packages.size());
+    for (auto index = std::size_t(); index != packages.size(); ++index) {
+        const auto &package = *packages[index].pkg;
+        const auto &fields = reference.packages[index];
+        const auto packageContext = argsToString("package ", index, " of ", context);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("name of " + packageContext, lastValue(fields, "pkgname"), package.name);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("description of " + packageContext, lastValue(fields, "pkgdesc"), package.description);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("URL of " + packageContext, lastValue(fields, "url"), package.upstreamUrl);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("licenses of " + packageContext, internedValues(fields, "license"), package.licenses);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("dependencies of " + packageContext, dependencies(fields, "depends"), package.dependencies);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("optional dependencies of " + packageContext, dependencies(fields, "optdepends"), package.optionalDependencies);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(
+            "make dependencies of " + packageContext, dependencies(fields, "makedepends"), package.sourceInfo->makeDependencies);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(
+            "check dependencies of " + packageContext, dependencies(fields, "checkdepends"), package.sourceInfo->checkDependencies);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("conflicts of " + packageContext, dependencies(fields, "conflicts"), package.conflicts);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("replaces of " + packageContext, dependencies(fields, "replaces"), package.replaces);
+        auto expectedProvides = dependencies(fields, "provides");
+        expectedProvides.emplace_back(package.name, package.version);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("provides of " + packageContext, expectedProvides, package.provides);
+    }
+}
+
+/// \brief Makes findLineEnd() use the specified implementation until destroyed.
+struct FindLineEndOverride {
+    explicit FindLineEndOverride(FindLineEnd implementation)
+    {
+        overrideFindLineEnd(implementation);
+    }
+    ~FindLineEndOverride()
+    {
+        overrideFindLineEnd(nullptr);
+    }
+};
+
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Parses all desc, .SRCINFO and .PKGINFO files under testfiles (including the ones within databases and packages) and
+ *        compares the results to the values read line-by-line.
+ * \remarks This is done for all implementations of findLineEnd() supported by the CPU as the parsers use it to skip over values.
+ */
+void ParserTests::testParsingAllTestFiles()
+{
+    // read descriptions from standalone files and from databases (which might be truncated)
+    auto descriptions = std::map<std::string, std::vector<std::string>>();
+    descriptions["linux-4.7.6-1-desc"] = { readFile(testFilePath("linux-4.7.6-1-desc")), readFile(testFilePath("linux-4.7.6-1-files")) };
+    for (const auto *const fileName : { "c++utilities/desc", "mingw-w64-harfbuzz/desc" }) {
+        descriptions[fileName] = { readFile(testFilePath(fileName)) };
+    }
+    for (const auto *const dbName : { "core.db", "core.files", "extra.files.truncated.tar.gz" }) {
+        auto parts = std::map<std::string, std::map<std::string, std::string>>();
+        try {
+            walkThroughArchive(testFilePath(dbName), &Database::isFileRelevant, [&parts](std::string_view directoryPath, ArchiveFile &&file) {
+                parts[std::string(directoryPath)][file.name] = std::move(file.content);
+                return false;
+            });
+        } catch (const std::runtime_error &) {
+            // the truncated database is expected to throw; use the files read so far
+        }
+        CPPUNIT_ASSERT_MESSAGE(argsToString("descriptions read from ", dbName), !parts.empty());
+        for (auto &[directoryPath, files] : parts) {
+            auto &description = descriptions[argsToString(dbName, '/', directoryPath)];
+            description.emplace_back(std::move(files["desc"]));
+            description.emplace_back(std::move(files["files"]));
+        }
+    }
+
+    // read .SRCINFO/.PKGINFO files from standalone files and from packages
+    auto infos = std::map<std::string, std::pair<std::string, bool>>();
+    for (const auto *const fileName : { "c++utilities/SRCINFO", "jdk/SRCINFO", "mingw-w64-harfbuzz/SRCINFO" }) {
+        infos[fileName] = { readFile(testFilePath(fileName)), false };
+    }
+    infos["mingw-w64-harfbuzz/PKGINFO"] = { readFile(testFilePath("mingw-w64-harfbuzz/PKGINFO")), true };
+    for (const auto *const pkgFileName : { "cmake/cmake-3.8.2-1-x86_64.pkg.tar.xz", "perl/perl-linux-desktopfiles-0.22-2-any.pkg.tar.xz",
+             "python/sphinxbase-5prealpha-7-i686.pkg.tar.xz", "mingw-w64-crt/mingw-w64-crt-6.0.0-1-any.pkg.tar.xz",
+             "mingw-w64-harfbuzz/mingw-w64-harfbuzz-1.4.2-1-any.pkg.tar.xz", "syncthingtray/syncthingtray-0.6.2-1-x86_64.pkg.tar.xz" }) {
+        walkThroughArchive(
+            testFilePath(pkgFileName), [](const char *, const char *fileName, mode_t) { return !std::strcmp(fileName, ".PKGINFO"); },
+            [&infos, pkgFileName](std::string_view, ArchiveFile &&file) {
+                infos[pkgFileName] = { std::move(file.content), true };
+                return true;
+            });
+        CPPUNIT_ASSERT_MESSAGE(argsToString(".PKGINFO read from ", pkgFileName), infos.contains(pkgFileName));
+    }
+
+    // parse everything with each implementation of findLineEnd()
+    for (const auto &[implementationName, implementation] : supportedFindLineEndImplementations()) {
+        const auto lineEndOverride = FindLineEndOverride(implementation);
+        for (const auto &[name, parts] : descriptions) {
+            auto partViews = std::vector<std::string_view>(parts.begin(), parts.end());
+            auto reference = ReferenceFields();
+            for (const auto part : partViews) {
+                readReferenceDescription(part, reference);
+            }
+            const auto package = Package::fromDescription(std::span<const std::string_view>(partViews));
+            checkDescription(*package, reference, argsToString(name, " (", implementationName, ')'));
+        }
+        for (const auto &[name, info] : infos) {
+            const auto &[contents, isPackageInfo] = info;
+            checkInfo(Package::fromInfo(contents, isPackageInfo), readReferenceInfo(contents), argsToString(name, " (", implementationName, ')'));
+        }
+    }
 }
 
 void ParserTests::testParsingDatabaseAndOverallStorageBehavior()
@@ -378,12 +645,18 @@ void ParserTests::testParsingDatabaseAndOverallStorageBehavior()
         auto *const db = config.findOrCreateDatabase("test"sv, "x86_64"sv);
         db->path = testFilePath("core.db");
         db->filesPath = testFilePath("core.files");
+        auto *const db2 = config.findOrCreateDatabase("test2"sv, "x86_64"sv);
+        db2->path = testFilePath("core.db");
 
-        // load packages
+        // load packages (databases are parsed concurrently)
         config.loadAllPackages(true, false);
         CPPUNIT_ASSERT_EQUAL_MESSAGE("all 215 packages present"s, 215_st, db->packageCount());
-        const auto autoreconf = db->findPackage("autoconf");
-        CPPUNIT_ASSERT_MESSAGE("autoreconf exists", autoreconf != nullptr);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("all 220 packages of 2nd db present"s, 220_st, db2->packageCount());
+        CPPUNIT_ASSERT_MESSAGE("last update of 2nd db set", db2->lastUpdate.load() != DateTime());
+        const auto [autoreconfID, cachedAutoreconf] = db->findPackageWithID("autoconf");
+        CPPUNIT_ASSERT_MESSAGE("autoreconf exists", cachedAutoreconf != nullptr);
+        const auto autoreconf = db->findPackageWithColdData(autoreconfID);
+        CPPUNIT_ASSERT_MESSAGE("autoreconf with cold data exists", autoreconf != nullptr);
         CPPUNIT_ASSERT_EQUAL_MESSAGE("origin", PackageOrigin::Database, autoreconf->origin);
         checkAutoconfPackage(*autoreconf);
     }
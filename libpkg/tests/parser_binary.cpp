@@ -6,6 +6,7 @@
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/misc.h>
 #include <c++utilities/io/path.h>
 #include <c++utilities/tests/testutils.h>
 
@@ -20,12 +21,14 @@ using CppUtilities::operator<<; // must be visible prior to the call site
 using namespace std;
 using namespace CPPUNIT_NS;
 using namespace CppUtilities;
+using namespace CppUtilities::Literals;
 using namespace LibPkg;
 using namespace TestHelper;
 
 class BinaryParserTests : public TestFixture {
     CPPUNIT_TEST_SUITE(BinaryParserTests);
     CPPUNIT_TEST(testParsingElf);
+    CPPUNIT_TEST(testParsingElfSymbols);
     CPPUNIT_TEST(testParsingPe);
     CPPUNIT_TEST(testParsingPeAarch64);
     CPPUNIT_TEST(testParsingAr);
@@ -41,6 +44,7 @@ public:
     void tearDown() override;
 
     void testParsingElf();
+    void testParsingElfSymbols();
     void testParsingPe();
     void testParsingPeAarch64();
     void testParsingAr();
@@ -75,6 +79,27 @@ void BinaryParserTests::testParsingElf()
     CPPUNIT_ASSERT_EQUAL_MESSAGE("rpath", "/test/rpath:/foo/bar"s, bin.rpath);
 }
 
+void BinaryParserTests::testParsingElfSymbols()
+{
+    const auto path = testFilePath("c++utilities/libc++utilities.so.4.5.0");
+    auto bin = Binary();
+    bin.load(path);
+    CPPUNIT_ASSERT_MESSAGE("symbols skipped by default", bin.symbols.empty());
+
+    bin = Binary();
+    bin.load(path, BinaryParseOptions::Symbols);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("number of defined global/weak symbols", 198_st, bin.symbols.size());
+    CPPUNIT_ASSERT_MESSAGE("defined function present", bin.symbols.contains("_Z11orderModulomm"));
+    CPPUNIT_ASSERT_MESSAGE("undefined symbol absent", !bin.symbols.contains("_Unwind_Resume"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("dynamic section still read", "libc++utilities.so.4"s, bin.name);
+
+    const auto content = readFile(path);
+    auto binFromContent = Binary();
+    binFromContent.load(content, "libc++utilities.so.4.5.0", "usr/lib", true, BinaryParseOptions::Symbols);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same symbols when parsing buffered content", bin.symbols, binFromContent.symbols);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same deps when parsing buffered content", bin.requiredLibs, binFromContent.requiredLibs);
+}
+
 void BinaryParserTests::testParsingPe()
 {
     Binary bin;
@@ -168,7 +193,7 @@ void BinaryParserTests::testParsingElfFromPkgFile()
     const auto pkgFilePath3 = testFilePath("perl/perl-linux-desktopfiles-0.22-2-any.pkg.tar.xz");
     const auto package3 = Package::fromPkgFile(pkgFilePath3);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("origin", PackageOrigin::PackageContents, package3->origin);
-    CPPUNIT_ASSERT_EQUAL_MESSAGE("arch", "any"s, package3->arch);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("arch", "any"s, package3->arch.str());
     const unordered_set<Dependency> expectedPerlDependencies{
         Dependency("perl", "5.28", DependencyMode::GreatherEqual), // because contained module built against Perl 5.28
         Dependency("perl", "5.29", DependencyMode::LessThan), // because contained module built against Perl 5.28
@@ -176,15 +201,15 @@ void BinaryParserTests::testParsingElfFromPkgFile()
     // note: Dependency perl>=5.14.0 from PKGBUILD has been removed. I guess that's ok.
     CPPUNIT_ASSERT_EQUAL_MESSAGE(
         "perl dependencies", expectedPerlDependencies, unordered_set<Dependency>(package3->dependencies.begin(), package3->dependencies.end()));
-    const set<string> expectedPerlLibProvides;
+    const InternedStringSet expectedPerlLibProvides;
     CPPUNIT_ASSERT_EQUAL_MESSAGE("perl lib provides", expectedPerlLibProvides, package3->libprovides);
-    const set<string> expectedPerlLibDepends;
+    const InternedStringSet expectedPerlLibDepends;
     CPPUNIT_ASSERT_EQUAL_MESSAGE("perl lib depends", expectedPerlLibDepends, package3->libdepends);
 
     const auto pkgFilePath4 = testFilePath("python/sphinxbase-5prealpha-7-i686.pkg.tar.xz");
     const auto package4 = Package::fromPkgFile(pkgFilePath4);
     CPPUNIT_ASSERT_EQUAL_MESSAGE("origin", PackageOrigin::PackageContents, package4->origin);
-    CPPUNIT_ASSERT_EQUAL_MESSAGE("arch", "i686"s, package4->arch);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("arch", "i686"s, package4->arch.str());
     const unordered_set<Dependency> expectedPythonDependencies{
         Dependency("libpulse"), // from PKGBUILD
         Dependency("lapack"), // from PKGBUILD
@@ -195,13 +220,13 @@ void BinaryParserTests::testParsingElfFromPkgFile()
     };
     CPPUNIT_ASSERT_EQUAL_MESSAGE(
         "python dependencies", expectedPythonDependencies, unordered_set<Dependency>(package4->dependencies.begin(), package4->dependencies.end()));
-    const set<string> expectedPythonLibProvides{
+    const InternedStringSet expectedPythonLibProvides{
         "elf-i386::_sphinxbase.so.0",
         "elf-i386::libsphinxad.so.3",
         "elf-i386::libsphinxbase.so.3",
     };
     CPPUNIT_ASSERT_EQUAL_MESSAGE("python lib provides", expectedPythonLibProvides, package4->libprovides);
-    const set<string> expectedPythonLibDepends{
+    const InternedStringSet expectedPythonLibDepends{
         "elf-i386::libblas.so.3",
         "elf-i386::libc.so.6",
         "elf-i386::liblapack.so.3",
@@ -228,7 +253,7 @@ void BinaryParserTests::testParsingArFromPkgFile()
     const auto package = Package::fromPkgFile(pkgFilePath);
     CPPUNIT_ASSERT_EQUAL("mingw-w64-crt"s, package->name);
     CPPUNIT_ASSERT_EQUAL("6.0.0-1"s, package->version);
-    const set<string> expectedDLLs{ "pe-i386::aclui.dll", "pe-i386::activeds.dll", "pe-i386::adsldpc.dll", "pe-i386::advapi32.dll",
+    const InternedStringSet expectedDLLs{ "pe-i386::aclui.dll", "pe-i386::activeds.dll", "pe-i386::adsldpc.dll", "pe-i386::advapi32.dll",
         "pe-i386::apcups.dll", "pe-i386::api-ms-win-core-synch-l1-2-0.dll", "pe-i386::api-ms-win-core-winrt-l1-1-0.dll",
         "pe-i386::api-ms-win-crt-utility-l1-1-0.dll", "pe-i386::api-ms-win-shcore-stream-winrt-l1-1-0.dll", "pe-i386::authz.dll",
         "pe-i386::avicap32.dll", "pe-i386::avifil32.dll", "pe-i386::avrt.dll", "pe-i386::bcrypt.dll", "pe-i386::bootvid.dll", "pe-i386::browcli.dll",
@@ -1,7 +1,14 @@
+#include <chrono>
+#include <functional>
+#include <future>
+#include <map>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "../data/boundedqueue.h"
+#include "../parser/binary.h"
 #include "../parser/database.h"
 #include "../parser/package.h"
 #include "../parser/utils.h"
@@ -21,12 +28,17 @@ using CppUtilities::operator<<; // must be visible prior to the call site
 using namespace std;
 using namespace CPPUNIT_NS;
 using namespace CppUtilities;
+using namespace CppUtilities::Literals;
 using namespace LibPkg;
 
 class UtilsTests : public TestFixture {
     CPPUNIT_TEST_SUITE(UtilsTests);
     CPPUNIT_TEST(testFileExtraction);
+    CPPUNIT_TEST(testPartialFileExtraction);
     CPPUNIT_TEST(testAmendingPkgbuild);
+    CPPUNIT_TEST(testRequiredSubstringsOfRegex);
+    CPPUNIT_TEST(testFindingLineEnds);
+    CPPUNIT_TEST(testBoundedQueue);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -34,7 +46,11 @@ public:
     void tearDown() override;
 
     void testFileExtraction();
+    void testPartialFileExtraction();
     void testAmendingPkgbuild();
+    void testRequiredSubstringsOfRegex();
+    void testFindingLineEnds();
+    void testBoundedQueue();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(UtilsTests);
@@ -64,6 +80,44 @@ void UtilsTests::testFileExtraction()
     CPPUNIT_ASSERT_EQUAL_MESSAGE("also depends present", "depends"s, zlibDir[1].name);
 }
 
+void UtilsTests::testPartialFileExtraction()
+{
+    const auto pkgFilePath = testFilePath("cmake/cmake-3.8.2-1-x86_64.pkg.tar.xz");
+    auto fullFiles = std::map<std::string, std::string>(), partialFiles = std::map<std::string, std::string>();
+    walkThroughArchive(pkgFilePath, &Package::isPkgInfoFileOrBinary, [&fullFiles](std::string_view directoryPath, ArchiveFile &&file) {
+        fullFiles.emplace(argsToString(directoryPath, '/', file.name), std::move(file.content));
+        return false;
+    });
+    walkThroughArchivePartially(pkgFilePath, &Package::isPkgInfoFileOrBinary, &Package::requiredSizeOfPkgInfoFileOrBinary,
+        [&partialFiles](std::string_view directoryPath, ArchiveFile &&file) {
+            partialFiles.emplace(argsToString(directoryPath, '/', file.name), std::move(file.content));
+            return false;
+        });
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("same files visited", fullFiles.size(), partialFiles.size());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(".PKGINFO read completely", fullFiles.at("/.PKGINFO"), partialFiles.at("/.PKGINFO"));
+
+    auto fullSize = std::size_t(), partialSize = std::size_t(), binaryCount = std::size_t();
+    for (const auto &[path, content] : fullFiles) {
+        const auto &prefix = partialFiles.at(path);
+        CPPUNIT_ASSERT_MESSAGE("buffered prefix of " + path, std::string_view(content).starts_with(prefix));
+        fullSize += content.size();
+        partialSize += prefix.size();
+        auto fullBinary = Binary(), partialBinary = Binary();
+        try {
+            fullBinary.load(content, path, std::string_view(), true);
+        } catch (const std::runtime_error &) {
+            continue;
+        }
+        partialBinary.load(prefix, path, std::string_view(), true);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("same type of " + path, fullBinary.type, partialBinary.type);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("same name of " + path, fullBinary.name, partialBinary.name);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("same deps of " + path, fullBinary.requiredLibs, partialBinary.requiredLibs);
+        binaryCount += fullBinary.type == BinaryType::Elf;
+    }
+    CPPUNIT_ASSERT_MESSAGE("ELF binaries present", binaryCount > 0);
+    CPPUNIT_ASSERT_MESSAGE("less than the full content buffered", partialSize < fullSize);
+}
+
 void UtilsTests::testAmendingPkgbuild()
 {
     const auto pkgbuildPath = workingCopyPath("c++utilities/PKGBUILD");
@@ -90,3 +144,113 @@ void UtilsTests::testAmendingPkgbuild()
     CPPUNIT_ASSERT_EQUAL_MESSAGE("pkgrel bumped when quotes were used", readFile(testFilePath("perl-data-dumper-concise/PKGBUILD.newpkgrel")),
         readFile(pkgbuildWithQuotingPath));
 }
+
+void UtilsTests::testRequiredSubstringsOfRegex()
+{
+    using Substrings = std::vector<std::string_view>;
+    CPPUNIT_ASSERT_MESSAGE("plain name", Substrings{ "foo" } == requiredSubstringsOfRegex("^foo$"));
+    CPPUNIT_ASSERT_MESSAGE("wildcard", (Substrings{ "lib", "-git" }) == requiredSubstringsOfRegex("lib.*-git"));
+    CPPUNIT_ASSERT_MESSAGE("optional group and char", (Substrings{ "py", "-bar" }) == requiredSubstringsOfRegex("py(thon)?-bars?"));
+    CPPUNIT_ASSERT_MESSAGE("optional char", (Substrings{ "a", "cde" }) == requiredSubstringsOfRegex("ab*cde"));
+    CPPUNIT_ASSERT_MESSAGE("escapes and classes", (Substrings{ "x", "y", "z", "q" }) == requiredSubstringsOfRegex("x\\.y[a-z]zz{2}q"));
+    CPPUNIT_ASSERT_MESSAGE("class containing bracket", Substrings{ "def" } == requiredSubstringsOfRegex("[]abc]def"));
+    CPPUNIT_ASSERT_MESSAGE("alternatives", requiredSubstringsOfRegex("foo|bar").empty());
+    CPPUNIT_ASSERT_MESSAGE("class containing escaped bracket", Substrings{ "b" } == requiredSubstringsOfRegex("[\\]a]b"));
+    CPPUNIT_ASSERT_MESSAGE("class containing named class", Substrings{ "-git" } == requiredSubstringsOfRegex("[[:alpha:]]+-git"));
+    CPPUNIT_ASSERT_MESSAGE("hex escape", Substrings{ "bc" } == requiredSubstringsOfRegex("\\x41bc"));
+    CPPUNIT_ASSERT_MESSAGE("unicode escape", requiredSubstringsOfRegex("\\u0041").empty());
+    CPPUNIT_ASSERT_MESSAGE("back reference", (Substrings{ "a", "b" }) == requiredSubstringsOfRegex("(x)a\\1b"));
+}
+
+void UtilsTests::testFindingLineEnds()
+{
+    // test all implementations supported by the CPU and not just the one selected at runtime
+    const auto implementations = supportedFindLineEndImplementations();
+    CPPUNIT_ASSERT_MESSAGE("scalar implementation always supported", !implementations.empty() && implementations.front().name == "scalar");
+    for (const auto &[name, implementation] : implementations) {
+        // check all positions within and after the chunks processed at once by the vectorized implementations
+        for (auto size = std::size_t(); size != 100; ++size) {
+            const auto noLineEnd = std::string(size, 'x');
+            CPPUNIT_ASSERT_MESSAGE(argsToString("end returned if no line end present (", name, ')'),
+                implementation(noLineEnd.data(), noLineEnd.data() + size) == noLineEnd.data() + size);
+            for (auto position = std::size_t(); position != size; ++position) {
+                for (const auto lineEnd : { '\n', '\r', '\0' }) {
+                    auto str = noLineEnd;
+                    str[position] = lineEnd;
+                    str.append(position % 3, '\n');
+                    CPPUNIT_ASSERT_EQUAL_MESSAGE(argsToString("position of line end in string of size ", size, " (", name, ')'), position,
+                        static_cast<std::size_t>(implementation(str.data(), str.data() + size) - str.data()));
+                }
+            }
+        }
+    }
+
+    // check all implementations against each other on the contents of test files, starting from every position
+    for (const auto *const fileName : { "linux-4.7.6-1-desc", "linux-4.7.6-1-files", "c++utilities/SRCINFO", "mingw-w64-harfbuzz/PKGINFO" }) {
+        const auto contents = readFile(testFilePath(fileName));
+        const auto *const end = contents.data() + contents.size();
+        for (const auto *i = contents.data(); i != end; ++i) {
+            const auto *const expected = implementations.front().function(i, end);
+            for (const auto &[name, implementation] : implementations) {
+                if (implementation(i, end) != expected) {
+                    CPPUNIT_FAIL(argsToString("different line end found in ", fileName, " at ", i - contents.data(), " (", name, ')'));
+                }
+            }
+        }
+    }
+
+    // parse description with lots of lines
+    const auto desc = readFile(testFilePath("linux-4.7.6-1-desc")), files = readFile(testFilePath("linux-4.7.6-1-files"));
+    const auto package = Package::fromDescription({ desc, files });
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("name", "linux"s, package->name);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all files present", 4595_st, package->packageInfo->files.size());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("first file", "boot/"s, package->packageInfo->files.front());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("last file", "usr/lib/modules/extramodules-4.7-ARCH/version"s, package->packageInfo->files.back());
+}
+
+void UtilsTests::testBoundedQueue()
+{
+    // items are popped in the order they have been pushed by default, also when the producer has to wait for space
+    auto fifo = BoundedQueue<int>(2);
+    auto producer = std::thread([&fifo] {
+        for (auto i = 0; i != 100; ++i) {
+            fifo.push(int(i));
+        }
+        fifo.close();
+    });
+    auto popped = std::vector<int>();
+    while (auto item = fifo.pop()) {
+        popped.emplace_back(*item);
+    }
+    producer.join();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all items popped", 100_st, popped.size());
+    for (auto i = 0; i != 100; ++i) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("items popped in order", i, popped[static_cast<std::size_t>(i)]);
+    }
+    CPPUNIT_ASSERT_MESSAGE("nothing pushed after closing", !fifo.push(100));
+    CPPUNIT_ASSERT_MESSAGE("nothing popped after draining", !fifo.pop().has_value());
+
+    // the greatest item is popped first if an order is specified; closing the queue still drains it
+    auto ordered = BoundedQueue<int, std::less<int>>(5);
+    for (const auto item : { 2, 5, 1, 4, 3 }) {
+        CPPUNIT_ASSERT_MESSAGE("item pushed", ordered.push(int(item)));
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("greatest item popped first", 5, ordered.pop().value_or(0));
+    ordered.push(6);
+    ordered.close();
+    CPPUNIT_ASSERT_MESSAGE("nothing pushed after closing", !ordered.push(7));
+    for (const auto expected : { 6, 4, 3, 2, 1 }) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("remaining items popped in order after closing", expected, ordered.pop().value_or(0));
+    }
+    CPPUNIT_ASSERT_MESSAGE("nothing popped after draining", !ordered.pop().has_value());
+
+    // aborting discards pending items and lets producers waiting for space stop
+    auto aborted = BoundedQueue<int>(1);
+    CPPUNIT_ASSERT_MESSAGE("first item pushed", aborted.push(1));
+    auto blockedPush = std::async(std::launch::async, [&aborted] { return aborted.push(2); });
+    CPPUNIT_ASSERT_MESSAGE("push blocks while full", blockedPush.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+    aborted.abort();
+    CPPUNIT_ASSERT_MESSAGE("blocked push fails when aborted", !blockedPush.get());
+    CPPUNIT_ASSERT_MESSAGE("pending item discarded", !aborted.pop().has_value());
+    CPPUNIT_ASSERT_MESSAGE("nothing pushed after aborting", !aborted.push(3));
+}
@@ -7,15 +7,20 @@
 #include "../webclient/aur.h"
 #include "../webclient/database.h"
 
+#include "../../libpkg/data/binaryinfocache.h"
+#include "../../libpkg/data/boundedqueue.h"
+
 #include <c++utilities/chrono/datetime.h>
 #include <c++utilities/io/ansiescapecodes.h>
 #include <c++utilities/io/inifile.h>
 #include <c++utilities/misc/flagenumclass.h>
 
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <mutex>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 
 #include <boost/asio/ip/tcp.hpp>
@@ -436,6 +441,8 @@ private:
 };
 
 struct LIBREPOMGR_EXPORT ReloadLibraryDependencies : public InternalBuildAction {
+    friend BuildActionsTests;
+
     ReloadLibraryDependencies(ServiceSetup &setup, const std::shared_ptr<BuildAction> &buildAction);
     void run();
 
@@ -451,11 +458,32 @@ private:
         std::string arch;
         std::vector<PackageToConsider> packages;
     };
+    struct PackageTask {
+        const DatabaseToConsider *db = nullptr;
+        PackageToConsider *package = nullptr;
+        std::uintmax_t size = 0;
+    };
+    struct LargerPackageFirst {
+        bool operator()(const PackageTask &lhs, const PackageTask &rhs) const
+        {
+            return lhs.size < rhs.size;
+        }
+    };
+    struct ParsingThread {
+        std::thread thread;
+        std::vector<std::string> errors, warnings;
+        std::size_t packages = 0;
+        std::chrono::steady_clock::duration busyTime = std::chrono::steady_clock::duration::zero();
+    };
 
     bool addRelevantPackage(LibPkg::StorageID packageID, const std::shared_ptr<LibPkg::Package> &package, const LibPkg::Database *db,
         bool isDestinationDb, DatabaseToConsider &relevantDbInfo,
         std::unordered_map<LibPkg::StorageID, std::shared_ptr<LibPkg::Package>> &relevantPkgs);
     void downloadPackagesFromMirror();
+    void startParsingPackages();
+    void queuePackage(PackageTask &&task);
+    void parsePackages(ParsingThread &parsingThread);
+    void parsePackage(const PackageTask &task, ParsingThread &parsingThread);
     void loadPackageInfoFromContents();
     void conclude();
 
@@ -464,6 +492,12 @@ private:
     std::vector<DatabaseToConsider> m_relevantPackagesByDatabase;
     std::atomic_size_t m_remainingPackages;
     WebClient::PackageCachingDataForSession m_cachingData;
+    std::unordered_map<const WebClient::PackageCachingDataForPackage *, PackageTask> m_packagesToDownload;
+    std::unique_ptr<LibPkg::BoundedQueue<PackageTask, LargerPackageFirst>> m_parsingQueue;
+    std::unique_ptr<LibPkg::BinaryInfoCache> m_binaryInfoCache;
+    std::vector<ParsingThread> m_parsingThreads;
+    std::chrono::steady_clock::time_point m_parsingStart, m_firstPackageQueued;
+    std::once_flag m_firstPackageQueuedFlag;
     std::uint64_t m_packageDownloadSizeLimit;
     std::string m_cacheDir;
     int m_additionalParsingThreads = -1;
@@ -110,17 +110,19 @@ void ReloadDatabase::run()
                         return;
                     }
 
-                    auto updater = LibPkg::PackageUpdater(*destinationDb, true);
-                    updater.insertFromDatabaseFile(dbPath);
+                    auto updater
+                        = LibPkg::PackageUpdater(*destinationDb, force ? LibPkg::PackageUpdaterMode::Clear : LibPkg::PackageUpdaterMode::Diff);
+                    updater.insertFromDatabaseFile(dbPath, m_setup.building.databaseParserCount());
                     dbFileLock.lock().unlock();
                     updater.commit();
                     destinationDb->lastUpdate = lastModified;
 
                     const auto newPackageCount = destinationDb->packageCount();
                     configLock.unlock();
+                    const auto &diff = updater.diff();
                     m_buildAction->appendOutput(Phrases::InfoMessage, "Inserted ", updater.packageCount(), " packages (handling ",
                         updater.handledIDs().size(), " IDs) into database \"", dbName, '@', dbArch, "\" which now contains ", newPackageCount,
-                        " packages\n");
+                        " packages (", diff.added, " added, ", diff.updated, " updated, ", diff.unchanged, " unchanged, ", diff.removed, " removed)\n");
                 } catch (const std::runtime_error &e) {
                     m_buildAction->appendOutput(Phrases::ErrorMessage, "An error occurred when reloading database \"", dbName, '@', dbArch,
                         "\" from local file \"", dbPath, "\": ", e.what(), '\n');
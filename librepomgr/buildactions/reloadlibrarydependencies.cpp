@@ -7,9 +7,15 @@
 #include "../../libpkg/data/package.h"
 #include "../../libpkg/parser/utils.h"
 
+#include <c++utilities/conversion/stringconversion.h>
 #include <c++utilities/io/ansiescapecodes.h>
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
 #include <regex>
+#include <sstream>
 #include <unordered_set>
 
 using namespace std;
@@ -191,7 +197,7 @@ bool ReloadLibraryDependencies::addRelevantPackage(LibPkg::StorageID packageID,
     std::string path, url, cachePath;
     std::error_code ec;
     const auto &fileName = packageInfo->fileName;
-    const auto &arch = package->arch;
+    const auto &arch = package->arch.str();
     if (!db->localPkgDir.empty() && std::filesystem::file_size(cachePath = db->localPkgDir % '/' + fileName, ec) && !ec) {
         path = std::move(cachePath);
     } else if (std::filesystem::file_size(cachePath = m_cacheDir + fileName, ec) && !ec) {
@@ -254,125 +260,219 @@ void LibRepoMgr::ReloadLibraryDependencies::downloadPackagesFromMirror()
 {
     // prepare caching data
     std::size_t packagesWhichNeedCaching = 0;
-    for (const auto &db : m_relevantPackagesByDatabase) {
-        for (const auto &pkg : db.packages) {
+    for (auto &db : m_relevantPackagesByDatabase) {
+        for (auto &pkg : db.packages) {
             if (!pkg.url.empty()) {
                 auto &cachingData = m_cachingData[db.name][pkg.info.name];
                 cachingData.url = pkg.url;
                 cachingData.destinationFilePath = pkg.path;
+                m_packagesToDownload.emplace(&cachingData, PackageTask{ .db = &db, .package = &pkg });
                 ++packagesWhichNeedCaching;
             }
         }
     }
 
-    // skip caching if not required
-    if (!packagesWhichNeedCaching) {
-        loadPackageInfoFromContents();
+    // allow aborting the build action
+    if (reportAbortedIfAborted()) {
         return;
     }
 
-    // allow aborting the build action
-    if (reportAbortedIfAborted()) {
+    // start parsing packages which are already present
+    startParsingPackages();
+
+    // skip caching if not required
+    if (!packagesWhichNeedCaching) {
+        loadPackageInfoFromContents();
         return;
     }
 
+    // download packages and hand each one over to the parsing threads as soon as it has been downloaded so downloading
+    // and parsing happen at the same time
     m_buildAction->appendOutput(Phrases::SuccessMessage, "Downloading ", packagesWhichNeedCaching, " binary packages from mirror ...\n");
     auto session = std::make_shared<WebClient::PackageCachingSession>(m_cachingData, m_setup.building.ioContext, m_setup.webServer.sslContext,
         std::bind(&ReloadLibraryDependencies::loadPackageInfoFromContents, this));
     session->aborted = &m_buildAction->aborted();
+    session->packageCached = [this](const WebClient::PackageCachingDataForPackage &cachingData) {
+        if (const auto task = m_packagesToDownload.find(&cachingData); task != m_packagesToDownload.end()) {
+            auto downloadedTask = task->second;
+            auto ec = std::error_code();
+            const auto size = std::filesystem::file_size(downloadedTask.package->path, ec);
+            downloadedTask.size = ec ? 0 : size;
+            queuePackage(std::move(downloadedTask));
+        }
+    };
     WebClient::cachePackages(
         m_buildAction->log(), std::move(session), m_packageDownloadSizeLimit ? std::make_optional(m_packageDownloadSizeLimit) : std::nullopt);
 }
 
-void ReloadLibraryDependencies::loadPackageInfoFromContents()
+/*!
+ * \brief Starts the threads for parsing package contents and queues the packages which do not need to be downloaded.
+ * \remarks
+ * - The queue hands out the largest package available first so a big package is not picked up last and keeps one thread
+ *   busy while all others are idling. Packages which need to be downloaded are queued as their download finishes; their
+ *   size is determined at that point.
+ * - The threads take packages from a shared queue so they never wait for each other. Hence there is no need for stealing
+ *   work between threads; picking the largest available package is what matters for the tail.
+ * - Each thread collects its messages and statistics separately; they are merged in loadPackageInfoFromContents().
+ */
+void ReloadLibraryDependencies::startParsingPackages()
 {
-    // allow aborting the build action
-    if (reportAbortedIfAborted()) {
-        return;
+    auto tasks = std::vector<PackageTask>();
+    tasks.reserve(m_remainingPackages.load());
+    for (auto &db : m_relevantPackagesByDatabase) {
+        for (auto &package : db.packages) {
+            if (!package.url.empty()) {
+                continue;
+            }
+            auto ec = std::error_code();
+            const auto size = std::filesystem::file_size(package.path, ec);
+            tasks.emplace_back(PackageTask{ .db = &db, .package = &package, .size = ec ? 0 : size });
+        }
     }
 
-    // load info from package contents utilizing hardware concurrency
-    std::mutex nextPackageMutex, submitErrorMutex, submitWarningMutex;
-    auto dbIterator = m_relevantPackagesByDatabase.begin(), dbEnd = m_relevantPackagesByDatabase.end();
-    auto pkgIterator = dbIterator->packages.begin(), pkgEnd = dbIterator->packages.end();
+    // use the binary info cache to avoid parsing binaries again which have not changed since the previous reload
+    // note: The generation only determines which entries are evicted first when exceeding the limit so it is fine to start a
+    //       new one when only reloading a subset of the databases.
+    if (auto &storage = m_setup.config.storage()) {
+        m_binaryInfoCache = std::make_unique<LibPkg::BinaryInfoCache>(*storage, m_setup.config.binaryInfoCacheLimit());
+        m_binaryInfoCache->startGeneration();
+    }
+    m_parsingQueue = std::make_unique<LibPkg::BoundedQueue<PackageTask, LargerPackageFirst>>(m_remainingPackages.load());
+    m_parsingStart = std::chrono::steady_clock::now();
+    for (auto &task : tasks) {
+        queuePackage(std::move(task));
+    }
     m_buildAction->appendOutput(Phrases::SuccessMessage, "Parsing ", m_remainingPackages.load(), " binary packages ...\n");
-    const auto processPackage = [this, &dbIterator, &dbEnd, &pkgIterator, &pkgEnd, &nextPackageMutex, &submitErrorMutex, &submitWarningMutex] {
-        for (; !m_buildAction->isAborted();) {
-            // get the next package
-            std::unique_lock<std::mutex> nextPackagelock(nextPackageMutex);
-            while (pkgIterator == pkgEnd) {
-                if (dbIterator == dbEnd || ++dbIterator == dbEnd) {
+    m_parsingThreads = std::vector<ParsingThread>(
+        1 + (m_additionalParsingThreads < 0 ? (std::thread::hardware_concurrency() - 1) : static_cast<std::size_t>(m_additionalParsingThreads)));
+    for (auto &parsingThread : m_parsingThreads) {
+        parsingThread.thread = std::thread(&ReloadLibraryDependencies::parsePackages, this, std::ref(parsingThread));
+    }
+}
+
+/*!
+ * \brief Hands the specified \a task over to the parsing threads.
+ * \remarks Records when the first package has been queued so the time waiting for the first download is not accounted as
+ *          idle time of the parsing threads.
+ */
+void ReloadLibraryDependencies::queuePackage(PackageTask &&task)
+{
+    std::call_once(m_firstPackageQueuedFlag, [this] { m_firstPackageQueued = std::chrono::steady_clock::now(); });
+    m_parsingQueue->push(std::move(task));
+}
+
+/*!
+ * \brief Parses the contents of packages from the queue until it has been closed and drained.
+ */
+void ReloadLibraryDependencies::parsePackages(ParsingThread &parsingThread)
+{
+    while (auto task = m_parsingQueue->pop()) {
+        if (m_buildAction->isAborted()) {
+            m_parsingQueue->abort();
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        parsePackage(*task, parsingThread);
+        ++parsingThread.packages;
+        parsingThread.busyTime += std::chrono::steady_clock::now() - start;
+    }
+}
+
+/*!
+ * \brief Parses the contents of the package from the specified \a task.
+ */
+void ReloadLibraryDependencies::parsePackage(const PackageTask &task, ParsingThread &parsingThread)
+{
+    const auto &currentDb = *task.db;
+    auto &currentPkg = *task.package;
+    auto *const cache = m_binaryInfoCache.get();
+
+    // log progress
+    m_buildAction->appendOutput(Phrases::InfoMessage, m_remainingPackages--, " packages remaining to parse, next package: ", currentPkg.path, '\n');
+
+    // check whether the package could be cached from the mirror and skip it with an error if not
+    if (!currentPkg.url.empty()) {
+        if (auto db = m_cachingData.find(currentDb.name); db != m_cachingData.end()) {
+            if (auto pkg = db->second.find(currentPkg.info.name); pkg != db->second.end()) {
+                auto &packageCachingInfo = pkg->second;
+                if (!packageCachingInfo.error.empty()) {
+                    parsingThread.errors.emplace_back(currentDb.name % '/' % currentPkg.info.name % ':' % ' ' + packageCachingInfo.error);
                     return;
                 }
-                pkgIterator = dbIterator->packages.begin();
-                pkgEnd = dbIterator->packages.end();
-            }
-            const auto &currentDb = *dbIterator;
-            auto &currentPkg = *pkgIterator;
-            // increment the current package
-            ++pkgIterator;
-            // allow other threads to get a package as well
-            nextPackagelock.unlock();
-
-            // log progress
-            m_buildAction->appendOutput(
-                Phrases::InfoMessage, m_remainingPackages--, " packages remaining to parse, next package: ", currentPkg.path, '\n');
-
-            // check whether the package could be cached from the mirror and skip it with an error if not
-            if (!currentPkg.url.empty()) {
-                if (auto db = m_cachingData.find(currentDb.name); db != m_cachingData.end()) {
-                    if (auto pkg = db->second.find(currentPkg.info.name); pkg != db->second.end()) {
-                        auto &packageCachingInfo = pkg->second;
-                        if (!packageCachingInfo.error.empty()) {
-                            std::unique_lock<std::mutex> submitErrorLock(submitErrorMutex);
-                            m_messages.errors.emplace_back(currentDb.name % '/' % currentPkg.info.name % ':' % ' ' + packageCachingInfo.error);
-                            continue;
-                        }
-                    }
-                }
             }
+        }
+    }
 
-            // extract the binary package's files
-            try {
-                auto dllsReferencedByImportLibs = std::set<std::string>();
-                CppUtilities::walkThroughArchive(
-                    currentPkg.path, &LibPkg::Package::isPkgInfoFileOrBinary,
-                    [&currentPkg, &dllsReferencedByImportLibs](std::string_view directoryPath, CppUtilities::ArchiveFile &&file) {
-                        if (directoryPath.empty() && file.name == ".PKGINFO") {
-                            currentPkg.info.addInfoFromPkgInfoFile(file.content);
-                            return false;
-                        }
-                        currentPkg.info.addDepsAndProvidesFromContainedFile(directoryPath, file, dllsReferencedByImportLibs);
-                        return false;
-                    },
-                    [&currentPkg](std::string_view directoryPath) {
-                        if (directoryPath.empty()) {
-                            return false;
-                        }
-                        currentPkg.info.addDepsAndProvidesFromContainedDirectory(directoryPath);
-                        return false;
-                    });
-                if (auto dllIssues = currentPkg.info.processDllsReferencedByImportLibs(std::move(dllsReferencedByImportLibs)); !dllIssues.empty()) {
-                    std::unique_lock<std::mutex> submitWarningLock(submitWarningMutex);
-                    for (auto &issue : dllIssues) {
-                        m_messages.warnings.emplace_back(std::move(issue));
-                    }
+    // extract the binary package's files
+    try {
+        auto dllsReferencedByImportLibs = std::set<std::string>();
+        LibPkg::walkThroughArchivePartially(
+            currentPkg.path, &LibPkg::Package::isPkgInfoFileOrBinary, &LibPkg::Package::requiredSizeOfPkgInfoFileOrBinary,
+            [&currentPkg, &dllsReferencedByImportLibs, cache](std::string_view directoryPath, CppUtilities::ArchiveFile &&file) {
+                if (directoryPath.empty() && file.name == ".PKGINFO") {
+                    currentPkg.info.addInfoFromPkgInfoFile(file.content);
+                    return false;
                 }
-                currentPkg.info.origin = LibPkg::PackageOrigin::PackageContents;
-            } catch (const std::runtime_error &e) {
-                std::unique_lock<std::mutex> submitErrorLock(submitErrorMutex);
-                m_messages.errors.emplace_back(currentDb.name % '/' % currentPkg.info.name % ':' % ' ' + e.what());
-            }
-        }
-    };
-    auto threads = std::vector<std::thread>(
-        m_additionalParsingThreads < 0 ? (std::thread::hardware_concurrency() - 1) : static_cast<std::size_t>(m_additionalParsingThreads));
-    for (std::thread &t : threads) {
-        t = std::thread(processPackage);
+                currentPkg.info.addDepsAndProvidesFromContainedFile(directoryPath, file, dllsReferencedByImportLibs, cache);
+                return false;
+            },
+            [&currentPkg](std::string_view directoryPath) {
+                if (directoryPath.empty()) {
+                    return false;
+                }
+                currentPkg.info.addDepsAndProvidesFromContainedDirectory(directoryPath);
+                return false;
+            });
+        auto dllIssues = currentPkg.info.processDllsReferencedByImportLibs(std::move(dllsReferencedByImportLibs));
+        std::move(dllIssues.begin(), dllIssues.end(), std::back_inserter(parsingThread.warnings));
+        currentPkg.info.origin = LibPkg::PackageOrigin::PackageContents;
+    } catch (const std::runtime_error &e) {
+        parsingThread.errors.emplace_back(currentDb.name % '/' % currentPkg.info.name % ':' % ' ' + e.what());
+    }
+}
+
+/*!
+ * \brief Waits until all packages have been parsed and adds the parsed information to the databases.
+ * \remarks Invoked once all downloads have finished (or immediately if there was nothing to download).
+ */
+void ReloadLibraryDependencies::loadPackageInfoFromContents()
+{
+    // wait until the remaining packages have been parsed
+    m_parsingQueue->close();
+    for (auto &parsingThread : m_parsingThreads) {
+        parsingThread.thread.join();
     }
-    processPackage();
-    for (std::thread &t : threads) {
-        t.join();
+    const auto parsingEnd = std::chrono::steady_clock::now();
+    std::call_once(m_firstPackageQueuedFlag, [this, parsingEnd] { m_firstPackageQueued = parsingEnd; }); // no package has been queued
+    const auto firstDownloadTime = m_firstPackageQueued - m_parsingStart;
+    const auto parsingTime = parsingEnd - m_firstPackageQueued;
+    if (m_binaryInfoCache) {
+        m_binaryInfoCache->flush();
+        const auto stats = m_binaryInfoCache->statistics();
+        const auto removed = m_binaryInfoCache->removeStaleEntries();
+        m_buildAction->appendOutput(Phrases::InfoMessage, "Parsed ", stats.misses, " binaries, took info of ", stats.hits,
+            " binaries from cache, removed ", removed, " stale or least recently used cache entries (limit: ",
+            dataSizeToString(m_binaryInfoCache->limit()), ")\n");
+    }
+
+    // merge messages of all threads and report how well the threads have been utilized
+    auto utilization = std::stringstream();
+    utilization << "Loading package contents took " << std::chrono::duration<double>(parsingEnd - m_parsingStart).count() << " s (waited "
+                << std::chrono::duration<double>(firstDownloadTime).count()
+                << " s for the first download), packages (utilization since the first package was available) per thread:";
+    for (auto &parsingThread : m_parsingThreads) {
+        std::move(parsingThread.errors.begin(), parsingThread.errors.end(), std::back_inserter(m_messages.errors));
+        std::move(parsingThread.warnings.begin(), parsingThread.warnings.end(), std::back_inserter(m_messages.warnings));
+        utilization << ' ' << parsingThread.packages << " ("
+                    << (parsingTime.count() ? static_cast<int>(100 * parsingThread.busyTime.count() / parsingTime.count()) : 100) << " %)";
+    }
+    utilization << '\n';
+    m_buildAction->appendOutput(Phrases::InfoMessage, utilization.str());
+    m_parsingThreads.clear();
+
+    // allow aborting the build action
+    if (reportAbortedIfAborted()) {
+        return;
     }
 
     // store the information in the database
@@ -43,7 +43,13 @@ ResourceUsage::ResourceUsage(ServiceSetup &setup)
     auto ec = std::error_code();
     packageDbSize = std::filesystem::file_size(setup.dbPath, ec);
     actionsDbSize = std::filesystem::file_size(setup.building.dbPath, ec);
-    cachedPackages = setup.config.cachedPackages();
+    const auto packageCacheStats = setup.config.packageCacheStatistics();
+    cachedPackages = packageCacheStats.entries;
+    packageCacheSize = packageCacheStats.size;
+    packageCacheLimit = packageCacheStats.limit;
+    packageCacheHits = packageCacheStats.hits;
+    packageCacheMisses = packageCacheStats.misses;
+    packageCacheEvictions = packageCacheStats.evictions;
     actionsCount = setup.building.buildActionCount();
     runningActionsCount = setup.building.runningBuildActionCount();
 }
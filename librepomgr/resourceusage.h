@@ -24,6 +24,11 @@ struct LIBREPOMGR_EXPORT ResourceUsage : public MemoryUsage, public ReflectiveRa
     std::size_t packageDbSize = 0;
     std::size_t actionsDbSize = 0;
     std::size_t cachedPackages = 0;
+    std::size_t packageCacheSize = 0;
+    std::size_t packageCacheLimit = 0;
+    std::size_t packageCacheHits = 0;
+    std::size_t packageCacheMisses = 0;
+    std::size_t packageCacheEvictions = 0;
     std::size_t actionsCount = 0;
     std::size_t runningActionsCount = 0;
 };
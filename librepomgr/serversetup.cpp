@@ -41,12 +41,14 @@
 
 #include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <regex>
 #include <string_view>
+#include <thread>
 #include <unordered_set>
 
 using namespace std;
@@ -286,6 +288,18 @@ ServiceSetup::BuildSetup::Worker ServiceSetup::BuildSetup::allocateBuildWorker()
     return Worker(*this);
 }
 
+/*!
+ * \brief Returns the number of parser threads to use when loading a database file on one of the build worker threads.
+ * \remarks Up to threadCount databases might be loaded at the same time so the CPU cores are split between them (like
+ *          LibPkg::Config::loadAllPackages() does) instead of letting each load use all of them.
+ */
+std::size_t ServiceSetup::BuildSetup::databaseParserCount() const
+{
+    const auto cpuCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 2);
+    const auto concurrentLoads = std::max<std::size_t>(threadCount, 1);
+    return std::max<std::size_t>(cpuCount / concurrentLoads, 2) - 1;
+}
+
 LibPkg::StorageID ServiceSetup::BuildSetup::allocateBuildActionID()
 {
     static const auto emptyBuildAction = BuildAction();
@@ -513,6 +527,7 @@ void ServiceSetup::loadConfigFiles(bool doFirstTimeSetup)
     // read config files
     auto configIni = IniFile();
     auto databaseCount = std::uint32_t();
+    constexpr auto approximatePackageCacheEntrySize = std::size_t(64 * 1024); // to convert the deprecated limit in packages
     for (const auto &configFilePath : configFilePaths) {
         std::cout << Phrases::InfoMessage << "Reading config file: " << configFilePath << Phrases::EndFlush;
         try {
@@ -529,7 +544,18 @@ void ServiceSetup::loadConfigFiles(bool doFirstTimeSetup)
                     convertValue(iniEntry.second, "default_arch", defaultArch);
                     convertValue(iniEntry.second, "db_path", dbPath);
                     convertValue(iniEntry.second, "max_dbs", maxDbs);
-                    convertValue(iniEntry.second, "package_cache_limit", packageCacheLimit);
+                    if (getLastValue(iniEntry.second, "package_cache_limit_bytes")) {
+                        convertValue(iniEntry.second, "package_cache_limit_bytes", packageCacheLimit);
+                    } else if (getLastValue(iniEntry.second, "package_cache_limit")) {
+                        // convert the deprecated limit which used to be a number of packages
+                        auto packageCacheEntryLimit = packageCacheLimit / approximatePackageCacheEntrySize;
+                        convertValue(iniEntry.second, "package_cache_limit", packageCacheEntryLimit);
+                        packageCacheLimit = packageCacheEntryLimit * approximatePackageCacheEntrySize;
+                        std::cerr << Phrases::WarningMessage << "The key \"package_cache_limit\" is deprecated, converted it to \""
+                                  << dataSizeToString(packageCacheLimit) << "\" (assuming " << dataSizeToString(approximatePackageCacheEntrySize)
+                                  << " per package); set \"package_cache_limit_bytes\" instead." << Phrases::EndFlush;
+                    }
+                    convertValue(iniEntry.second, "binary_info_cache_limit_bytes", binaryInfoCacheLimit);
                 }
             }
             // apply working directory
@@ -582,6 +608,7 @@ void ServiceSetup::loadConfigFiles(bool doFirstTimeSetup)
     }
 
     // restore state/cache and discard databases
+    config.setBinaryInfoCacheLimit(binaryInfoCacheLimit);
     if (doFirstTimeSetup) {
         config.databases.reserve(databaseCount);
         initStorage();
@@ -769,8 +796,9 @@ void ServiceSetup::restoreState()
         // open LMDB storage
         cout << Phrases::InfoMessage << "Opening config LMDB file: " << dbPath << Phrases::End;
         config.initStorage(dbPath.data(), maxDbs);
-        cout << Phrases::SubMessage << "Package cache limit: " << packageCacheLimit << Phrases::End;
+        cout << Phrases::SubMessage << "Package cache limit: " << dataSizeToString(packageCacheLimit) << Phrases::End;
         config.setPackageCacheLimit(packageCacheLimit);
+        cout << Phrases::SubMessage << "Binary info cache limit: " << dataSizeToString(config.binaryInfoCacheLimit()) << Phrases::End;
         cout << Phrases::InfoMessage << "Opening actions LMDB file: " << building.dbPath << Phrases::EndFlush;
         building.initStorage(building.dbPath.data());
 
@@ -836,7 +864,15 @@ int ServiceSetup::run()
             return EXIT_FAILURE + 1;
         }
         config.discardDatabases();
+        const auto loadingStart = std::chrono::steady_clock::now();
         config.loadAllPackages(building.loadFilesDbs, building.forceLoadingDbs);
+        const auto loadingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadingStart).count();
+        auto packageCount = std::size_t();
+        for (const auto &db : config.databases) {
+            packageCount += db.packageCount();
+        }
+        cerr << Phrases::InfoMessage << "Loaded " << config.databases.size() << " databases (" << packageCount << " packages) within "
+             << loadingSeconds << " s" << Phrases::End;
 #ifndef CPP_UTILITIES_DEBUG_BUILD
     } catch (const std::exception &e) {
         cerr << Phrases::SubError << e.what() << endl;
@@ -914,7 +950,10 @@ int ServiceSetup::run()
     return EXIT_SUCCESS;
 }
 
-int ServiceSetup::fixDb()
+/*!
+ * \brief Rebuilds the databases and indexes and optionally enables/disables compression of cold package data if \a compressPackages is set.
+ */
+int ServiceSetup::fixDb(std::optional<bool> compressPackages)
 {
 #ifndef CPP_UTILITIES_DEBUG_BUILD
     try {
@@ -923,6 +962,9 @@ int ServiceSetup::fixDb()
         building.initStorage(building.dbPath.data());
         building.rebuildDb();
         config.rebuildDb();
+        if (compressPackages.has_value()) {
+            config.setPackageCompression(compressPackages.value());
+        }
 #ifndef CPP_UTILITIES_DEBUG_BUILD
     } catch (const std::exception &e) {
         cerr << Phrases::ErrorMessage << "Exception occurred: " << Phrases::End << "    " << e.what() << Phrases::EndFlush;
@@ -18,6 +18,7 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <regex>
 #include <thread>
 #include <vector>
@@ -65,7 +66,8 @@ struct LIBREPOMGR_EXPORT ServiceSetup : public LibPkg::Lockable {
     std::string defaultArch = "x86_64";
     std::string dbPath = "libpkg-1.db";
     std::uint32_t maxDbs = 0;
-    std::size_t packageCacheLimit = 1000;
+    std::size_t packageCacheLimit = 64 * 1024 * 1024; // in bytes
+    std::size_t binaryInfoCacheLimit = 64 * 1024 * 1024; // in bytes
 
     void loadConfigFiles(bool doFirstTimeSetup);
     void printLimits();
@@ -76,7 +78,7 @@ struct LIBREPOMGR_EXPORT ServiceSetup : public LibPkg::Lockable {
     std::size_t saveState();
     void initStorage();
     int run();
-    int fixDb();
+    int fixDb(std::optional<bool> compressPackages = std::nullopt);
     int dumpDb(std::string_view filterRegex);
     ServiceStatus computeStatus();
 
@@ -173,6 +175,7 @@ struct LIBREPOMGR_EXPORT ServiceSetup : public LibPkg::Lockable {
         void readComplementaryVariants(const std::multimap<std::string, std::string> &multimap);
         void readPresets(const std::string &configFilePath, const std::string &presetsFile);
         Worker allocateBuildWorker();
+        std::size_t databaseParserCount() const;
         LibPkg::StorageID allocateBuildActionID();
         std::shared_ptr<BuildAction> getBuildAction(BuildActionIdType id);
         std::vector<std::shared_ptr<BuildAction>> getBuildActions(const std::vector<BuildActionIdType> &ids);
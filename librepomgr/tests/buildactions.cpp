@@ -7,6 +7,7 @@
 #include "../buildactions/buildaction.h"
 #include "../buildactions/buildactionprivate.h"
 #include "../buildactions/subprocess.h"
+#include "../webapi/server.h"
 
 #include <passwordfile/io/passwordfile.h>
 
@@ -26,6 +27,8 @@ using CppUtilities::operator<<; // must be visible prior to the call site
 #include <boost/process/v1/search_path.hpp>
 
 #include <chrono>
+#include <random>
+#include <thread>
 
 using namespace std;
 using namespace std::literals;
@@ -44,6 +47,7 @@ class BuildActionsTests : public TestFixture {
     CPPUNIT_TEST(testProcessSession);
     CPPUNIT_TEST(testBuildActionProcess);
     CPPUNIT_TEST(testParsingInfoFromPkgFiles);
+    CPPUNIT_TEST(testParsingInfoFromDownloadedPkgFiles);
     CPPUNIT_TEST(testPreparingBuild);
     CPPUNIT_TEST(testConductingBuild);
     CPPUNIT_TEST(testRepoCleanup);
@@ -59,6 +63,7 @@ public:
     void testProcessSession();
     void testBuildActionProcess();
     void testParsingInfoFromPkgFiles();
+    void testParsingInfoFromDownloadedPkgFiles();
     void testPreparingBuild();
     void testConductingBuild();
     void testRepoCleanup();
@@ -361,6 +366,82 @@ void BuildActionsTests::testParsingInfoFromPkgFiles()
     });
 }
 
+/*!
+ * \brief Tests the ReloadLibraryDependencies build action with packages which need to be downloaded from a mirror.
+ * \remarks The mirror is served by the web server from the test files. Packages present locally are supposed to be parsed
+ *          while the downloads are still pending and each downloaded package is supposed to be parsed as soon as its
+ *          download has finished, also if it failed.
+ */
+void BuildActionsTests::testParsingInfoFromDownloadedPkgFiles()
+{
+    // init config
+    initStorage();
+    auto &config = m_setup.config;
+    for (const auto dbName : { "foo.db"sv, "bar.db"sv }) {
+        config.findOrCreateDatabase(dbName, "x86_64"sv);
+    }
+    auto &fooDb = config.databases[0];
+    auto &barDb = config.databases[1];
+
+    // serve the packages of "foo.db" (and a missing one) via the web server
+    auto random = std::random_device();
+    m_setup.webServer.port = std::uniform_int_distribution<unsigned short>(5000, 25000)(random);
+    m_setup.webServer.staticFilesPath = directory(testFilePath("repo/foo/mingw-w64-harfbuzz-1.4.2-1-any.pkg.tar.xz"));
+    fooDb.mirrors = { argsToString("http://", m_setup.webServer.address.to_string(), ':', m_setup.webServer.port) };
+    const auto harfbuzz = LibPkg::Package::fromPkgFileName("mingw-w64-harfbuzz-1.4.2-1-any.pkg.tar.xz");
+    fooDb.updatePackage(harfbuzz);
+    const auto syncthingtray = LibPkg::Package::fromPkgFileName("syncthingtray-0.6.2-1-x86_64.pkg.tar.xz");
+    fooDb.updatePackage(syncthingtray);
+    fooDb.updatePackage(LibPkg::Package::fromPkgFileName("missing-1-1-x86_64.pkg.tar.xz"));
+    m_setup.building.packageCacheDir = TestApplication::instance()->workingDirectory() + "/test-download-cache";
+    std::filesystem::remove_all(m_setup.building.packageCacheDir);
+    std::filesystem::create_directories(m_setup.building.packageCacheDir);
+
+    // use a local package for "bar.db"
+    const auto cmake = LibPkg::Package::fromPkgFileName("cmake-3.8.2-1-x86_64.pkg.tar.xz");
+    barDb.updatePackage(cmake);
+    barDb.localPkgDir = directory(testFilePath("repo/bar/cmake-3.8.2-1-x86_64.pkg.tar.xz"));
+
+    auto server = std::make_shared<WebAPI::Server>(m_setup);
+    server->run();
+    auto serverThread = std::thread([this] { m_setup.webServer.ioContext.run(); });
+    auto buildAction = std::make_shared<BuildAction>(0, &m_setup);
+    auto reloadLibDependencies = ReloadLibraryDependencies(m_setup, buildAction);
+    reloadLibDependencies.run();
+
+    // check whether the local package is parsed while the downloads are still pending
+    // note: Downloads can not finish before running the IO context so only the local package can be parsed at this point.
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (reloadLibDependencies.m_remainingPackages.load() > 3 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("local package parsed while downloads are pending", 3_st, reloadLibDependencies.m_remainingPackages.load());
+
+    // download the other packages
+    auto &ioc = m_setup.building.ioContext;
+    ioc.restart();
+    ioc.run();
+    m_setup.webServer.ioContext.stop();
+    serverThread.join();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("all packages parsed", 0_st, reloadLibDependencies.m_remainingPackages.load());
+
+    // check whether the failed download has been reported
+    const auto &messages = std::get<BuildActionMessages>(buildAction->resultData);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("one error", 1_st, messages.errors.size());
+    TESTUTILS_ASSERT_LIKE_FLAGS("failed download reported", "foo\\.db/missing: Error downloading .*missing-1-1-x86_64\\.pkg\\.tar\\.xz.*404.*"s,
+        std::regex::extended, messages.errors.front());
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>(), messages.warnings);
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>(), messages.notes);
+
+    // check whether the downloaded packages have been parsed
+    using namespace TestHelper;
+    checkHarfbuzzPackagePeDependencies(*harfbuzz);
+    checkSyncthingTrayPackageSoDependencies(*syncthingtray);
+    checkCmakePackageSoDependencies(*cmake);
+    CPPUNIT_ASSERT_MESSAGE(
+        "package downloaded", std::filesystem::exists(m_setup.building.packageCacheDir + "/syncthingtray-0.6.2-1-x86_64.pkg.tar.xz"));
+}
+
 /*!
  * \brief Tests the PrepareBuild build action.
  */
@@ -10,6 +10,7 @@
 #include "../../libpkg/data/config.h"
 #include "../../libpkg/data/package.h"
 #include "../../libpkg/parser/aur.h"
+#include "../../libpkg/parser/utils.h"
 
 #include "resources/config.h"
 
@@ -21,6 +22,7 @@
 #include <iostream>
 #include <numeric>
 #include <regex>
+#include <set>
 
 using namespace std;
 using namespace CppUtilities;
@@ -125,7 +127,7 @@ void getUnresolved(const Params &params, ResponseHandler &&handler)
         DependencySet removedProvides;
         for (const auto &dependencyString : params.target.decodeValues("remove")) {
             auto dependency(Dependency::fromString(dependencyString.data(), dependencyString.size()));
-            removedProvides.add(std::move(dependency.name), DependencyDetail(std::move(dependency.version), dependency.mode));
+            removedProvides.add(std::string(dependency.name), DependencyDetail(std::move(dependency.version), dependency.mode));
         }
         return removedProvides;
     }();
@@ -164,6 +166,7 @@ void getPackages(const Params &params, ResponseHandler &&handler)
         Depends,
         LibProvides,
         LibDepends,
+        Files,
     } mode = Mode::Name;
     static const std::unordered_map<std::string_view, Mode> modeByParamValue{
         { "name", Mode::Name },
@@ -173,11 +176,13 @@ void getPackages(const Params &params, ResponseHandler &&handler)
         { "depends", Mode::Depends },
         { "libprovides", Mode::LibProvides },
         { "libdepends", Mode::LibDepends },
+        { "files", Mode::Files },
     };
     if (!modes.empty()) {
         const auto modeIterator = modeByParamValue.find(modes.front());
         if (modeIterator == modeByParamValue.end()) {
-            throw BadRequest("mode must be \"name\", \"name-contains\", \"regex\", \"provides\", \"depends\", \"libprovides\" or \"libdepends\"");
+            throw BadRequest(
+                "mode must be \"name\", \"name-contains\", \"regex\", \"provides\", \"depends\", \"libprovides\", \"libdepends\" or \"files\"");
         }
         mode = modeIterator->second;
     }
@@ -231,15 +236,18 @@ void getPackages(const Params &params, ResponseHandler &&handler)
             ReflectiveRapidJSON::JsonReflector::push(LibPkg::PackageBaseSearchResult(db, *pkg, id), array, document.GetAllocator());
             return array.Size() >= limit;
         });
-    const auto pushBasePackage = [&array, &document, &limit](Database &db, LibPkg::StorageID id, const PackageBase &pkg) {
+    const auto pushPackageView = [&array, &document, &limit](Database &db, LibPkg::StorageID id, const PackageView &pkg) {
         ReflectiveRapidJSON::JsonReflector::push(LibPkg::PackageBaseSearchResult(db, pkg, id), array, document.GetAllocator());
         return array.Size() >= limit;
     };
-    const auto pushPackageDetails = !details ? LibPkg::Config::PackageVisitorConst()
-                                             : [&array, &document, &limit](Database &, LibPkg::StorageID, const std::shared_ptr<Package> &pkg) {
-                                                   ReflectiveRapidJSON::JsonReflector::push(pkg, array, document.GetAllocator());
-                                                   return array.Size() >= limit;
-                                               };
+    const auto pushPackageDetails = !details
+        ? LibPkg::Config::PackageVisitorConst()
+        : [&array, &document, &limit](Database &db, LibPkg::StorageID id, const std::shared_ptr<Package> &pkg) {
+              // load the cold data (files, install info) as well as it is not present in cached packages
+              const auto packageWithColdData = db.findPackageWithColdData(id);
+              ReflectiveRapidJSON::JsonReflector::push(packageWithColdData ? packageWithColdData : pkg, array, document.GetAllocator());
+              return array.Size() >= limit;
+          };
 
     auto aurPackages = std::vector<PackageSearchResult>();
     auto neededAurPackages = std::vector<std::string>();
@@ -274,19 +282,18 @@ void getPackages(const Params &params, ResponseHandler &&handler)
             break;
         }
         case Mode::NameContains: {
-            auto basePackage = PackageBase();
-            params.setup.config.packagesByName(
-                visitDb, [&](LibPkg::Database &db, std::string_view packageName, const std::function<StorageID(PackageBase &)> &getPackage) {
+            auto packageView = PackageView();
+            const std::string_view substrings[] = { name };
+            params.setup.config.packagesByNameContaining(substrings, visitDb,
+                [&](LibPkg::Database &db, std::string_view packageName, const std::function<StorageID(PackageView &)> &getPackage) {
                     if (packageName.find(name) != std::string_view::npos) {
-                        const auto packageID = getPackage(basePackage);
+                        const auto packageID = getPackage(packageView);
                         if (!packageID) {
                             cerr << Phrases::ErrorMessage << "Broken index in db \"" << db.name << "\": package \"" << packageName
                                  << "\" does not exist" << std::endl;
                             return false;
                         }
-                        const auto stopSearch = pushBasePackage(db, packageID, basePackage);
-                        basePackage.clear();
-                        return stopSearch;
+                        return pushPackageView(db, packageID, packageView);
                     }
                     return false;
                 });
@@ -298,19 +305,18 @@ void getPackages(const Params &params, ResponseHandler &&handler)
         case Mode::Regex: {
             try {
                 const auto regex = std::regex(name.data(), name.size());
-                auto basePackage = PackageBase();
-                params.setup.config.packagesByName(
-                    visitDb, [&](LibPkg::Database &db, std::string_view packageName, const std::function<StorageID(PackageBase &)> &getPackage) {
+                const auto substrings = LibPkg::requiredSubstringsOfRegex(name);
+                auto packageView = PackageView();
+                params.setup.config.packagesByNameContaining(substrings, visitDb,
+                    [&](LibPkg::Database &db, std::string_view packageName, const std::function<StorageID(PackageView &)> &getPackage) {
                         if (std::regex_match(packageName.begin(), packageName.end(), regex)) {
-                            const auto packageID = getPackage(basePackage);
+                            const auto packageID = getPackage(packageView);
                             if (!packageID) {
                                 cerr << Phrases::ErrorMessage << "Broken index in db \"" << db.name << "\": package \"" << packageName
                                      << "\" does not exist" << std::endl;
                                 return false;
                             }
-                            const auto stopSearch = pushBasePackage(db, packageID, basePackage);
-                            basePackage.clear();
-                            return stopSearch;
+                            return pushPackageView(db, packageID, packageView);
                         }
                         return false;
                     });
@@ -327,6 +333,30 @@ void getPackages(const Params &params, ResponseHandler &&handler)
         case Mode::LibDepends:
             params.setup.config.providingPackagesBase(name, mode == Mode::LibDepends, visitDb, pushSharedBasePackage);
             break;
+        case Mode::Files: {
+            // search for the path of a file; names without slash are file names, a trailing "*" searches for a path prefix
+            auto path = std::string_view(name);
+            auto fileSearchMode = path.find('/') == std::string_view::npos ? LibPkg::FileSearchMode::Name : LibPkg::FileSearchMode::Path;
+            if (path.ends_with('*')) {
+                path.remove_suffix(1);
+                fileSearchMode = LibPkg::FileSearchMode::PathPrefix;
+            }
+            auto visited = std::set<std::pair<const Database *, LibPkg::StorageID>>();
+            auto packageView = PackageView();
+            params.setup.config.packagesContainingFile(path, fileSearchMode, visitDb,
+                [&](Database &db, LibPkg::StorageID packageID, std::string_view, const std::function<bool(PackageView &)> &getPackage) {
+                    if (!visited.emplace(&db, packageID).second) {
+                        return false;
+                    }
+                    if (!getPackage(packageView)) {
+                        cerr << Phrases::ErrorMessage << "Broken index in db \"" << db.name << "\": package with ID " << packageID
+                             << " contains \"" << path << "\" but does not exist" << std::endl;
+                        return false;
+                    }
+                    return pushPackageView(db, packageID, packageView);
+                });
+            break;
+        }
         default:;
         }
     }
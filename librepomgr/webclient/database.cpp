@@ -164,14 +164,16 @@ void queryDatabases(LogContext &log, ServiceSetup &setup, std::vector<DatabaseQu
                     log(Phrases::ErrorMessage, "Retrieved database file for \"", dbName, '@', dbArch, "\" but it no longer exists; discarding\n");
                     return;
                 }
-                auto updater = LibPkg::PackageUpdater(*db, true);
-                updater.insertFromDatabaseFile(session2.destinationFilePath);
+                auto updater = LibPkg::PackageUpdater(*db, force ? LibPkg::PackageUpdaterMode::Clear : LibPkg::PackageUpdaterMode::Diff);
+                updater.insertFromDatabaseFile(session2.destinationFilePath, setup.building.databaseParserCount());
                 updater.commit();
                 db->lastUpdate = lastModified;
                 const auto newPackageCount = db->packageCount();
                 lock.unlock();
+                const auto &diff = updater.diff();
                 log(Phrases::InfoMessage, "Inserted ", updater.packageCount(), " packages (handling ", updater.handledIDs().size(),
-                    " IDs) into database \"", dbName, '@', dbArch, "\" which now contains ", newPackageCount, " packages\n");
+                    " IDs) into database \"", dbName, '@', dbArch, "\" which now contains ", newPackageCount, " packages (", diff.added, " added, ",
+                    diff.updated, " updated, ", diff.unchanged, " unchanged, ", diff.removed, " removed)\n");
             } catch (const std::runtime_error &e) {
                 log(Phrases::ErrorMessage, "Unable to parse retrieved database file for \"", dbName, '@', dbArch, "\": ", e.what(), '\n');
                 dbQuerySession->addResponse(std::move(dbName));
@@ -260,6 +262,9 @@ void cachePackages(LogContext &log, std::shared_ptr<PackageCachingSession> &&pac
                     cachingData->error = tupleToString(msg);
                     log(Phrases::ErrorMessage, msg, '\n');
                 }
+                if (packageCachingSession->packageCached) {
+                    packageCachingSession->packageCached(*cachingData);
+                }
                 cachePackages(log, std::move(packageCachingSession), bodyLimit, 1);
             },
             std::string(cachingData->destinationFilePath), std::string_view(), std::string_view(), boost::beast::http::verb::get, bodyLimit);
@@ -56,6 +56,7 @@ struct PackageCachingSession : public MultiSession<void> {
         PackageCachingDataForSession &data, boost::asio::io_context &ioContext, boost::asio::ssl::context &sslContext, HandlerType &&handler);
 
     const std::atomic_bool *aborted = nullptr;
+    std::function<void(const PackageCachingDataForPackage &)> packageCached; // invoked after each download, also if it failed
 
 private:
     void selectNextPackage();
@@ -34,9 +34,15 @@ int main(int argc, const char *argv[])
     regexArg.setCombinable(true);
     Argument negateArg("negate", 'n', "lists only packages which do NOT contain --file-name");
     negateArg.setCombinable(true);
+    Argument exactArg("exact", 'e', "looks up the exact path specified via --file-name using the file index");
+    exactArg.setCombinable(true);
+    Argument prefixArg("prefix", 'p', "looks up paths starting with --file-name using the file index");
+    prefixArg.setCombinable(true);
+    Argument basenameArg("basename", 'b', "looks up files with the name specified via --file-name (regardless of the directory) using the file index");
+    basenameArg.setCombinable(true);
     OperationArgument searchArg("search", '\0', "searches for packages containing the specified file");
     searchArg.setImplicit(true);
-    searchArg.setSubArguments({ &fileNameArg, &regexArg, &negateArg, &dbFileArg, &loadPacmanConfigArg });
+    searchArg.setSubArguments({ &fileNameArg, &regexArg, &negateArg, &exactArg, &prefixArg, &basenameArg, &dbFileArg, &loadPacmanConfigArg });
     HelpArgument helpArg(parser);
     OperationArgument listArg("list", '\0', "lists the files contained within the specified package");
     ConfigValueArgument packageArg("package", '\0', "the name of the package", { "name" });
@@ -46,6 +52,12 @@ int main(int argc, const char *argv[])
     parser.setMainArguments({ &searchArg, &listArg, &helpArg });
     parser.setDefaultArgument(&helpArg);
     parser.parseArgs(argc, argv);
+    const auto indexedSearchArgCount = exactArg.isPresent() + prefixArg.isPresent() + basenameArg.isPresent();
+    if (indexedSearchArgCount > 1 || (indexedSearchArgCount && (regexArg.isPresent() || negateArg.isPresent()))) {
+        std::cerr << "Only one of --exact, --prefix and --basename can be specified and they can not be combined with --regex or --negate."
+                  << std::endl;
+        std::exit(5);
+    }
 
     // init config from pacman config to get relevant dbs
     auto cfg = LibPkg::Config();
@@ -102,15 +114,17 @@ int main(int argc, const char *argv[])
     if (listArg.isPresent()) {
         const auto pkgs = cfg.findPackages(packageArg.firstValue());
         for (const auto &pkg : pkgs) {
-            if (const auto *const db = std::get<LibPkg::Database *>(pkg.db); !db->name.empty()) {
+            auto *const db = std::get<LibPkg::Database *>(pkg.db);
+            if (!db->name.empty()) {
                 std::cout << db->name << '/';
             }
             std::cout << pkg.pkg->name;
-            if (!pkg.pkg->packageInfo) {
+            const auto package = db->findPackageWithColdData(pkg.id);
+            if (!package || !package->packageInfo) {
                 std::cout << '\n';
                 continue;
             }
-            for (const auto &path : pkg.pkg->packageInfo->files) {
+            for (const auto &path : package->packageInfo->files) {
                 std::cout << "\n - " << path;
             }
             std::cout << '\n';
@@ -120,6 +134,42 @@ int main(int argc, const char *argv[])
 
     // search databases for relevant packages
     const char *const searchTerm = fileNameArg.firstValue();
+    if (indexedSearchArgCount) {
+        // look up packages via the file index instead of scanning all packages
+        const auto mode = exactArg.isPresent() ? LibPkg::FileSearchMode::Path
+            : prefixArg.isPresent()            ? LibPkg::FileSearchMode::PathPrefix
+                                               : LibPkg::FileSearchMode::Name;
+        auto *lastDb = static_cast<LibPkg::Database *>(nullptr);
+        auto lastPackageID = LibPkg::StorageID();
+        cfg.packagesContainingFile(searchTerm, mode, LibPkg::Config::DatabaseVisitor(),
+            [&](LibPkg::Database &db, LibPkg::StorageID packageID, std::string_view path) {
+                // note: The files are only needed when searching by name to print the full paths.
+                const auto package = mode == LibPkg::FileSearchMode::Name ? db.findPackageWithColdData(packageID) : db.findPackage(packageID);
+                if (!package) {
+                    return false;
+                }
+                if (&db != lastDb || packageID != lastPackageID) {
+                    if (!db.name.empty()) {
+                        std::cout << db.name << '/';
+                    }
+                    std::cout << package->name << '\n';
+                    lastDb = &db;
+                    lastPackageID = packageID;
+                }
+                if (mode != LibPkg::FileSearchMode::Name) {
+                    std::cout << " - " << path << '\n';
+                } else if (package->packageInfo) {
+                    // the index only knows the file name so print all paths with that name
+                    for (const auto &file : package->packageInfo->files) {
+                        if (std::string_view(file).substr(file.rfind('/') + 1) == path) {
+                            std::cout << " - " << file << '\n';
+                        }
+                    }
+                }
+                return false;
+            });
+        return 0;
+    }
     const auto negate = negateArg.isPresent();
     auto regex = std::optional<std::regex>();
     if (regexArg.isPresent()) {
@@ -131,42 +181,44 @@ int main(int argc, const char *argv[])
         }
     }
     for (auto &db : cfg.databases) {
-        db.allPackages([&](LibPkg::StorageID, std::shared_ptr<LibPkg::Package> &&package) {
-            const auto &pkgInfo = package->packageInfo;
-            if (!pkgInfo) {
-                return false;
-            }
-            auto foundOne = false;
-            for (const auto &file : pkgInfo->files) {
-                const auto found = regex.has_value() ? std::regex_match(file, regex.value()) : file.find(searchTerm) != std::string::npos;
-                if (negate) {
-                    if (found) {
-                        foundOne = true;
-                        break;
-                    } else {
+        db.allPackages(
+            [&](LibPkg::StorageID, std::shared_ptr<LibPkg::Package> &&package) {
+                const auto &pkgInfo = package->packageInfo;
+                if (!pkgInfo) {
+                    return false;
+                }
+                auto foundOne = false;
+                for (const auto &file : pkgInfo->files) {
+                    const auto found = regex.has_value() ? std::regex_match(file, regex.value()) : file.find(searchTerm) != std::string::npos;
+                    if (negate) {
+                        if (found) {
+                            foundOne = true;
+                            break;
+                        } else {
+                            continue;
+                        }
+                    }
+                    if (!found) {
                         continue;
                     }
+                    if (!foundOne) {
+                        if (!db.name.empty()) {
+                            std::cout << db.name << '/';
+                        }
+                        std::cout << package->name << '\n';
+                        foundOne = true;
+                    }
+                    std::cout << " - " << file << '\n';
                 }
-                if (!found) {
-                    continue;
-                }
-                if (!foundOne) {
+                if (negate && !foundOne) {
                     if (!db.name.empty()) {
                         std::cout << db.name << '/';
                     }
                     std::cout << package->name << '\n';
-                    foundOne = true;
-                }
-                std::cout << " - " << file << '\n';
-            }
-            if (negate && !foundOne) {
-                if (!db.name.empty()) {
-                    std::cout << db.name << '/';
                 }
-                std::cout << package->name << '\n';
-            }
-            return false;
-        });
+                return false;
+            },
+            true);
     }
 
     return 0;
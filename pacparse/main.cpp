@@ -47,7 +47,8 @@ int main(int argc, const char *argv[])
     packagesArg.setImplicit(true);
     auto binariesArg = ConfigValueArgument("binaries", 'b', "specifies the paths of the binaries", { "path" });
     binariesArg.setRequiredValueCount(Argument::varValueCount);
-    parser.setMainArguments({ &packagesArg, &binariesArg, &parser.helpArg() });
+    auto symbolsArg = ConfigValueArgument("symbols", 's', "reads the exported symbols of ELF binaries as well (skipped by default)");
+    parser.setMainArguments({ &packagesArg, &binariesArg, &symbolsArg, &parser.helpArg() });
     parser.setDefaultArgument(&parser.helpArg());
     parser.parseArgs(argc, argv);
     if (parser.helpArg().isPresent()) {
@@ -58,6 +59,7 @@ int main(int argc, const char *argv[])
     auto packageMutex = std::mutex();
     auto binaryMutex = std::mutex();
     auto returnCode = std::atomic<int>(EXIT_SUCCESS);
+    const auto binaryParseOptions = symbolsArg.isPresent() ? LibPkg::BinaryParseOptions::Symbols : LibPkg::BinaryParseOptions::None;
 
     auto pi = std::vector<const char *>::const_iterator();
     auto pend = std::vector<const char *>::const_iterator();
@@ -97,7 +99,7 @@ int main(int argc, const char *argv[])
             try {
                 if (isBinary) {
                     auto binary = LibPkg::Binary();
-                    binary.load(path);
+                    binary.load(path, binaryParseOptions);
                     auto binaryLock = std::unique_lock<std::mutex>(binaryMutex);
                     auto &binaryInfo = res.binaries.emplace_back();
                     binaryInfo.prefix = binary.addPrefix(std::string_view());
@@ -62,10 +62,17 @@ int main(int argc, const char *argv[])
         exitCode = setup.run();
     });
     auto fixDb = OperationArgument("fix-db", '\0', "fixes the database files");
-    fixDb.setSubArguments({ &configFileArg });
-    fixDb.setCallback([&setup, &exitCode, &assignConfigFiles](const ArgumentOccurrence &) {
+    auto compressArg = Argument("compress", '\0', "compresses cold package data (e.g. file lists) using a dictionary trained from the present packages");
+    auto decompressArg = Argument("decompress", '\0', "stores cold package data uncompressed");
+    fixDb.setSubArguments({ &configFileArg, &compressArg, &decompressArg });
+    fixDb.setCallback([&setup, &exitCode, &assignConfigFiles, &compressArg, &decompressArg](const ArgumentOccurrence &) {
         assignConfigFiles();
-        exitCode = setup.fixDb();
+        if (compressArg.isPresent() && decompressArg.isPresent()) {
+            std::cerr << EscapeCodes::Phrases::ErrorMessage << "--compress and --decompress can not be combined." << EscapeCodes::Phrases::End;
+            exitCode = EXIT_FAILURE;
+            return;
+        }
+        exitCode = setup.fixDb(compressArg.isPresent() ? std::optional(true) : (decompressArg.isPresent() ? std::optional(false) : std::nullopt));
     });
     auto dumpDb = OperationArgument("dump-db", '\0', "dumps package database entries");
     auto filterRegexArg = ConfigValueArgument("filter-regex", 'r', "dump only packages which name matches the specified regex", { "regex" });
@@ -72,11 +72,13 @@ function handleGlobalStatusUpdate(ajaxRequest)
         data: responseJson.resourceUsage,
         displayLabels: [
             'Virtual memory', 'Resident set size', 'Peak resident set size', 'Shared resident set size',
-            'Package-DB size', 'Actions-DB size', 'Cached packages', 'Actions', 'Running actions',
+            'Package-DB size', 'Actions-DB size', 'Cached packages', 'Package cache size', 'Package cache limit',
+            'Package cache hits', 'Package cache misses', 'Package cache evictions', 'Actions', 'Running actions',
         ],
         fieldAccessors: [
             'virtualMemory', 'residentSetSize', 'peakResidentSetSize', 'sharedResidentSetSize',
-            'packageDbSize', 'actionsDbSize', 'cachedPackages', 'actionsCount', 'runningActionsCount',
+            'packageDbSize', 'actionsDbSize', 'cachedPackages', 'packageCacheSize', 'packageCacheLimit',
+            'packageCacheHits', 'packageCacheMisses', 'packageCacheEvictions', 'actionsCount', 'runningActionsCount',
         ],
         customRenderer: {
             virtualMemory: GenericRendering.renderDataSize,
@@ -85,6 +87,8 @@ function handleGlobalStatusUpdate(ajaxRequest)
             sharedResidentSetSize: GenericRendering.renderDataSize,
             packageDbSize: GenericRendering.renderDataSize,
             actionsDbSize: GenericRendering.renderDataSize,
+            packageCacheSize: GenericRendering.renderDataSize,
+            packageCacheLimit: GenericRendering.renderDataSize,
         },
     });
     globalStatus.appendChild(resTable);